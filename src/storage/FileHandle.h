@@ -0,0 +1,109 @@
+#ifndef STORAGE_FILEHANDLE_H
+#define STORAGE_FILEHANDLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "IFile.h"
+#include "Debug.h"
+
+// Liczba obiektów plików w puli każdego systemu plików (openPooled).
+#ifndef ESP32_STORAGE_FILE_POOL_SIZE
+#define ESP32_STORAGE_FILE_POOL_SIZE 4
+#endif
+
+namespace storage {
+
+// Deleter zwracający obiekt tam, skąd pochodzi: do puli, do pamięci
+// dostarczonej przez wywołującego (tylko destruktor) albo na stertę.
+struct FileDeleter {
+    void (*release)(void* ctx, IFile* f) = nullptr;
+    void* ctx = nullptr;
+
+    void operator()(IFile* f) const {
+        if (!f) return;
+        if (release) release(ctx, f);
+        else delete f;
+    }
+};
+
+// Uchwyt pliku niezależny od sposobu alokacji. Uchwyt z puli lub z pamięci
+// wywołującego nie może przeżyć swojego źródła (systemu plików / bufora).
+using FileHandle = std::unique_ptr<IFile, FileDeleter>;
+
+// Pamięć na obiekt pliku dostarczana przez wywołującego (np. na stosie lub statycznie).
+template <class T>
+using FileStorage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+template <class T, class... Args>
+FileHandle placeFile(FileStorage<T>& storage, Args&&... args) {
+    T* obj = new (&storage) T(std::forward<Args>(args)...);
+    FileDeleter d;
+    d.release = [](void*, IFile* f) { static_cast<T*>(f)->~T(); };
+    return FileHandle(obj, d);
+}
+
+/**
+ * @brief Pula stałej liczby obiektów plików (bez sterty).
+ *
+ * Sloty zajmowane są bitmapą atomową, więc uchwyt można zwolnić z innego
+ * wątku niż ten, który go otworzył. Gdy pula jest pełna, `make` zwraca
+ * pusty uchwyt.
+ */
+template <class T, size_t N>
+class FilePool {
+    static_assert(N > 0 && N <= 32, "FilePool: 1..32 slotow");
+
+public:
+    FilePool() = default;
+    FilePool(const FilePool&) = delete;
+    FilePool& operator=(const FilePool&) = delete;
+
+    template <class... Args>
+    FileHandle make(Args&&... args) {
+        uint32_t cur = used.load(std::memory_order_relaxed);
+        size_t idx;
+        do {
+            for (idx = 0; idx < N && (cur & (1u << idx)); ++idx) {}
+            if (idx == N) {
+                DBG("FilePool::make exhausted (%u)", (unsigned)N);
+                return FileHandle();
+            }
+        } while (!used.compare_exchange_weak(cur, cur | (1u << idx), std::memory_order_acquire));
+
+        T* obj = new (&slots[idx]) T(std::forward<Args>(args)...);
+        FileDeleter d;
+        d.release = &FilePool::release;
+        d.ctx = this;
+        return FileHandle(obj, d);
+    }
+
+    size_t available() const {
+        uint32_t cur = used.load(std::memory_order_relaxed);
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) if (!(cur & (1u << i))) n++;
+        return n;
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    FileStorage<T> slots[N];
+    std::atomic<uint32_t> used{0};
+
+    static void release(void* ctx, IFile* f) {
+        FilePool* pool = static_cast<FilePool*>(ctx);
+        T* obj = static_cast<T*>(f);
+        size_t idx = static_cast<size_t>(reinterpret_cast<FileStorage<T>*>(obj) - pool->slots);
+        obj->~T();
+        pool->used.fetch_and(~(1u << idx), std::memory_order_release);
+    }
+};
+
+} // namespace storage
+
+#endif // STORAGE_FILEHANDLE_H
@@ -21,8 +21,21 @@ public:
     virtual bool isOpen() const = 0;
     virtual void close() = 0;
 
-    virtual bool getCreateDateTime(uint16_t* d, uint16_t* t) {
-        DBG("IFile::getCreateDateTime(d=%p, t=%p)", d, t);
+    // Offsety 64-bitowe (exFAT, pliki > 4 GiB). Domyślnie przez wywołania 32-bitowe,
+    // a pozycja poza zakresem uint32_t jest odrzucana. Wywołania 32-bitowe na
+    // dużym pliku zwracają co najwyżej UINT32_MAX.
+    virtual bool seek64(uint64_t pos) {
+        if (pos > UINT32_MAX) {
+            DBG("IFile::seek64(pos=%llu) beyond 32-bit range", static_cast<unsigned long long>(pos));
+            return false;
+        }
+        return seek(static_cast<uint32_t>(pos));
+    }
+    virtual uint64_t position64() { return position(); }
+    virtual uint64_t size64() { return size(); }
+
+    virtual bool getCreateDateTime(uint16_t* /*d*/, uint16_t* /*t*/) {
+        DBG("IFile::getCreateDateTime() not supported");
         return false;
     }
 };
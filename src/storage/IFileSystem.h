@@ -5,6 +5,8 @@
 #include <memory>
 #include <string>
 #include "IFile.h"
+#include "FileHandle.h"
+#include "Metrics.h"
 #include "Debug.h"
 
 namespace storage {
@@ -16,6 +18,15 @@ enum class OpenMode {
     ReadWrite,
 };
 
+// Geometria i zajętość nośnika (IFileSystem::info).
+struct FsInfo {
+    uint64_t totalBytes = 0;
+    uint64_t freeBytes = 0;
+    uint32_t sectorSize = 0;   // najmniejsza jednostka zapisu nośnika
+    uint32_t clusterSize = 0;  // jednostka alokacji (klaster FAT / blok LittleFS)
+    uint32_t ioAlignment = 0;  // zalecane wyrównanie i wielokrotność buforów zapisu
+};
+
 // Interfejs abstrakcyjny systemu plików (SD, Flash, RAM)
 class IFileSystem {
 public:
@@ -26,11 +37,34 @@ public:
     virtual bool exists(const std::string& path) = 0;
     virtual bool remove(const std::string& path) = 0;
     virtual bool mkdir(const std::string& path) = 0;
+
+    // Zmiana nazwy/przeniesienie. Cel nie może istnieć (jednakowo dla wszystkich backendów).
+    virtual bool rename(const std::string& /*from*/, const std::string& /*to*/) {
+        DBG("IFileSystem::rename not supported");
+        return false;
+    }
     virtual uint32_t getCreatedTimestamp(const std::string& path) = 0;
     virtual uint32_t getModifiedTimestamp(const std::string& path) = 0;
 
     virtual std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) = 0;
 
+    // Otwarcie bez alokacji na stercie – obiekt pliku z puli systemu plików.
+    // Domyślnie (backend bez puli) opakowuje open(). Pusty uchwyt = błąd lub pula pełna.
+    virtual FileHandle openPooled(const std::string& path, OpenMode mode) {
+        DBG("IFileSystem::openPooled(path=%s) -> heap", path.c_str());
+        return FileHandle(open(path, mode).release());
+    }
+
+    // Pojemność, wolne miejsce i geometria. false = backend nie udostępnia tych danych.
+    virtual bool info(FsInfo& out) {
+        DBG("IFileSystem::info() not supported");
+        out = FsInfo();
+        return false;
+    }
+
+    // Metryki backendu (liczniki/histogramy, ESP32_STORAGE_METRICS); nullptr = brak.
+    virtual FsMetrics* metrics() { return nullptr; }
+
     std::unique_ptr<IFile> openRead(const std::string& path) {
         DBG("IFileSystem::openRead(path=%s)", path.c_str());
         return open(path, OpenMode::Read);
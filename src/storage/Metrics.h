@@ -0,0 +1,243 @@
+#ifndef STORAGE_METRICS_H
+#define STORAGE_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef ESP32_STORAGE_METRICS
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace storage {
+
+enum class IoOp : uint8_t {
+    Open,
+    Read,
+    Write,
+    Flush,
+    Seek,
+    Close,
+    Remove,
+    Mkdir,
+    Rename,
+    List,
+    Stat,   // exists, znaczniki czasu
+    Count,
+};
+
+inline const char* ioOpName(IoOp op) {
+    static const char* const names[] = {
+        "open", "read", "write", "flush", "seek", "close",
+        "remove", "mkdir", "rename", "list", "stat",
+    };
+    return op < IoOp::Count ? names[static_cast<int>(op)] : "?";
+}
+
+#ifdef ESP32_STORAGE_METRICS
+
+// Licznik cykli: na ESP32 rejestr CCOUNT (per rdzeń – operacja nie powinna
+// migrować między rdzeniami; różnica bez znaku przeżywa jedno przepełnienie,
+// ~17 s przy 240 MHz), na hoście steady_clock w ns na 64 bitach.
+namespace metrics_clock {
+#if defined(ARDUINO)
+typedef uint32_t ticks;
+inline ticks now() { return ESP.getCycleCount(); }
+inline uint32_t cyclesPerUs() { return getCpuFrequencyMhz(); }
+#else
+typedef uint64_t ticks;
+inline ticks now() {
+    using namespace std::chrono;
+    return static_cast<ticks>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+inline uint32_t cyclesPerUs() { return 1000; }
+#endif
+
+// Czas od `start` w cyklach; dłuższe pomiary są obcinane do UINT32_MAX.
+inline uint32_t since(ticks start) {
+    ticks d = static_cast<ticks>(now() - start);
+    return d > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(d);
+}
+} // namespace metrics_clock
+
+/**
+ * @brief Liczniki i histogram czasu jednej operacji.
+ *
+ * Histogram ma kubełki potęg dwójki (w cyklach), p50/p99 są szacowane
+ * górną granicą kubełka (ograniczoną przez max).
+ */
+struct OpStats {
+    static constexpr int kBuckets = 32;
+
+    uint32_t count = 0;
+    uint32_t errors = 0;
+    uint64_t bytes = 0;
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+    uint32_t hist[kBuckets] = {};
+
+    void record(uint32_t cycles, size_t nbytes, bool ok) {
+        count++;
+        if (!ok) errors++;
+        bytes += nbytes;
+        totalCycles += cycles;
+        if (cycles > maxCycles) maxCycles = cycles;
+        int b = 0;
+        while (b < kBuckets - 1 && (cycles >> (b + 1))) b++;
+        hist[b]++;
+    }
+
+    uint32_t percentileCycles(uint32_t permille) const {
+        if (!count) return 0;
+        uint64_t want = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+        uint64_t acc = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            acc += hist[b];
+            if (acc >= want) {
+                uint64_t upper = (2ull << b) - 1;
+                return upper < maxCycles ? static_cast<uint32_t>(upper) : maxCycles;
+            }
+        }
+        return maxCycles;
+    }
+};
+
+/**
+ * @brief Metryki jednego systemu plików (per operacja).
+ *
+ * Każdy obiekt rejestruje się na liście globalnej, więc `dumpAll` wypisuje
+ * wszystkie backendy naraz. Liczniki nie są atomowe – zakładamy jeden
+ * wątek I/O na system plików (np. `io::IoScheduler`).
+ */
+class FsMetrics {
+public:
+    explicit FsMetrics(const char* name) : fsName(name), next(head()) { head() = this; }
+    ~FsMetrics() {
+        for (FsMetrics** p = &head(); *p; p = &(*p)->next) {
+            if (*p == this) { *p = next; break; }
+        }
+    }
+
+    FsMetrics(const FsMetrics&) = delete;
+    FsMetrics& operator=(const FsMetrics&) = delete;
+
+    void record(IoOp op, uint32_t cycles, size_t bytes, bool ok) {
+        ops[static_cast<int>(op)].record(cycles, bytes, ok);
+    }
+
+    const OpStats& stats(IoOp op) const { return ops[static_cast<int>(op)]; }
+    const char* name() const { return fsName; }
+    void reset() { for (auto& s : ops) s = OpStats(); }
+
+    template <class Out>
+    void dumpText(Out& out) const {
+        char line[160];
+        uint32_t mhz = metrics_clock::cyclesPerUs();
+        for (int i = 0; i < static_cast<int>(IoOp::Count); ++i) {
+            const OpStats& s = ops[i];
+            if (!s.count) continue;
+            // czasy w us z jednym miejscem po przecinku
+            unsigned long p50 = (unsigned long)((uint64_t)s.percentileCycles(500) * 10 / mhz);
+            unsigned long p99 = (unsigned long)((uint64_t)s.percentileCycles(990) * 10 / mhz);
+            unsigned long mx = (unsigned long)((uint64_t)s.maxCycles * 10 / mhz);
+            snprintf(line, sizeof(line),
+                     "[%s] %-6s n=%lu err=%lu bytes=%llu p50=%lu.%luus p99=%lu.%luus max=%lu.%luus\n",
+                     fsName, ioOpName(static_cast<IoOp>(i)),
+                     (unsigned long)s.count, (unsigned long)s.errors, (unsigned long long)s.bytes,
+                     p50 / 10, p50 % 10, p99 / 10, p99 % 10, mx / 10, mx % 10);
+            out.print(line);
+        }
+    }
+
+    template <class Out>
+    void dumpJson(Out& out) const {
+        char line[200];
+        uint32_t mhz = metrics_clock::cyclesPerUs();
+        snprintf(line, sizeof(line), "{\"fs\":\"%s\",\"ops\":{", fsName);
+        out.print(line);
+        bool first = true;
+        for (int i = 0; i < static_cast<int>(IoOp::Count); ++i) {
+            const OpStats& s = ops[i];
+            if (!s.count) continue;
+            snprintf(line, sizeof(line),
+                     "%s\"%s\":{\"n\":%lu,\"err\":%lu,\"bytes\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+                     first ? "" : ",", ioOpName(static_cast<IoOp>(i)),
+                     (unsigned long)s.count, (unsigned long)s.errors, (unsigned long long)s.bytes,
+                     (unsigned long long)s.percentileCycles(500) * 1000 / mhz,
+                     (unsigned long long)s.percentileCycles(990) * 1000 / mhz,
+                     (unsigned long long)s.maxCycles * 1000 / mhz);
+            out.print(line);
+            first = false;
+        }
+        out.print("}}");
+    }
+
+    template <class Out>
+    static void dumpAll(Out& out, bool json = false) {
+        if (json) out.print("[");
+        for (FsMetrics* m = head(); m; m = m->next) {
+            if (json) { m->dumpJson(out); if (m->next) out.print(","); }
+            else m->dumpText(out);
+        }
+        if (json) out.print("]\n");
+    }
+
+private:
+    const char* fsName;
+    FsMetrics* next;
+    OpStats ops[static_cast<int>(IoOp::Count)];
+
+    static FsMetrics*& head() {
+        static FsMetrics* h = nullptr;
+        return h;
+    }
+};
+
+// Pomiar jednej operacji (RAII): czas od konstrukcji do destrukcji.
+class MetricScope {
+public:
+    MetricScope(FsMetrics* m, IoOp o) : metrics(m), op(o), start(m ? metrics_clock::now() : 0) {}
+    ~MetricScope() {
+        if (metrics) metrics->record(op, metrics_clock::since(start), nbytes, ok);
+    }
+    void bytes(size_t n) { nbytes = n; }
+    void fail() { ok = false; }
+    void result(bool success) { ok = success; }
+
+private:
+    FsMetrics* metrics;
+    IoOp op;
+    metrics_clock::ticks start;
+    size_t nbytes = 0;
+    bool ok = true;
+};
+
+#else // !ESP32_STORAGE_METRICS – wszystko sprowadza się do pustych funkcji inline
+
+class FsMetrics {
+public:
+    explicit FsMetrics(const char*) {}
+    void record(IoOp, uint32_t, size_t, bool) {}
+    void reset() {}
+    template <class Out> void dumpText(Out&) const {}
+    template <class Out> void dumpJson(Out& out) const { out.print("{}"); }
+    template <class Out> static void dumpAll(Out& out, bool json = false) { if (json) out.print("[]\n"); }
+};
+
+class MetricScope {
+public:
+    MetricScope(FsMetrics*, IoOp) {}
+    void bytes(size_t) {}
+    void fail() {}
+    void result(bool) {}
+};
+
+#endif // ESP32_STORAGE_METRICS
+
+} // namespace storage
+
+#endif // STORAGE_METRICS_H
@@ -0,0 +1,190 @@
+#include "AsyncFile.h"
+#include "storage/Debug.h"
+
+#include <chrono>
+#include <vector>
+
+namespace storage {
+namespace io {
+
+// ------------------- IoCompletion -------------------
+
+IoCompletion IoCompletion::create() {
+    IoCompletion c;
+    c.state = std::make_shared<State>();
+    return c;
+}
+
+IoCompletion IoCompletion::failed() {
+    IoCompletion c = create();
+    c.complete(IoResult());
+    return c;
+}
+
+void IoCompletion::complete(const IoResult& res) const {
+    IoCallback cb;
+    {
+        std::lock_guard<std::mutex> lock(state->m);
+        state->res = res;
+        state->done = true;
+        cb = std::move(state->cb);
+    }
+    state->cv.notify_all();
+    if (cb) cb(res);
+}
+
+bool IoCompletion::ready() const {
+    if (!state) return false;
+    std::lock_guard<std::mutex> lock(state->m);
+    return state->done;
+}
+
+IoResult IoCompletion::result() const {
+    if (!state) return IoResult();
+    std::lock_guard<std::mutex> lock(state->m);
+    return state->res;
+}
+
+IoResult IoCompletion::wait() const {
+    if (!state) return IoResult();
+    std::unique_lock<std::mutex> lock(state->m);
+    state->cv.wait(lock, [this] { return state->done; });
+    return state->res;
+}
+
+bool IoCompletion::waitFor(uint32_t ms) const {
+    if (!state) return false;
+    std::unique_lock<std::mutex> lock(state->m);
+    return state->cv.wait_for(lock, std::chrono::milliseconds(ms), [this] { return state->done; });
+}
+
+bool IoCompletion::attach(IoCallback&& cb) {
+    std::lock_guard<std::mutex> lock(state->m);
+    if (state->done) return false;
+    state->cb = std::move(cb);
+    return true;
+}
+
+void IoCompletion::then(IoCallback cb) {
+    if (!state || !cb) return;
+    if (!attach(std::move(cb))) cb(result());
+}
+
+// ------------------- AsyncFile -------------------
+
+AsyncFile::AsyncFile(IoScheduler& scheduler, IoPriority p)
+    : slot(std::make_shared<Slot>()), io(scheduler), prio(p) {}
+
+std::unique_ptr<AsyncFile> AsyncFile::open(IoScheduler& scheduler, const std::string& path, OpenMode mode,
+                                           IoPriority prio) {
+    DBG("AsyncFile::open(%s)", path.c_str());
+    std::unique_ptr<AsyncFile> af(new AsyncFile(scheduler, prio));
+    IoCompletion c = IoCompletion::create();
+    std::shared_ptr<Slot> s = af->slot;
+    bool queued = scheduler.run(
+        [s, path, mode, c](IFileSystem& fs) {
+            s->file = fs.open(path, mode);
+            IoResult r;
+            r.ok = static_cast<bool>(s->file);
+            c.complete(r);
+            return r.ok;
+        },
+        prio);
+    if (!queued) {
+        DBG("AsyncFile::open rejected");
+        af->slot.reset();
+        return nullptr;
+    }
+    af->openDone = c;
+    af->last = c;
+    return af;
+}
+
+AsyncFile::~AsyncFile() {
+    DBG("AsyncFile::~AsyncFile()");
+    if (slot) closeAsync();
+    // z wątku roboczego nie da się czekać na własną kolejkę
+    if (last.valid() && !io.isWorkerThread()) last.wait();
+}
+
+IoCompletion AsyncFile::submit(std::function<IoResult(IFile&)> op) {
+    if (!slot) return IoCompletion::failed();
+    IoCompletion c = IoCompletion::create();
+    std::shared_ptr<Slot> s = slot;
+    bool queued = io.run(
+        [s, op, c](IFileSystem&) {
+            c.complete(s->file ? op(*s->file) : IoResult());
+            return true;
+        },
+        prio);
+    if (!queued) {
+        DBG("AsyncFile::submit rejected");
+        c.complete(IoResult());
+    }
+    last = c;
+    return c;
+}
+
+IoCompletion AsyncFile::readAsync(void* buf, size_t size) {
+    return submit([buf, size](IFile& f) {
+        IoResult r;
+        r.bytes = f.read(buf, size);
+        r.ok = r.bytes == size;
+        return r;
+    });
+}
+
+IoCompletion AsyncFile::writeAsync(const void* buf, size_t size) {
+    auto data = std::make_shared<std::vector<uint8_t>>(
+        static_cast<const uint8_t*>(buf), static_cast<const uint8_t*>(buf) + size);
+    return submit([data](IFile& f) {
+        IoResult r;
+        r.bytes = f.write(data->data(), data->size());
+        r.ok = r.bytes == data->size();
+        return r;
+    });
+}
+
+IoCompletion AsyncFile::flushAsync() {
+    return submit([](IFile& f) {
+        f.flush();
+        IoResult r;
+        r.ok = true;
+        return r;
+    });
+}
+
+IoCompletion AsyncFile::seekAsync(uint64_t pos) {
+    return submit([pos](IFile& f) {
+        IoResult r;
+        r.ok = f.seek64(pos);
+        return r;
+    });
+}
+
+IoCompletion AsyncFile::closeAsync() {
+    if (!slot) return IoCompletion::failed();
+    IoCompletion c = IoCompletion::create();
+    std::shared_ptr<Slot> s = slot;
+    bool queued = io.run(
+        [s, c](IFileSystem&) {
+            IoResult r;
+            r.ok = static_cast<bool>(s->file);
+            if (s->file) s->file->close();
+            s->file.reset();
+            c.complete(r);
+            return true;
+        },
+        prio);
+    if (!queued) {
+        // bez wątku roboczego uchwyt zamyka destruktor ostatniej referencji
+        DBG("AsyncFile::closeAsync rejected");
+        c.complete(IoResult());
+    }
+    slot.reset();
+    last = c;
+    return c;
+}
+
+} // namespace io
+} // namespace storage
@@ -0,0 +1,120 @@
+#ifndef STORAGE_IO_ASYNCFILE_H
+#define STORAGE_IO_ASYNCFILE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "storage/IFile.h"
+#include "IoScheduler.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define STORAGE_IO_COROUTINES 1
+#endif
+#endif
+
+namespace storage {
+namespace io {
+
+/**
+ * @brief Uchwyt zakończenia operacji asynchronicznej.
+ *
+ * Można go odpytywać (`ready`), czekać na niego (`wait`, `waitFor`) albo
+ * zarejestrować callback (`then`). Callback zarejestrowany przed zakończeniem
+ * wywoływany jest w wątku roboczym, po zakończeniu – od razu w wątku wołającym.
+ * W C++20 uchwyt jest też awaitable (`co_await`), wznowienie następuje
+ * w wątku roboczym.
+ */
+class IoCompletion {
+public:
+    IoCompletion() = default;
+
+    bool valid() const { return static_cast<bool>(state); }
+    bool ready() const;
+    IoResult result() const; // ważny po ready()
+    IoResult wait() const;
+    bool waitFor(uint32_t ms) const;
+    void then(IoCallback cb);
+
+#ifdef STORAGE_IO_COROUTINES
+    bool await_ready() const noexcept { return !valid() || ready(); }
+    // false = zakończone w międzyczasie – kontynuacja bez zawieszania
+    bool await_suspend(std::coroutine_handle<> h) {
+        return attach([h](const IoResult&) { h.resume(); });
+    }
+    IoResult await_resume() const { return result(); }
+#endif
+
+private:
+    struct State {
+        std::mutex m;
+        std::condition_variable cv;
+        bool done = false;
+        IoResult res;
+        IoCallback cb;
+    };
+    std::shared_ptr<State> state;
+
+    static IoCompletion create();
+    static IoCompletion failed();
+    void complete(const IoResult& res) const;
+    bool attach(IoCallback&& cb); // false = już zakończone, cb nie został przejęty
+
+    friend class AsyncFile;
+};
+
+/**
+ * @brief Asynchroniczne operacje na pliku.
+ *
+ * Plik otwierany jest w wątku `IoScheduler` (`open()` tylko zleca otwarcie –
+ * otwarcie w wątku wołającym ścigałoby się z wątkiem roboczym o ten sam
+ * wolumen SdFat). Operacje wykonywane są w kolejności zlecania (wszystkie
+ * z tym samym priorytetem, za otwarciem), na bieżącej pozycji pliku – tak
+ * jak ich blokujące odpowiedniki. Jeśli otwarcie się nie powiedzie, `opened()`
+ * i wszystkie operacje kończą się z `ok = false`. Bufor `readAsync` musi
+ * pozostać ważny do zakończenia; dane `writeAsync` są kopiowane.
+ *
+ * Destruktor czeka na zakończenie zleconych operacji i zamyka plik.
+ */
+class AsyncFile {
+public:
+    // nullptr tylko, gdy scheduler nie przyjął zlecenia otwarcia (zatrzymany, pełna kolejka)
+    static std::unique_ptr<AsyncFile> open(IoScheduler& scheduler, const std::string& path, OpenMode mode,
+                                           IoPriority prio = IoPriority::Normal);
+    ~AsyncFile();
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    IoCompletion readAsync(void* buf, size_t size);
+    IoCompletion writeAsync(const void* buf, size_t size);
+    IoCompletion flushAsync();
+    IoCompletion seekAsync(uint64_t pos);  // seek64: pełny zakres exFAT
+    IoCompletion closeAsync();
+
+    IoCompletion opened() const { return openDone; }
+    bool isOpen() const { return static_cast<bool>(slot); } // do closeAsync()
+
+private:
+    struct Slot {
+        std::unique_ptr<IFile> file; // tylko w wątku roboczym
+    };
+
+    std::shared_ptr<Slot> slot;
+    IoScheduler& io;
+    IoPriority prio;
+    IoCompletion openDone;
+    IoCompletion last;
+
+    AsyncFile(IoScheduler& scheduler, IoPriority prio);
+
+    IoCompletion submit(std::function<IoResult(IFile&)> op);
+};
+
+} // namespace io
+} // namespace storage
+
+#endif // STORAGE_IO_ASYNCFILE_H
@@ -0,0 +1,100 @@
+#include "FileHandleCache.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+namespace storage {
+namespace io {
+
+FileHandleCache::FileHandleCache(IFileSystem& f, size_t limit) : fs(f), maxOpen(limit ? limit : 1) {
+    DBG("FileHandleCache::FileHandleCache(limit=%u)", (unsigned)maxOpen);
+    entries.reserve(maxOpen);
+}
+
+FileHandleCache::~FileHandleCache() {
+    closeAll();
+}
+
+std::string FileHandleCache::key(const std::string& path) {
+    std::string k = util::normalizePath(path);
+    if (!k.empty() && k[0] != '/') k.insert(0, "/");
+    return k;
+}
+
+IFile* FileHandleCache::get(const std::string& rawPath, OpenMode mode) {
+    const std::string path = key(rawPath);
+    tick++;
+    for (size_t i = 0; i < entries.size();) {
+        Entry& e = entries[i];
+        // WriteTruncate zawsze otwiera na nowo – trafienie nie obcięłoby pliku
+        if (e.path == path && e.mode == mode && mode != OpenMode::WriteTruncate) {
+            e.lastUse = tick;
+            hitCount++;
+            return e.file.get();
+        }
+        // ten sam plik w innym trybie – nie trzymamy równoległych uchwytów z zapisem
+        if (e.path == path && (e.mode != OpenMode::Read || mode != OpenMode::Read)) {
+            closeAt(i);
+            continue;
+        }
+        ++i;
+    }
+
+    missCount++;
+    while (entries.size() >= maxOpen) evictOne();
+
+    std::unique_ptr<IFile> f = fs.open(path, mode);
+    DBG("FileHandleCache::get(%s, mode=%d) open=%d", path.c_str(), static_cast<int>(mode), f ? 1 : 0);
+    if (!f) return nullptr;
+    entries.push_back(Entry{path, mode, std::move(f), tick});
+    return entries.back().file.get();
+}
+
+size_t FileHandleCache::append(const std::string& path, const void* data, size_t size) {
+    IFile* f = get(path, OpenMode::WriteAppend);
+    return f ? f->write(data, size) : 0;
+}
+
+void FileHandleCache::flushAll() {
+    DBG("FileHandleCache::flushAll() entries=%u", (unsigned)entries.size());
+    for (auto& e : entries) {
+        if (e.mode != OpenMode::Read) e.file->flush();
+    }
+}
+
+void FileHandleCache::close(const std::string& rawPath) {
+    const std::string path = key(rawPath);
+    for (size_t i = 0; i < entries.size();) {
+        if (entries[i].path == path) closeAt(i);
+        else ++i;
+    }
+}
+
+void FileHandleCache::closeAll() {
+    while (!entries.empty()) closeAt(entries.size() - 1);
+}
+
+void FileHandleCache::setLimit(size_t limit) {
+    maxOpen = limit ? limit : 1;
+    while (entries.size() > maxOpen) evictOne();
+}
+
+void FileHandleCache::evictOne() {
+    if (entries.empty()) return;
+    size_t lru = 0;
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i].lastUse < entries[lru].lastUse) lru = i;
+    }
+    DBG("FileHandleCache::evict %s", entries[lru].path.c_str());
+    closeAt(lru);
+}
+
+void FileHandleCache::closeAt(size_t idx) {
+    Entry& e = entries[idx];
+    if (e.mode != OpenMode::Read) e.file->flush();
+    e.file->close();
+    if (idx != entries.size() - 1) entries[idx] = std::move(entries.back());
+    entries.pop_back();
+}
+
+} // namespace io
+} // namespace storage
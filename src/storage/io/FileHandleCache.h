@@ -0,0 +1,84 @@
+#ifndef STORAGE_IO_FILEHANDLECACHE_H
+#define STORAGE_IO_FILEHANDLECACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+// Domyślny limit uchwytów. LittleFsFileSystem montuje VFS z maxOpenFiles=5,
+// więc zostawiamy jeden wolny uchwyt na zwykłe open().
+#ifndef ESP32_STORAGE_HANDLE_CACHE_SIZE
+#define ESP32_STORAGE_HANDLE_CACHE_SIZE 4
+#endif
+
+namespace storage {
+namespace io {
+
+/**
+ * @brief Pamięć podręczna (LRU) otwartych uchwytów `IFile`.
+ *
+ * Zastępuje wzorzec `openAppend` → `write` → `close` dla często
+ * zapisywanych plików: kolejne `get()` tej samej ścieżki i trybu zwracają
+ * ten sam otwarty uchwyt (bez tworzenia katalogów, wyszukiwania
+ * w katalogu i seek na koniec pliku).
+ *
+ * - Klucz to znormalizowana ścieżka (`util::normalizePath`; względna liczona
+ *   od katalogu głównego, jak w SdFat/LittleFS) + tryb otwarcia.
+ * - `WriteTruncate` nie daje trafień: każde `get()` zamyka poprzedni uchwyt
+ *   i otwiera plik ponownie (obcięty).
+ * - Po przekroczeniu limitu najdawniej używany uchwyt jest flushowany i zamykany.
+ * - Otwarcie pliku w innym trybie zamyka najpierw jego uchwyt w trybie zapisu.
+ * - Przed `remove`/`rename` pliku z cache trzeba wywołać `close(path)`.
+ *
+ * Uchwyty należą do cache – nie wolno ich zamykać ani usuwać samodzielnie.
+ * Klasa nie jest thread-safe (tak jak systemy plików, które opakowuje).
+ */
+class FileHandleCache {
+public:
+    explicit FileHandleCache(IFileSystem& fs, size_t limit = ESP32_STORAGE_HANDLE_CACHE_SIZE);
+    ~FileHandleCache();
+
+    FileHandleCache(const FileHandleCache&) = delete;
+    FileHandleCache& operator=(const FileHandleCache&) = delete;
+
+    IFile* get(const std::string& path, OpenMode mode);
+
+    // Skrót dla logów: dopisanie przez uchwyt z cache (bez zamykania).
+    size_t append(const std::string& path, const void* data, size_t size);
+
+    void flushAll();
+    void close(const std::string& path);
+    void closeAll();
+
+    void setLimit(size_t limit);
+    size_t limit() const { return maxOpen; }
+    size_t size() const { return entries.size(); }
+    uint32_t hits() const { return hitCount; }
+    uint32_t misses() const { return missCount; }
+
+private:
+    struct Entry {
+        std::string path;
+        OpenMode mode;
+        std::unique_ptr<IFile> file;
+        uint32_t lastUse;
+    };
+
+    IFileSystem& fs;
+    size_t maxOpen;
+    std::vector<Entry> entries;
+    uint32_t tick = 0;
+    uint32_t hitCount = 0;
+    uint32_t missCount = 0;
+
+    static std::string key(const std::string& path);
+    void evictOne();
+    void closeAt(size_t idx);
+};
+
+} // namespace io
+} // namespace storage
+
+#endif // STORAGE_IO_FILEHANDLECACHE_H
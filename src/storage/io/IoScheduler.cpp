@@ -0,0 +1,397 @@
+#include "IoScheduler.h"
+#include "storage/Debug.h"
+
+#include <cstring>
+
+#ifdef ESP_PLATFORM
+#include <esp_pthread.h>
+#endif
+
+namespace storage {
+namespace io {
+
+IoScheduler::IoScheduler(IFileSystem& f) : IoScheduler(f, Config()) {}
+
+IoScheduler::IoScheduler(IFileSystem& f, const Config& c) : fs(f), cfg(c) {
+    if (!cfg.maxChunk) cfg.maxChunk = 512;
+    DBG("IoScheduler::IoScheduler(chunk=%u, batch=%u)", (unsigned)cfg.maxChunk, (unsigned)cfg.appendBatch);
+}
+
+IoScheduler::~IoScheduler() {
+    if (isWorkerThread()) DBG("IoScheduler::~IoScheduler() called from the worker thread");
+    stop();
+}
+
+bool IoScheduler::start() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (running) return !stopping;
+    stopping = false;
+
+#ifdef ESP_PLATFORM
+    esp_pthread_cfg_t pcfg = esp_pthread_get_default_config();
+    pcfg.stack_size = cfg.stackSize;
+    pcfg.prio = cfg.taskPriority;
+    pcfg.pin_to_core = cfg.core;
+    pcfg.thread_name = "storage-io";
+    esp_pthread_set_cfg(&pcfg);
+#endif
+    worker = std::thread([this] { loop(); });
+#ifdef ESP_PLATFORM
+    pcfg = esp_pthread_get_default_config();
+    esp_pthread_set_cfg(&pcfg);
+#endif
+
+    running = true;
+    DBG("IoScheduler::start()");
+    return true;
+}
+
+void IoScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    // z callbacku nie można czekać na samego siebie: wątek kończy się po bieżącym
+    // zleceniu, a join wykona kolejne stop() (np. destruktor) z innego wątku
+    if (isWorkerThread()) return;
+    if (worker.joinable()) worker.join();
+    std::lock_guard<std::mutex> lock(mtx);
+    running = false;
+    DBG("IoScheduler::stop()");
+}
+
+bool IoScheduler::isWorkerThread() const {
+    return worker.get_id() == std::this_thread::get_id();
+}
+
+size_t IoScheduler::pending() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return queued;
+}
+
+bool IoScheduler::enqueue(Request&& req, IoPriority prio) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running || stopping) return false;
+        if (cfg.queueLimit && queued >= cfg.queueLimit) {
+            DBG("IoScheduler::enqueue queue full (%u)", (unsigned)queued);
+            return false;
+        }
+        queues[static_cast<int>(prio)].push_back(std::move(req));
+        queued++;
+    }
+    wake.notify_one();
+    return true;
+}
+
+bool IoScheduler::read(const std::string& path, uint32_t offset, void* dst, size_t len,
+                       IoPriority prio, IoCallback done) {
+    Request r;
+    r.kind = Kind::Read;
+    r.path = path;
+    r.offset = offset;
+    r.dst = static_cast<uint8_t*>(dst);
+    r.len = len;
+    r.cb = std::move(done);
+    return enqueue(std::move(r), prio);
+}
+
+bool IoScheduler::write(const std::string& path, uint32_t offset, const void* src, size_t len,
+                        IoPriority prio, IoCallback done) {
+    Request r;
+    r.kind = Kind::Write;
+    r.path = path;
+    r.offset = offset;
+    r.data.assign(static_cast<const uint8_t*>(src), static_cast<const uint8_t*>(src) + len);
+    r.len = len;
+    r.cb = std::move(done);
+    return enqueue(std::move(r), prio);
+}
+
+bool IoScheduler::append(const std::string& path, const void* src, size_t len,
+                         IoPriority prio, IoCallback done) {
+    Request r;
+    r.kind = Kind::Append;
+    r.path = path;
+    r.data.assign(static_cast<const uint8_t*>(src), static_cast<const uint8_t*>(src) + len);
+    r.len = len;
+    r.cb = std::move(done);
+    return enqueue(std::move(r), prio);
+}
+
+bool IoScheduler::run(std::function<bool(IFileSystem&)> fn, IoPriority prio, IoCallback done) {
+    Request r;
+    r.kind = Kind::Call;
+    r.fn = std::move(fn);
+    r.cb = std::move(done);
+    return enqueue(std::move(r), prio);
+}
+
+IoResult IoScheduler::readSync(const std::string& path, uint32_t offset, void* dst, size_t len,
+                               IoPriority prio) {
+    if (isWorkerThread()) {
+        IoResult res;
+        IFile* f = fileFor(path, OpenMode::Read);
+        if (f && f->seek(offset)) {
+            res.bytes = f->read(dst, len);
+            res.ok = res.bytes == len;
+        }
+        return res;
+    }
+    std::mutex m;
+    std::condition_variable cv;
+    bool finished = false;
+    IoResult out;
+    if (!read(path, offset, dst, len, prio, [&](const IoResult& r) {
+            std::lock_guard<std::mutex> lock(m);
+            out = r;
+            finished = true;
+            cv.notify_one();
+        })) {
+        return out;
+    }
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return finished; });
+    return out;
+}
+
+IoResult IoScheduler::runSync(std::function<bool(IFileSystem&)> fn, IoPriority prio) {
+    if (isWorkerThread()) {
+        closeCurrent();
+        IoResult res;
+        res.ok = fn(fs);
+        return res;
+    }
+    std::mutex m;
+    std::condition_variable cv;
+    bool finished = false;
+    IoResult out;
+    if (!run(std::move(fn), prio, [&](const IoResult& r) {
+            std::lock_guard<std::mutex> lock(m);
+            out = r;
+            finished = true;
+            cv.notify_one();
+        })) {
+        return out;
+    }
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return finished; });
+    return out;
+}
+
+void IoScheduler::drain() {
+    if (isWorkerThread()) return;
+    std::unique_lock<std::mutex> lock(mtx);
+    idle.wait(lock, [this] { return (queued == 0 && !busy) || !running; });
+}
+
+// ------------------- wątek roboczy -------------------
+
+bool IoScheduler::conflicts(const Request& a, const Request& b) {
+    if (a.kind == Kind::Call || b.kind == Kind::Call) return true;
+    if (a.path != b.path) return false;
+    return a.kind != b.kind;
+}
+
+void IoScheduler::takeBatch(std::vector<Request>& batch, int& level) {
+    level = 0;
+    while (level < kLevels && queues[level].empty()) level++;
+    std::deque<Request>& q = queues[level];
+
+    batch.push_back(std::move(q.front()));
+    q.pop_front();
+    queued--;
+
+    // batch.front() pobierane na nowo – push_back może przenieść elementy
+    const Kind kind = batch.front().kind;
+    if (kind != Kind::Read && kind != Kind::Append) return;
+
+    // dobieranie zleceń do tego samego pliku z tego samego priorytetu
+    uint32_t nextOffset = batch.front().offset + batch.front().len;
+    size_t appended = batch.front().len - batch.front().done;
+    // sklejone dopisania idą jednym zapisem, więc razem nie więcej niż maxChunk
+    size_t appendLimit = cfg.appendBatch < cfg.maxChunk ? cfg.appendBatch : cfg.maxChunk;
+    for (auto it = q.begin(); it != q.end();) {
+        if (it->path == batch.front().path && it->kind == kind) {
+            // sklejone odczyty też idą jedną operacją – razem nie więcej niż maxChunk
+            bool take = kind == Kind::Read
+                ? it->offset == nextOffset && appended + it->len <= cfg.maxChunk
+                : appended + it->len <= appendLimit;
+            if (!take) break;
+            nextOffset += it->len;
+            appended += it->len;
+            batch.push_back(std::move(*it));
+            it = q.erase(it);
+            queued--;
+            continue;
+        }
+        if (conflicts(batch.front(), *it)) break;
+        ++it;
+    }
+}
+
+IFile* IoScheduler::fileFor(const std::string& path, OpenMode mode) {
+    if (cur && curPath == path && curMode == mode) return cur.get();
+    closeCurrent();
+    cur = fs.open(path, mode);
+    if (!cur) return nullptr;
+    curPath = path;
+    curMode = mode;
+    return cur.get();
+}
+
+void IoScheduler::closeCurrent() {
+    if (!cur) return;
+    cur->close();
+    cur.reset();
+    curPath.clear();
+}
+
+void IoScheduler::execute(std::vector<Request>& batch, int level) {
+    Request& head = batch.front();
+
+    switch (head.kind) {
+    case Kind::Call: {
+        closeCurrent();
+        IoResult res;
+        res.ok = head.fn ? head.fn(fs) : false;
+        if (head.cb) head.cb(res);
+        return;
+    }
+
+    case Kind::Append: {
+        IFile* f = fileFor(head.path, OpenMode::WriteAppend);
+        if (batch.size() == 1) {
+            // pojedyncze duże dopisanie – porcjami jak Write
+            size_t want = head.len - head.done;
+            if (want > cfg.maxChunk) want = cfg.maxChunk;
+            size_t n = f ? f->write(head.data.data() + head.done, want) : 0;
+            head.done += n;
+            if (n == want && head.done < head.len) {
+                std::lock_guard<std::mutex> lock(mtx);
+                queues[level].push_front(std::move(head));
+                queued++;
+                return;
+            }
+            DBG("IoScheduler append %s -> %u/%u", head.path.c_str(), (unsigned)head.done, (unsigned)head.len);
+            IoResult res;
+            res.ok = head.done == head.len;
+            res.bytes = head.done;
+            if (head.cb) head.cb(res);
+            return;
+        }
+        size_t total = 0;
+        for (auto& r : batch) total += r.len;
+        size_t written = 0;
+        if (f) {
+            batchBuf.clear();
+            batchBuf.reserve(total);
+            for (auto& r : batch) batchBuf.insert(batchBuf.end(), r.data.begin(), r.data.end());
+            written = f->write(batchBuf.data(), batchBuf.size());
+        }
+        DBG("IoScheduler append %s x%u -> %u/%u", head.path.c_str(), (unsigned)batch.size(),
+            (unsigned)written, (unsigned)total);
+        // niepełny zapis: zlecenia w kolejności dostają bajty, które zmieściły się w pliku
+        for (auto& r : batch) {
+            IoResult res;
+            res.bytes = written < r.len ? written : r.len;
+            res.ok = res.bytes == r.len;
+            written -= res.bytes;
+            if (r.cb) r.cb(res);
+        }
+        return;
+    }
+
+    case Kind::Read: {
+        IFile* f = fileFor(head.path, OpenMode::Read);
+        bool positioned = f && f->seek(head.offset + head.done);
+        if (batch.size() > 1) {
+            // sąsiednie odczyty (razem <= maxChunk, patrz takeBatch) – jeden odczyt z nośnika
+            size_t total = 0;
+            for (auto& r : batch) total += r.len - r.done;
+            batchBuf.resize(total);
+            size_t got = positioned ? f->read(batchBuf.data(), total) : 0;
+            size_t pos = 0;
+            for (auto& r : batch) {
+                size_t want = r.len - r.done;
+                size_t n = got - pos < want ? got - pos : want;
+                if (n) memcpy(r.dst + r.done, batchBuf.data() + pos, n);
+                pos += n;
+                r.done += n;
+                IoResult res;
+                res.ok = r.done == r.len;
+                res.bytes = r.done;
+                if (r.cb) r.cb(res);
+            }
+            return;
+        }
+        size_t want = head.len - head.done;
+        if (want > cfg.maxChunk) want = cfg.maxChunk;
+        size_t n = positioned ? f->read(head.dst + head.done, want) : 0;
+        head.done += n;
+        if (n == want && head.done < head.len) {
+            // reszta wraca na początek swojej kolejki – wyższe priorytety mogą wejść pomiędzy
+            std::lock_guard<std::mutex> lock(mtx);
+            queues[level].push_front(std::move(head));
+            queued++;
+            return;
+        }
+        IoResult res;
+        res.ok = head.done == head.len;
+        res.bytes = head.done;
+        if (head.cb) head.cb(res);
+        return;
+    }
+
+    case Kind::Write: {
+        IFile* f = fileFor(head.path, OpenMode::ReadWrite);
+        size_t want = head.len - head.done;
+        if (want > cfg.maxChunk) want = cfg.maxChunk;
+        size_t n = (f && f->seek(head.offset + head.done)) ? f->write(head.data.data() + head.done, want) : 0;
+        head.done += n;
+        if (n == want && head.done < head.len) {
+            std::lock_guard<std::mutex> lock(mtx);
+            queues[level].push_front(std::move(head));
+            queued++;
+            return;
+        }
+        IoResult res;
+        res.ok = head.done == head.len;
+        res.bytes = head.done;
+        if (head.cb) head.cb(res);
+        return;
+    }
+    }
+}
+
+void IoScheduler::loop() {
+    std::vector<Request> batch;
+    while (true) {
+        int level = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (queued == 0) {
+                lock.unlock();
+                closeCurrent(); // bezczynność – zamknięcie (i flush) uchwytu
+                lock.lock();
+                busy = false;
+                idle.notify_all();
+            }
+            wake.wait(lock, [this] { return queued > 0 || stopping; });
+            if (queued == 0 && stopping) break;
+            busy = true;
+            takeBatch(batch, level);
+        }
+        execute(batch, level);
+        batch.clear();
+    }
+    closeCurrent();
+    std::lock_guard<std::mutex> lock(mtx);
+    busy = false;
+    idle.notify_all();
+}
+
+} // namespace io
+} // namespace storage
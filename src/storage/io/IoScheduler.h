@@ -0,0 +1,142 @@
+#ifndef STORAGE_IO_IOSCHEDULER_H
+#define STORAGE_IO_IOSCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace io {
+
+enum class IoPriority : uint8_t {
+    High = 0,    // np. logi krytyczne czasowo
+    Normal = 1,
+    Low = 2,     // np. eksport masowy
+};
+
+struct IoResult {
+    bool ok = false;
+    size_t bytes = 0;
+};
+
+using IoCallback = std::function<void(const IoResult&)>;
+
+/**
+ * @brief Jedno zadanie robocze przed systemem plików (SdFat nie jest thread-safe).
+ *
+ * Zlecenia z dowolnego wątku/rdzenia trafiają do kolejek priorytetów i są
+ * wykonywane sekwencyjnie przez jeden wątek:
+ * - zawsze najpierw kolejka o najwyższym priorytecie,
+ * - duże odczyty/zapisy dzielone są na porcje `maxChunk`, więc eksport
+ *   o niskim priorytecie oddaje magistralę między porcjami,
+ * - sąsiadujące odczyty tego samego pliku (offset = koniec poprzedniego)
+ *   wykonywane są jednym odczytem (razem najwyżej `maxChunk`),
+ * - małe dopisania do tego samego pliku sklejane są w jeden zapis
+ *   (najwyżej `min(appendBatch, maxChunk)`), duże dzielone na porcje `maxChunk`;
+ *   przy niepełnym zapisie sklejone zlecenia dostają w kolejności bajty, które
+ *   trafiły do pliku (`bytes`), a `ok` tylko te zapisane w całości,
+ * - uchwyt ostatniego pliku jest trzymany, dopóki kolejka nie opustoszeje.
+ *
+ * Kolejność jest gwarantowana tylko w obrębie jednego priorytetu (porcje
+ * dużego dopisania mogą przeplatać się z dopisaniami o wyższym priorytecie).
+ * Callbacki wywoływane są w wątku roboczym – powinny być krótkie.
+ *
+ * Obiektu nie wolno niszczyć z callbacku (wątek roboczy wciąż z niego korzysta):
+ * z callbacku można tylko wywołać `stop()`, a destruktor – z innego wątku.
+ */
+class IoScheduler {
+public:
+    struct Config {
+        size_t maxChunk = 4096;     // maks. bajtów jednej operacji przed ponownym wyborem zlecenia
+        size_t appendBatch = 1024;  // bufor sklejania dopisań
+        size_t queueLimit = 64;     // maks. oczekujących zleceń (0 = bez limitu)
+        uint32_t stackSize = 6144;  // tylko ESP32
+        int taskPriority = 5;       // tylko ESP32
+        int core = -1;              // tylko ESP32, -1 = dowolny
+    };
+
+    explicit IoScheduler(IFileSystem& fs);
+    IoScheduler(IFileSystem& fs, const Config& cfg);
+    ~IoScheduler(); // nie z wątku roboczego (std::terminate)
+
+    IoScheduler(const IoScheduler&) = delete;
+    IoScheduler& operator=(const IoScheduler&) = delete;
+
+    bool start();
+    void stop(); // wykonuje pozostałe zlecenia i kończy wątek (z callbacku: tylko sygnał zakończenia)
+
+    // Zwracają false, gdy kolejka jest pełna lub scheduler nie działa.
+    // `dst` musi pozostać ważny do wywołania callbacku; dane zapisu są kopiowane.
+    bool read(const std::string& path, uint32_t offset, void* dst, size_t len,
+              IoPriority prio, IoCallback done);
+    bool write(const std::string& path, uint32_t offset, const void* src, size_t len,
+               IoPriority prio, IoCallback done = nullptr);
+    bool append(const std::string& path, const void* src, size_t len,
+                IoPriority prio, IoCallback done = nullptr);
+    // Dowolna operacja na systemie plików (listDir, remove, ...) w wątku roboczym.
+    bool run(std::function<bool(IFileSystem&)> fn, IoPriority prio, IoCallback done = nullptr);
+
+    // Wersje blokujące. Wywołane z wątku roboczego wykonują się od razu.
+    IoResult readSync(const std::string& path, uint32_t offset, void* dst, size_t len,
+                      IoPriority prio = IoPriority::Normal);
+    IoResult runSync(std::function<bool(IFileSystem&)> fn, IoPriority prio = IoPriority::Normal);
+
+    void drain(); // czeka aż kolejki będą puste
+    size_t pending() const;
+    bool isWorkerThread() const;
+
+private:
+    enum class Kind : uint8_t { Read, Write, Append, Call };
+
+    struct Request {
+        Kind kind;
+        std::string path;
+        uint32_t offset = 0;
+        uint8_t* dst = nullptr;
+        std::vector<uint8_t> data;
+        size_t len = 0;
+        size_t done = 0;
+        std::function<bool(IFileSystem&)> fn;
+        IoCallback cb;
+    };
+
+    static constexpr int kLevels = 3;
+
+    IFileSystem& fs;
+    Config cfg;
+    std::deque<Request> queues[kLevels];
+    size_t queued = 0;
+    bool running = false;
+    bool stopping = false;
+    bool busy = false;
+    mutable std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::thread worker;
+
+    // stan wątku roboczego
+    std::unique_ptr<IFile> cur;
+    std::string curPath;
+    OpenMode curMode = OpenMode::Read;
+    std::vector<uint8_t> batchBuf;
+
+    bool enqueue(Request&& req, IoPriority prio);
+    void loop();
+    void takeBatch(std::vector<Request>& batch, int& level);
+    void execute(std::vector<Request>& batch, int level);
+    IFile* fileFor(const std::string& path, OpenMode mode);
+    void closeCurrent();
+    static bool conflicts(const Request& a, const Request& b);
+};
+
+} // namespace io
+} // namespace storage
+
+#endif // STORAGE_IO_IOSCHEDULER_H
@@ -0,0 +1,232 @@
+#include "WatchedFileSystem.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <algorithm>
+
+namespace storage {
+namespace io {
+
+using util::normalizePath;
+
+namespace {
+
+// true, gdy `path` to `prefix` lub leży w nim
+bool under(const std::string& path, const std::string& prefix) {
+    if (prefix == "/") return true;
+    return path.compare(0, prefix.size(), prefix) == 0 &&
+           (path.size() == prefix.size() || path[prefix.size()] == '/');
+}
+
+std::string clean(const std::string& path) {
+    std::string p = normalizePath(path);
+    return p.empty() ? std::string("/") : p;
+}
+
+} // namespace
+
+WatchedFileSystem::WatchedFileSystem(IFileSystem& in) : inner(in) {}
+
+bool WatchedFileSystem::related(const std::string& sub, const std::string& path) {
+    // zmiana w obserwowanym drzewie albo usunięcie/przeniesienie katalogu nadrzędnego
+    return under(path, sub) || under(sub, path);
+}
+
+bool WatchedFileSystem::watched(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const Subscription& s : subs) {
+        if (related(s.path, path)) return true;
+    }
+    return false;
+}
+
+void WatchedFileSystem::notify(const std::string& path, uint8_t events) {
+    std::function<void()> wake;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        bool match = false;
+        for (const Subscription& s : subs) {
+            if (related(s.path, path)) {
+                match = true;
+                break;
+            }
+        }
+        if (!match) return;
+        if (queue.empty()) wake = wakeup;
+        queue[path] |= events;
+    }
+    DBG("WatchedFileSystem::notify(path=%s, events=%u)", path.c_str(), events);
+    if (wake) wake();
+}
+
+uint32_t WatchedFileSystem::subscribe(const std::string& path, Callback cb) {
+    if (!cb) return 0;
+    std::lock_guard<std::mutex> lock(mtx);
+    uint32_t id = nextId++;
+    subs.push_back(Subscription{id, clean(path), std::move(cb)});
+    return id;
+}
+
+void WatchedFileSystem::unsubscribe(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mtx);
+    subs.erase(std::remove_if(subs.begin(), subs.end(), [id](const Subscription& s) { return s.id == id; }),
+               subs.end());
+}
+
+void WatchedFileSystem::setWakeup(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(mtx);
+    wakeup = std::move(fn);
+}
+
+size_t WatchedFileSystem::pending() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return queue.size();
+}
+
+size_t WatchedFileSystem::dispatch() {
+    std::map<std::string, uint8_t> events;
+    std::vector<Subscription> targets;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (queue.empty()) return 0;
+        events.swap(queue);
+        targets = subs; // callback może (od)subskrybować
+    }
+    size_t calls = 0;
+    for (const auto& ev : events) {
+        for (const Subscription& s : targets) {
+            if (!related(s.path, ev.first)) continue;
+            s.cb(ev.first, ev.second);
+            calls++;
+        }
+    }
+    return calls;
+}
+
+bool WatchedFileSystem::begin() {
+    return inner.begin();
+}
+
+bool WatchedFileSystem::listDir(const char* path, std::function<void(const char*, size_t)> callback) {
+    return inner.listDir(path, std::move(callback));
+}
+
+bool WatchedFileSystem::exists(const std::string& path) {
+    return inner.exists(path);
+}
+
+bool WatchedFileSystem::remove(const std::string& path) {
+    if (!inner.remove(path)) return false;
+    notify(clean(path), Removed);
+    return true;
+}
+
+bool WatchedFileSystem::mkdir(const std::string& path) {
+    std::string p = clean(path);
+    bool created = watched(p) && !inner.exists(p);
+    if (!inner.mkdir(path)) return false;
+    if (created) notify(p, Created);
+    return true;
+}
+
+bool WatchedFileSystem::rename(const std::string& from, const std::string& to) {
+    if (!inner.rename(from, to)) return false;
+    notify(clean(from), Removed | Renamed);
+    notify(clean(to), Created | Renamed);
+    return true;
+}
+
+uint32_t WatchedFileSystem::getCreatedTimestamp(const std::string& path) {
+    return inner.getCreatedTimestamp(path);
+}
+
+uint32_t WatchedFileSystem::getModifiedTimestamp(const std::string& path) {
+    return inner.getModifiedTimestamp(path);
+}
+
+bool WatchedFileSystem::info(FsInfo& out) {
+    return inner.info(out);
+}
+
+FsMetrics* WatchedFileSystem::metrics() {
+    return inner.metrics();
+}
+
+std::unique_ptr<IFile> WatchedFileSystem::open(const std::string& path, OpenMode mode) {
+    if (mode == OpenMode::Read) return inner.open(path, mode);
+    std::string p = clean(path);
+    if (!watched(p)) return inner.open(path, mode);
+
+    bool created = !inner.exists(p);
+    std::unique_ptr<IFile> f = inner.open(path, mode);
+    if (!f) return nullptr;
+    if (created) notify(p, Created);
+    return std::unique_ptr<IFile>(new WatchedFile(*this, std::move(f), p, mode == OpenMode::WriteTruncate));
+}
+
+// ------------------- WatchedFile -------------------
+
+WatchedFile::WatchedFile(WatchedFileSystem& owner, std::unique_ptr<IFile> inner, const std::string& p, bool mod)
+    : fs(owner), file(std::move(inner)), path(p), modified(mod) {}
+
+WatchedFile::~WatchedFile() {
+    close();
+}
+
+size_t WatchedFile::read(void* buf, size_t size) {
+    return file ? file->read(buf, size) : 0;
+}
+
+size_t WatchedFile::write(const void* buf, size_t size) {
+    if (!file) return 0;
+    size_t n = file->write(buf, size);
+    if (n) modified = true;
+    return n;
+}
+
+void WatchedFile::flush() {
+    if (file) file->flush();
+}
+
+bool WatchedFile::seek(uint32_t pos) {
+    return file && file->seek(pos);
+}
+
+uint32_t WatchedFile::position() {
+    return file ? file->position() : 0;
+}
+
+uint32_t WatchedFile::size() {
+    return file ? file->size() : 0;
+}
+
+bool WatchedFile::seek64(uint64_t pos) {
+    return file && file->seek64(pos);
+}
+
+uint64_t WatchedFile::position64() {
+    return file ? file->position64() : 0;
+}
+
+uint64_t WatchedFile::size64() {
+    return file ? file->size64() : 0;
+}
+
+bool WatchedFile::isOpen() const {
+    return file && file->isOpen();
+}
+
+bool WatchedFile::getCreateDateTime(uint16_t* d, uint16_t* t) {
+    return file && file->getCreateDateTime(d, t);
+}
+
+void WatchedFile::close() {
+    if (!file) return;
+    file->close();
+    file.reset();
+    // zgłoszenie po zamknięciu – subskrybent czyta już kompletny plik
+    if (modified) fs.notify(path, WatchedFileSystem::Modified);
+}
+
+} // namespace io
+} // namespace storage
@@ -0,0 +1,130 @@
+#ifndef STORAGE_IO_WATCHEDFILESYSTEM_H
+#define STORAGE_IO_WATCHEDFILESYSTEM_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace io {
+
+/**
+ * @brief Dekorator IFileSystem powiadamiający o zmianach plików wykonanych przez bibliotekę.
+ *
+ * Subskrypcja dotyczy ścieżki lub prefiksu katalogu ("/config" obejmuje
+ * "/config/app.ini"; "/" – wszystko). Zdarzenia:
+ *
+ * - `Created`  – utworzenie pliku (open do zapisu) lub katalogu,
+ * - `Modified` – zamknięcie pliku, do którego coś zapisano (lub otwartego z WriteTruncate),
+ * - `Removed`  – usunięcie (także katalogu zawierającego obserwowaną ścieżkę),
+ * - `Renamed`  – zmiana nazwy; stara ścieżka dostaje też `Removed`, nowa `Created`.
+ *
+ * Zdarzenia nie są wywoływane w trakcie operacji I/O: trafiają do kolejki,
+ * łączone po ścieżce (maska bitowa), a `dispatch()` wywołany przez aplikację
+ * (np. w `loop()` albo w zadaniu obudzonym przez `setWakeup`) przekazuje je
+ * subskrybentom. Sprawdzenie, czy ścieżkę ktoś obserwuje, odbywa się w RAM;
+ * dla ścieżek bez subskrybentów dekorator nie dodaje żadnych operacji
+ * na nośniku (dla obserwowanych: jedno `exists()` przy otwarciu do zapisu).
+ *
+ * Zmiany wykonane z pominięciem dekoratora (np. przez USB MSC) nie są widoczne.
+ *
+ * @code
+ * storage::io::WatchedFileSystem fs(sdFs);
+ * fs.subscribe("/config/app.ini", [](const std::string& path, uint8_t events) {
+ *     config.reload();
+ * });
+ * // loop():
+ * fs.dispatch();
+ * @endcode
+ */
+class WatchedFileSystem : public IFileSystem {
+public:
+    static const uint8_t Created = 1;
+    static const uint8_t Modified = 2;
+    static const uint8_t Removed = 4;
+    static const uint8_t Renamed = 8;
+
+    using Callback = std::function<void(const std::string& path, uint8_t events)>;
+
+    explicit WatchedFileSystem(IFileSystem& inner);
+
+    // Zwraca identyfikator do unsubscribe (0 = błąd).
+    uint32_t subscribe(const std::string& pathOrPrefix, Callback cb);
+    void unsubscribe(uint32_t id);
+
+    // Przekazuje zebrane zdarzenia; zwraca liczbę wywołanych callbacków.
+    size_t dispatch();
+    size_t pending() const;
+
+    // Wołane (z wątku wykonującego I/O), gdy kolejka z pustej staje się niepusta.
+    void setWakeup(std::function<void()> fn);
+
+    bool begin() override;
+    bool listDir(const char* path, std::function<void(const char*, size_t)> callback) override;
+    bool exists(const std::string& path) override;
+    bool remove(const std::string& path) override;
+    bool mkdir(const std::string& path) override;
+    bool rename(const std::string& from, const std::string& to) override;
+    uint32_t getCreatedTimestamp(const std::string& path) override;
+    uint32_t getModifiedTimestamp(const std::string& path) override;
+
+    std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override;
+    bool info(FsInfo& out) override;
+    FsMetrics* metrics() override;
+
+private:
+    friend class WatchedFile;
+
+    struct Subscription {
+        uint32_t id;
+        std::string path;
+        Callback cb;
+    };
+
+    IFileSystem& inner;
+    mutable std::mutex mtx;
+    std::vector<Subscription> subs;
+    std::map<std::string, uint8_t> queue;  // ścieżka → suma zdarzeń
+    std::function<void()> wakeup;
+    uint32_t nextId = 1;
+
+    static bool related(const std::string& sub, const std::string& path);
+    bool watched(const std::string& path) const;
+    void notify(const std::string& path, uint8_t events);
+};
+
+// Plik dekoratora – po zamknięciu zgłasza `Modified`, jeśli coś zapisano.
+class WatchedFile : public IFile {
+public:
+    WatchedFile(WatchedFileSystem& fs, std::unique_ptr<IFile> inner, const std::string& path, bool modified);
+    ~WatchedFile() override;
+
+    size_t read(void* buf, size_t size) override;
+    size_t write(const void* buf, size_t size) override;
+    void flush() override;
+    bool seek(uint32_t pos) override;
+    uint32_t position() override;
+    uint32_t size() override;
+    bool seek64(uint64_t pos) override;
+    uint64_t position64() override;
+    uint64_t size64() override;
+    bool isOpen() const override;
+    void close() override;
+    bool getCreateDateTime(uint16_t* d, uint16_t* t) override;
+
+private:
+    WatchedFileSystem& fs;
+    std::unique_ptr<IFile> file;
+    std::string path;
+    bool modified;
+};
+
+} // namespace io
+} // namespace storage
+
+#endif // STORAGE_IO_WATCHEDFILESYSTEM_H
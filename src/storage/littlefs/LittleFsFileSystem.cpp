@@ -1,5 +1,6 @@
 #include "LittleFsFileSystem.h"
 #include "storage/Debug.h"
+#include "storage/util/Path.h"
 
 #include <vector>
 
@@ -9,36 +10,22 @@ namespace littlefs {
 namespace {
 const char* MOUNT_PATH = "/littlefs";   // mount point używany przez VFS (wewnętrznie, żeby nie gryzł się z innymi FS, np. SD)
 const char* PARTITION_LABEL = "spiffs"; // zgodnie z partitions.csv
+
+// Geometria esp_littlefs: blok = sektor kasowania flash, zapis przez cache o rozmiarze strony.
+#ifdef CONFIG_LITTLEFS_BLOCK_SIZE
+const uint32_t BLOCK_SIZE = CONFIG_LITTLEFS_BLOCK_SIZE;
+#else
+const uint32_t BLOCK_SIZE = 4096;
+#endif
+#ifdef CONFIG_LITTLEFS_CACHE_SIZE
+const uint32_t CACHE_SIZE = CONFIG_LITTLEFS_CACHE_SIZE;
+#else
+const uint32_t CACHE_SIZE = 512;
+#endif
 }
 
 // ------------------- helpers: path -------------------
-static std::string normalizePath(const std::string& in) {
-    if (in.empty()) return std::string();
-
-    bool absolute = in[0] == '/';
-    std::vector<std::string> stack;
-    size_t i = 0, n = in.size();
-
-    while (i < n) {
-        while (i < n && in[i] == '/') i++; // pomiń duplikaty '/'
-        if (i >= n) break;
-        size_t j = i; while (j < n && in[j] != '/') j++;
-        std::string seg = in.substr(i, j - i);
-        i = j;
-
-        if (seg == "." || seg.empty()) continue;
-        if (seg == "..") {
-            if (!stack.empty()) stack.pop_back();
-        } else {
-            stack.push_back(seg);
-        }
-    }
-
-    std::string out; if (absolute) out.push_back('/');
-    for (size_t k = 0; k < stack.size(); ++k) { if (k) out.push_back('/'); out += stack[k]; }
-    if (out.empty()) return absolute ? std::string("/") : std::string();
-    return out;
-}
+using util::normalizePath;
 
 static bool isDirectory(fs::FS& fs, const char* path) {
     if (!fs.exists(path)) return false; // unikamy logów VFS przy nieistniejących ścieżkach
@@ -56,6 +43,8 @@ static bool ensureParentDirs(fs::FS& fs, const std::string& rawPath) {
 
     std::string dir = path.substr(0, pos);
     if (dir.empty() || dir == "/") return true;
+    // zwykle katalog już jest – jedno sprawdzenie zamiast mkdir na każdym poziomie
+    if (fs.exists(dir.c_str())) return true;
 
     bool absolute = dir[0] == '/';
     size_t start = absolute ? 1 : 0;
@@ -126,14 +115,35 @@ bool LittleFsFileSystem::begin() {
     return true;
 }
 
+bool LittleFsFileSystem::info(FsInfo& out) {
+    DBG("LittleFsFileSystem::info()");
+    MetricScope m(&stats, IoOp::Stat);
+    out = FsInfo();
+    out.totalBytes = LittleFS.totalBytes();
+    if (!out.totalBytes) {
+        m.fail();
+        return false;
+    }
+    uint64_t used = LittleFS.usedBytes(); // przejście po metadanych, bez czytania danych plików
+    out.freeBytes = used < out.totalBytes ? out.totalBytes - used : 0;
+    out.sectorSize = CACHE_SIZE;
+    out.clusterSize = BLOCK_SIZE;
+    out.ioAlignment = CACHE_SIZE;
+    DBG("LittleFsFileSystem::info total=%llu free=%llu",
+        static_cast<unsigned long long>(out.totalBytes), static_cast<unsigned long long>(out.freeBytes));
+    return true;
+}
+
 bool LittleFsFileSystem::listDir(const char* rawPath, std::function<void(const char*, size_t)> callback) {
     std::string path = normalizePath(rawPath ? std::string(rawPath) : std::string("/"));
     if (path.empty()) path = "/";
     DBG("LittleFsFileSystem::listDir(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::List);
 
     fs::File dir = LittleFS.open(path.c_str(), "r");
     if (!dir || !dir.isDirectory()) {
         DBG("listDir: cannot open directory %s", path.c_str());
+        m.fail();
         return false;
     }
 
@@ -151,6 +161,7 @@ bool LittleFsFileSystem::listDir(const char* rawPath, std::function<void(const c
 bool LittleFsFileSystem::exists(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("LittleFsFileSystem::exists(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Stat);
     bool res = !path.empty() && LittleFS.exists(path.c_str());
     DBG("LittleFsFileSystem::exists result=%d", res);
     return res;
@@ -159,6 +170,7 @@ bool LittleFsFileSystem::exists(const std::string& rawPath) {
 bool LittleFsFileSystem::remove(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("LittleFsFileSystem::remove(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Remove);
     if (path.empty()) return false;
 
     if (!LittleFS.exists(path.c_str())) { // unikamy open("r") na nieistniejących ścieżkach
@@ -173,15 +185,32 @@ bool LittleFsFileSystem::remove(const std::string& rawPath) {
         res = LittleFS.remove(path.c_str());
     }
     DBG("LittleFsFileSystem::remove result=%d", res);
+    m.result(res);
     return res;
 }
 
 bool LittleFsFileSystem::mkdir(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("LittleFsFileSystem::mkdir(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Mkdir);
     if (path.empty() || path == "/") return true;
     bool res = LittleFS.mkdir(path.c_str());
     DBG("LittleFsFileSystem::mkdir result=%d", res);
+    m.result(res);
+    return res;
+}
+
+bool LittleFsFileSystem::rename(const std::string& rawFrom, const std::string& rawTo) {
+    std::string from = normalizePath(rawFrom);
+    std::string to = normalizePath(rawTo);
+    DBG("LittleFsFileSystem::rename(from=%s, to=%s)", from.c_str(), to.c_str());
+    MetricScope m(&stats, IoOp::Rename);
+    // VFS nadpisałby cel atomowo; trzymamy się wspólnej semantyki z SdFat
+    bool res = !from.empty() && !to.empty() &&
+               LittleFS.exists(from.c_str()) && !LittleFS.exists(to.c_str()) &&
+               ensureParentDirs(LittleFS, to) && LittleFS.rename(from.c_str(), to.c_str());
+    DBG("LittleFsFileSystem::rename result=%d", res);
+    m.result(res);
     return res;
 }
 
@@ -195,9 +224,10 @@ uint32_t LittleFsFileSystem::getModifiedTimestamp(const std::string&) {
     return 0;
 }
 
-std::unique_ptr<IFile> LittleFsFileSystem::open(const std::string& rawPath, OpenMode mode) {
+bool LittleFsFileSystem::openRaw(const std::string& rawPath, OpenMode mode, fs::File& out) {
     std::string path = normalizePath(rawPath);
     DBG("LittleFsFileSystem::open(path=%s, mode=%d)", path.c_str(), static_cast<int>(mode));
+    MetricScope m(&stats, IoOp::Open);
 
     const char* flags = "r"; // ciaśniejsze flagi
     switch (mode) {
@@ -210,14 +240,35 @@ std::unique_ptr<IFile> LittleFsFileSystem::open(const std::string& rawPath, Open
     if (mode != OpenMode::Read) {
         if (!ensureParentDirs(LittleFS, path)) {
             DBG("ensureParentDirs failed for %s", path.c_str());
-            return nullptr;
+            m.fail();
+            return false;
         }
     }
 
-    fs::File f = LittleFS.open(path.c_str(), flags);
-    DBG("open(%s) result=%d", path.c_str(), f ? 1 : 0);
-    if (!f) return nullptr;
-    return std::make_unique<LittleFsFileWrapper>(std::move(f));
+    out = LittleFS.open(path.c_str(), flags);
+    DBG("open(%s) result=%d", path.c_str(), out ? 1 : 0);
+    m.result(static_cast<bool>(out));
+    return static_cast<bool>(out);
+}
+
+std::unique_ptr<IFile> LittleFsFileSystem::open(const std::string& path, OpenMode mode) {
+    fs::File f;
+    if (!openRaw(path, mode, f)) return nullptr;
+    return std::make_unique<LittleFsFileWrapper>(std::move(f), &stats);
+}
+
+FileHandle LittleFsFileSystem::openPooled(const std::string& path, OpenMode mode) {
+    fs::File f;
+    if (!openRaw(path, mode, f)) return FileHandle();
+    FileHandle h = pool.make(std::move(f), &stats);
+    if (!h) f.close(); // pula pełna
+    return h;
+}
+
+FileHandle LittleFsFileSystem::openIn(FileSlot& slot, const std::string& path, OpenMode mode) {
+    fs::File f;
+    if (!openRaw(path, mode, f)) return FileHandle();
+    return placeFile<LittleFsFileWrapper>(slot, std::move(f), &stats);
 }
 
 } // namespace littlefs
@@ -12,6 +12,10 @@ namespace littlefs {
 
 // Implementacja IFileSystem dla LittleFS
 class LittleFsFileSystem : public IFileSystem {
+private:
+    FilePool<LittleFsFileWrapper, ESP32_STORAGE_FILE_POOL_SIZE> pool;
+    FsMetrics stats{"littlefs"};
+    bool openRaw(const std::string& path, OpenMode mode, fs::File& out);
 public:
     LittleFsFileSystem() = default;
     bool begin() override;
@@ -20,10 +24,18 @@ public:
     bool exists(const std::string& path) override;
     bool remove(const std::string& path) override;
     bool mkdir(const std::string& path) override;
+    bool rename(const std::string& from, const std::string& to) override;
     uint32_t getCreatedTimestamp(const std::string& path) override;
     uint32_t getModifiedTimestamp(const std::string& path) override;
 
     std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override;
+    FileHandle openPooled(const std::string& path, OpenMode mode) override;
+    FsMetrics* metrics() override { return &stats; }
+    bool info(FsInfo& out) override;
+
+    // Otwarcie w pamięci dostarczonej przez wywołującego (musi przeżyć uchwyt).
+    using FileSlot = FileStorage<LittleFsFileWrapper>;
+    FileHandle openIn(FileSlot& slot, const std::string& path, OpenMode mode);
 };
 
 } // namespace littlefs
@@ -4,33 +4,41 @@
 namespace storage {
 namespace littlefs {
 
-LittleFsFileWrapper::LittleFsFileWrapper(fs::File f) : file(std::move(f)) {
+LittleFsFileWrapper::LittleFsFileWrapper(fs::File f, FsMetrics* m) : file(std::move(f)), metrics(m) {
     DBG("LittleFsFileWrapper::LittleFsFileWrapper(%p)", &file);
 }
 
 size_t LittleFsFileWrapper::read(void* buf, size_t size) {
     DBG("LittleFsFileWrapper::read(size=%u)", size);
+    MetricScope m(metrics, IoOp::Read);
     size_t n = file.read(static_cast<uint8_t*>(buf), size);
+    m.bytes(n);
     DBG("LittleFsFileWrapper::read -> %u", n);
     return n;
 }
 
 size_t LittleFsFileWrapper::write(const void* buf, size_t size) {
     DBG("LittleFsFileWrapper::write(size=%u)", size);
+    MetricScope m(metrics, IoOp::Write);
     size_t n = file.write(static_cast<const uint8_t*>(buf), size);
+    m.bytes(n);
+    m.result(n == size);
     DBG("LittleFsFileWrapper::write -> %u", n);
     return n;
 }
 
 void LittleFsFileWrapper::flush() {
     DBG("LittleFsFileWrapper::flush()");
+    MetricScope m(metrics, IoOp::Flush);
     file.flush();
     DBG("LittleFsFileWrapper::flush done");
 }
 
 bool LittleFsFileWrapper::seek(uint32_t pos) {
     DBG("LittleFsFileWrapper::seek(pos=%u)", pos);
+    MetricScope m(metrics, IoOp::Seek);
     bool res = file.seek(pos);
+    m.result(res);
     DBG("LittleFsFileWrapper::seek -> %d", res);
     return res;
 }
@@ -58,6 +66,7 @@ bool LittleFsFileWrapper::isOpen() const {
 
 void LittleFsFileWrapper::close() {
     DBG("LittleFsFileWrapper::close()");
+    MetricScope m(metrics, IoOp::Close);
     file.close();
     DBG("LittleFsFileWrapper::close done");
 }
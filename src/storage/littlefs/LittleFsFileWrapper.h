@@ -3,16 +3,19 @@
 
 #include <LittleFS.h>
 #include "storage/IFile.h"
+#include "storage/Metrics.h"
 
 namespace storage {
 namespace littlefs {
 
-// Wrapper IFile dla fs::File
+// Wrapper IFile dla fs::File. Offsety 64-bitowe z domyślnej implementacji IFile –
+// LittleFS ogranicza rozmiar pliku do 2 GiB, więc API 32-bitowe jest pełne.
 class LittleFsFileWrapper : public IFile {
 private:
     fs::File file;
+    FsMetrics* metrics;
 public:
-    explicit LittleFsFileWrapper(fs::File f);
+    explicit LittleFsFileWrapper(fs::File f, FsMetrics* m = nullptr);
 
     size_t read(void* buf, size_t size) override;
     size_t write(const void* buf, size_t size) override;
@@ -0,0 +1,237 @@
+#include "ColumnCodec.h"
+
+#include <cstring>
+
+namespace storage {
+namespace logs {
+
+namespace {
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>((v >> 1) ^ (0 - (v & 1)));
+}
+
+inline uint8_t bitWidth(uint64_t v) {
+    uint8_t w = 0;
+    while (v) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+}
+
+inline uint8_t trailingZeros(uint64_t v) {
+    if (!v) return 0;
+    uint8_t n = 0;
+    while (!(v & 1)) {
+        n++;
+        v >>= 1;
+    }
+    return n;
+}
+
+void put(std::vector<uint8_t>& out, const void* p, size_t n) {
+    const uint8_t* b = static_cast<const uint8_t*>(p);
+    out.insert(out.end(), b, b + n);
+}
+
+} // namespace
+
+void ColumnCodec::pack(const uint64_t* values, size_t n, uint8_t width, std::vector<uint8_t>& out) {
+    if (!width) return;
+    size_t base = out.size();
+    out.resize(base + packedBytes(n, width) + kPad, 0);
+    uint8_t* dst = out.data() + base;
+    uint64_t acc = 0;
+    unsigned fill = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = values[i];
+        acc |= v << fill;
+        if (fill + width >= 64) {
+            memcpy(dst, &acc, 8);
+            dst += 8;
+            acc = fill ? v >> (64 - fill) : 0;
+            fill = fill + width - 64;
+        } else {
+            fill += width;
+        }
+    }
+    if (fill) memcpy(dst, &acc, 8);
+    out.resize(base + packedBytes(n, width));
+}
+
+void ColumnCodec::unpack(const uint8_t* in, uint8_t width, size_t n, uint64_t* out) {
+    if (!width) {
+        for (size_t i = 0; i < n; ++i) out[i] = 0;
+        return;
+    }
+    uint64_t mask = width >= 64 ? ~0ULL : (1ULL << width) - 1;
+    if (width <= 56) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t bit = i * width;
+            uint64_t v;
+            memcpy(&v, in + (bit >> 3), 8);
+            out[i] = (v >> (bit & 7)) & mask;
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        size_t bit = i * width;
+        unsigned shift = bit & 7;
+        uint64_t v;
+        memcpy(&v, in + (bit >> 3), 8);
+        v >>= shift;
+        if (shift) v |= static_cast<uint64_t>(in[(bit >> 3) + 8]) << (64 - shift);
+        out[i] = v & mask;
+    }
+}
+
+void ColumnCodec::encodeInts(const int64_t* values, size_t n, std::vector<uint8_t>& out) {
+    if (!n) return;
+    put(out, &values[0], 8);
+    if (n < 2) return;
+    uint64_t d0 = zigzag(static_cast<int64_t>(static_cast<uint64_t>(values[1]) - static_cast<uint64_t>(values[0])));
+    put(out, &d0, 8);
+
+    uint64_t tmp[kChunk];
+    for (size_t i = 2; i < n; i += kChunk) {
+        size_t m = n - i < kChunk ? n - i : kChunk;
+        uint64_t all = 0;
+        for (size_t j = 0; j < m; ++j) {
+            uint64_t a = static_cast<uint64_t>(values[i + j]) - static_cast<uint64_t>(values[i + j - 1]);
+            uint64_t b = static_cast<uint64_t>(values[i + j - 1]) - static_cast<uint64_t>(values[i + j - 2]);
+            tmp[j] = zigzag(static_cast<int64_t>(a - b));
+            all |= tmp[j];
+        }
+        uint8_t w = bitWidth(all);
+        out.push_back(w);
+        pack(tmp, m, w, out);
+    }
+}
+
+bool ColumnCodec::decodeInts(const uint8_t* in, size_t len, size_t n, int64_t* out, uint64_t* scratch) {
+    if (!n) return true;
+    if (len < (n < 2 ? 8u : 16u)) return false;
+    int64_t v;
+    memcpy(&v, in, 8);
+    out[0] = v;
+    if (n < 2) return true;
+    uint64_t zz;
+    memcpy(&zz, in + 8, 8);
+    uint64_t delta = static_cast<uint64_t>(unzigzag(zz));
+    uint64_t cur = static_cast<uint64_t>(v) + delta;
+    out[1] = static_cast<int64_t>(cur);
+
+    size_t pos = 16;
+    for (size_t i = 2; i < n; i += kChunk) {
+        size_t m = n - i < kChunk ? n - i : kChunk;
+        if (pos >= len) return false;
+        uint8_t w = in[pos++];
+        size_t bytes = packedBytes(m, w);
+        if (w > 64 || pos + bytes > len) return false;
+        unpack(in + pos, w, m, scratch);
+        pos += bytes;
+        for (size_t j = 0; j < m; ++j) {
+            delta += static_cast<uint64_t>(unzigzag(scratch[j]));
+            cur += delta;
+            out[i + j] = static_cast<int64_t>(cur);
+        }
+    }
+    return true;
+}
+
+void ColumnCodec::encodeFloats(const float* values, size_t n, std::vector<uint8_t>& out) {
+    if (!n) return;
+    put(out, &values[0], 4);
+
+    uint64_t tmp[kChunk];
+    uint32_t prev;
+    memcpy(&prev, &values[0], 4);
+    for (size_t i = 1; i < n; i += kChunk) {
+        size_t m = n - i < kChunk ? n - i : kChunk;
+        uint64_t all = 0;
+        size_t nonZero = 0;
+        for (size_t j = 0; j < m; ++j) {
+            uint32_t bits;
+            memcpy(&bits, &values[i + j], 4);
+            tmp[j] = bits ^ prev;
+            prev = bits;
+            all |= tmp[j];
+            nonZero += tmp[j] != 0;
+        }
+        // wspólne zera na końcu (typowe dla wartości o małej precyzji) nie są zapisywane
+        uint8_t tz = trailingZeros(all);
+        uint8_t w = bitWidth(all >> tz);
+        out.push_back(tz);
+        if ((m - nonZero) * w > m + 8) {
+            // wiele powtórzeń: mapa bitowa zmian + tylko niezerowe XOR-y
+            out.push_back(w | kSparse);
+            size_t base = out.size();
+            out.resize(base + (m + 7) / 8, 0);
+            size_t k = 0;
+            for (size_t j = 0; j < m; ++j) {
+                if (!tmp[j]) continue;
+                out[base + j / 8] |= static_cast<uint8_t>(1u << (j % 8));
+                tmp[k++] = tmp[j] >> tz;
+            }
+            pack(tmp, k, w, out);
+            continue;
+        }
+        for (size_t j = 0; j < m; ++j) tmp[j] >>= tz;
+        out.push_back(w);
+        pack(tmp, m, w, out);
+    }
+}
+
+bool ColumnCodec::decodeFloats(const uint8_t* in, size_t len, size_t n, float* out, uint64_t* scratch) {
+    if (!n) return true;
+    if (len < 4) return false;
+    uint32_t prev;
+    memcpy(&prev, in, 4);
+    memcpy(&out[0], &prev, 4);
+
+    size_t pos = 4;
+    for (size_t i = 1; i < n; i += kChunk) {
+        size_t m = n - i < kChunk ? n - i : kChunk;
+        if (pos + 2 > len) return false;
+        uint8_t tz = in[pos];
+        uint8_t w = in[pos + 1] & ~kSparse;
+        bool sparse = (in[pos + 1] & kSparse) != 0;
+        pos += 2;
+        if (tz + w > 32) return false;
+        if (sparse) {
+            const uint8_t* map = in + pos;
+            size_t mapBytes = (m + 7) / 8;
+            if (pos + mapBytes > len) return false;
+            size_t k = 0;
+            for (size_t b = 0; b < mapBytes; ++b) k += static_cast<size_t>(__builtin_popcount(map[b]));
+            pos += mapBytes;
+            size_t bytes = packedBytes(k, w);
+            if (k > m || pos + bytes > len) return false;
+            unpack(in + pos, w, k, scratch);
+            pos += bytes;
+            k = 0;
+            for (size_t j = 0; j < m; ++j) {
+                if (map[j / 8] & (1u << (j % 8))) prev ^= static_cast<uint32_t>(scratch[k++] << tz);
+                memcpy(&out[i + j], &prev, 4);
+            }
+            continue;
+        }
+        size_t bytes = packedBytes(m, w);
+        if (pos + bytes > len) return false;
+        unpack(in + pos, w, m, scratch);
+        pos += bytes;
+        for (size_t j = 0; j < m; ++j) {
+            prev ^= static_cast<uint32_t>(scratch[j] << tz);
+            memcpy(&out[i + j], &prev, 4);
+        }
+    }
+    return true;
+}
+
+} // namespace logs
+} // namespace storage
@@ -0,0 +1,50 @@
+#ifndef STORAGE_LOGS_COLUMNCODEC_H
+#define STORAGE_LOGS_COLUMNCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace storage {
+namespace logs {
+
+/**
+ * @brief Kodowanie kolumn liczbowych dla `ColumnStore`.
+ *
+ * Liczby całkowite (czas, kanały int32): pierwsza wartość (8 B), pierwsza
+ * różnica (8 B, zigzag), dalej różnice drugiego rzędu (delta-of-delta, zigzag).
+ * Floaty: bity pierwszej wartości (4 B), dalej XOR z poprzednią wartością.
+ *
+ * Wartości po pierwszych są pakowane w porcje po `kChunk`: bajt szerokości
+ * (dla floatów także liczba wspólnych zer na końcu) i wartości na stałej
+ * liczbie bitów. Próbkowanie ze stałym okresem daje szerokość 0 – sam
+ * bajt nagłówka na 128 znaczników czasu. Porcja floatów z wieloma
+ * powtórzeniami zapisywana jest jako mapa bitowa zmian (16 B) i tylko
+ * niezerowe XOR-y.
+ *
+ * Dekodowanie porcji to rozpakowanie do `scratch` (pętla bez rozgałęzień)
+ * i osobna pętla sumy/XOR prefiksowego. Bufor wejściowy musi mieć
+ * `kPad` dostępnych bajtów za końcem danych (odczyty 8-bajtowe).
+ */
+class ColumnCodec {
+public:
+    static const size_t kChunk = 128;
+    static const size_t kPad = 8;
+    static const uint8_t kSparse = 0x80;  // bajt szerokości porcji floatów: mapa zmian
+
+    static void encodeInts(const int64_t* values, size_t n, std::vector<uint8_t>& out);
+    static void encodeFloats(const float* values, size_t n, std::vector<uint8_t>& out);
+
+    // scratch: kChunk elementów. false = uszkodzony/za krótki blok.
+    static bool decodeInts(const uint8_t* in, size_t len, size_t n, int64_t* out, uint64_t* scratch);
+    static bool decodeFloats(const uint8_t* in, size_t len, size_t n, float* out, uint64_t* scratch);
+
+    static void pack(const uint64_t* values, size_t n, uint8_t width, std::vector<uint8_t>& out);
+    static void unpack(const uint8_t* in, uint8_t width, size_t n, uint64_t* out);
+    static size_t packedBytes(size_t n, uint8_t width) { return (n * width + 7) / 8; }
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_COLUMNCODEC_H
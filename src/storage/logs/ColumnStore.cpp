@@ -0,0 +1,479 @@
+#include "ColumnStore.h"
+#include "ColumnCodec.h"
+#include "storage/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace storage {
+namespace logs {
+
+namespace {
+
+const uint32_t kStoreMagic = 0x31435354; // "TSC1"
+const uint16_t kStoreVersion = 1;
+
+// Układ nagłówka pliku (28 B + bajt typu na kanał, little-endian):
+//   0 magic u32 | 4 version u16 | 6 channels u8 | 7 reserved u8 | 8 rowsPerGroup u16 | 10 reserved u16
+//  12 periodSec u32 | 16 dataEnd u32 | 20 reserved u32 | 24 reserved u32 | 28 types u8[channels]
+struct RawStoreHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t channels;
+    uint8_t reserved0;
+    uint16_t rowsPerGroup;
+    uint16_t reserved1;
+    uint32_t periodSec;
+    uint32_t dataEnd;
+    uint32_t reserved2;
+    uint32_t reserved3;
+};
+static_assert(sizeof(RawStoreHeader) == 28, "RawStoreHeader layout");
+
+// Nagłówek grupy (24 B) + wpis na kolumnę (czas, potem kanały), dalej bloki kolumn.
+struct RawGroup {
+    uint16_t rows;
+    uint8_t columns;
+    uint8_t reserved;
+    uint32_t bodyBytes;
+    uint64_t tMin;
+    uint64_t tMax;
+};
+static_assert(sizeof(RawGroup) == 24, "RawGroup layout");
+
+struct RawEntry {
+    uint32_t len;
+    uint32_t min;  // bity float albo int32
+    uint32_t max;
+};
+static_assert(sizeof(RawEntry) == 12, "RawEntry layout");
+
+float asFloat(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, 4);
+    return f;
+}
+
+uint32_t floatBits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, 4);
+    return bits;
+}
+
+} // namespace
+
+// Odbiorca zapytania: statystyki grup w całości w zakresie i zdekodowane wiersze.
+struct ColumnStore::Sink {
+    // true = grupa rozstrzygnięta samymi statystykami (bez dekodowania)
+    std::function<bool(uint32_t rawMin, uint32_t rawMax)> stats;
+    std::function<bool(const uint64_t* ts, const float* f, const int32_t* i, size_t n)> rows;
+};
+
+ColumnStore::ColumnStore(IFileSystem& f, const std::string& d, const std::vector<ColumnType>& channels)
+    : ColumnStore(f, d, channels, Config()) {
+}
+
+ColumnStore::ColumnStore(IFileSystem& f, const std::string& d, const std::vector<ColumnType>& channels,
+                         const Config& c)
+    : fs(f), dir(d), types(channels), cfg(c) {
+    while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+    if (types.size() > kMaxChannels) types.resize(kMaxChannels);
+    if (!cfg.filePeriodSec) cfg.filePeriodSec = 86400;
+    if (cfg.rowsPerGroup < 16) cfg.rowsPerGroup = 16;
+    if (cfg.rowsPerGroup > 8192) cfg.rowsPerGroup = 8192;
+    pendingTs.reserve(cfg.rowsPerGroup);
+    pendingCols.resize(types.size());
+    for (auto& col : pendingCols) col.reserve(cfg.rowsPerGroup);
+    scratch.resize(ColumnCodec::kChunk);
+}
+
+ColumnStore::~ColumnStore() {
+    close();
+}
+
+std::string ColumnStore::dataPath(uint32_t p) const {
+    char name[24];
+    snprintf(name, sizeof(name), "/%lu.tsc", static_cast<unsigned long>(p));
+    return dir + name;
+}
+
+uint32_t ColumnStore::periodOf(uint64_t tsMs) const {
+    uint64_t sec = tsMs / 1000;
+    return static_cast<uint32_t>(sec - sec % cfg.filePeriodSec);
+}
+
+uint32_t ColumnStore::headerSize() const {
+    return sizeof(RawStoreHeader) + static_cast<uint32_t>(types.size());
+}
+
+uint32_t ColumnStore::groupHeaderSize() const {
+    return sizeof(RawGroup) + sizeof(RawEntry) * static_cast<uint32_t>(types.size() + 1);
+}
+
+void ColumnStore::listPeriods() {
+    if (listed) return;
+    periods.clear();
+    fs.listDir(dir.c_str(), [this](const char* name, size_t) {
+        const char* dot = strrchr(name, '.');
+        if (!dot || strcmp(dot, ".tsc") != 0) return;
+        char* end = nullptr;
+        unsigned long p = strtoul(name, &end, 10);
+        if (end == dot) periods.push_back(static_cast<uint32_t>(p));
+    });
+    std::sort(periods.begin(), periods.end());
+    listed = true;
+}
+
+bool ColumnStore::writeHeader(IFile& f) {
+    std::vector<uint8_t> buf(headerSize());
+    RawStoreHeader raw;
+    memset(&raw, 0, sizeof(raw));
+    raw.magic = kStoreMagic;
+    raw.version = kStoreVersion;
+    raw.channels = static_cast<uint8_t>(types.size());
+    raw.rowsPerGroup = cfg.rowsPerGroup;
+    raw.periodSec = cfg.filePeriodSec;
+    raw.dataEnd = dataEnd;
+    memcpy(buf.data(), &raw, sizeof(raw));
+    for (size_t i = 0; i < types.size(); ++i) buf[sizeof(raw) + i] = static_cast<uint8_t>(types[i]);
+    return f.seek(0) && f.write(buf.data(), buf.size()) == buf.size();
+}
+
+bool ColumnStore::readHeader(IFile& f, uint32_t& end) const {
+    std::vector<uint8_t> buf(headerSize());
+    uint32_t sz = f.size();
+    if (sz < buf.size() || !f.seek(0) || f.read(buf.data(), buf.size()) != buf.size()) return false;
+    RawStoreHeader raw;
+    memcpy(&raw, buf.data(), sizeof(raw));
+    bool ok = raw.magic == kStoreMagic && raw.version == kStoreVersion && raw.channels == types.size();
+    for (size_t i = 0; ok && i < types.size(); ++i) ok = buf[sizeof(raw) + i] == static_cast<uint8_t>(types[i]);
+    if (!ok || raw.dataEnd < buf.size()) {
+        DBG("ColumnStore: incompatible header (magic=%08x channels=%u)", (unsigned)raw.magic, raw.channels);
+        return false;
+    }
+    // grupa zapisana, ale bez aktualizacji nagłówka (awaria) jest pomijana
+    end = std::min(raw.dataEnd, sz);
+    return true;
+}
+
+bool ColumnStore::openPeriod(uint32_t p) {
+    close();
+    fs.mkdir(dir);
+    std::string path = dataPath(p);
+    bool existed = fs.exists(path);
+    data = fs.open(path, OpenMode::ReadWrite);
+    if (!data) {
+        DBG("ColumnStore::openPeriod(%s) open failed", path.c_str());
+        return false;
+    }
+    period = p;
+    lastMs = 0;
+    if (existed && data->size() > 0) {
+        if (!readHeader(*data, dataEnd)) {
+            data.reset();
+            return false;
+        }
+        // czas ostatniego wiersza z nagłówków grup
+        uint32_t pos = headerSize();
+        RawGroup g;
+        while (pos + groupHeaderSize() <= dataEnd && data->seek(pos) && data->read(&g, sizeof(g)) == sizeof(g)) {
+            uint32_t total = groupHeaderSize() + g.bodyBytes;
+            if (pos + total > dataEnd) break;
+            lastMs = g.tMax;
+            pos += total;
+        }
+        dataEnd = pos;
+    } else {
+        dataEnd = headerSize();
+        if (!writeHeader(*data)) {
+            data.reset();
+            return false;
+        }
+        if (listed && !std::binary_search(periods.begin(), periods.end(), p))
+            periods.insert(std::upper_bound(periods.begin(), periods.end(), p), p);
+    }
+    DBG("ColumnStore::openPeriod(%s) dataEnd=%u", path.c_str(), (unsigned)dataEnd);
+    return true;
+}
+
+bool ColumnStore::append(uint64_t tsMs, const double* values) {
+    if (!pendingTs.empty() ? tsMs < static_cast<uint64_t>(pendingTs.back()) : (data && tsMs < lastMs)) return false;
+    uint32_t p = periodOf(tsMs);
+    if (!data || p != period) {
+        if (data && p < period) return false;
+        if (!openPeriod(p)) return false;
+        if (tsMs < lastMs) return false;
+    }
+
+    pendingTs.push_back(static_cast<int64_t>(tsMs));
+    for (size_t c = 0; c < types.size(); ++c) {
+        if (types[c] == ColumnType::Float32) {
+            pendingCols[c].push_back(floatBits(static_cast<float>(values[c])));
+        } else {
+            double v = std::round(values[c]);
+            if (!(v >= INT32_MIN)) v = INT32_MIN; // także NaN
+            if (v > INT32_MAX) v = INT32_MAX;
+            pendingCols[c].push_back(static_cast<uint32_t>(static_cast<int32_t>(v)));
+        }
+    }
+    if (pendingTs.size() >= cfg.rowsPerGroup) return writeGroup();
+    return true;
+}
+
+bool ColumnStore::writeGroup() {
+    size_t n = pendingTs.size();
+    if (!n || !data) return true;
+
+    uint32_t ghSize = groupHeaderSize();
+    encoded.assign(ghSize, 0);
+    std::vector<RawEntry> entries(types.size() + 1);
+
+    size_t before = encoded.size();
+    ColumnCodec::encodeInts(pendingTs.data(), n, encoded);
+    entries[0].len = static_cast<uint32_t>(encoded.size() - before);
+
+    for (size_t c = 0; c < types.size(); ++c) {
+        const std::vector<uint32_t>& col = pendingCols[c];
+        RawEntry& e = entries[c + 1];
+        before = encoded.size();
+        if (types[c] == ColumnType::Float32) {
+            floatBuf.resize(n);
+            memcpy(floatBuf.data(), col.data(), n * 4);
+            float mn = NAN, mx = NAN;
+            for (float v : floatBuf) {
+                if (std::isnan(v)) continue;
+                if (!(v >= mn)) mn = v;
+                if (!(v <= mx)) mx = v;
+            }
+            e.min = floatBits(mn);
+            e.max = floatBits(mx);
+            ColumnCodec::encodeFloats(floatBuf.data(), n, encoded);
+        } else {
+            intBuf.resize(n);
+            int32_t mn = INT32_MAX, mx = INT32_MIN;
+            for (size_t i = 0; i < n; ++i) {
+                int32_t v = static_cast<int32_t>(col[i]);
+                intBuf[i] = v;
+                mn = std::min(mn, v);
+                mx = std::max(mx, v);
+            }
+            e.min = static_cast<uint32_t>(mn);
+            e.max = static_cast<uint32_t>(mx);
+            ColumnCodec::encodeInts(intBuf.data(), n, encoded);
+        }
+        e.len = static_cast<uint32_t>(encoded.size() - before);
+    }
+
+    RawGroup g;
+    g.rows = static_cast<uint16_t>(n);
+    g.columns = static_cast<uint8_t>(types.size() + 1);
+    g.reserved = 0;
+    g.bodyBytes = static_cast<uint32_t>(encoded.size() - ghSize);
+    g.tMin = static_cast<uint64_t>(pendingTs.front());
+    g.tMax = static_cast<uint64_t>(pendingTs.back());
+    memcpy(encoded.data(), &g, sizeof(g));
+    memcpy(encoded.data() + sizeof(g), entries.data(), entries.size() * sizeof(RawEntry));
+
+    if (!data->seek(dataEnd) || data->write(encoded.data(), encoded.size()) != encoded.size()) {
+        DBG("ColumnStore: group write failed at %u", (unsigned)dataEnd);
+        return false;
+    }
+    dataEnd += static_cast<uint32_t>(encoded.size());
+    if (!writeHeader(*data)) return false;
+    data->flush();
+    DBG("ColumnStore: group rows=%u bytes=%u", (unsigned)n, (unsigned)encoded.size());
+
+    lastMs = g.tMax;
+    pendingTs.clear();
+    for (auto& col : pendingCols) col.clear();
+    return true;
+}
+
+bool ColumnStore::flush() {
+    return writeGroup();
+}
+
+void ColumnStore::close() {
+    if (!data) return;
+    writeGroup();
+    data->close();
+    data.reset();
+}
+
+bool ColumnStore::readColumn(IFile& f, uint32_t offset, uint32_t len) {
+    block.resize(len + ColumnCodec::kPad);
+    memset(block.data() + len, 0, ColumnCodec::kPad);
+    if (!f.seek(offset) || f.read(block.data(), len) != len) return false;
+    stats.bytesRead += len;
+    return true;
+}
+
+bool ColumnStore::scanChannel(uint8_t channel, uint64_t fromMs, uint64_t toMs, Sink& sink) {
+    stats = ScanStats();
+    if (channel >= types.size() || fromMs > toMs) return false;
+    bool isFloat = types[channel] == ColumnType::Float32;
+    listPeriods();
+
+    uint32_t firstP = periodOf(fromMs), lastP = periodOf(toMs);
+    uint32_t ghSize = groupHeaderSize();
+    std::vector<uint8_t> gh(ghSize);
+    for (uint32_t p : periods) {
+        if (p < firstP) continue;
+        if (p > lastP) break;
+        std::unique_ptr<IFile> own;
+        IFile* f = data.get();
+        if (!data || p != period) {
+            own = fs.openRead(dataPath(p));
+            f = own.get();
+        }
+        uint32_t end;
+        if (!f) continue;
+        stats.filesOpened++;
+        if (!readHeader(*f, end)) continue;
+
+        uint32_t pos = headerSize();
+        while (pos + ghSize <= end) {
+            if (!f->seek(pos) || f->read(gh.data(), ghSize) != ghSize) break;
+            stats.bytesRead += ghSize;
+            RawGroup g;
+            memcpy(&g, gh.data(), sizeof(g));
+            uint32_t total = ghSize + g.bodyBytes;
+            if (pos + total > end || g.columns != types.size() + 1) break;
+            if (g.tMin > toMs) {
+                stats.groupsSkipped++;
+                return true; // grupy uporządkowane w czasie
+            }
+            const uint8_t* entries = gh.data() + sizeof(RawGroup);
+            RawEntry ts, col;
+            memcpy(&ts, entries, sizeof(ts));
+            memcpy(&col, entries + sizeof(RawEntry) * (channel + 1), sizeof(col));
+            bool inside = g.tMin >= fromMs && g.tMax <= toMs;
+            if (g.tMax < fromMs || (inside && sink.stats && sink.stats(col.min, col.max))) {
+                stats.groupsSkipped++;
+                pos += total;
+                continue;
+            }
+
+            uint32_t colOff = pos + ghSize;
+            for (uint8_t c = 0; c <= channel; ++c) {
+                RawEntry e;
+                memcpy(&e, entries + sizeof(RawEntry) * c, sizeof(e));
+                colOff += e.len;
+            }
+            size_t rows = g.rows;
+            tsBuf.resize(rows);
+            if (!readColumn(*f, pos + ghSize, ts.len) ||
+                !ColumnCodec::decodeInts(block.data(), ts.len, rows, tsBuf.data(), scratch.data()) ||
+                !readColumn(*f, colOff, col.len)) {
+                DBG("ColumnStore: corrupt group at %u", (unsigned)pos);
+                break;
+            }
+            bool ok;
+            if (isFloat) {
+                floatBuf.resize(rows);
+                ok = ColumnCodec::decodeFloats(block.data(), col.len, rows, floatBuf.data(), scratch.data());
+            } else {
+                intBuf.resize(rows);
+                int32Buf.resize(rows);
+                ok = ColumnCodec::decodeInts(block.data(), col.len, rows, intBuf.data(), scratch.data());
+                for (size_t i = 0; ok && i < rows; ++i) int32Buf[i] = static_cast<int32_t>(intBuf[i]);
+            }
+            if (!ok) {
+                DBG("ColumnStore: corrupt column at %u", (unsigned)colOff);
+                break;
+            }
+            stats.groupsDecoded++;
+
+            const uint64_t* t = reinterpret_cast<const uint64_t*>(tsBuf.data());
+            size_t i0 = std::lower_bound(t, t + rows, fromMs) - t;
+            size_t i1 = std::upper_bound(t, t + rows, toMs) - t;
+            if (i1 > i0 && !sink.rows(t + i0, isFloat ? floatBuf.data() + i0 : nullptr,
+                                      isFloat ? nullptr : int32Buf.data() + i0, i1 - i0)) {
+                return true;
+            }
+            pos += total;
+        }
+    }
+
+    // wiersze jeszcze w RAM (najnowsze)
+    size_t n = pendingTs.size();
+    if (!n) return true;
+    const uint64_t* t = reinterpret_cast<const uint64_t*>(pendingTs.data());
+    size_t i0 = std::lower_bound(t, t + n, fromMs) - t;
+    size_t i1 = std::upper_bound(t, t + n, toMs) - t;
+    if (i1 <= i0) return true;
+    const std::vector<uint32_t>& col = pendingCols[channel];
+    if (isFloat) {
+        floatBuf.resize(n);
+        memcpy(floatBuf.data(), col.data(), n * 4);
+    } else {
+        int32Buf.resize(n);
+        for (size_t i = 0; i < n; ++i) int32Buf[i] = static_cast<int32_t>(col[i]);
+    }
+    sink.rows(t + i0, isFloat ? floatBuf.data() + i0 : nullptr, isFloat ? nullptr : int32Buf.data() + i0, i1 - i0);
+    return true;
+}
+
+size_t ColumnStore::scan(uint8_t channel, uint64_t fromMs, uint64_t toMs, const FloatBatch& cb) {
+    if (channel >= types.size() || types[channel] != ColumnType::Float32) return 0;
+    size_t delivered = 0;
+    Sink sink;
+    sink.rows = [&](const uint64_t* ts, const float* v, const int32_t*, size_t n) {
+        delivered += n;
+        return cb(ts, v, n);
+    };
+    scanChannel(channel, fromMs, toMs, sink);
+    return delivered;
+}
+
+size_t ColumnStore::scanInt(uint8_t channel, uint64_t fromMs, uint64_t toMs, const IntBatch& cb) {
+    if (channel >= types.size() || types[channel] != ColumnType::Int32) return 0;
+    size_t delivered = 0;
+    Sink sink;
+    sink.rows = [&](const uint64_t* ts, const float*, const int32_t* v, size_t n) {
+        delivered += n;
+        return cb(ts, v, n);
+    };
+    scanChannel(channel, fromMs, toMs, sink);
+    return delivered;
+}
+
+bool ColumnStore::minMax(uint8_t channel, uint64_t fromMs, uint64_t toMs, double& minOut, double& maxOut) {
+    if (channel >= types.size()) return false;
+    bool isFloat = types[channel] == ColumnType::Float32;
+    bool any = false;
+    double mn = 0, mx = 0;
+    auto take = [&](double v) {
+        if (std::isnan(v)) return;
+        if (!any || v < mn) mn = v;
+        if (!any || v > mx) mx = v;
+        any = true;
+    };
+    Sink sink;
+    sink.stats = [&](uint32_t rawMin, uint32_t rawMax) {
+        if (isFloat) {
+            take(asFloat(rawMin));
+            take(asFloat(rawMax));
+        } else {
+            take(static_cast<int32_t>(rawMin));
+            take(static_cast<int32_t>(rawMax));
+        }
+        return true;
+    };
+    sink.rows = [&](const uint64_t*, const float* f, const int32_t* i, size_t n) {
+        for (size_t k = 0; k < n; ++k) take(f ? f[k] : i[k]);
+        return true;
+    };
+    scanChannel(channel, fromMs, toMs, sink);
+    if (any) {
+        minOut = mn;
+        maxOut = mx;
+    }
+    return any;
+}
+
+} // namespace logs
+} // namespace storage
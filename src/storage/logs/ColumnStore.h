@@ -0,0 +1,143 @@
+#ifndef STORAGE_LOGS_COLUMNSTORE_H
+#define STORAGE_LOGS_COLUMNSTORE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace logs {
+
+enum class ColumnType : uint8_t {
+    Float32 = 1,
+    Int32 = 2,
+};
+
+/**
+ * @brief Kolumnowy, kompresowany magazyn kanałów pomiarowych.
+ *
+ * Wiersz = znacznik czasu (ms Unix) + wartość każdego kanału. Wiersze
+ * zbierane są w RAM w grupy (`rowsPerGroup`), a grupa zapisywana jest
+ * kolumnami: czas i kanały int32 jako delta-of-delta, kanały float jako XOR
+ * z poprzednią wartością, wszystko z pakowaniem bitów (`ColumnCodec`).
+ * Nagłówek grupy zawiera zakres czasu, długość i min/max każdej kolumny.
+ *
+ * Pliki per okres (`filePeriodSec`, domyślnie doba), jak w `TimeSeriesLog`:
+ *
+ *   <dir>/<początek okresu, s>.tsc – nagłówek + grupy
+ *
+ * Zapytanie o jeden kanał w zakresie czasu pomija pliki po nazwie, grupy
+ * po nagłówku, a z pasującej grupy czyta i dekoduje tylko kolumnę czasu
+ * i żądanego kanału. `minMax` dla grup w całości w zakresie korzysta
+ * wyłącznie ze statystyk. Wiersze jeszcze w RAM są uwzględniane.
+ *
+ * Nagłówek pliku zawiera koniec poprawnych danych, aktualizowany po
+ * każdej grupie – grupa przerwana awarią jest ignorowana i nadpisywana.
+ * RAM zapisu: rowsPerGroup × (8 + 4 × kanały) B (512 × 16 kanałów ≈ 36 KiB).
+ *
+ * @code
+ * using storage::logs::ColumnType;
+ * storage::logs::ColumnStore cs(sdFs, "/cs/env", std::vector<ColumnType>(16, ColumnType::Float32));
+ * double row[16] = {...};
+ * cs.append(nowMs, row);
+ * cs.scan(3, dayStartMs, nowMs, [](const uint64_t* ts, const float* v, size_t n) {
+ *     for (size_t i = 0; i < n; ++i) sum += v[i];
+ *     return true;
+ * });
+ * @endcode
+ */
+class ColumnStore {
+public:
+    struct Config {
+        uint32_t filePeriodSec = 86400;  // jeden plik na dobę
+        uint16_t rowsPerGroup = 512;     // 16..8192
+    };
+
+    // Statystyki ostatniego zapytania (skuteczność pomijania).
+    struct ScanStats {
+        uint32_t filesOpened = 0;
+        uint32_t groupsDecoded = 0;
+        uint32_t groupsSkipped = 0;  // pominięte po zakresie czasu lub rozstrzygnięte statystykami
+        uint32_t bytesRead = 0;
+    };
+
+    using FloatBatch = std::function<bool(const uint64_t* tsMs, const float* values, size_t n)>;
+    using IntBatch = std::function<bool(const uint64_t* tsMs, const int32_t* values, size_t n)>;
+
+    static const uint8_t kMaxChannels = 32;
+
+    ColumnStore(IFileSystem& fs, const std::string& dir, const std::vector<ColumnType>& channels);
+    ColumnStore(IFileSystem& fs, const std::string& dir, const std::vector<ColumnType>& channels, const Config& cfg);
+    ~ColumnStore();
+
+    ColumnStore(const ColumnStore&) = delete;
+    ColumnStore& operator=(const ColumnStore&) = delete;
+
+    // values: jedna wartość na kanał (int32 zaokrąglane). Czas niemalejący.
+    bool append(uint64_t tsMs, const double* values);
+    // Zapisuje zebrane wiersze jako (niepełną) grupę.
+    bool flush();
+    void close();
+
+    // Partie wartości kanału z [fromMs, toMs] w kolejności czasu; cb zwraca false = przerwij.
+    // Zwraca liczbę przekazanych wartości (0 także przy złym typie kanału).
+    size_t scan(uint8_t channel, uint64_t fromMs, uint64_t toMs, const FloatBatch& cb);
+    size_t scanInt(uint8_t channel, uint64_t fromMs, uint64_t toMs, const IntBatch& cb);
+
+    // Minimum i maksimum kanału w zakresie (NaN pomijane). false = brak wartości.
+    bool minMax(uint8_t channel, uint64_t fromMs, uint64_t toMs, double& minOut, double& maxOut);
+
+    const ScanStats& lastScan() const { return stats; }
+    size_t channels() const { return types.size(); }
+
+private:
+    struct Sink;
+
+    IFileSystem& fs;
+    std::string dir;
+    std::vector<ColumnType> types;
+    Config cfg;
+
+    // bieżący plik do zapisu
+    std::unique_ptr<IFile> data;
+    uint32_t period = 0;
+    uint32_t dataEnd = 0;
+    uint64_t lastMs = 0;        // czas ostatniego zapisanego wiersza
+
+    // wiersze czekające na zapis
+    std::vector<int64_t> pendingTs;
+    std::vector<std::vector<uint32_t>> pendingCols;  // bity float / int32
+    std::vector<uint8_t> encoded;
+
+    // bufory dekodowania
+    std::vector<uint8_t> block;
+    std::vector<int64_t> tsBuf;
+    std::vector<int64_t> intBuf;
+    std::vector<float> floatBuf;
+    std::vector<int32_t> int32Buf;
+    std::vector<uint64_t> scratch;
+
+    std::vector<uint32_t> periods;
+    bool listed = false;
+    ScanStats stats;
+
+    std::string dataPath(uint32_t periodStart) const;
+    uint32_t periodOf(uint64_t tsMs) const;
+    uint32_t headerSize() const;
+    uint32_t groupHeaderSize() const;
+    void listPeriods();
+    bool openPeriod(uint32_t periodStart);
+    bool writeHeader(IFile& f);
+    bool readHeader(IFile& f, uint32_t& end) const;
+    bool writeGroup();
+    bool scanChannel(uint8_t channel, uint64_t fromMs, uint64_t toMs, Sink& sink);
+    bool readColumn(IFile& f, uint32_t offset, uint32_t len);
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_COLUMNSTORE_H
@@ -0,0 +1,288 @@
+#include "RetentionManager.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <cctype>
+
+namespace storage {
+namespace logs {
+
+using util::normalizePath;
+using util::parentPath;
+
+bool NaturalLess::operator()(const std::string& a, const std::string& b) const {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isdigit((unsigned char)a[i]) && isdigit((unsigned char)b[j])) {
+            size_t ei = i, ej = j;
+            while (ei < a.size() && isdigit((unsigned char)a[ei])) ++ei;
+            while (ej < b.size() && isdigit((unsigned char)b[ej])) ++ej;
+            size_t si = i, sj = j;
+            while (si + 1 < ei && a[si] == '0') ++si;
+            while (sj + 1 < ej && b[sj] == '0') ++sj;
+            if (ei - si != ej - sj) return ei - si < ej - sj;
+            int c = a.compare(si, ei - si, b, sj, ej - sj);
+            if (c) return c < 0;
+            if (ei - i != ej - j) return ei - i < ej - j; // "01" vs "1": rozstrzygnięcie deterministyczne
+            i = ei;
+            j = ej;
+            continue;
+        }
+        if (a[i] != b[j]) return (unsigned char)a[i] < (unsigned char)b[j];
+        ++i;
+        ++j;
+    }
+    return a.size() - i < b.size() - j;
+}
+
+RetentionManager::RetentionManager(IFileSystem& f, const std::string& r, const Policy& policy,
+                                   std::function<uint32_t()> timeSource)
+    : fs(f), root(normalizePath(r)), pol(policy), clock(std::move(timeSource)) {
+    if (root.empty()) root = "/";
+    pendingDirs.push_back(root);
+}
+
+void RetentionManager::addLocked(const std::string& path, uint64_t size, uint32_t created, bool overwrite) {
+    auto it = files.find(path);
+    if (it != files.end()) {
+        if (!overwrite) return;
+        total -= it->second.size;
+        it->second.size = size;
+        if (created) {
+            it->second.created = created;
+            it->second.timeChecked = true;
+        }
+        total += size;
+        return;
+    }
+    Entry e;
+    e.size = size;
+    e.created = created;
+    e.timeChecked = created != 0;
+    files.emplace(path, e);
+    linkLocked(path);
+    total += size;
+}
+
+// Zlicza `path` w katalogu rodzica; brakujące katalogi pośrednie (pod root) są dopisywane.
+void RetentionManager::linkLocked(const std::string& path) {
+    std::string dir = parentPath(path);
+    while (!dir.empty()) {
+        auto d = dirFiles.find(dir);
+        bool fresh = d == dirFiles.end();
+        if (fresh) d = dirFiles.emplace(dir, 0).first;
+        d->second++;
+        if (!fresh || dir == root || dir.size() < root.size()) break;
+        dir = parentPath(dir);
+    }
+}
+
+// Odwrotność linkLocked. Zwraca katalogi, które stały się puste (od najgłębszego).
+std::vector<std::string> RetentionManager::unlinkLocked(const std::string& path) {
+    std::vector<std::string> empty;
+    std::string activeDir = parentPath(active);
+    std::string dir = parentPath(path);
+    while (!dir.empty() && dir != root) {
+        auto d = dirFiles.find(dir);
+        if (d == dirFiles.end()) break;
+        if (d->second) d->second--;
+        if (d->second || dir == activeDir) break;
+        dirFiles.erase(d);
+        empty.push_back(dir);
+        dir = parentPath(dir);
+    }
+    if (dir == root) {
+        auto d = dirFiles.find(dir);
+        if (d != dirFiles.end() && d->second) d->second--;
+    }
+    return empty;
+}
+
+std::vector<std::string> RetentionManager::eraseLocked(std::map<std::string, Entry, NaturalLess>::iterator it) {
+    total -= it->second.size;
+    if (it->second.removeFailed) failed--;
+    std::string path = it->first;
+    files.erase(it);
+    return unlinkLocked(path);
+}
+
+void RetentionManager::track(const std::string& rawPath, size_t size, uint32_t createdTs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    addLocked(normalizePath(rawPath), size, createdTs, true);
+}
+
+void RetentionManager::grow(const std::string& rawPath, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string path = normalizePath(rawPath);
+    auto it = files.find(path);
+    if (it == files.end()) {
+        addLocked(path, bytes, clock ? clock() : 0, true);
+        return;
+    }
+    it->second.size += bytes;
+    total += bytes;
+}
+
+void RetentionManager::forget(const std::string& rawPath) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = files.find(normalizePath(rawPath));
+    if (it != files.end()) eraseLocked(it); // katalog zostaje – forget nie usuwa z nośnika
+}
+
+void RetentionManager::setActive(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mtx);
+    active = normalizePath(path);
+}
+
+bool RetentionManager::scanned() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return pendingDirs.empty();
+}
+
+size_t RetentionManager::fileCount() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return files.size();
+}
+
+uint64_t RetentionManager::totalBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return total;
+}
+
+uint32_t RetentionManager::removedFiles() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return removed;
+}
+
+// Jedno listDir. Wpisy o rozmiarze 0 mogą być katalogami – trafiają do kolejki;
+// jeśli listDir na nich się nie powiedzie, są pustymi plikami.
+bool RetentionManager::scanOne() {
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (pendingDirs.empty()) return false;
+        dir = pendingDirs.back();
+        pendingDirs.pop_back();
+    }
+    std::vector<std::pair<std::string, size_t>> entries;
+    bool isDir = fs.listDir(dir.c_str(), [&](const char* name, size_t size) {
+        entries.emplace_back(name, size);
+    });
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!isDir) {
+        if (dir != root) addLocked(dir, 0, 0, false);
+        return true;
+    }
+    if (dir != root && !dirFiles.count(dir)) {
+        dirFiles.emplace(dir, 0);
+        linkLocked(dir);
+    }
+    std::string prefix = dir == "/" ? dir : dir + "/";
+    for (const auto& e : entries) {
+        std::string path = prefix + e.first;
+        if (e.second == 0) pendingDirs.push_back(path);
+        else addLocked(path, e.second, 0, false);
+    }
+    DBG("RetentionManager: scanned %s (%u entries)", dir.c_str(), (unsigned)entries.size());
+    return true;
+}
+
+bool RetentionManager::pruneOne(uint8_t& budget) {
+    std::string victim;
+    bool needTime = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = files.begin();
+        while (it != files.end() && (it->first == active || it->second.removeFailed)) ++it;
+        if (it == files.end()) return false;
+
+        bool over = (pol.maxFiles && files.size() > pol.maxFiles) || (pol.maxTotalBytes && total > pol.maxTotalBytes);
+        if (!over && pol.maxAgeSec && clock) {
+            // pliki bez daty (0) nie wygasają, ale nie mogą blokować nowszych
+            for (; it != files.end(); ++it) {
+                if (it->first == active || it->second.removeFailed) continue;
+                if (!it->second.timeChecked) {
+                    needTime = true;
+                } else if (!it->second.created) {
+                    continue;
+                } else if (clock() - it->second.created > pol.maxAgeSec) {
+                    over = true;
+                }
+                break;
+            }
+        }
+        if (!over && !needTime) return false;
+        victim = it->first;
+    }
+
+    if (needTime) {
+        uint32_t ts = fs.getModifiedTimestamp(victim);
+        budget--;
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = files.find(victim);
+        if (it != files.end()) {
+            it->second.created = ts;
+            it->second.timeChecked = true;
+        }
+        return true;
+    }
+
+    DBG("RetentionManager: removing %s", victim.c_str());
+    bool ok = fs.remove(victim);
+    budget--;
+    // nieudane remove pliku, którego już nie ma (usunięty z zewnątrz) = usunięty
+    bool gone = ok || !fs.exists(victim);
+    if (!ok && budget) budget--;
+    std::vector<std::string> emptyDirs;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = files.find(victim);
+        if (it != files.end()) {
+            if (gone) {
+                emptyDirs = eraseLocked(it);
+            } else if (!it->second.removeFailed) {
+                DBG("RetentionManager: cannot remove %s, retry in next step", victim.c_str());
+                it->second.removeFailed = true;
+                failed++;
+            }
+        }
+        if (ok) removed++;
+    }
+    // puste katalogi (np. minionego dnia) – poza budżetem, to zwykle 1 operacja
+    for (const auto& dir : emptyDirs) {
+        fs.remove(dir);
+        if (budget) budget--;
+    }
+    return true;
+}
+
+bool RetentionManager::step(uint8_t budget) {
+    {
+        // pliki, których nie udało się usunąć, wracają do kolejki raz na step()
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto it = files.begin(); failed && it != files.end(); ++it) {
+            if (it->second.removeFailed) {
+                it->second.removeFailed = false;
+                failed--;
+            }
+        }
+    }
+    while (budget) {
+        bool scanning;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            scanning = !pendingDirs.empty();
+        }
+        if (scanning) {
+            scanOne();
+            budget--;
+            continue;
+        }
+        if (!pruneOne(budget)) return false;
+    }
+    return true;
+}
+
+} // namespace logs
+} // namespace storage
@@ -0,0 +1,103 @@
+#ifndef STORAGE_LOGS_RETENTIONMANAGER_H
+#define STORAGE_LOGS_RETENTIONMANAGER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace logs {
+
+// Porównanie ścieżek z liczbami porównywanymi wartością ("9.log" < "10.log",
+// "13.2.log" < "13.10.log"). Kolejność plików rotacji = kolejność czasu.
+struct NaturalLess {
+    bool operator()(const std::string& a, const std::string& b) const;
+};
+
+/**
+ * @brief Retencja katalogu logów: limit bajtów, wieku i liczby plików.
+ *
+ * Utrzymuje w RAM katalog plików pod `root` uporządkowany od najstarszego
+ * (porządek naturalny ścieżek – nazwy z `RotatingLog` rosną z czasem).
+ * Katalog budowany jest raz, przyrostowo: jedno `listDir` na krok.
+ * Potem aktualizują go powiadomienia (`track`/`grow`) od `RotatingLog`,
+ * więc egzekwowanie polityki nie listuje drzewa ponownie.
+ *
+ * `step(budget)` wykonuje co najwyżej `budget` operacji na systemie plików
+ * (listDir, remove, getModifiedTimestamp) i zwraca true, jeśli jest jeszcze
+ * praca. Wywołuj z pętli, zadania o niskim priorytecie lub
+ * `IoScheduler::run(..., IoPriority::Low)`, żeby nie blokować zapisu logów.
+ *
+ * Wiek pliku to czas z `track` (pliki utworzone w tej sesji) albo – tylko
+ * dla najstarszego kandydata – `getModifiedTimestamp`. Backend bez dat
+ * (LittleFS) zwraca 0 i taki plik nie jest usuwany z powodu wieku;
+ * sprawdzanie przechodzi wtedy do następnego (nowszego) pliku.
+ * Puste katalogi (np. po dniu) są usuwane razem z ostatnim plikiem.
+ *
+ * Plik, którego `remove` się nie udał (a nadal istnieje), zostaje w katalogu
+ * i w sumie bajtów, ale do końca bieżącego `step` jest pomijany – polityka
+ * przechodzi do nowszych plików. Kolejne `step` próbuje go usunąć ponownie.
+ */
+class RetentionManager {
+public:
+    struct Policy {
+        uint64_t maxTotalBytes = 0; // 0 = bez limitu
+        uint32_t maxAgeSec = 0;
+        uint32_t maxFiles = 0;
+    };
+
+    RetentionManager(IFileSystem& fs, const std::string& root, const Policy& policy,
+                     std::function<uint32_t()> clock = nullptr);
+
+    // Powiadomienia od piszącego (dowolny wątek).
+    void track(const std::string& path, size_t size, uint32_t createdTs);
+    void grow(const std::string& path, size_t bytes);
+    void forget(const std::string& path);
+    void setActive(const std::string& path); // plik, którego nie wolno usunąć
+
+    bool step(uint8_t budget = 4);
+
+    bool scanned() const;
+    size_t fileCount() const;
+    uint64_t totalBytes() const;
+    uint32_t removedFiles() const;
+    const Policy& policy() const { return pol; }
+
+private:
+    struct Entry {
+        uint64_t size = 0;
+        uint32_t created = 0;  // 0 = nieznany (jeszcze nie sprawdzony)
+        bool timeChecked = false;
+        bool removeFailed = false; // pomijany do następnego step()
+    };
+
+    IFileSystem& fs;
+    std::string root;
+    Policy pol;
+    std::function<uint32_t()> clock;
+
+    mutable std::mutex mtx;
+    std::map<std::string, Entry, NaturalLess> files;
+    std::map<std::string, uint32_t> dirFiles; // liczba wpisów (pliki i podkatalogi) w katalogu
+    std::vector<std::string> pendingDirs;     // katalogi do wylistowania
+    std::string active;
+    uint64_t total = 0;
+    uint32_t removed = 0;
+    uint32_t failed = 0;                      // wpisy z removeFailed
+
+    void addLocked(const std::string& path, uint64_t size, uint32_t created, bool overwrite);
+    void linkLocked(const std::string& path);
+    std::vector<std::string> unlinkLocked(const std::string& path);
+    std::vector<std::string> eraseLocked(std::map<std::string, Entry, NaturalLess>::iterator it);
+    bool scanOne();
+    bool pruneOne(uint8_t& budget);
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_RETENTIONMANAGER_H
@@ -0,0 +1,355 @@
+#include "RingLog.h"
+#include "storage/Debug.h"
+#include "storage/pack/Crc32.h"
+#include "storage/util/Path.h"
+
+#include <cstring>
+
+namespace storage {
+namespace logs {
+
+using pack::Crc32;
+
+namespace {
+
+const uint16_t kRingMagic = 0x4752;     // "RG"
+const uint8_t kRingVersion = 1;
+const uint8_t kRingDirty = 1;           // zapisy po ostatnim flush()
+const uint32_t kRingSlot = 32;          // jeden slot nagłówka
+const uint32_t kRingData = 64;          // początek obszaru danych
+const uint32_t kRingRecHdr = 16;
+const uint16_t kRingWrap = 0xFFFF;      // len znacznika zawinięcia
+const uint32_t kRingNone = UINT32_MAX;
+
+// Slot nagłówka (32 B): 0 magic u16 | 2 version u8 | 3 flags u8 | 4 gen | 8 capacity | 12 head
+//                       16 tail | 20 first | 24 next | 28 crc
+struct RawRingHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint32_t gen;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t first;
+    uint32_t next;
+    uint32_t crc;
+};
+static_assert(sizeof(RawRingHeader) == kRingSlot, "RawRingHeader layout");
+
+uint32_t recordSize(uint32_t len) {
+    return (kRingRecHdr + len + 3) & ~3u;
+}
+
+// s ∈ [lo, hi) z przepełnieniem numerów
+bool seqIn(uint32_t s, uint32_t lo, uint32_t hi) {
+    return s - lo < hi - lo;
+}
+
+} // namespace
+
+RingLog::RingLog(IFileSystem& f, const std::string& p) : RingLog(f, p, Config()) {}
+
+RingLog::RingLog(IFileSystem& f, const std::string& p, const Config& c)
+    : fs(f), path(util::normalizePath(p)), cfg(c) {
+    static_assert(sizeof(RecordHeader) == kRingRecHdr, "RecordHeader layout");
+    cap = cfg.capacity & ~3u;
+    if (cap < 256) cap = 256;
+    // co najmniej dwa najdłuższe rekordy w obszarze danych
+    if (cfg.maxRecord > cap / 2 - kRingRecHdr) cfg.maxRecord = static_cast<uint16_t>(cap / 2 - kRingRecHdr);
+    if (cfg.maxRecord == kRingWrap) cfg.maxRecord = kRingWrap - 1;
+}
+
+RingLog::~RingLog() {
+    close();
+}
+
+bool RingLog::open() {
+    if (file) return true;
+    buf.assign(recordSize(cfg.maxRecord), 0);
+    if (fs.exists(path)) {
+        file = fs.open(path, OpenMode::ReadWrite);
+        if (file && load()) return true;
+        DBG("RingLog::open(%s): invalid ring file, recreating", path.c_str());
+        file.reset();
+    }
+    return create();
+}
+
+bool RingLog::create() {
+    DBG("RingLog::create(%s, capacity=%u)", path.c_str(), (unsigned)cap);
+    std::unique_ptr<IFile> f = fs.open(path, OpenMode::WriteTruncate);
+    if (!f) return false;
+    // cały plik od razu – później append nie zmienia już rozmiaru
+    uint8_t zeros[512] = {};
+    uint32_t total = kRingData + cap;
+    for (uint32_t done = 0; done < total;) {
+        uint32_t n = total - done < sizeof(zeros) ? total - done : static_cast<uint32_t>(sizeof(zeros));
+        if (f->write(zeros, n) != n) return false;
+        done += n;
+    }
+    f->close();
+    file = fs.open(path, OpenMode::ReadWrite);
+    if (!file) return false;
+    head = tail = tailSize = first = next = gen = unsynced = 0;
+    if (!writeHeader(false)) {
+        file.reset();
+        return false;
+    }
+    file->flush();
+    return true;
+}
+
+bool RingLog::load() {
+    if (file->size() != kRingData + cap) return false;
+    RawRingHeader best = RawRingHeader();
+    bool found = false;
+    for (uint32_t slot = 0; slot < 2; ++slot) {
+        RawRingHeader raw;
+        if (!file->seek(slot * kRingSlot) || file->read(&raw, sizeof(raw)) != sizeof(raw)) return false;
+        if (raw.magic != kRingMagic || raw.version != kRingVersion || raw.capacity != cap || raw.head > cap ||
+            raw.tail >= cap || raw.crc != Crc32::update(0, &raw, sizeof(raw) - 4)) {
+            continue;
+        }
+        if (!found || static_cast<int32_t>(raw.gen - best.gen) > 0) best = raw;
+        found = true;
+    }
+    if (!found) return false;
+    gen = best.gen;
+    head = best.head;
+    tail = best.tail;
+    first = best.first;
+    next = best.next;
+    tailSize = unsynced = 0;
+    dirty = false;
+
+    if (best.flags & kRingDirty) {
+        // brak flush() po ostatnich zapisach – najnowszy rekord wg numeru
+        RecordHeader h;
+        uint32_t pos = scanNewest(next, h);
+        if (pos != kRingNone) {
+            DBG("RingLog::load(%s): recovered %u records", path.c_str(), (unsigned)(h.seq + 1 - next));
+            head = pos + recordSize(h.len);
+            next = h.seq + 1;
+            tail = h.tail;
+            first = next - cap / kRingRecHdr; // dolna granica – findTail ustala dokładny numer
+        }
+        dirty = true;
+    }
+    findTail();
+    return true;
+}
+
+uint32_t RingLog::scanNewest(uint32_t lo, RecordHeader& newest) {
+    uint8_t block[512 + kRingRecHdr];
+    uint32_t found = kRingNone;
+    for (uint32_t base = 0; base + kRingRecHdr <= cap; base += 512) {
+        uint32_t n = cap - base < sizeof(block) ? cap - base : static_cast<uint32_t>(sizeof(block));
+        if (!file->seek(kRingData + base) || file->read(block, n) != n) break;
+        for (uint32_t off = 0; off < 512 && off + kRingRecHdr <= n; off += 4) {
+            RecordHeader h;
+            memcpy(&h, block + off, sizeof(h));
+            if (h.len > cfg.maxRecord || h.check != static_cast<uint16_t>(~h.len)) continue;
+            if (!seqIn(h.seq, lo, lo + 0x80000000u)) continue;
+            if (found != kRingNone && h.seq - lo <= newest.seq - lo) continue;
+            if (validRecord(base + off, h, h.seq, h.seq + 1)) {
+                newest = h;
+                found = base + off;
+            }
+        }
+    }
+    return found;
+}
+
+bool RingLog::writeHeader(bool markDirty) {
+    RawRingHeader raw;
+    raw.magic = kRingMagic;
+    raw.version = kRingVersion;
+    raw.flags = markDirty ? kRingDirty : 0;
+    raw.gen = gen + 1;
+    raw.capacity = cap;
+    raw.head = head;
+    raw.tail = tail;
+    raw.first = first;
+    raw.next = next;
+    raw.crc = Crc32::update(0, &raw, sizeof(raw) - 4);
+    // naprzemiennie – przerwany zapis zostawia poprzedni slot
+    if (!file->seek((raw.gen & 1) * kRingSlot) || file->write(&raw, sizeof(raw)) != sizeof(raw)) return false;
+    gen = raw.gen;
+    unsynced = 0;
+    dirty = markDirty;
+    return true;
+}
+
+bool RingLog::readRecordHeader(uint32_t pos, RecordHeader& h) {
+    return file->seek(kRingData + pos) && file->read(&h, sizeof(h)) == sizeof(h);
+}
+
+bool RingLog::readRecord(uint32_t pos, const RecordHeader& h) {
+    // pozycja pliku jest tuż za nagłówkiem po readRecordHeader
+    if (file->position() != kRingData + pos + kRingRecHdr && !file->seek(kRingData + pos + kRingRecHdr)) return false;
+    if (h.len && file->read(buf.data(), h.len) != h.len) return false;
+    uint32_t crc = Crc32::update(0, &h, kRingRecHdr - 4);
+    return Crc32::update(crc, buf.data(), h.len) == h.crc;
+}
+
+bool RingLog::validRecord(uint32_t pos, RecordHeader& h, uint32_t lo, uint32_t hi) {
+    return readRecordHeader(pos, h) && h.len <= cfg.maxRecord && h.check == static_cast<uint16_t>(~h.len) &&
+           seqIn(h.seq, lo, hi) && pos + recordSize(h.len) <= cap && readRecord(pos, h);
+}
+
+uint32_t RingLog::findValid(uint32_t pos, uint32_t lo, RecordHeader& h) {
+    for (uint32_t n = 0; n < cap / 4; ++n, pos += 4) {
+        if (pos + kRingRecHdr > cap) pos = 0;
+        if (pos == head && (n || pos != tail)) break;
+        if (validRecord(pos, h, lo, next)) return pos;
+    }
+    return kRingNone;
+}
+
+void RingLog::findTail() {
+    tailSize = 0;
+    if (first == next) {
+        tail = head;
+        return;
+    }
+    RecordHeader h;
+    for (int i = 0; i < 2; ++i) {
+        if (tail + kRingRecHdr > cap) {
+            tail = 0;
+            continue;
+        }
+        if (!readRecordHeader(tail, h)) break;
+        if (h.len == kRingWrap && seqIn(h.seq, first, next + 1)) {
+            tail = 0;
+            continue;
+        }
+        if (h.len <= cfg.maxRecord && h.check == static_cast<uint16_t>(~h.len) && seqIn(h.seq, first, next)) {
+            first = h.seq;
+            tailSize = recordSize(h.len);
+            return;
+        }
+        break;
+    }
+    // nieczytelny początek (np. przerwany zapis nadpisał część najstarszych rekordów)
+    uint32_t pos = findValid(tail, first, h);
+    if (pos == kRingNone) {
+        DBG("RingLog::findTail(%s): no valid records", path.c_str());
+        first = next;
+        tail = head;
+        return;
+    }
+    DBG("RingLog::findTail(%s): resync %u -> %u", path.c_str(), (unsigned)tail, (unsigned)pos);
+    tail = pos;
+    first = h.seq;
+    tailSize = recordSize(h.len);
+}
+
+bool RingLog::evict() {
+    if (first != next && !tailSize) findTail();
+    if (first == next) return false;
+    tail += tailSize;
+    first++;
+    findTail();
+    return true;
+}
+
+bool RingLog::reserve(uint32_t size) {
+    if (head + size > cap) {
+        // zawinięcie: zwalnia koniec obszaru i zaczyna od 0
+        while (first != next && tail >= head) evict();
+        if (head + kRingRecHdr <= cap) {
+            RecordHeader m = {next, 0, kRingWrap, static_cast<uint16_t>(~kRingWrap), 0};
+            m.crc = Crc32::update(0, &m, kRingRecHdr - 4);
+            if (!file->seek(kRingData + head) || file->write(&m, sizeof(m)) != sizeof(m)) return false;
+        }
+        head = 0;
+        if (first == next) tail = 0;
+    }
+    while (first != next && tail >= head && tail < head + size) evict();
+    return true;
+}
+
+bool RingLog::append(const void* data, size_t len) {
+    if (!file || len > cfg.maxRecord) return false;
+    // raz na okres między flush(): po awarii open() wie, że trzeba szukać nowszych rekordów
+    if (!dirty && !writeHeader(true)) return false;
+    uint32_t size = recordSize(static_cast<uint32_t>(len));
+    if (!reserve(size)) return false;
+    bool empty = first == next;
+
+    RecordHeader h;
+    h.seq = next;
+    h.tail = empty ? head : tail;
+    h.len = static_cast<uint16_t>(len);
+    h.check = static_cast<uint16_t>(~h.len);
+    h.crc = Crc32::update(Crc32::update(0, &h, kRingRecHdr - 4), data, len);
+    memcpy(buf.data(), &h, sizeof(h));
+    if (len) memcpy(buf.data() + kRingRecHdr, data, len);
+    memset(buf.data() + kRingRecHdr + len, 0, size - kRingRecHdr - len);
+    if (!file->seek(kRingData + head) || file->write(buf.data(), size) != size) return false;
+
+    if (empty) {
+        tail = head;
+        tailSize = size;
+    }
+    head += size;
+    next++;
+    unsynced++;
+    if (cfg.syncEvery && unsynced >= cfg.syncEvery) return flush();
+    return true;
+}
+
+bool RingLog::append(const char* text) {
+    return append(text, strlen(text));
+}
+
+bool RingLog::flush() {
+    if (!file) return false;
+    bool ok = !dirty || writeHeader(false);
+    file->flush();
+    return ok;
+}
+
+void RingLog::close() {
+    if (!file) return;
+    flush();
+    file->close();
+    file.reset();
+}
+
+bool RingLog::clear() {
+    if (!file) return false;
+    // numery rosną dalej – stare rekordy w pliku nie pasują już do zakresu
+    head = tail = tailSize = 0;
+    first = next;
+    dirty = true;
+    return flush();
+}
+
+size_t RingLog::forEach(const RecordCallback& cb) {
+    if (!file) return 0;
+    size_t n = 0;
+    uint32_t pos = tail, seq = first;
+    RecordHeader h;
+    while (seq != next) {
+        if (pos + kRingRecHdr > cap) pos = 0;
+        if (validRecord(pos, h, seq, next)) {
+            n++;
+            if (!cb(h.seq, buf.data(), h.len)) break;
+            pos += recordSize(h.len);
+            seq = h.seq + 1;
+            continue;
+        }
+        if (pos && readRecordHeader(pos, h) && h.len == kRingWrap && seqIn(h.seq, seq, next + 1)) {
+            pos = 0;
+            continue;
+        }
+        pos = findValid(pos + 4, seq, h);
+        if (pos == kRingNone) break;
+    }
+    return n;
+}
+
+} // namespace logs
+} // namespace storage
@@ -0,0 +1,128 @@
+#ifndef STORAGE_LOGS_RINGLOG_H
+#define STORAGE_LOGS_RINGLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace logs {
+
+/**
+ * @brief Log cykliczny w jednym pliku o stałym rozmiarze („ostatnie N KiB zdarzeń”).
+ *
+ * Plik tworzony jest raz (wypełniony zerami) i później nie zmienia rozmiaru:
+ * `append` nadpisuje najstarsze rekordy zamiast dopisywać na końcu, więc
+ * nie przydziela klastrów/bloków, nie usuwa ani nie tworzy plików i ma
+ * stały koszt (jeden zapis + zwykle jeden odczyt 16 B nagłówka usuwanego
+ * rekordu). Zastępuje przełączanie dwóch plików (`remove` + ponowne
+ * utworzenie przy każdej zamianie). Na LittleFS nadpisanie i tak przepisuje
+ * modyfikowany blok (copy-on-write), ale bez zmian rozmiaru i katalogu.
+ *
+ * Układ pliku (little-endian):
+ *
+ *   0   dwa sloty nagłówka po 32 B: head, tail, zakres numerów rekordów,
+ *       licznik generacji (zapisywane naprzemiennie, ważny = z CRC i wyższą generacją)
+ *   64  obszar danych `capacity` B: rekordy 16 B nagłówka (numer, podpowiedź
+ *       tail, długość, CRC-32) + treść, wyrównane do 4 B; rekord nie jest
+ *       dzielony na końcu obszaru – zamiast tego znacznik zawinięcia
+ *
+ * Nagłówek pliku zapisywany jest w `flush()` (lub co `syncEvery` rekordów)
+ * oraz przy pierwszym `append` po nim – z flagą „nieaktualny”. Po awarii
+ * `open()` przegląda wtedy cały obszar danych, bierze rekord o najwyższym
+ * numerze (z poprawnym CRC) jako koniec logu, a początek – z zapisanej
+ * w nim podpowiedzi. Rekord przerwany w trakcie zapisu jest pomijany.
+ *
+ * @code
+ * storage::logs::RingLog events(flashFs, "/events.ring");   // 64 KiB
+ * events.open();
+ * events.append("wifi: reconnect");
+ * events.flush();                                           // np. co minutę
+ * events.forEach([](uint32_t seq, const uint8_t* data, size_t len) {
+ *     Serial.write(data, len);
+ *     return true;
+ * });
+ * @endcode
+ */
+class RingLog {
+public:
+    struct Config {
+        uint32_t capacity = 64 * 1024;  // obszar danych; zmiana = nowy, pusty plik
+        uint16_t maxRecord = 512;       // najdłuższa treść rekordu
+        uint32_t syncEvery = 0;         // zapis nagłówka co N rekordów (0 = tylko flush)
+    };
+
+    // Callback forEach; false = przerwij.
+    using RecordCallback = std::function<bool(uint32_t seq, const uint8_t* data, size_t len)>;
+
+    RingLog(IFileSystem& fs, const std::string& path);
+    RingLog(IFileSystem& fs, const std::string& path, const Config& cfg);
+    ~RingLog();
+
+    RingLog(const RingLog&) = delete;
+    RingLog& operator=(const RingLog&) = delete;
+
+    // Otwiera istniejący plik (z odtworzeniem po awarii) albo tworzy nowy.
+    bool open();
+    bool append(const void* data, size_t len);
+    bool append(const char* text);
+    bool flush();
+    void close();
+    bool clear();
+
+    // Rekordy od najstarszego do najnowszego. Zwraca liczbę przekazanych.
+    // W callbacku nie wolno wołać append().
+    size_t forEach(const RecordCallback& cb);
+
+    bool isOpen() const { return file != nullptr; }
+    uint32_t count() const { return next - first; }
+    uint32_t firstSeq() const { return first; }
+    uint32_t nextSeq() const { return next; }
+    uint32_t generation() const { return gen; }
+    uint32_t capacity() const { return cap; }
+
+private:
+    struct RecordHeader {
+        uint32_t seq;
+        uint32_t tail;
+        uint16_t len;
+        uint16_t check;
+        uint32_t crc;
+    };
+
+    IFileSystem& fs;
+    std::string path;
+    Config cfg;
+    uint32_t cap;
+
+    std::unique_ptr<IFile> file;
+    std::vector<uint8_t> buf;   // rekord do zapisu / odczytu
+    uint32_t head = 0;          // pozycja następnego rekordu (względem obszaru danych)
+    uint32_t tail = 0;          // pozycja najstarszego rekordu
+    uint32_t tailSize = 0;      // rozmiar rekordu w tail (0 = nieznany)
+    uint32_t first = 0;         // numer najstarszego rekordu
+    uint32_t next = 0;          // numer następnego rekordu
+    uint32_t gen = 0;
+    uint32_t unsynced = 0;
+    bool dirty = false;         // nagłówek na nośniku nieaktualny (flaga kRingDirty)
+
+    bool create();
+    bool load();
+    bool writeHeader(bool markDirty);
+    bool readRecordHeader(uint32_t pos, RecordHeader& h);
+    bool readRecord(uint32_t pos, const RecordHeader& h);
+    bool validRecord(uint32_t pos, RecordHeader& h, uint32_t lo, uint32_t hi);
+    void findTail();
+    uint32_t findValid(uint32_t from, uint32_t lo, RecordHeader& h);
+    uint32_t scanNewest(uint32_t lo, RecordHeader& newest);
+    bool evict();
+    bool reserve(uint32_t size);
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_RINGLOG_H
@@ -0,0 +1,150 @@
+#include "RotatingLog.h"
+#include "RetentionManager.h"
+#include "storage/Debug.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace storage {
+namespace logs {
+
+RotatingLog::RotatingLog(IFileSystem& f, std::function<uint32_t()> timeSource, RetentionManager* r)
+    : RotatingLog(f, std::move(timeSource), Config(), r) {
+}
+
+RotatingLog::RotatingLog(IFileSystem& f, std::function<uint32_t()> timeSource, const Config& c,
+                         RetentionManager* r)
+    : fs(f), clock(std::move(timeSource)), cfg(c), retention(r) {
+    while (cfg.root.size() > 1 && cfg.root.back() == '/') cfg.root.pop_back();
+    buf.reserve(cfg.bufferSize);
+}
+
+RotatingLog::~RotatingLog() {
+    close();
+}
+
+std::string RotatingLog::bucketPath(uint32_t now) const {
+    time_t t = static_cast<time_t>(now);
+    struct tm tmv;
+    localtime_r(&t, &tmv);
+    char name[96];
+    size_t n = strftime(name, sizeof(name), cfg.pattern.c_str(), &tmv);
+    if (!n) return std::string();
+    std::string p = cfg.root;
+    if (name[0] != '/') p += '/';
+    return p + name;
+}
+
+std::string RotatingLog::partPath(const std::string& basePath, uint32_t n) const {
+    if (!cfg.maxFileBytes) return basePath;
+    size_t slash = basePath.rfind('/');
+    size_t dot = basePath.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = basePath.size();
+    char num[12];
+    snprintf(num, sizeof(num), ".%lu", static_cast<unsigned long>(n));
+    return basePath.substr(0, dot) + num + basePath.substr(dot);
+}
+
+bool RotatingLog::rotate(const std::string& basePath, bool nextPart) {
+    if (file) {
+        file->close();
+        file.reset();
+    }
+    if (nextPart) {
+        part++;
+    } else {
+        base = basePath;
+        part = 0;
+        // po restarcie: kontynuacja ostatniej części okresu
+        while (cfg.maxFileBytes && fs.exists(partPath(base, part + 1))) part++;
+    }
+    path = partPath(base, part);
+
+    bool existed = fs.exists(path);
+    file = fs.openAppend(path);
+    if (!file) {
+        DBG("RotatingLog: cannot open %s", path.c_str());
+        return false;
+    }
+    fileSize = file->size();
+    DBG("RotatingLog: now writing %s (size=%u)", path.c_str(), (unsigned)fileSize);
+    if (retention) {
+        if (!existed) retention->track(path, 0, clock());
+        retention->setActive(path);
+    }
+    return true;
+}
+
+bool RotatingLog::writeOut() {
+    if (buf.empty() || !file) return buf.empty();
+    size_t n = file->write(buf.data(), buf.size());
+    fileSize += n;
+    if (retention && n) retention->grow(path, n);
+    bool ok = n == buf.size();
+    buf.clear();
+    return ok;
+}
+
+size_t RotatingLog::write(const void* data, size_t len) {
+    return append(data, len, nullptr, 0);
+}
+
+// Dwa fragmenty jako jeden wpis (np. linia i "\n") – nie są dzielone między pliki.
+size_t RotatingLog::append(const void* data, size_t len, const void* tail, size_t tailLen) {
+    size_t total = len + tailLen;
+    uint32_t now = clock();
+    if (now != lastSec || !file) {
+        lastSec = now;
+        std::string b = bucketPath(now);
+        if (b.empty()) return 0;
+        if (b != base || !file) {
+            writeOut();
+            if (!rotate(b, false)) return 0;
+        }
+    }
+    if (cfg.maxFileBytes && fileSize + buf.size() > 0 && fileSize + buf.size() + total > cfg.maxFileBytes) {
+        writeOut();
+        if (!rotate(base, true)) return 0;
+    }
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* t = static_cast<const uint8_t*>(tail);
+    if (total >= cfg.bufferSize) {
+        writeOut();
+        size_t n = file->write(p, len);
+        if (n == len && tailLen) n += file->write(t, tailLen);
+        fileSize += n;
+        if (retention && n) retention->grow(path, n);
+        return n;
+    }
+    buf.insert(buf.end(), p, p + len);
+    if (tailLen) buf.insert(buf.end(), t, t + tailLen);
+    if (buf.size() >= cfg.bufferSize) writeOut();
+    return total;
+}
+
+size_t RotatingLog::print(const char* text) {
+    return write(text, strlen(text));
+}
+
+size_t RotatingLog::println(const char* text) {
+    return append(text, strlen(text), "\n", 1);
+}
+
+bool RotatingLog::flush() {
+    bool ok = writeOut();
+    if (file) file->flush();
+    return ok;
+}
+
+void RotatingLog::close() {
+    if (!file) return;
+    flush();
+    file->close();
+    file.reset();
+    base.clear();
+}
+
+} // namespace logs
+} // namespace storage
@@ -0,0 +1,89 @@
+#ifndef STORAGE_LOGS_ROTATINGLOG_H
+#define STORAGE_LOGS_ROTATINGLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace logs {
+
+class RetentionManager;
+
+/**
+ * @brief Log dopisywany do plików przełączanych wg czasu i/lub rozmiaru.
+ *
+ * Ścieżka pliku to `root` + `pattern` sformatowany przez `strftime`
+ * (czas lokalny, TZ), np. `/logs` + `%Y-%m-%d/%H.log` → `/logs/2026-10-16/13.log`.
+ * Przy `maxFileBytes` > 0 pliki w obrębie jednego okresu są numerowane
+ * przed rozszerzeniem: `13.0.log`, `13.1.log`, ... (porządek naturalny
+ * nazw = porządek czasu, z czego korzysta `RetentionManager`).
+ *
+ * Zapis jest buforowany (`bufferSize`); plik pozostaje otwarty do rotacji.
+ * Z podpiętym `RetentionManager` każdy nowy plik i każdy zapis są zgłaszane
+ * do katalogu retencji, a bieżący plik jest chroniony przed usunięciem.
+ *
+ * @code
+ * storage::logs::RetentionManager::Policy keep;
+ * keep.maxTotalBytes = 512ull << 20;
+ * keep.maxAgeSec = 30 * 86400;
+ * storage::logs::RetentionManager retention(sdFs, "/logs", keep, now);
+ * storage::logs::RotatingLog log(sdFs, now, &retention);
+ * log.println("boot");
+ * // w pętli / zadaniu niskiego priorytetu:
+ * retention.step();
+ * @endcode
+ */
+class RotatingLog {
+public:
+    struct Config {
+        std::string root = "/logs";
+        std::string pattern = "%Y-%m-%d/%H.log";
+        uint32_t maxFileBytes = 0;  // 0 = tylko rotacja czasowa
+        size_t bufferSize = 512;
+    };
+
+    RotatingLog(IFileSystem& fs, std::function<uint32_t()> clock, RetentionManager* retention = nullptr);
+    RotatingLog(IFileSystem& fs, std::function<uint32_t()> clock, const Config& cfg,
+                RetentionManager* retention = nullptr);
+    ~RotatingLog();
+
+    RotatingLog(const RotatingLog&) = delete;
+    RotatingLog& operator=(const RotatingLog&) = delete;
+
+    size_t write(const void* data, size_t len);
+    size_t print(const char* text);
+    size_t println(const char* text);
+    bool flush();
+    void close();
+
+    const std::string& currentPath() const { return path; }
+
+private:
+    IFileSystem& fs;
+    std::function<uint32_t()> clock;
+    Config cfg;
+    RetentionManager* retention;
+
+    std::unique_ptr<IFile> file;
+    std::string base;     // ścieżka okresu (bez numeru części)
+    std::string path;     // bieżący plik
+    uint32_t part = 0;
+    uint32_t fileSize = 0;
+    uint32_t lastSec = UINT32_MAX;
+    std::vector<uint8_t> buf;
+
+    std::string bucketPath(uint32_t now) const;
+    std::string partPath(const std::string& basePath, uint32_t n) const;
+    bool rotate(const std::string& basePath, bool nextPart);
+    bool writeOut();
+    size_t append(const void* data, size_t len, const void* tail, size_t tailLen);
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_ROTATINGLOG_H
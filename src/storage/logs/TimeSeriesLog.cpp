@@ -0,0 +1,343 @@
+#include "TimeSeriesLog.h"
+#include "storage/Debug.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+namespace storage {
+namespace logs {
+
+namespace {
+
+const uint32_t kMagic = 0x314C5354; // "TSL1"
+const uint16_t kVersion = 1;
+
+// Układ nagłówka (40 B, little-endian):
+//   0 magic u32 | 4 version u16 | 6 payload u16 | 8 recordsPerBlock u16 | 10 reserved u16
+//  12 periodSec u32 | 16 count u32 | 20 reserved u32 | 24 firstMs u64 | 32 lastMs u64
+struct RawHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t payload;
+    uint16_t recordsPerBlock;
+    uint16_t reserved0;
+    uint32_t periodSec;
+    uint32_t count;
+    uint32_t reserved1;
+    uint64_t firstMs;
+    uint64_t lastMs;
+};
+static_assert(sizeof(RawHeader) == 40, "RawHeader layout");
+
+} // namespace
+
+constexpr uint32_t TimeSeriesLog::kHeaderSize;
+
+TimeSeriesLog::TimeSeriesLog(IFileSystem& f, const std::string& d, uint16_t payloadSize)
+    : TimeSeriesLog(f, d, payloadSize, Config()) {
+}
+
+TimeSeriesLog::TimeSeriesLog(IFileSystem& f, const std::string& d, uint16_t payloadSize, const Config& c)
+    : fs(f), dir(d), payload(payloadSize), stride(8u + payloadSize), cfg(c) {
+    static_assert(sizeof(RawHeader) == kHeaderSize, "kHeaderSize");
+    while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+    if (!cfg.filePeriodSec) cfg.filePeriodSec = 3600;
+    if (!cfg.recordsPerBlock) cfg.recordsPerBlock = 1;
+    block.reserve(static_cast<size_t>(cfg.recordsPerBlock) * stride);
+}
+
+TimeSeriesLog::~TimeSeriesLog() {
+    close();
+}
+
+std::string TimeSeriesLog::dataPath(uint32_t p) const {
+    char name[24];
+    snprintf(name, sizeof(name), "/%lu.tsl", static_cast<unsigned long>(p));
+    return dir + name;
+}
+
+std::string TimeSeriesLog::idxPath(uint32_t p) const {
+    char name[24];
+    snprintf(name, sizeof(name), "/%lu.idx", static_cast<unsigned long>(p));
+    return dir + name;
+}
+
+uint32_t TimeSeriesLog::periodOf(uint64_t tsMs) const {
+    uint64_t sec = tsMs / 1000;
+    return static_cast<uint32_t>(sec - sec % cfg.filePeriodSec);
+}
+
+void TimeSeriesLog::listPeriods() {
+    if (listed) return;
+    periods.clear();
+    fs.listDir(dir.c_str(), [this](const char* name, size_t) {
+        const char* dot = strrchr(name, '.');
+        if (!dot || strcmp(dot, ".tsl") != 0) return;
+        char* end = nullptr;
+        unsigned long p = strtoul(name, &end, 10);
+        if (end == dot) periods.push_back(static_cast<uint32_t>(p));
+    });
+    std::sort(periods.begin(), periods.end());
+    listed = true;
+}
+
+bool TimeSeriesLog::readHeader(IFile& f, Header& h) const {
+    uint32_t sz = f.size();
+    RawHeader raw;
+    if (sz < kHeaderSize || !f.seek(0) || f.read(&raw, sizeof(raw)) != sizeof(raw)) return false;
+    if (raw.magic != kMagic || raw.version != kVersion || raw.payload != payload) {
+        DBG("TimeSeriesLog: incompatible header (magic=%08x payload=%u)", (unsigned)raw.magic, raw.payload);
+        return false;
+    }
+    // inna ziarnistość indeksu lub okres pliku – indeks i nazwy plików znaczyłyby co innego
+    if (raw.recordsPerBlock != cfg.recordsPerBlock || raw.periodSec != cfg.filePeriodSec) {
+        DBG("TimeSeriesLog: incompatible header (recordsPerBlock=%u periodSec=%u)", raw.recordsPerBlock,
+            (unsigned)raw.periodSec);
+        return false;
+    }
+    h.count = (sz - kHeaderSize) / stride;
+    if (raw.count == h.count) {
+        h.firstMs = raw.firstMs;
+        h.lastMs = raw.lastMs;
+        return true;
+    }
+    // nagłówek nieaktualny (przerwany zapis) – zakres z rekordów
+    h.firstMs = h.lastMs = 0;
+    return !h.count || (readTs(f, 0, h.firstMs) && readTs(f, h.count - 1, h.lastMs));
+}
+
+bool TimeSeriesLog::readTs(IFile& f, uint32_t record, uint64_t& ts) const {
+    return f.seek(kHeaderSize + record * stride) && f.read(&ts, sizeof(ts)) == sizeof(ts);
+}
+
+bool TimeSeriesLog::writeHeader() {
+    RawHeader raw;
+    memset(&raw, 0, sizeof(raw));
+    raw.magic = kMagic;
+    raw.version = kVersion;
+    raw.payload = payload;
+    raw.recordsPerBlock = cfg.recordsPerBlock;
+    raw.periodSec = cfg.filePeriodSec;
+    raw.count = flushedCount;
+    // zakres tylko rekordów już zapisanych – nagłówek zgodny z rozmiarem pliku
+    raw.firstMs = flushedCount ? head.firstMs : 0;
+    raw.lastMs = 0;
+    if (flushedCount == head.count) {
+        raw.lastMs = head.lastMs;
+    } else if (flushedCount && !readTs(*data, flushedCount - 1, raw.lastMs)) {
+        return false;
+    }
+    if (!data->seek(0) || data->write(&raw, sizeof(raw)) != sizeof(raw)) return false;
+    headerDirty = flushedCount != head.count;
+    return true;
+}
+
+bool TimeSeriesLog::openPeriod(uint32_t p) {
+    close();
+    fs.mkdir(dir);
+    std::string path = dataPath(p);
+    bool existed = fs.exists(path);
+    data = fs.open(path, OpenMode::ReadWrite);
+    idx = data ? fs.open(idxPath(p), OpenMode::ReadWrite) : nullptr;
+    if (!data || !idx) {
+        DBG("TimeSeriesLog::openPeriod(%s) open failed", path.c_str());
+        data.reset();
+        idx.reset();
+        return false;
+    }
+
+    head = Header();
+    if (existed && data->size() > 0) {
+        if (!readHeader(*data, head)) {
+            data.reset();
+            idx.reset();
+            return false;
+        }
+    }
+    period = p;
+    flushedCount = head.count;
+    block.clear();
+
+    // indeks: brakujące wpisy (przerwany zapis) odtwarzane z rekordów
+    uint32_t expected = (head.count + cfg.recordsPerBlock - 1) / cfg.recordsPerBlock;
+    idxEntries = std::min<uint32_t>(idx->size() / 8, expected);
+    for (; idxEntries < expected; ++idxEntries) {
+        uint64_t ts;
+        if (!readTs(*data, idxEntries * cfg.recordsPerBlock, ts) || !idx->seek(idxEntries * 8) ||
+            idx->write(&ts, sizeof(ts)) != sizeof(ts)) {
+            data.reset();
+            idx.reset();
+            return false;
+        }
+    }
+
+    if (!existed || data->size() < kHeaderSize) {
+        if (!writeHeader()) return false;
+        if (listed && !std::binary_search(periods.begin(), periods.end(), p))
+            periods.insert(std::upper_bound(periods.begin(), periods.end(), p), p);
+    }
+    DBG("TimeSeriesLog::openPeriod(%s) records=%u", path.c_str(), (unsigned)head.count);
+    return true;
+}
+
+bool TimeSeriesLog::append(uint64_t tsMs, const void* rec) {
+    if (head.count && tsMs < head.lastMs) return false;
+    uint32_t p = periodOf(tsMs);
+    if (!data || p != period) {
+        if (data && p < period) return false;
+        if (!openPeriod(p)) return false;
+        if (head.count && tsMs < head.lastMs) return false;
+    }
+
+    size_t off = block.size();
+    block.resize(off + stride);
+    memcpy(&block[off], &tsMs, sizeof(tsMs));
+    memcpy(&block[off + 8], rec, payload);
+    if (!head.count) head.firstMs = tsMs;
+    head.lastMs = tsMs;
+    head.count++;
+    headerDirty = true;
+
+    // zapis całymi blokami indeksu
+    if (head.count % cfg.recordsPerBlock == 0) return writeBlock();
+    return true;
+}
+
+bool TimeSeriesLog::writeBlock() {
+    if (block.empty()) return true;
+    uint32_t n = static_cast<uint32_t>(block.size() / stride);
+    if (!data->seek(kHeaderSize + flushedCount * stride) || data->write(block.data(), block.size()) != block.size())
+        return false;
+    for (uint32_t i = 0; i < n; ++i) {
+        if ((flushedCount + i) % cfg.recordsPerBlock) continue;
+        if (!idx->seek(idxEntries * 8) || idx->write(&block[i * stride], 8) != 8) return false;
+        idxEntries++;
+    }
+    flushedCount += n;
+    block.clear();
+    return true;
+}
+
+bool TimeSeriesLog::flush() {
+    if (!data) return true;
+    bool ok = writeBlock();
+    if (ok && headerDirty) ok = writeHeader();
+    data->flush();
+    idx->flush();
+    return ok;
+}
+
+void TimeSeriesLog::close() {
+    if (!data) return;
+    flush();
+    data->close();
+    idx->close();
+    data.reset();
+    idx.reset();
+}
+
+bool TimeSeriesLog::scanFile(uint32_t p, uint64_t fromMs, uint64_t toMs, const RecordCallback& cb,
+                             size_t& delivered) {
+    std::unique_ptr<IFile> ownData, ownIdx;
+    IFile* df = nullptr;
+    IFile* xf = nullptr;
+    Header h;
+    if (data && p == period) {
+        // bieżący plik: te same uchwyty (drugie otwarcie pliku w zapisie nie jest bezpieczne)
+        if (!writeBlock()) return false;
+        df = data.get();
+        xf = idx.get();
+        h = head;
+    } else {
+        ownData = fs.open(dataPath(p), OpenMode::Read);
+        if (!ownData || !readHeader(*ownData, h)) return true;
+        ownIdx = fs.open(idxPath(p), OpenMode::Read);
+        df = ownData.get();
+        xf = ownIdx.get();
+    }
+    if (!h.count || h.lastMs < fromMs || h.firstMs > toMs) return true;
+
+    // ostatni blok, którego pierwszy rekord jest < fromMs
+    uint32_t blocks = (h.count + cfg.recordsPerBlock - 1) / cfg.recordsPerBlock;
+    if (xf) blocks = std::min<uint32_t>(blocks, xf->size() / 8);
+    uint32_t startBlock = 0;
+    if (xf && h.firstMs < fromMs) {
+        uint32_t lo = 0, hi = blocks; // szukamy pierwszego bloku z ts >= fromMs
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            uint64_t ts = 0;
+            if (!xf->seek(mid * 8) || xf->read(&ts, 8) != 8) break;
+            if (ts < fromMs) lo = mid + 1;
+            else hi = mid;
+        }
+        startBlock = lo ? lo - 1 : 0;
+    }
+
+    std::vector<uint8_t> buf(static_cast<size_t>(cfg.recordsPerBlock) * stride);
+    uint32_t rec = startBlock * cfg.recordsPerBlock;
+    if (!df->seek(kHeaderSize + rec * stride)) return false;
+    while (rec < h.count) {
+        uint32_t n = std::min<uint32_t>(cfg.recordsPerBlock, h.count - rec);
+        size_t got = df->read(buf.data(), n * stride) / stride;
+        if (!got) return false;
+        for (size_t i = 0; i < got; ++i) {
+            uint64_t ts;
+            memcpy(&ts, &buf[i * stride], sizeof(ts));
+            if (ts > toMs) return false;
+            if (ts < fromMs) continue;
+            delivered++;
+            if (!cb(ts, &buf[i * stride + 8])) return false;
+        }
+        rec += static_cast<uint32_t>(got);
+    }
+    return true;
+}
+
+size_t TimeSeriesLog::query(uint64_t fromMs, uint64_t toMs, const RecordCallback& cb) {
+    size_t delivered = 0;
+    if (fromMs > toMs) return 0;
+    listPeriods();
+    uint32_t first = periodOf(fromMs);
+    for (uint32_t p : periods) {
+        // pliki poza zakresem pomijane po nazwie, bez otwierania
+        if (p < first) continue;
+        if (static_cast<uint64_t>(p) * 1000 > toMs) break;
+        if (!scanFile(p, fromMs, toMs, cb, delivered)) break;
+    }
+    DBG("TimeSeriesLog::query(%llu..%llu) -> %u", (unsigned long long)fromMs, (unsigned long long)toMs,
+        (unsigned)delivered);
+    return delivered;
+}
+
+bool TimeSeriesLog::span(uint64_t& firstMs, uint64_t& lastMs) {
+    listPeriods();
+    bool haveFirst = false, haveLast = false;
+    auto headerOf = [this](uint32_t p, Header& h) {
+        if (data && p == period) {
+            h = head;
+            return true;
+        }
+        auto f = fs.open(dataPath(p), OpenMode::Read);
+        return f && readHeader(*f, h);
+    };
+    for (size_t i = 0; i < periods.size() && !haveFirst; ++i) {
+        Header h;
+        if (headerOf(periods[i], h) && h.count) {
+            firstMs = h.firstMs;
+            haveFirst = true;
+        }
+    }
+    for (size_t i = periods.size(); i > 0 && !haveLast; --i) {
+        Header h;
+        if (headerOf(periods[i - 1], h) && h.count) {
+            lastMs = h.lastMs;
+            haveLast = true;
+        }
+    }
+    return haveFirst && haveLast;
+}
+
+} // namespace logs
+} // namespace storage
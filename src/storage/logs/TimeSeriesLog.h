@@ -0,0 +1,121 @@
+#ifndef STORAGE_LOGS_TIMESERIESLOG_H
+#define STORAGE_LOGS_TIMESERIESLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace logs {
+
+/**
+ * @brief Binarny log szeregów czasowych o stałym rozmiarze rekordu.
+ *
+ * Rekord = znacznik czasu (uint64, ms Unix) + `payloadSize` bajtów.
+ * Dane dzielone są na pliki per okres (`filePeriodSec`, domyślnie godzina):
+ *
+ *   <dir>/<początek okresu, s>.tsl  – nagłówek 40 B + rekordy
+ *   <dir>/<początek okresu, s>.idx  – rzadki indeks: czas pierwszego rekordu
+ *                                     każdego bloku (`recordsPerBlock` rekordów)
+ *
+ * Nagłówek zawiera zakres czasu pliku, więc zapytanie `query(t1, t2)`:
+ * 1. pomija pliki po nazwie (okres) i po nagłówku (first/last),
+ * 2. w pliku szuka binarnie bloku w `.idx` (kilka odczytów po 8 B),
+ * 3. czyta sekwencyjnie od tego bloku do pierwszego rekordu > t2.
+ *
+ * Czas rekordów musi być niemalejący (`append` odrzuca cofnięcia).
+ * Rekordy trafiają na nośnik całymi blokami; nagłówek i indeks są
+ * aktualizowane przy `flush`/`close`. Po awarii liczba rekordów wynika
+ * z rozmiaru pliku, a brakujące wpisy indeksu są odtwarzane.
+ * Format jest little-endian (ESP32 i typowy host).
+ *
+ * Plik danych i indeks bieżącego okresu są trzymane otwarte (2 uchwyty).
+ *
+ * @code
+ * struct Sample { float temp; float hum; };
+ * storage::logs::TimeSeriesLog ts(sdFs, "/ts/env", sizeof(Sample));
+ * ts.append(nowMs, &sample);
+ * ts.query(nowMs - 3600000, nowMs, [](uint64_t t, const uint8_t* p) {
+ *     const Sample* s = reinterpret_cast<const Sample*>(p);
+ *     return true; // false = przerwij
+ * });
+ * @endcode
+ */
+class TimeSeriesLog {
+public:
+    struct Config {
+        uint32_t filePeriodSec = 3600;  // jeden plik na godzinę
+        uint16_t recordsPerBlock = 64;  // ziarnistość indeksu i zapisu
+    };
+
+    using RecordCallback = std::function<bool(uint64_t tsMs, const uint8_t* payload)>;
+
+    TimeSeriesLog(IFileSystem& fs, const std::string& dir, uint16_t payloadSize);
+    TimeSeriesLog(IFileSystem& fs, const std::string& dir, uint16_t payloadSize, const Config& cfg);
+    ~TimeSeriesLog();
+
+    TimeSeriesLog(const TimeSeriesLog&) = delete;
+    TimeSeriesLog& operator=(const TimeSeriesLog&) = delete;
+
+    bool append(uint64_t tsMs, const void* payload);
+    bool flush();
+    void close();
+
+    // Wywołuje cb dla rekordów z [fromMs, toMs] w kolejności czasu.
+    // Zwraca liczbę przekazanych rekordów.
+    size_t query(uint64_t fromMs, uint64_t toMs, const RecordCallback& cb);
+
+    // Zakres czasu całego logu; false = log pusty.
+    bool span(uint64_t& firstMs, uint64_t& lastMs);
+
+    uint16_t payloadSize() const { return payload; }
+    uint32_t recordSize() const { return stride; }
+
+    static constexpr uint32_t kHeaderSize = 40;
+
+private:
+    struct Header {
+        uint64_t firstMs = 0;
+        uint64_t lastMs = 0;
+        uint32_t count = 0;
+    };
+
+    IFileSystem& fs;
+    std::string dir;
+    uint16_t payload;
+    uint32_t stride;
+    Config cfg;
+
+    // bieżący plik do zapisu
+    std::unique_ptr<IFile> data;
+    std::unique_ptr<IFile> idx;
+    uint32_t period = 0;        // początek okresu otwartego pliku
+    Header head;
+    uint32_t flushedCount = 0;  // rekordy już zapisane na nośniku
+    uint32_t idxEntries = 0;
+    std::vector<uint8_t> block; // rekordy czekające na zapis
+    bool headerDirty = false;
+
+    std::vector<uint32_t> periods; // posortowane okresy obecne w katalogu
+    bool listed = false;
+
+    std::string dataPath(uint32_t periodStart) const;
+    std::string idxPath(uint32_t periodStart) const;
+    uint32_t periodOf(uint64_t tsMs) const;
+    void listPeriods();
+    bool openPeriod(uint32_t periodStart);
+    bool writeHeader();
+    bool writeBlock();
+    bool readHeader(IFile& f, Header& h) const;
+    bool readTs(IFile& f, uint32_t record, uint64_t& ts) const;
+    bool scanFile(uint32_t periodStart, uint64_t fromMs, uint64_t toMs, const RecordCallback& cb,
+                  size_t& delivered);
+};
+
+} // namespace logs
+} // namespace storage
+
+#endif // STORAGE_LOGS_TIMESERIESLOG_H
@@ -0,0 +1,80 @@
+#include "MemFile.h"
+#include "storage/Debug.h"
+
+#include <cstring>
+
+namespace storage {
+namespace mem {
+
+MemFile::MemFile(std::shared_ptr<MemNode> n, bool canRead, bool canWrite, std::function<uint32_t()> timeSource,
+                 FsMetrics* m)
+    : node(std::move(n)), readable(canRead), writable(canWrite), clock(std::move(timeSource)), metrics(m) {
+}
+
+MemFile::~MemFile() {
+    close();
+}
+
+size_t MemFile::read(void* buf, size_t size) {
+    MetricScope m(metrics, IoOp::Read);
+    if (!open || !readable || !size || pos >= node->data.size()) return 0;
+    size_t n = node->data.size() - pos;
+    if (n > size) n = size;
+    memcpy(buf, node->data.data() + pos, n);
+    pos += n;
+    m.bytes(n);
+    return n;
+}
+
+size_t MemFile::write(const void* buf, size_t size) {
+    MetricScope m(metrics, IoOp::Write);
+    if (!open || !writable) {
+        m.fail();
+        return 0;
+    }
+    if (!size) return 0; // pusty węzeł: data() == nullptr, memcpy tego nie dopuszcza
+    if (pos + size > node->data.size()) node->data.resize(pos + size);
+    memcpy(node->data.data() + pos, buf, size);
+    pos += size;
+    dirty = true;
+    m.bytes(size);
+    return size;
+}
+
+void MemFile::flush() {
+    MetricScope m(metrics, IoOp::Flush);
+    if (dirty && clock) node->modified = clock();
+    dirty = false;
+}
+
+bool MemFile::seek(uint32_t p) {
+    MetricScope m(metrics, IoOp::Seek);
+    if (!open || p > node->data.size()) {
+        m.fail();
+        return false;
+    }
+    pos = p;
+    return true;
+}
+
+uint32_t MemFile::position() {
+    return pos;
+}
+
+uint32_t MemFile::size() {
+    return static_cast<uint32_t>(node->data.size());
+}
+
+bool MemFile::isOpen() const {
+    return open;
+}
+
+void MemFile::close() {
+    if (!open) return;
+    MetricScope m(metrics, IoOp::Close);
+    flush();
+    open = false;
+}
+
+} // namespace mem
+} // namespace storage
@@ -0,0 +1,50 @@
+#ifndef STORAGE_MEM_MEMFILE_H
+#define STORAGE_MEM_MEMFILE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "storage/IFile.h"
+#include "storage/Metrics.h"
+
+namespace storage {
+namespace mem {
+
+// Zawartość pliku w RAM; współdzielona przez wszystkie otwarte uchwyty.
+struct MemNode {
+    std::vector<uint8_t> data;
+    uint32_t created = 0;
+    uint32_t modified = 0;
+};
+
+// Implementacja IFile nad MemNode
+class MemFile : public IFile {
+private:
+    std::shared_ptr<MemNode> node;
+    uint32_t pos = 0;
+    bool readable;
+    bool writable;
+    bool open = true;
+    bool dirty = false;
+    std::function<uint32_t()> clock;
+    FsMetrics* metrics;
+public:
+    MemFile(std::shared_ptr<MemNode> n, bool canRead, bool canWrite, std::function<uint32_t()> timeSource,
+            FsMetrics* m = nullptr);
+    ~MemFile() override;
+
+    size_t read(void* buf, size_t size) override;
+    size_t write(const void* buf, size_t size) override;
+    void flush() override;
+    bool seek(uint32_t pos) override;
+    uint32_t position() override;
+    uint32_t size() override;
+    bool isOpen() const override;
+    void close() override;
+};
+
+} // namespace mem
+} // namespace storage
+
+#endif // STORAGE_MEM_MEMFILE_H
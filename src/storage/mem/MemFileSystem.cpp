@@ -0,0 +1,209 @@
+#include "MemFileSystem.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <vector>
+
+namespace storage {
+namespace mem {
+
+using util::normalizePath;
+using util::parentPath;
+using util::baseName;
+
+MemFileSystem::MemFileSystem() {
+    dirs.insert("/");
+}
+
+void MemFileSystem::setTimeSource(std::function<uint32_t()> source) {
+    clock = std::move(source);
+}
+
+bool MemFileSystem::begin() {
+    DBG("MemFileSystem::begin()");
+    return true;
+}
+
+bool MemFileSystem::isDir(const std::string& path) const {
+    return dirs.count(path) > 0;
+}
+
+void MemFileSystem::ensureParentDirs(const std::string& path) {
+    std::string dir = parentPath(path);
+    while (!dir.empty() && !isDir(dir)) {
+        dirs.insert(dir);
+        dir = parentPath(dir);
+    }
+}
+
+bool MemFileSystem::listDir(const char* rawPath, std::function<void(const char*, size_t)> callback) {
+    std::string path = normalizePath(rawPath ? std::string(rawPath) : std::string("/"));
+    if (path.empty()) path = "/";
+    DBG("MemFileSystem::listDir(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::List);
+    if (!isDir(path)) {
+        m.fail();
+        return false;
+    }
+
+    // kopia nazw – callback może modyfikować system plików (np. remove)
+    std::vector<std::pair<std::string, size_t>> entries;
+    for (const auto& d : dirs) {
+        if (d != "/" && parentPath(d) == path) entries.emplace_back(baseName(d), 0);
+    }
+    for (const auto& f : files) {
+        if (parentPath(f.first) == path) entries.emplace_back(baseName(f.first), f.second->data.size());
+    }
+    for (const auto& e : entries) callback(e.first.c_str(), e.second);
+    return true;
+}
+
+bool MemFileSystem::exists(const std::string& rawPath) {
+    std::string path = normalizePath(rawPath);
+    MetricScope m(&stats, IoOp::Stat);
+    return !path.empty() && (files.count(path) || isDir(path));
+}
+
+bool MemFileSystem::remove(const std::string& rawPath) {
+    std::string path = normalizePath(rawPath);
+    DBG("MemFileSystem::remove(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Remove);
+    if (path.empty()) {
+        m.fail();
+        return false;
+    }
+    if (files.erase(path)) return true;
+    if (!isDir(path) || path == "/") {
+        m.fail();
+        return false;
+    }
+
+    std::string prefix = path + "/";
+    for (auto it = files.lower_bound(prefix); it != files.end() && it->first.compare(0, prefix.size(), prefix) == 0;)
+        it = files.erase(it);
+    for (auto it = dirs.lower_bound(prefix); it != dirs.end() && it->compare(0, prefix.size(), prefix) == 0;)
+        it = dirs.erase(it);
+    dirs.erase(path);
+    return true;
+}
+
+bool MemFileSystem::mkdir(const std::string& rawPath) {
+    std::string path = normalizePath(rawPath);
+    MetricScope m(&stats, IoOp::Mkdir);
+    if (path.empty() || path == "/") return true;
+    if (files.count(path)) {
+        m.fail();
+        return false;
+    }
+    ensureParentDirs(path);
+    dirs.insert(path);
+    return true;
+}
+
+bool MemFileSystem::rename(const std::string& rawFrom, const std::string& rawTo) {
+    std::string from = normalizePath(rawFrom);
+    std::string to = normalizePath(rawTo);
+    DBG("MemFileSystem::rename(from=%s, to=%s)", from.c_str(), to.c_str());
+    MetricScope m(&stats, IoOp::Rename);
+    if (from.empty() || to.empty() || files.count(to) || isDir(to)) {
+        m.fail();
+        return false;
+    }
+    auto it = files.find(from);
+    if (it != files.end()) {
+        ensureParentDirs(to);
+        files[to] = it->second;
+        files.erase(it);
+        return true;
+    }
+    if (!isDir(from) || from == "/") {
+        m.fail();
+        return false;
+    }
+
+    // katalog: przepisanie prefiksu wszystkich potomków
+    std::string prefix = from + "/";
+    std::map<std::string, std::shared_ptr<MemNode>> movedFiles;
+    std::set<std::string> movedDirs;
+    for (auto f = files.lower_bound(prefix); f != files.end() && f->first.compare(0, prefix.size(), prefix) == 0;) {
+        movedFiles[to + f->first.substr(from.size())] = f->second;
+        f = files.erase(f);
+    }
+    for (auto d = dirs.lower_bound(prefix); d != dirs.end() && d->compare(0, prefix.size(), prefix) == 0;) {
+        movedDirs.insert(to + d->substr(from.size()));
+        d = dirs.erase(d);
+    }
+    dirs.erase(from);
+    ensureParentDirs(to);
+    dirs.insert(to);
+    files.insert(movedFiles.begin(), movedFiles.end());
+    dirs.insert(movedDirs.begin(), movedDirs.end());
+    return true;
+}
+
+uint32_t MemFileSystem::getCreatedTimestamp(const std::string& rawPath) {
+    MetricScope m(&stats, IoOp::Stat);
+    auto it = files.find(normalizePath(rawPath));
+    return it != files.end() ? it->second->created : 0;
+}
+
+uint32_t MemFileSystem::getModifiedTimestamp(const std::string& rawPath) {
+    MetricScope m(&stats, IoOp::Stat);
+    auto it = files.find(normalizePath(rawPath));
+    return it != files.end() ? it->second->modified : 0;
+}
+
+std::unique_ptr<IFile> MemFileSystem::open(const std::string& rawPath, OpenMode mode) {
+    std::string path = normalizePath(rawPath);
+    DBG("MemFileSystem::open(path=%s, mode=%d)", path.c_str(), static_cast<int>(mode));
+    MetricScope m(&stats, IoOp::Open);
+    if (path.empty() || isDir(path)) {
+        m.fail();
+        return nullptr;
+    }
+
+    auto it = files.find(path);
+    if (it == files.end()) {
+        if (mode == OpenMode::Read) {
+            m.fail();
+            return nullptr;
+        }
+        ensureParentDirs(path);
+        auto node = std::make_shared<MemNode>();
+        node->created = node->modified = clock ? clock() : 0;
+        it = files.emplace(path, node).first;
+    }
+
+    std::shared_ptr<MemNode> node = it->second;
+    if (mode == OpenMode::WriteTruncate && !node->data.empty()) {
+        node->data.clear();
+        if (clock) node->modified = clock();
+    }
+
+    bool canRead = mode == OpenMode::Read || mode == OpenMode::ReadWrite;
+    bool canWrite = mode != OpenMode::Read;
+    std::unique_ptr<MemFile> f(new MemFile(node, canRead, canWrite, clock, &stats));
+    if (mode == OpenMode::WriteAppend) f->seek(f->size());
+    return f;
+}
+
+size_t MemFileSystem::totalBytes() const {
+    size_t total = 0;
+    for (const auto& f : files) total += f.second->data.size();
+    return total;
+}
+
+bool MemFileSystem::info(FsInfo& out) {
+    out = FsInfo();
+    if (!capacity) return false;
+    uint64_t used = totalBytes();
+    out.totalBytes = capacity;
+    out.freeBytes = used < capacity ? capacity - used : 0;
+    out.sectorSize = 1;
+    out.clusterSize = 1;
+    out.ioAlignment = 1;
+    return true;
+}
+
+} // namespace mem
+} // namespace storage
@@ -0,0 +1,65 @@
+#ifndef STORAGE_MEM_MEMFILESYSTEM_H
+#define STORAGE_MEM_MEMFILESYSTEM_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "storage/IFileSystem.h"
+#include "MemFile.h"
+
+namespace storage {
+namespace mem {
+
+/**
+ * @brief Implementacja IFileSystem w RAM (bez zależności od Arduino).
+ *
+ * Zachowuje się jak backendy SD/LittleFS: normalizuje ścieżki, tworzy
+ * katalogi rodzica przy zapisie, `remove` katalogu jest rekurencyjne,
+ * `rename` nie nadpisuje celu, `listDir` podaje nazwy bez ścieżki.
+ * Przeznaczona do testów i benchmarków w `[env:native]` oraz jako
+ * ulotny system plików na urządzeniu.
+ *
+ * Znaczniki czasu pochodzą z `setTimeSource` (domyślnie brak → 0).
+ * `setCapacity` deklaruje pojemność raportowaną przez `info()` (zapis
+ * nie jest ograniczany); bez niej `info()` zwraca false. Z flagą
+ * `ESP32_STORAGE_METRICS` operacje trafiają do `metrics()` jak w backendach.
+ */
+class MemFileSystem : public IFileSystem {
+private:
+    std::map<std::string, std::shared_ptr<MemNode>> files;
+    std::set<std::string> dirs;
+    std::function<uint32_t()> clock;
+    uint64_t capacity = 0;
+    FsMetrics stats{"mem"};
+
+    bool isDir(const std::string& path) const;
+    void ensureParentDirs(const std::string& path);
+public:
+    MemFileSystem();
+
+    void setTimeSource(std::function<uint32_t()> source);
+    bool begin() override;
+
+    bool listDir(const char* path, std::function<void(const char*, size_t)> callback) override;
+    bool exists(const std::string& path) override;
+    bool remove(const std::string& path) override;
+    bool mkdir(const std::string& path) override;
+    bool rename(const std::string& from, const std::string& to) override;
+    uint32_t getCreatedTimestamp(const std::string& path) override;
+    uint32_t getModifiedTimestamp(const std::string& path) override;
+
+    std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override;
+    bool info(FsInfo& out) override;
+    FsMetrics* metrics() override { return &stats; }
+
+    void setCapacity(uint64_t bytes) { capacity = bytes; }
+    size_t fileCount() const { return files.size(); }
+    size_t totalBytes() const;
+};
+
+} // namespace mem
+} // namespace storage
+
+#endif // STORAGE_MEM_MEMFILESYSTEM_H
@@ -0,0 +1,286 @@
+#include "SimulatedFileSystem.h"
+#include "storage/Debug.h"
+
+#include <chrono>
+#include <thread>
+
+namespace storage {
+namespace mem {
+
+namespace {
+thread_local uint64_t tlsChargedUs = 0;
+}
+
+void VirtualClock::advance(uint64_t us) {
+    if (!us) return;
+    now.fetch_add(us);
+    tlsChargedUs += us;
+    if (divisor) std::this_thread::sleep_for(std::chrono::microseconds(us / divisor));
+}
+
+uint64_t VirtualClock::threadUs() {
+    return tlsChargedUs;
+}
+
+void VirtualClock::resetThreadUs() {
+    tlsChargedUs = 0;
+}
+
+MediaModel MediaModel::sdCard() {
+    return MediaModel();
+}
+
+MediaModel MediaModel::spiFlash() {
+    MediaModel m;
+    m.sectorSize = 256;
+    m.eraseBlockSize = 4096;
+    m.readSectorUs = 10;
+    m.writeSectorUs = 700;
+    m.seekUs = 0;
+    m.eraseUs = 45000;
+    m.stallUs = 0;
+    m.stallChance = 0.0f;
+    m.openUs = 3000;   // LittleFS przechodzi po metadanych katalogu
+    m.closeUs = 500;
+    m.flushUs = 5000;  // commit metadanych
+    m.metaUs = 2000;
+    m.maxOpenFiles = 5;
+    return m;
+}
+
+MediaModel MediaModel::instant() {
+    MediaModel m;
+    m.readSectorUs = m.writeSectorUs = m.seekUs = m.eraseUs = m.stallUs = 0;
+    m.stallChance = 0.0f;
+    m.openUs = m.closeUs = m.flushUs = m.metaUs = 0;
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+
+SimulatedFileSystem::SimulatedFileSystem(IFileSystem& in, VirtualClock& c, const MediaModel& model)
+    : inner(in), clock(c), cfg(model), rng(model.seed ? model.seed : 1) {
+    if (!cfg.sectorSize) cfg.sectorSize = 1;
+    if (!cfg.eraseBlockSize) cfg.eraseBlockSize = cfg.sectorSize;
+}
+
+void SimulatedFileSystem::charge(uint32_t us) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        st.ops++;
+        st.busyUs += us;
+        if (us > st.maxOpUs) st.maxOpUs = us;
+    }
+    clock.advance(us);
+}
+
+uint32_t SimulatedFileSystem::nextRandom() {
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+uint32_t SimulatedFileSystem::readCost(uint32_t pos, size_t len, bool sequential) const {
+    if (!len) return 0;
+    uint32_t first = pos / cfg.sectorSize;
+    uint32_t last = static_cast<uint32_t>((pos + len - 1) / cfg.sectorSize);
+    return (sequential ? 0 : cfg.seekUs) + (last - first + 1) * cfg.readSectorUs;
+}
+
+uint32_t SimulatedFileSystem::writeCost(uint32_t pos, size_t len, bool sequential) {
+    if (!len) return 0;
+    uint32_t first = pos / cfg.sectorSize;
+    uint32_t last = static_cast<uint32_t>((pos + len - 1) / cfg.sectorSize);
+    uint32_t cost = (sequential ? 0 : cfg.seekUs) + (last - first + 1) * cfg.writeSectorUs;
+
+    // niepełne sektory na brzegach: najpierw odczyt
+    bool headPartial = pos % cfg.sectorSize != 0;
+    bool tailPartial = (pos + len) % cfg.sectorSize != 0;
+    if (headPartial) cost += cfg.readSectorUs;
+    if (tailPartial && (last != first || !headPartial)) cost += cfg.readSectorUs;
+
+    // Nośnik zapisuje jak log: nowy blok kasowania przy każdym przekroczeniu
+    // granicy, a zapis nieciągły od razu wymaga nowego bloku.
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!sequential) blockFill = 0;
+    size_t left = len;
+    while (left) {
+        if (!blockFill) {
+            st.erases++;
+            cost += cfg.eraseUs;
+            if (cfg.stallChance > 0.0f && (nextRandom() % 10000) < cfg.stallChance * 10000) {
+                st.stalls++;
+                cost += cfg.stallUs;
+            }
+        }
+        size_t take = cfg.eraseBlockSize - blockFill;
+        if (take > left) take = left;
+        blockFill = static_cast<uint32_t>((blockFill + take) % cfg.eraseBlockSize);
+        left -= take;
+    }
+    return cost;
+}
+
+void SimulatedFileSystem::fileClosed() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (st.openFiles) st.openFiles--;
+}
+
+SimulatedFileSystem::Stats SimulatedFileSystem::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return st;
+}
+
+void SimulatedFileSystem::resetStats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint8_t open = st.openFiles;
+    st = Stats();
+    st.openFiles = st.peakOpenFiles = open;
+}
+
+bool SimulatedFileSystem::begin() {
+    DBG("SimulatedFileSystem::begin()");
+    return inner.begin();
+}
+
+bool SimulatedFileSystem::listDir(const char* path, std::function<void(const char*, size_t)> callback) {
+    charge(cfg.metaUs);
+    return inner.listDir(path, callback);
+}
+
+bool SimulatedFileSystem::exists(const std::string& path) {
+    charge(cfg.metaUs);
+    return inner.exists(path);
+}
+
+bool SimulatedFileSystem::remove(const std::string& path) {
+    charge(cfg.metaUs);
+    return inner.remove(path);
+}
+
+bool SimulatedFileSystem::mkdir(const std::string& path) {
+    charge(cfg.metaUs);
+    return inner.mkdir(path);
+}
+
+bool SimulatedFileSystem::rename(const std::string& from, const std::string& to) {
+    charge(cfg.metaUs);
+    return inner.rename(from, to);
+}
+
+uint32_t SimulatedFileSystem::getCreatedTimestamp(const std::string& path) {
+    charge(cfg.metaUs);
+    return inner.getCreatedTimestamp(path);
+}
+
+uint32_t SimulatedFileSystem::getModifiedTimestamp(const std::string& path) {
+    charge(cfg.metaUs);
+    return inner.getModifiedTimestamp(path);
+}
+
+bool SimulatedFileSystem::info(FsInfo& out) {
+    charge(cfg.metaUs);
+    if (!inner.info(out)) return false;
+    // geometria z modelu nośnika, pojemność z systemu wewnętrznego
+    out.sectorSize = cfg.sectorSize;
+    out.ioAlignment = cfg.sectorSize;
+    return true;
+}
+
+std::unique_ptr<IFile> SimulatedFileSystem::open(const std::string& path, OpenMode mode) {
+    DBG("SimulatedFileSystem::open(path=%s, mode=%d)", path.c_str(), static_cast<int>(mode));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (cfg.maxOpenFiles && st.openFiles >= cfg.maxOpenFiles) {
+            st.rejectedOpens++;
+            DBG("SimulatedFileSystem::open too many open files (%u)", st.openFiles);
+            return nullptr;
+        }
+        // rezerwacja miejsca przed otwarciem (inne wątki widzą limit od razu)
+        st.openFiles++;
+        if (st.openFiles > st.peakOpenFiles) st.peakOpenFiles = st.openFiles;
+    }
+    charge(cfg.openUs);
+    std::unique_ptr<IFile> f = inner.open(path, mode);
+    if (!f) {
+        fileClosed();
+        return nullptr;
+    }
+    return std::unique_ptr<IFile>(new SimulatedFile(*this, std::move(f)));
+}
+
+// ---------------------------------------------------------------------------
+
+SimulatedFile::SimulatedFile(SimulatedFileSystem& owner, std::unique_ptr<IFile> inner)
+    : fs(owner), file(std::move(inner)) {
+    nextPos = file->position();
+}
+
+SimulatedFile::~SimulatedFile() {
+    close();
+}
+
+size_t SimulatedFile::read(void* buf, size_t size) {
+    if (!open) return 0;
+    uint32_t pos = file->position();
+    size_t n = file->read(buf, size);
+    fs.charge(fs.readCost(pos, n, pos == nextPos));
+    nextPos = pos + n;
+    return n;
+}
+
+size_t SimulatedFile::write(const void* buf, size_t size) {
+    if (!open) return 0;
+    uint32_t pos = file->position();
+    size_t n = file->write(buf, size);
+    fs.charge(fs.writeCost(pos, n, pos == nextPos));
+    nextPos = pos + n;
+    return n;
+}
+
+void SimulatedFile::flush() {
+    if (!open) return;
+    file->flush();
+    fs.charge(fs.cfg.flushUs);
+}
+
+bool SimulatedFile::seek(uint32_t pos) {
+    return open && file->seek(pos);
+}
+
+uint32_t SimulatedFile::position() {
+    return file->position();
+}
+
+uint32_t SimulatedFile::size() {
+    return file->size();
+}
+
+bool SimulatedFile::seek64(uint64_t pos) {
+    return open && file->seek64(pos);
+}
+
+uint64_t SimulatedFile::position64() {
+    return file->position64();
+}
+
+uint64_t SimulatedFile::size64() {
+    return file->size64();
+}
+
+bool SimulatedFile::isOpen() const {
+    return open && file->isOpen();
+}
+
+void SimulatedFile::close() {
+    if (!open) return;
+    open = false;
+    file->close();
+    fs.charge(fs.cfg.closeUs);
+    fs.fileClosed();
+}
+
+} // namespace mem
+} // namespace storage
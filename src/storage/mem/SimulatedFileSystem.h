@@ -0,0 +1,171 @@
+#ifndef STORAGE_MEM_SIMULATEDFILESYSTEM_H
+#define STORAGE_MEM_SIMULATEDFILESYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace mem {
+
+/**
+ * @brief Wirtualny zegar (µs) dla symulowanego nośnika.
+ *
+ * `advance` przesuwa czas zamiast czekać, więc test z setkami
+ * przestojów po 250 ms wykonuje się w milisekundach. Dodatkowo każdy
+ * wątek ma własny licznik czasu „naliczonego” (`threadUs`) – pozwala
+ * sprawdzić, ile opóźnień nośnika odczuł wątek aplikacji, a ile przejął
+ * wątek roboczy (IoScheduler, AsyncFile).
+ *
+ * `realTimeDivisor` > 0 dodatkowo usypia wątek na czas/realTimeDivisor,
+ * gdy test potrzebuje prawdziwej współbieżności (kolejki, back-pressure).
+ */
+class VirtualClock {
+public:
+    explicit VirtualClock(uint32_t realTimeDivisor = 0) : divisor(realTimeDivisor) {}
+
+    uint64_t nowUs() const { return now.load(); }
+    uint32_t millis() const { return static_cast<uint32_t>(now.load() / 1000); }
+    uint32_t seconds() const { return static_cast<uint32_t>(now.load() / 1000000); }
+
+    void advance(uint64_t us);
+
+    // Czas naliczony wątkowi wywołującemu (suma wszystkich zegarów).
+    static uint64_t threadUs();
+    static void resetThreadUs();
+
+private:
+    std::atomic<uint64_t> now{0};
+    uint32_t divisor;
+};
+
+/**
+ * @brief Parametry nośnika. Wartości domyślne odpowiadają karcie SD w SPI.
+ *
+ * - odczyt/zapis kosztuje za każdy dotknięty sektor,
+ * - zapis niepełnego sektora wymaga odczytu (read-modify-write),
+ * - nieciągły dostęp kosztuje `seekUs`,
+ * - zapis w nowym bloku kasowania kosztuje `eraseUs`, a z prawdopodobieństwem
+ *   `stallChance` dodatkowo `stallUs` (wewnętrzne GC karty),
+ * - `maxOpenFiles` ogranicza liczbę jednocześnie otwartych plików (0 = brak).
+ */
+struct MediaModel {
+    uint32_t sectorSize = 512;
+    uint32_t eraseBlockSize = 64 * 1024;
+    uint32_t readSectorUs = 200;
+    uint32_t writeSectorUs = 250;
+    uint32_t seekUs = 50;
+    uint32_t eraseUs = 2000;
+    uint32_t stallUs = 250000;
+    float stallChance = 0.02f;
+    uint32_t openUs = 1500;
+    uint32_t closeUs = 1000;
+    uint32_t flushUs = 2000;
+    uint32_t metaUs = 800;     // exists/remove/mkdir/rename/listDir/timestampy
+    uint8_t maxOpenFiles = 0;
+    uint32_t seed = 1;         // PRNG przestojów – powtarzalne przebiegi
+
+    static MediaModel sdCard();
+    static MediaModel spiFlash(); // LittleFS: strony 256 B, kasowanie 4 KiB, 5 otwartych plików
+    static MediaModel instant();  // zerowe opóźnienia, tylko limity
+};
+
+/**
+ * @brief Dekorator IFileSystem modelujący opóźnienia nośnika na wirtualnym zegarze.
+ *
+ * Dane trzyma system wewnętrzny (zwykle MemFileSystem); ten obiekt tylko
+ * nalicza czas i wymusza limit otwartych plików. Stan modelu jest chroniony
+ * mutexem, ale system wewnętrzny nie – równoległy dostęp z wielu wątków
+ * należy szeregować tak jak na urządzeniu (np. przez IoScheduler).
+ *
+ * @code
+ * storage::mem::MemFileSystem ram;
+ * storage::mem::VirtualClock clock;
+ * storage::mem::SimulatedFileSystem sd(ram, clock, storage::mem::MediaModel::sdCard());
+ * auto f = sd.openWrite("/log.txt");
+ * f->write(buf, 100);          // clock.nowUs() rośnie o koszt zapisu
+ * sd.stats().stalls;           // liczba przestojów GC
+ * @endcode
+ */
+class SimulatedFileSystem : public IFileSystem {
+public:
+    struct Stats {
+        uint32_t ops = 0;
+        uint32_t stalls = 0;
+        uint32_t erases = 0;
+        uint32_t rejectedOpens = 0;
+        uint64_t busyUs = 0;
+        uint32_t maxOpUs = 0;
+        uint8_t openFiles = 0;
+        uint8_t peakOpenFiles = 0;
+    };
+
+    SimulatedFileSystem(IFileSystem& inner, VirtualClock& clock, const MediaModel& model = MediaModel());
+
+    bool begin() override;
+    bool listDir(const char* path, std::function<void(const char*, size_t)> callback) override;
+    bool exists(const std::string& path) override;
+    bool remove(const std::string& path) override;
+    bool mkdir(const std::string& path) override;
+    bool rename(const std::string& from, const std::string& to) override;
+    uint32_t getCreatedTimestamp(const std::string& path) override;
+    uint32_t getModifiedTimestamp(const std::string& path) override;
+
+    std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override;
+    bool info(FsInfo& out) override;
+
+    const MediaModel& model() const { return cfg; }
+    Stats stats() const;
+    void resetStats();
+
+private:
+    friend class SimulatedFile;
+
+    IFileSystem& inner;
+    VirtualClock& clock;
+    MediaModel cfg;
+    mutable std::mutex mtx;
+    Stats st;
+    uint32_t rng;
+    uint32_t blockFill = 0; // bajty w bieżącym bloku kasowania (0 = potrzebny nowy)
+
+    void charge(uint32_t us);
+    uint32_t readCost(uint32_t pos, size_t len, bool sequential) const;
+    uint32_t writeCost(uint32_t pos, size_t len, bool sequential);
+    void fileClosed();
+    uint32_t nextRandom();
+};
+
+// Plik symulowanego systemu – nalicza koszt każdej operacji na pliku wewnętrznym.
+class SimulatedFile : public IFile {
+public:
+    SimulatedFile(SimulatedFileSystem& fs, std::unique_ptr<IFile> inner);
+    ~SimulatedFile() override;
+
+    size_t read(void* buf, size_t size) override;
+    size_t write(const void* buf, size_t size) override;
+    void flush() override;
+    bool seek(uint32_t pos) override;
+    uint32_t position() override;
+    uint32_t size() override;
+    bool seek64(uint64_t pos) override;
+    uint64_t position64() override;
+    uint64_t size64() override;
+    bool isOpen() const override;
+    void close() override;
+
+private:
+    SimulatedFileSystem& fs;
+    std::unique_ptr<IFile> file;
+    uint32_t nextPos = 0;   // pozycja, przy której dostęp jest sekwencyjny
+    bool open = true;
+};
+
+} // namespace mem
+} // namespace storage
+
+#endif // STORAGE_MEM_SIMULATEDFILESYSTEM_H
@@ -0,0 +1,129 @@
+#include "FirmwareSink.h"
+#include "storage/Debug.h"
+
+namespace storage {
+namespace ota {
+
+// ------------------- MemorySink -------------------
+
+bool MemorySink::begin(uint32_t size) {
+    buf.clear();
+    buf.reserve(size);
+    done = false;
+    return true;
+}
+
+bool MemorySink::write(const uint8_t* data, size_t len) {
+    buf.insert(buf.end(), data, data + len);
+    return true;
+}
+
+bool MemorySink::commit() {
+    done = true;
+    return true;
+}
+
+void MemorySink::abort() {
+    buf.clear();
+    done = false;
+}
+
+// ------------------- FileSink -------------------
+
+FileSink::FileSink(IFileSystem& f, const std::string& p) : fs(f), path(p), partPath(p + ".part") {
+}
+
+FileSink::~FileSink() {
+    if (file) abort();
+}
+
+bool FileSink::begin(uint32_t /*size*/) {
+    DBG("FileSink::begin(path=%s)", path.c_str());
+    recover(fs, path);
+    file = fs.openWrite(partPath);
+    return static_cast<bool>(file);
+}
+
+bool FileSink::write(const uint8_t* data, size_t len) {
+    return file && file->write(data, len) == len;
+}
+
+bool FileSink::commit() {
+    if (!file) return false;
+    file->flush();
+    file->close();
+    file.reset();
+    // jak IniWriter::commit: stary obraz do .bak, .part na miejsce, usunięcie .bak –
+    // w każdej chwili istnieje path albo .bak (recover)
+    std::string bak = path + ".bak";
+    bool hadOld = fs.exists(path);
+    if (hadOld && !fs.rename(path, bak)) return false;
+    bool ok = fs.rename(partPath, path);
+    if (!ok && hadOld) fs.rename(bak, path);
+    if (ok && hadOld) fs.remove(bak);
+    DBG("FileSink::commit(%s) -> %d", path.c_str(), ok);
+    return ok;
+}
+
+bool FileSink::recover(IFileSystem& fs, const std::string& path) {
+    std::string bak = path + ".bak";
+    bool ok = true;
+    if (fs.exists(bak)) {
+        if (!fs.exists(path)) ok = fs.rename(bak, path); // przerwane między rename
+        else fs.remove(bak);                              // przerwane po podmianie
+    }
+    return ok;
+}
+
+void FileSink::abort() {
+    DBG("FileSink::abort(%s)", path.c_str());
+    if (file) {
+        file->close();
+        file.reset();
+    }
+    fs.remove(partPath);
+}
+
+// ------------------- OtaSink -------------------
+
+#ifdef ESP_PLATFORM
+OtaSink::~OtaSink() {
+    if (active) abort();
+}
+
+bool OtaSink::begin(uint32_t size) {
+    target = esp_ota_get_next_update_partition(nullptr);
+    if (!target || size > target->size) {
+        DBG("OtaSink::begin: no partition for %u bytes", (unsigned)size);
+        return false;
+    }
+    esp_err_t err = esp_ota_begin(target, size, &handle);
+    DBG("OtaSink::begin(%s, size=%u) -> %d", target->label, (unsigned)size, err);
+    active = err == ESP_OK;
+    return active;
+}
+
+bool OtaSink::write(const uint8_t* data, size_t len) {
+    return active && esp_ota_write(handle, data, len) == ESP_OK;
+}
+
+bool OtaSink::commit() {
+    if (!active) return false;
+    active = false;
+    // esp_ota_end sprawdza też nagłówek i sumę obrazu aplikacji
+    esp_err_t err = esp_ota_end(handle);
+    if (err == ESP_OK) err = esp_ota_set_boot_partition(target);
+    DBG("OtaSink::commit -> %d", err);
+    return err == ESP_OK;
+}
+
+void OtaSink::abort() {
+    if (!active) return;
+    active = false;
+    esp_ota_abort(handle);
+    DBG("OtaSink::abort()");
+}
+#endif
+
+} // namespace ota
+} // namespace storage
@@ -0,0 +1,97 @@
+#ifndef STORAGE_OTA_FIRMWARESINK_H
+#define STORAGE_OTA_FIRMWARESINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_ota_ops.h>
+#endif
+
+namespace storage {
+namespace ota {
+
+/**
+ * @brief Miejsce docelowe obrazu firmware dla `FirmwareStager`.
+ *
+ * Kolejność wywołań: `begin(size)`, `write` (blokami, w kolejności),
+ * a na końcu `commit()` (suma kontrolna zgodna) albo `abort()`.
+ * `write` wywoływane jest z wątku roboczego stagera.
+ */
+class IFirmwareSink {
+public:
+    virtual ~IFirmwareSink() = default;
+
+    virtual bool begin(uint32_t size) = 0;
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+    virtual bool commit() = 0;
+    virtual void abort() = 0;
+};
+
+// Obraz w RAM (testy, małe obrazy).
+class MemorySink : public IFirmwareSink {
+public:
+    bool begin(uint32_t size) override;
+    bool write(const uint8_t* data, size_t len) override;
+    bool commit() override;
+    void abort() override;
+
+    const std::vector<uint8_t>& data() const { return buf; }
+    bool committed() const { return done; }
+
+private:
+    std::vector<uint8_t> buf;
+    bool done = false;
+};
+
+// Obraz w pliku: zapis do `<path>.part`, przy commit zamiana na `path` przez `<path>.bak`
+// (jak IniWriter). Po przerwanym commit `recover` przywraca poprzedni obraz.
+class FileSink : public IFirmwareSink {
+public:
+    FileSink(IFileSystem& fs, const std::string& path);
+    ~FileSink() override;
+
+    bool begin(uint32_t size) override;
+    bool write(const uint8_t* data, size_t len) override;
+    bool commit() override;
+    void abort() override;
+
+    // Wołane przez begin(); przed odczytem obrazu po starcie też warto.
+    static bool recover(IFileSystem& fs, const std::string& path);
+
+private:
+    IFileSystem& fs;
+    std::string path;
+    std::string partPath;
+    std::unique_ptr<IFile> file;
+};
+
+#ifdef ESP_PLATFORM
+// Następna partycja OTA (ota_0/ota_1 z partitions.csv); commit ustawia ją jako rozruchową.
+class OtaSink : public IFirmwareSink {
+public:
+    OtaSink() = default;
+    ~OtaSink() override;
+
+    bool begin(uint32_t size) override;
+    bool write(const uint8_t* data, size_t len) override;
+    bool commit() override;
+    void abort() override;
+
+    const esp_partition_t* partition() const { return target; }
+
+private:
+    const esp_partition_t* target = nullptr;
+    esp_ota_handle_t handle = 0;
+    bool active = false;
+};
+#endif
+
+} // namespace ota
+} // namespace storage
+
+#endif // STORAGE_OTA_FIRMWARESINK_H
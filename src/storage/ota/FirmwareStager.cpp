@@ -0,0 +1,154 @@
+#include "FirmwareStager.h"
+#include "storage/Debug.h"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef ESP_PLATFORM
+#include <esp_pthread.h>
+#endif
+
+namespace storage {
+namespace ota {
+
+FirmwareStager::FirmwareStager() : FirmwareStager(Config()) {}
+
+FirmwareStager::FirmwareStager(const Config& c) : cfg(c) {
+    if (cfg.blocks < 2) cfg.blocks = 2;
+    if (!cfg.blockSize) cfg.blockSize = 4096;
+}
+
+void FirmwareStager::writerLoop(IFirmwareSink& sink) {
+    size_t tail = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return filled > 0 || producerDone; });
+            if (!filled) return; // producent skończył, wszystko zapisane
+        }
+        // slot `tail` należy do tego wątku, dopóki nie zmniejszymy `filled`
+        Slot& s = ring[tail];
+        bool ok = sink.write(s.data.get(), s.len);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            filled--;
+            if (!ok) sinkFailed = true;
+        }
+        cv.notify_all();
+        if (!ok) {
+            DBG("FirmwareStager: sink write failed");
+            return;
+        }
+        tail = (tail + 1) % ring.size();
+    }
+}
+
+FirmwareStager::Result FirmwareStager::stage(IFile& src, IFirmwareSink& sink, const uint8_t* expected,
+                                             Progress progress) {
+    Result res;
+    uint32_t total = src.size();
+    DBG("FirmwareStager::stage(size=%u, block=%u, blocks=%u)", (unsigned)total, (unsigned)cfg.blockSize,
+        (unsigned)cfg.blocks);
+
+    if (ring.size() != cfg.blocks) {
+        ring.clear();
+        ring.resize(cfg.blocks);
+        for (auto& s : ring) {
+            s.data.reset(new (std::nothrow) uint8_t[cfg.blockSize]);
+            if (!s.data) {
+                ring.clear();
+                res.status = Status::NoMemory;
+                return res;
+            }
+        }
+    }
+    if (!src.seek(0)) {
+        res.status = Status::ReadError;
+        return res;
+    }
+    if (!sink.begin(total)) {
+        res.status = Status::SinkError;
+        return res;
+    }
+
+    filled = 0;
+    producerDone = false;
+    sinkFailed = false;
+
+#ifdef ESP_PLATFORM
+    esp_pthread_cfg_t pcfg = esp_pthread_get_default_config();
+    pcfg.stack_size = cfg.stackSize;
+    pcfg.prio = cfg.taskPriority;
+    pcfg.pin_to_core = cfg.core;
+    pcfg.thread_name = "fw-stage";
+    esp_pthread_set_cfg(&pcfg);
+#endif
+    std::thread writer([this, &sink] { writerLoop(sink); });
+#ifdef ESP_PLATFORM
+    pcfg = esp_pthread_get_default_config();
+    esp_pthread_set_cfg(&pcfg);
+#endif
+
+    Sha256 hash;
+    size_t head = 0;
+    bool readFailed = false;
+    while (res.bytes < total) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return filled < ring.size() || sinkFailed; });
+            if (sinkFailed) break;
+        }
+        Slot& s = ring[head];
+        size_t want = total - res.bytes < cfg.blockSize ? total - res.bytes : cfg.blockSize;
+        s.len = src.read(s.data.get(), want);
+        if (s.len != want) {
+            DBG("FirmwareStager: short read at %u", (unsigned)res.bytes);
+            readFailed = true;
+            break;
+        }
+        hash.update(s.data.get(), s.len);
+        res.bytes += static_cast<uint32_t>(s.len);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            filled++;
+        }
+        cv.notify_all();
+        head = (head + 1) % ring.size();
+        if (progress) progress(res.bytes, total);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        producerDone = true;
+    }
+    cv.notify_all();
+    writer.join();
+
+    hash.finish(res.digest);
+    if (readFailed) {
+        res.status = Status::ReadError;
+    } else if (sinkFailed) {
+        res.status = Status::SinkError;
+    } else if (expected && memcmp(expected, res.digest, Sha256::kDigestSize) != 0) {
+        res.status = Status::DigestMismatch;
+    } else {
+        res.status = sink.commit() ? Status::Ok : Status::SinkError;
+        DBG("FirmwareStager::stage done, status=%d", static_cast<int>(res.status));
+        return res;
+    }
+    sink.abort();
+    DBG("FirmwareStager::stage failed, status=%d", static_cast<int>(res.status));
+    return res;
+}
+
+bool FirmwareStager::loadDigest(IFileSystem& fs, const std::string& path, uint8_t out[Sha256::kDigestSize]) {
+    auto f = fs.openRead(path);
+    if (!f) return false;
+    char hex[Sha256::kDigestSize * 2 + 1];
+    if (f->read(hex, sizeof(hex) - 1) != sizeof(hex) - 1) return false;
+    hex[sizeof(hex) - 1] = '\0';
+    return Sha256::fromHex(hex, out);
+}
+
+} // namespace ota
+} // namespace storage
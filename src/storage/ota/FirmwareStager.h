@@ -0,0 +1,99 @@
+#ifndef STORAGE_OTA_FIRMWARESTAGER_H
+#define STORAGE_OTA_FIRMWARESTAGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "storage/IFileSystem.h"
+#include "FirmwareSink.h"
+#include "Sha256.h"
+
+namespace storage {
+namespace ota {
+
+/**
+ * @brief Potokowe przeniesienie obrazu firmware z `IFile` do `IFirmwareSink`.
+ *
+ * Pierścień `blocks` buforów po `blockSize` bajtów:
+ * - wątek wywołujący czyta blok z pliku i liczy jego SHA-256,
+ * - wątek roboczy w tym czasie zapisuje poprzednie bloki do ujścia.
+ *
+ * Odczyt z SD, haszowanie i zapis flash nakładają się w czasie zamiast
+ * następować po sobie. Ujście dostaje `commit()` dopiero wtedy, gdy wszystkie
+ * bloki są zapisane, a skrót całego obrazu zgadza się z oczekiwanym.
+ * W przeciwnym razie wywoływane jest `abort()`.
+ *
+ * @code
+ * uint8_t expected[storage::ota::Sha256::kDigestSize];
+ * storage::ota::FirmwareStager::loadDigest(sdFs, "/fw/app.bin.sha256", expected);
+ * auto img = sdFs.openRead("/fw/app.bin");
+ * storage::ota::OtaSink ota;
+ * storage::ota::FirmwareStager stager;
+ * auto r = stager.stage(*img, ota, expected);
+ * if (r.status == storage::ota::FirmwareStager::Status::Ok) ESP.restart();
+ * @endcode
+ */
+class FirmwareStager {
+public:
+    struct Config {
+        size_t blockSize = 4096;    // wielokrotność sektora flash
+        uint8_t blocks = 4;         // rozmiar pierścienia (min. 2)
+        uint32_t stackSize = 4096;  // tylko ESP32
+        int taskPriority = 5;       // tylko ESP32
+        int core = -1;              // tylko ESP32, -1 = dowolny
+    };
+
+    enum class Status : uint8_t {
+        Ok,
+        ReadError,       // krótki odczyt z pliku źródłowego
+        SinkError,       // begin/write/commit ujścia zawiodło
+        DigestMismatch,  // obraz zapisany, ale skrót niezgodny – abort()
+        NoMemory,
+    };
+
+    struct Result {
+        Status status = Status::ReadError;
+        uint32_t bytes = 0;
+        uint8_t digest[Sha256::kDigestSize] = {};
+    };
+
+    // Postęp: bajty przeczytane i zhaszowane / rozmiar obrazu (wątek wywołujący).
+    using Progress = std::function<void(uint32_t done, uint32_t total)>;
+
+    FirmwareStager();
+    explicit FirmwareStager(const Config& cfg);
+
+    FirmwareStager(const FirmwareStager&) = delete;
+    FirmwareStager& operator=(const FirmwareStager&) = delete;
+
+    // `expected` = nullptr: bez weryfikacji (tylko policzenie skrótu).
+    Result stage(IFile& src, IFirmwareSink& sink, const uint8_t* expected, Progress progress = nullptr);
+
+    // Plik w formacie `sha256sum`: 64 znaki hex, opcjonalnie dalej nazwa pliku.
+    static bool loadDigest(IFileSystem& fs, const std::string& path, uint8_t out[Sha256::kDigestSize]);
+
+private:
+    struct Slot {
+        std::unique_ptr<uint8_t[]> data;
+        size_t len = 0;
+    };
+
+    Config cfg;
+    std::vector<Slot> ring;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t filled = 0;        // bloki czekające na zapis
+    bool producerDone = false;
+    bool sinkFailed = false;
+
+    void writerLoop(IFirmwareSink& sink);
+};
+
+} // namespace ota
+} // namespace storage
+
+#endif // STORAGE_OTA_FIRMWARESTAGER_H
@@ -0,0 +1,47 @@
+#ifndef STORAGE_OTA_SHA256_H
+#define STORAGE_OTA_SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace storage {
+namespace ota {
+
+/**
+ * @brief SHA-256 (FIPS 180-4) liczony strumieniowo, bez zależności od platformy.
+ *
+ * @code
+ * storage::ota::Sha256 h;
+ * h.update(buf, len);             // dowolnie wiele razy
+ * uint8_t digest[storage::ota::Sha256::kDigestSize];
+ * h.finish(digest);
+ * @endcode
+ */
+class Sha256 {
+public:
+    static const size_t kDigestSize = 32;
+    static const size_t kBlockSize = 64;
+
+    Sha256() { reset(); }
+
+    void reset();
+    void update(const void* data, size_t len);
+    void finish(uint8_t out[kDigestSize]); // po finish() potrzebny reset()
+
+    // 64 znaki hex (wielkość liter dowolna, białe znaki na końcu ignorowane).
+    static bool fromHex(const char* hex, uint8_t out[kDigestSize]);
+    static void toHex(const uint8_t digest[kDigestSize], char out[kDigestSize * 2 + 1]);
+
+private:
+    uint32_t state[8];
+    uint64_t total;
+    uint8_t buf[kBlockSize];
+    size_t used;
+
+    void compress(const uint8_t* block);
+};
+
+} // namespace ota
+} // namespace storage
+
+#endif // STORAGE_OTA_SHA256_H
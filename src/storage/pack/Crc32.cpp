@@ -0,0 +1,30 @@
+#include "Crc32.h"
+
+namespace storage {
+namespace pack {
+
+namespace {
+
+struct CrcTable {
+    uint32_t t[256];
+    CrcTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+    }
+};
+
+} // namespace
+
+uint32_t Crc32::update(uint32_t crc, const void* data, size_t len) {
+    static const CrcTable table;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) crc = table.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+} // namespace pack
+} // namespace storage
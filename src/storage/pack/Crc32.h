@@ -0,0 +1,26 @@
+#ifndef STORAGE_PACK_CRC32_H
+#define STORAGE_PACK_CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace storage {
+namespace pack {
+
+/**
+ * @brief CRC-32 (IEEE 802.3, jak zlib/zip) z tablicą 1 KiB.
+ *
+ * @code
+ * uint32_t c = storage::pack::Crc32::update(0, buf, len);  // dowolnie wiele razy
+ * @endcode
+ */
+class Crc32 {
+public:
+    // crc = 0 dla pierwszego fragmentu, dalej wynik poprzedniego wywołania.
+    static uint32_t update(uint32_t crc, const void* data, size_t len);
+};
+
+} // namespace pack
+} // namespace storage
+
+#endif // STORAGE_PACK_CRC32_H
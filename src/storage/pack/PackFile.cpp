@@ -0,0 +1,456 @@
+#include "PackFile.h"
+#include "Crc32.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace storage {
+namespace pack {
+
+namespace {
+
+const uint32_t kPackMagic = 0x314B4150; // "PAK1"
+const uint16_t kPackVersion = 1;
+const size_t kCopyBlock = 4096;
+
+struct RawFooter {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t entries;
+    uint32_t indexOffset;
+    uint32_t namesBytes;
+    uint32_t deadBytes;
+    uint32_t indexCrc;
+};
+static_assert(sizeof(RawFooter) == 28, "RawFooter layout");
+static_assert(sizeof(PackIndexEntry) == 24, "PackIndexEntry layout");
+
+uint32_t hashName(const char* name, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<uint8_t>(name[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Nazwa wpisu bez wiodących '/'.
+const char* entryName(const std::string& name) {
+    const char* p = name.c_str();
+    while (*p == '/') ++p;
+    return p;
+}
+
+bool footerAt(IFile& f, uint32_t pos, RawFooter& ft) {
+    if (!f.seek(pos) || f.read(&ft, sizeof(ft)) != sizeof(ft)) return false;
+    if (ft.magic != kPackMagic || ft.version != kPackVersion) return false;
+    uint64_t indexEnd = static_cast<uint64_t>(ft.indexOffset) + static_cast<uint64_t>(ft.entries) * sizeof(PackIndexEntry) +
+                        ft.namesBytes;
+    return indexEnd == pos;
+}
+
+bool loadIndex(IFile& f, const RawFooter& ft, std::vector<PackIndexEntry>& index, std::string& names) {
+    index.resize(ft.entries);
+    names.resize(ft.namesBytes);
+    size_t bytes = index.size() * sizeof(PackIndexEntry);
+    if (!f.seek(ft.indexOffset) || f.read(index.data(), bytes) != bytes) return false;
+    if (ft.namesBytes && f.read(&names[0], names.size()) != names.size()) return false;
+    uint32_t crc = Crc32::update(0, index.data(), bytes);
+    crc = Crc32::update(crc, names.data(), names.size());
+    if (crc != ft.indexCrc) return false;
+    for (const PackIndexEntry& e : index) {
+        if (static_cast<uint64_t>(e.nameOff) + e.nameLen >= names.size() || names[e.nameOff + e.nameLen]) return false;
+        if (static_cast<uint64_t>(e.offset) + e.length > ft.indexOffset) return false;
+    }
+    return true;
+}
+
+// Stopka na końcu pliku; po przerwanym dopisywaniu – ostatnia poprawna przed końcem.
+bool readIndex(IFile& f, RawFooter& ft, std::vector<PackIndexEntry>& index, std::string& names) {
+    uint32_t size = f.size();
+    if (size < sizeof(RawFooter)) return false;
+    uint32_t pos = size - sizeof(RawFooter);
+    if (footerAt(f, pos, ft) && loadIndex(f, ft, index, names)) return true;
+
+    DBG("PackReader: no footer at end, scanning back");
+    const uint8_t magic[4] = {0x50, 0x41, 0x4B, 0x31};
+    std::vector<uint8_t> buf(kCopyBlock + 3);
+    uint32_t blockEnd = pos;
+    while (blockEnd > 0) {
+        uint32_t blockStart = blockEnd > kCopyBlock ? blockEnd - kCopyBlock : 0;
+        size_t n = blockEnd - blockStart + 3; // zakładka na magic przecinające granicę
+        if (blockStart + n > size) n = size - blockStart;
+        if (!f.seek(blockStart) || f.read(buf.data(), n) != n) return false;
+        for (size_t i = n >= 4 ? n - 4 + 1 : 0; i-- > 0;) {
+            if (memcmp(&buf[i], magic, 4) != 0) continue;
+            uint32_t cand = blockStart + static_cast<uint32_t>(i);
+            if (cand + sizeof(RawFooter) <= size && footerAt(f, cand, ft) && loadIndex(f, ft, index, names)) return true;
+        }
+        blockEnd = blockStart;
+    }
+    return false;
+}
+
+// Widok wpisu: fragment kontenera jako plik tylko do odczytu.
+class PackEntryFile : public IFile {
+public:
+    PackEntryFile(std::shared_ptr<IFile> c, uint32_t off, uint32_t len) : container(std::move(c)), offset(off), length(len) {}
+
+    size_t read(void* buf, size_t size) override {
+        if (!container || pos >= length) return 0;
+        if (size > length - pos) size = length - pos;
+        if (container->position() != offset + pos && !container->seek(offset + pos)) return 0;
+        size_t n = container->read(buf, size);
+        pos += static_cast<uint32_t>(n);
+        return n;
+    }
+    size_t write(const void*, size_t) override { return 0; }
+    void flush() override {}
+    bool seek(uint32_t p) override {
+        if (!container || p > length) return false;
+        pos = p;
+        return true;
+    }
+    uint32_t position() override { return pos; }
+    uint32_t size() override { return length; }
+    bool isOpen() const override { return container != nullptr; }
+    void close() override { container.reset(); }
+
+private:
+    std::shared_ptr<IFile> container;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t pos = 0;
+};
+
+} // namespace
+
+// ------------------- PackReader -------------------
+
+PackReader::PackReader(IFileSystem& f, const std::string& p) : fs(f), path(p) {}
+
+bool PackReader::open() {
+    close();
+    std::unique_ptr<IFile> f = fs.openRead(path);
+    // brak paczki – może przerwany compactPack (paczka tylko w .bak)
+    if (!f && fs.exists(path + ".bak") && recoverPack(fs, path)) f = fs.openRead(path);
+    if (!f) return false;
+    RawFooter ft;
+    if (!readIndex(*f, ft, index, names)) {
+        DBG("PackReader::open(%s) invalid pack", path.c_str());
+        index.clear();
+        names.clear();
+        return false;
+    }
+    dead = ft.deadBytes;
+    total = f->size();
+    file = std::shared_ptr<IFile>(f.release());
+    DBG("PackReader::open(%s) entries=%u", path.c_str(), (unsigned)index.size());
+    return true;
+}
+
+void PackReader::close() {
+    file.reset(); // widoki trzymają własną referencję do kontenera
+    index.clear();
+    names.clear();
+    dead = total = 0;
+}
+
+const PackIndexEntry* PackReader::find(const std::string& rawName) const {
+    const char* name = entryName(rawName);
+    size_t len = strlen(name);
+    uint32_t h = hashName(name, len);
+    auto it = std::lower_bound(index.begin(), index.end(), h,
+                               [](const PackIndexEntry& e, uint32_t v) { return e.hash < v; });
+    for (; it != index.end() && it->hash == h; ++it) {
+        if (it->nameLen == len && memcmp(names.data() + it->nameOff, name, len) == 0) return &*it;
+    }
+    return nullptr;
+}
+
+bool PackReader::stat(const std::string& name, PackIndexEntry& out) const {
+    const PackIndexEntry* e = find(name);
+    if (!e) return false;
+    out = *e;
+    return true;
+}
+
+std::unique_ptr<IFile> PackReader::openEntry(const std::string& name) {
+    const PackIndexEntry* e = find(name);
+    if (!e || !file) return nullptr;
+    return std::unique_ptr<IFile>(new PackEntryFile(file, e->offset, e->length));
+}
+
+bool PackReader::verifyEntry(const PackIndexEntry& e) {
+    uint8_t buf[512];
+    uint32_t crc = 0, left = e.length;
+    if (!file->seek(e.offset)) return false;
+    while (left) {
+        size_t n = left < sizeof(buf) ? left : sizeof(buf);
+        if (file->read(buf, n) != n) return false;
+        crc = Crc32::update(crc, buf, n);
+        left -= static_cast<uint32_t>(n);
+    }
+    return crc == e.crc;
+}
+
+bool PackReader::verify(const std::string& name) {
+    const PackIndexEntry* e = find(name);
+    return e && file && verifyEntry(*e);
+}
+
+bool PackReader::verifyAll() {
+    if (!file) return false;
+    for (const PackIndexEntry& e : index) {
+        if (!verifyEntry(e)) {
+            DBG("PackReader: CRC mismatch in %s", names.c_str() + e.nameOff);
+            return false;
+        }
+    }
+    return true;
+}
+
+void PackReader::forEach(const std::function<void(const char*, uint32_t)>& cb) const {
+    for (const PackIndexEntry& e : index) cb(names.c_str() + e.nameOff, e.length);
+}
+
+// ------------------- PackWriter -------------------
+
+PackWriter::PackWriter(IFileSystem& f, const std::string& p) : fs(f), path(p) {}
+
+PackWriter::~PackWriter() {
+    finish();
+}
+
+bool PackWriter::create() {
+    finish();
+    entries.clear();
+    end = dead = 0;
+    out = fs.open(path, OpenMode::WriteTruncate);
+    return out != nullptr;
+}
+
+bool PackWriter::append() {
+    finish();
+    if (!fs.exists(path) && !(fs.exists(path + ".bak") && recoverPack(fs, path))) return create();
+    entries.clear();
+    out = fs.open(path, OpenMode::ReadWrite);
+    if (!out) return false;
+
+    RawFooter ft;
+    std::vector<PackIndexEntry> index;
+    std::string names;
+    if (!readIndex(*out, ft, index, names)) {
+        DBG("PackWriter::append(%s) invalid pack", path.c_str());
+        out.reset();
+        return false;
+    }
+    for (const PackIndexEntry& e : index) {
+        entries.push_back(Entry{e.hash, e.offset, e.length, e.crc, std::string(names, e.nameOff, e.nameLen)});
+    }
+    // nowe dane za końcem pliku – stara paczka pozostaje czytelna do nowego finish(),
+    // a nowa stopka znów jest na końcu (także po przerwanym wcześniej dopisywaniu)
+    end = out->size();
+    dead = ft.deadBytes + (end - ft.indexOffset);
+    return true;
+}
+
+void PackWriter::drop(size_t i) {
+    dead += entries[i].length;
+    entries.erase(entries.begin() + i);
+}
+
+bool PackWriter::beginEntry(const std::string& rawName, Entry& e) {
+    const char* name = entryName(rawName);
+    size_t len = strlen(name);
+    if (!out || !len || len > UINT16_MAX) return false;
+    e = Entry{hashName(name, len), end, 0, 0, std::string(name, len)};
+    return out->seek(end);
+}
+
+void PackWriter::commitEntry(Entry& e) {
+    // stary wpis o tej nazwie martwy dopiero, gdy nowe dane są zapisane
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].name == e.name) {
+            drop(i);
+            break;
+        }
+    }
+    end += e.length;
+    entries.push_back(std::move(e));
+}
+
+bool PackWriter::add(const std::string& name, const void* data, size_t len) {
+    Entry e;
+    if (!beginEntry(name, e)) return false;
+    if (len && out->write(data, len) != len) return false; // częściowe dane nadpisze następny wpis lub indeks
+    e.length = static_cast<uint32_t>(len);
+    e.crc = Crc32::update(0, data, len);
+    commitEntry(e);
+    return true;
+}
+
+bool PackWriter::addFile(const std::string& name, IFile& src) {
+    Entry e;
+    if (!beginEntry(name, e) || !src.seek(0)) return false;
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[kCopyBlock]);
+    uint32_t left = src.size();
+    while (left) {
+        size_t n = left < kCopyBlock ? left : kCopyBlock;
+        if (src.read(buf.get(), n) != n || out->write(buf.get(), n) != n) {
+            DBG("PackWriter::addFile(%s) copy failed", name.c_str());
+            return false;
+        }
+        e.crc = Crc32::update(e.crc, buf.get(), n);
+        e.length += static_cast<uint32_t>(n);
+        left -= static_cast<uint32_t>(n);
+    }
+    commitEntry(e);
+    return true;
+}
+
+bool PackWriter::remove(const std::string& rawName) {
+    const char* name = entryName(rawName);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].name == name) {
+            drop(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PackWriter::finish() {
+    if (!out) return false;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+    std::vector<PackIndexEntry> index;
+    std::string names;
+    index.reserve(entries.size());
+    for (const Entry& e : entries) {
+        PackIndexEntry r;
+        r.hash = e.hash;
+        r.offset = e.offset;
+        r.length = e.length;
+        r.crc = e.crc;
+        r.nameOff = static_cast<uint32_t>(names.size());
+        r.nameLen = static_cast<uint16_t>(e.name.size());
+        r.reserved = 0;
+        names += e.name;
+        names += '\0';
+        index.push_back(r);
+    }
+    RawFooter ft;
+    ft.magic = kPackMagic;
+    ft.version = kPackVersion;
+    ft.reserved = 0;
+    ft.entries = static_cast<uint32_t>(index.size());
+    ft.indexOffset = end;
+    ft.namesBytes = static_cast<uint32_t>(names.size());
+    ft.deadBytes = dead;
+    size_t bytes = index.size() * sizeof(PackIndexEntry);
+    ft.indexCrc = Crc32::update(Crc32::update(0, index.data(), bytes), names.data(), names.size());
+
+    bool ok = out->seek(end) && (!bytes || out->write(index.data(), bytes) == bytes) &&
+              out->write(names.data(), names.size()) == names.size() && out->write(&ft, sizeof(ft)) == sizeof(ft);
+    out->flush();
+    out->close();
+    out.reset();
+    DBG("PackWriter::finish(%s) entries=%u ok=%d", path.c_str(), (unsigned)index.size(), ok);
+    return ok;
+}
+
+// ------------------- narzędzia -------------------
+
+int buildPack(IFileSystem& fs, const std::string& srcDir, const std::string& packPath) {
+    std::string root = util::normalizePath(srcDir);
+    if (root == "/") root.clear();
+    std::string pack = util::normalizePath(packPath);
+    PackWriter w(fs, packPath);
+    if (!w.create()) return -1;
+
+    int count = 0;
+    std::vector<std::string> dirs(1, std::string());
+    while (!dirs.empty()) {
+        std::string rel = dirs.back();
+        dirs.pop_back();
+        std::vector<std::pair<std::string, size_t>> children;
+        std::string dir = root + (rel.empty() ? std::string("/") : "/" + rel);
+        fs.listDir(dir.c_str(), [&](const char* name, size_t size) { children.emplace_back(name, size); });
+        std::sort(children.begin(), children.end()); // powtarzalny układ paczki
+        for (const auto& c : children) {
+            std::string name = rel.empty() ? c.first : rel + "/" + c.first;
+            std::string full = root + "/" + name;
+            if (full == pack) continue;
+            if (c.second == 0) {
+                // rozmiar 0: katalog albo pusty plik
+                bool isDir = fs.listDir(full.c_str(), [](const char*, size_t) {});
+                if (isDir) {
+                    dirs.push_back(name);
+                    continue;
+                }
+            }
+            auto f = fs.openRead(full);
+            if (!f || !w.addFile(name, *f)) return -1;
+            count++;
+        }
+    }
+    return w.finish() ? count : -1;
+}
+
+bool compactPack(IFileSystem& fs, const std::string& packPath) {
+    recoverPack(fs, packPath); // pozostałości poprzedniej kompaktacji blokowałyby rename
+    PackReader r(fs, packPath);
+    if (!r.open()) return false;
+    std::string tmp = packPath + ".tmp";
+    bool ok = true;
+    {
+        PackWriter w(fs, tmp);
+        if (!w.create()) return false;
+        std::vector<std::string> names;
+        r.forEach([&](const char* name, uint32_t) { names.emplace_back(name); });
+        for (const std::string& name : names) {
+            auto f = r.openEntry(name);
+            if (!f || !w.addFile(name, *f)) {
+                ok = false;
+                break;
+            }
+        }
+        ok = w.finish() && ok;
+    }
+    r.close();
+    if (!ok) {
+        fs.remove(tmp);
+        return false;
+    }
+    // jak IniWriter::commit: w każdej chwili istnieje paczka albo .bak (recoverPack)
+    std::string bak = packPath + ".bak";
+    if (!fs.rename(packPath, bak)) {
+        fs.remove(tmp);
+        return false;
+    }
+    if (!fs.rename(tmp, packPath)) {
+        fs.rename(bak, packPath);
+        return false;
+    }
+    fs.remove(bak);
+    return true;
+}
+
+bool recoverPack(IFileSystem& fs, const std::string& packPath) {
+    std::string tmp = packPath + ".tmp", bak = packPath + ".bak";
+    bool ok = true;
+    if (fs.exists(bak)) {
+        if (!fs.exists(packPath)) ok = fs.rename(bak, packPath); // przerwane między rename
+        else fs.remove(bak);                                      // przerwane po podmianie
+    }
+    if (fs.exists(tmp)) fs.remove(tmp);
+    return ok;
+}
+
+} // namespace pack
+} // namespace storage
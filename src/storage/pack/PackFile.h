@@ -0,0 +1,151 @@
+#ifndef STORAGE_PACK_PACKFILE_H
+#define STORAGE_PACK_PACKFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace pack {
+
+/**
+ * Format kontenera (little-endian):
+ *
+ *   dane wpisów, jeden za drugim (bez wyrównania)
+ *   indeks: PackIndexEntry[n] posortowane po (hash, nazwa), dalej nazwy zakończone NUL
+ *   stopka: 28 B (magic "PAK1", liczba wpisów, offset indeksu, rozmiar nazw,
+ *           martwe bajty, CRC-32 indeksu)
+ *
+ * Dopisanie do istniejącej paczki dodaje dane i nowy indeks za starą stopką;
+ * stary indeks i zastąpione/usunięte wpisy stają się martwymi bajtami
+ * (odzyskiwanymi przez `compactPack`). Przerwany zapis nie psuje paczki,
+ * dopóki nie powstanie nowa stopka – czytana jest ostatnia poprawna.
+ */
+struct PackIndexEntry {
+    uint32_t hash;     // FNV-1a nazwy
+    uint32_t offset;   // początek danych w kontenerze
+    uint32_t length;
+    uint32_t crc;      // CRC-32 danych
+    uint32_t nameOff;  // w bloku nazw
+    uint16_t nameLen;  // bez NUL
+    uint16_t reserved;
+};
+
+/**
+ * @brief Odczyt paczki: indeks w RAM, wpisy jako widoki `IFile` na kontenerze.
+ *
+ * `open()` czyta stopkę i indeks (24 B na wpis + nazwy). Wyszukiwanie to
+ * wyszukiwanie binarne po hashu bez operacji na nośniku; `openEntry()` nie
+ * otwiera nowego pliku – widok czyta z jednego, współdzielonego uchwytu
+ * kontenera (jeden z `maxOpenFiles` LittleFS na dowolnie wiele wpisów).
+ * Widoki mogą przeżyć `PackReader`. Nie jest thread-safe.
+ *
+ * Nazwy wpisów to ścieżki względne ("lang/pl.json"); wiodący '/' przy
+ * wyszukiwaniu jest pomijany.
+ *
+ * @code
+ * storage::pack::PackReader ui(flashFs, "/ui.pak");
+ * ui.open();
+ * auto f = ui.openEntry("lang/pl.json");   // IFile tylko do odczytu
+ * @endcode
+ */
+class PackReader {
+public:
+    PackReader(IFileSystem& fs, const std::string& path);
+
+    bool open();
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    size_t size() const { return index.size(); }
+    bool exists(const std::string& name) const { return find(name) != nullptr; }
+    bool stat(const std::string& name, PackIndexEntry& out) const;
+    std::unique_ptr<IFile> openEntry(const std::string& name);
+
+    // Porównanie CRC-32 danych z indeksem.
+    bool verify(const std::string& name);
+    bool verifyAll();
+
+    void forEach(const std::function<void(const char* name, uint32_t length)>& cb) const;
+
+    uint32_t deadBytes() const { return dead; }
+    uint32_t containerBytes() const { return total; }
+    size_t memoryUsage() const { return index.capacity() * sizeof(PackIndexEntry) + names.capacity(); }
+
+private:
+    IFileSystem& fs;
+    std::string path;
+    std::shared_ptr<IFile> file;
+    std::vector<PackIndexEntry> index;
+    std::string names;
+    uint32_t dead = 0;
+    uint32_t total = 0;
+
+    const PackIndexEntry* find(const std::string& name) const;
+    bool verifyEntry(const PackIndexEntry& e);
+};
+
+/**
+ * @brief Budowa paczki: `create()` albo `append()`, wpisy, `finish()`.
+ *
+ * Ponowne dodanie nazwy zastępuje wpis. Bez `finish()` (wywoływanego
+ * też w destruktorze) nowe wpisy nie są widoczne.
+ */
+class PackWriter {
+public:
+    PackWriter(IFileSystem& fs, const std::string& path);
+    ~PackWriter();
+
+    PackWriter(const PackWriter&) = delete;
+    PackWriter& operator=(const PackWriter&) = delete;
+
+    bool create();  // nowa, pusta paczka (nadpisuje istniejący plik)
+    bool append();  // dopisywanie do istniejącej (lub nowa, gdy brak pliku)
+
+    bool add(const std::string& name, const void* data, size_t len);
+    bool addFile(const std::string& name, IFile& src);
+    bool remove(const std::string& name);
+    bool finish();
+
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint32_t offset;
+        uint32_t length;
+        uint32_t crc;
+        std::string name;
+    };
+
+    IFileSystem& fs;
+    std::string path;
+    std::unique_ptr<IFile> out;
+    std::vector<Entry> entries;
+    uint32_t end = 0;
+    uint32_t dead = 0;
+
+    bool beginEntry(const std::string& name, Entry& e);
+    void commitEntry(Entry& e);
+    void drop(size_t i);
+};
+
+// Paczka z całego drzewa katalogów `srcDir` (nazwy względne). Zwraca liczbę wpisów lub -1.
+int buildPack(IFileSystem& fs, const std::string& srcDir, const std::string& packPath);
+
+// Przepisuje żywe wpisy do `<paczka>.tmp` i podmienia paczkę przez `<paczka>.bak`
+// (usuwa martwe bajty).
+bool compactPack(IFileSystem& fs, const std::string& packPath);
+
+// Sprzątanie po przerwanym compactPack (jak IniWriter::recover). PackReader::open
+// i PackWriter::append wołają je same, gdy paczki brak, a jest `.bak`.
+bool recoverPack(IFileSystem& fs, const std::string& packPath);
+
+} // namespace pack
+} // namespace storage
+
+#endif // STORAGE_PACK_PACKFILE_H
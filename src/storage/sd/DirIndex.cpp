@@ -0,0 +1,79 @@
+#include "DirIndex.h"
+
+namespace storage {
+namespace sd {
+
+uint32_t DirIndex::hashName(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* p = name; *p; ++p) {
+        uint8_t c = static_cast<uint8_t>(*p);
+        if (c >= 'A' && c <= 'Z') c += 32; // FAT: nazwy bez rozróżniania wielkości liter
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void DirIndex::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    count = deleted = 0;
+}
+
+void DirIndex::reserve(size_t entries) {
+    size_t cap = entries + entries / 4 + 1;
+    if (cap > slots.size()) rehash(cap < 16 ? 16 : cap);
+}
+
+void DirIndex::rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(capacity, Slot{0, kEmpty});
+    count = deleted = 0;
+    for (const Slot& s : old) {
+        if (s.pos == kEmpty || s.pos == kDeleted) continue;
+        size_t i = home(s.hash);
+        while (slots[i].pos != kEmpty) {
+            if (++i == slots.size()) i = 0;
+        }
+        slots[i] = s;
+        count++;
+    }
+}
+
+bool DirIndex::insert(uint32_t hash, uint32_t pos, bool isDir) {
+    if (pos > kMaxPos) return false;
+    // obciążenie (z usuniętymi) do 80%
+    if ((count + deleted + 1) * 5 > slots.size() * 4) {
+        size_t cap = (count + 1) * 3 / 2;
+        rehash(cap < 16 ? 16 : cap);
+    }
+    size_t i = home(hash);
+    while (slots[i].pos != kEmpty && slots[i].pos != kDeleted) {
+        if (++i == slots.size()) i = 0;
+    }
+    if (slots[i].pos == kDeleted) deleted--;
+    slots[i] = Slot{hash, pos | (isDir ? kDirBit : 0)};
+    count++;
+    return true;
+}
+
+bool DirIndex::erase(uint32_t hash, uint32_t pos) {
+    if (slots.empty()) return false;
+    size_t i = home(hash);
+    for (size_t n = 0; n < slots.size(); ++n) {
+        Slot& s = slots[i];
+        if (s.pos == kEmpty) return false;
+        if (s.pos != kDeleted && s.hash == hash && (s.pos & ~kDirBit) == pos) {
+            s.pos = kDeleted;
+            count--;
+            deleted++;
+            return true;
+        }
+        if (++i == slots.size()) i = 0;
+    }
+    return false;
+}
+
+} // namespace sd
+} // namespace storage
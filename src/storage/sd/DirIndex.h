@@ -0,0 +1,73 @@
+#ifndef STORAGE_SD_DIRINDEX_H
+#define STORAGE_SD_DIRINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace storage {
+namespace sd {
+
+/**
+ * @brief Tablica haszująca nazwa → pozycja wpisu w katalogu (bez nazw w RAM).
+ *
+ * Wpis to 8 B: hash nazwy (FNV-1a bez rozróżniania wielkości liter, jak FAT)
+ * i indeks wpisu katalogu (`FsFile::dirIndex()`) z bitem „katalog”.
+ * Nazwy nie są przechowywane – przy trafieniu wywołujący otwiera wpis po
+ * indeksie i porównuje nazwę, więc kolizje hashy są tylko kosztem jednego
+ * odczytu. Brak hasha = plik na pewno nie istnieje (bez I/O).
+ *
+ * Adresowanie otwarte z sondowaniem liniowym, obciążenie do 80%
+ * (10 000 plików ≈ 100 KiB).
+ */
+class DirIndex {
+public:
+    static const uint32_t kMaxPos = 0x7FFFFFFD;
+
+    static uint32_t hashName(const char* name);
+
+    void clear();
+    void reserve(size_t entries);
+    bool insert(uint32_t hash, uint32_t pos, bool isDir);
+    bool erase(uint32_t hash, uint32_t pos);
+
+    // Wywołuje cb(pos, isDir) dla każdego wpisu o danym hashu, aż cb zwróci true.
+    template <class F>
+    bool find(uint32_t hash, F&& cb) const {
+        if (slots.empty()) return false;
+        size_t i = home(hash);
+        for (size_t n = 0; n < slots.size(); ++n) {
+            const Slot& s = slots[i];
+            if (s.pos == kEmpty) return false;
+            if (s.pos != kDeleted && s.hash == hash && cb(s.pos & ~kDirBit, (s.pos & kDirBit) != 0)) return true;
+            if (++i == slots.size()) i = 0;
+        }
+        return false;
+    }
+
+    size_t size() const { return count; }
+    size_t memoryUsage() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t pos;
+    };
+    static const uint32_t kEmpty = 0xFFFFFFFF;
+    static const uint32_t kDeleted = 0xFFFFFFFE;
+    static const uint32_t kDirBit = 0x80000000;
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+    size_t deleted = 0;
+
+    size_t home(uint32_t hash) const {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * slots.size()) >> 32);
+    }
+    void rehash(size_t capacity);
+};
+
+} // namespace sd
+} // namespace storage
+
+#endif // STORAGE_SD_DIRINDEX_H
@@ -0,0 +1,31 @@
+#include "FreeSpaceTracker.h"
+
+namespace storage {
+namespace sd {
+
+void FreeSpaceTracker::reset(uint32_t freeClusters, uint32_t bytesPerCluster) {
+    cluster = bytesPerCluster;
+    free.store(freeClusters > INT32_MAX ? INT32_MAX : static_cast<int32_t>(freeClusters));
+}
+
+uint32_t FreeSpaceTracker::freeClusters() const {
+    int32_t n = free.load();
+    return n > 0 ? static_cast<uint32_t>(n) : 0;
+}
+
+void FreeSpaceTracker::resized(uint64_t oldSize, uint64_t newSize) {
+    if (!cluster || oldSize == newSize) return;
+    int64_t before = static_cast<int64_t>((oldSize + cluster - 1) / cluster);
+    int64_t after = static_cast<int64_t>((newSize + cluster - 1) / cluster);
+    if (before != after) adjust(static_cast<int32_t>(before - after));
+}
+
+void FreeSpaceTracker::adjust(int32_t clusters) {
+    if (!clusters) return;
+    int32_t cur = free.load();
+    // przed pierwszym policzeniem nie ma czego korygować
+    while (cur >= 0 && !free.compare_exchange_weak(cur, cur + clusters < 0 ? 0 : cur + clusters)) {}
+}
+
+} // namespace sd
+} // namespace storage
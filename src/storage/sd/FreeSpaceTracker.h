@@ -0,0 +1,32 @@
+#ifndef STORAGE_SD_FREESPACETRACKER_H
+#define STORAGE_SD_FREESPACETRACKER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace storage {
+namespace sd {
+
+// Licznik wolnych klastrów: pełny skan FAT raz, potem korekty z zapisów/usunięć
+// wykonanych przez SdFatFileSystem. Wartość < 0 = jeszcze nie policzono.
+class FreeSpaceTracker {
+public:
+    void reset(uint32_t freeClusters, uint32_t bytesPerCluster);
+    void invalidate() { free.store(-1); }
+    bool valid() const { return free.load() >= 0; }
+    uint32_t freeClusters() const;
+    uint32_t clusterBytes() const { return cluster; }
+
+    // Plik urósł/zmalał z oldSize do newSize (zajęte klastry liczone w górę).
+    void resized(uint64_t oldSize, uint64_t newSize);
+    void adjust(int32_t clusters);
+
+private:
+    std::atomic<int32_t> free{-1};
+    uint32_t cluster = 0;
+};
+
+} // namespace sd
+} // namespace storage
+
+#endif // STORAGE_SD_FREESPACETRACKER_H
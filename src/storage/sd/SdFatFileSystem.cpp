@@ -1,103 +1,34 @@
 #include "SdFatFileSystem.h"
 #include "storage/time/TimeUtils.h"
 #include "storage/Debug.h"
+#include "storage/util/Path.h"
 
+#include <cstring>
 #include <vector>
 
 namespace storage {
 namespace sd {
 
 // ------------------- helpers: path -------------------
-static std::string normalizePath(const std::string& in) {
-    if (in.empty()) return std::string();
-
-    bool absolute = in[0] == '/';
-    std::vector<std::string> stack;
-    size_t i = 0, n = in.size();
-
-    while (i < n) {
-        // pomiń wielokrotne '/'
-        while (i < n && in[i] == '/') i++;
-        if (i >= n) break;
-        size_t j = i;
-        while (j < n && in[j] != '/') j++;
-        std::string seg = in.substr(i, j - i);
-        i = j;
-
-        if (seg == "." || seg.empty()) {
-            continue; // ignoruj
-        } else if (seg == "..") {
-            if (!stack.empty()) stack.pop_back();
-            // jeśli ścieżka relatywna i stack pusty, pozostaw tak (".." na początku)
-        } else {
-            stack.push_back(seg);
-        }
-    }
-
-    std::string out;
-    if (absolute) out.push_back('/');
-    for (size_t k = 0; k < stack.size(); ++k) {
-        if (k) out.push_back('/');
-        out += stack[k];
-    }
-    if (out.empty()) return absolute ? std::string("/") : std::string();
-    return out;
-}
+using util::normalizePath;
+using util::parentPath;
+using util::baseName;
 
-static bool ensureParentDirs(SdFat& sd, const std::string& rawPath) {
-    if (rawPath.empty()) return true;
+static bool removeRecursive(SdFat& sd, const std::string& rawPath, FreeSpaceTracker& space) {
     std::string path = normalizePath(rawPath);
-    auto pos = path.find_last_of('/');
-    if (pos == std::string::npos) return true; // brak katalogu rodzica
-    std::string dir = path.substr(0, pos);
-    if (dir.empty() || dir == "/") return true;
-
-    bool absolute = dir[0] == '/';
-    size_t start = absolute ? 1 : 0;
-    std::string cur = absolute ? std::string("/") : std::string();
-
-    while (start <= dir.size()) {
-        size_t next = dir.find('/', start);
-        std::string token = dir.substr(start, (next == std::string::npos) ? std::string::npos : next - start);
-        if (!token.empty() && token != ".") {
-            if (token == "..") {
-                // cofnięcie w górę dla relatywnych — dla absolutnych ignorujemy powyżej '/'
-                if (!cur.empty() && cur != "/") {
-                    auto slash = cur.find_last_of('/');
-                    if (slash == std::string::npos) cur.clear();
-                    else cur.erase(slash ? slash : 1);
-                }
-            } else {
-                if (cur.empty() || cur == "/") cur += token;
-                else cur += "/" + token;
-                if (!sd.exists(cur.c_str())) {
-                    if (!sd.mkdir(cur.c_str())) {
-                        DBG("ensureParentDirs: mkdir failed for %s", cur.c_str());
-                        return false;
-                    }
-                }
-            }
-        }
-        if (next == std::string::npos) break;
-        start = next + 1;
-    }
-    return true;
-}
+    if (path.empty()) return false;
 
-static bool isDirectory(SdFat& sd, const char* path) {
-    FsFile f = sd.open(path);
-    bool dir = (bool)f && f.isDirectory();
+    FsFile f = sd.open(path.c_str());
+    if (!f) return false;
+    bool isDir = f.isDirectory();
+    uint64_t size = f.fileSize();
     f.close();
-    return dir;
-}
 
-static bool removeRecursive(SdFat& sd, const std::string& rawPath) {
-    std::string path = normalizePath(rawPath);
-    if (path.empty()) return false;
-
-    if (!isDirectory(sd, path.c_str())) {
+    if (!isDir) {
         // plik
-        return sd.remove(path.c_str());
+        bool ok = sd.remove(path.c_str());
+        if (ok) space.resized(size, 0);
+        return ok;
     }
 
     // katalog — usuń zawartość
@@ -110,7 +41,7 @@ static bool removeRecursive(SdFat& sd, const std::string& rawPath) {
         if (entry.getName(nameBuf, sizeof(nameBuf))) {
             std::string child = (path == "/" ? std::string("/") + nameBuf : path + "/" + nameBuf);
             entry.close();
-            if (!removeRecursive(sd, child)) {
+            if (!removeRecursive(sd, child, space)) {
                 // spróbuj dalej, ale raportuj błąd
                 DBG("removeRecursive: failed for %s", child.c_str());
                 // nie przerywamy, by spróbować usunąć resztę
@@ -121,8 +52,10 @@ static bool removeRecursive(SdFat& sd, const std::string& rawPath) {
     }
     dir.close();
 
-    // po opróżnieniu katalogu usuń sam katalog
-    return sd.rmdir(path.c_str());
+    // po opróżnieniu katalogu usuń sam katalog (FAT podaje rozmiar 0 – min. jeden klaster)
+    bool ok = sd.rmdir(path.c_str());
+    if (ok) space.resized(size ? size : 1, 0);
+    return ok;
 }
 
 // ------------------- statyczny provider czasu -------------------
@@ -152,19 +85,54 @@ bool SdFatFileSystem::begin() {
     if (timeProvider) {
         FsDateTime::setCallback(SdFatFileSystem::getGlobalTime);
     }
+    space.invalidate(); // nowa karta – wolne miejsce policzy pierwsze info()
+    for (auto& d : indexed) d->dir.close();
+    indexed.clear();
     bool ok = sd.begin(csPin);
     DBG("SdFatFileSystem::begin result=%d", ok);
     return ok;
 }
 
+bool SdFatFileSystem::recountFreeSpace() {
+    DBG("SdFatFileSystem::recountFreeSpace()");
+    MetricScope m(&stats, IoOp::Stat);
+    int32_t n = sd.freeClusterCount(); // skan całej FAT – sekundy na dużych kartach
+    if (n < 0) {
+        m.fail();
+        return false;
+    }
+    space.reset(static_cast<uint32_t>(n), sd.bytesPerCluster());
+    DBG("SdFatFileSystem::recountFreeSpace -> %ld clusters", static_cast<long>(n));
+    return true;
+}
+
+bool SdFatFileSystem::info(FsInfo& out) {
+    DBG("SdFatFileSystem::info()");
+    out = FsInfo();
+    uint32_t cluster = sd.bytesPerCluster();
+    if (!cluster) return false; // brak karty / begin() nie wykonane
+    if (!space.valid() && !recountFreeSpace()) return false;
+
+    out.totalBytes = static_cast<uint64_t>(sd.clusterCount()) * cluster;
+    out.freeBytes = static_cast<uint64_t>(space.freeClusters()) * cluster;
+    out.sectorSize = 512;
+    out.clusterSize = cluster;
+    out.ioAlignment = 512;
+    DBG("SdFatFileSystem::info total=%llu free=%llu cluster=%u",
+        static_cast<unsigned long long>(out.totalBytes), static_cast<unsigned long long>(out.freeBytes), cluster);
+    return true;
+}
+
 bool SdFatFileSystem::listDir(const char* rawPath, std::function<void(const char*, size_t)> callback) {
     std::string path = normalizePath(rawPath ? std::string(rawPath) : std::string("/"));
     if (path.empty()) path = "/";
     DBG("SdFatFileSystem::listDir(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::List);
 
     FsFile dir = sd.open(path.c_str());
     if (!dir || !dir.isDirectory()) {
         DBG("listDir: cannot open directory %s", path.c_str());
+        m.fail();
         return false;
     }
 
@@ -173,8 +141,11 @@ bool SdFatFileSystem::listDir(const char* rawPath, std::function<void(const char
 
     while ((entry = dir.openNextFile())) {
         if (entry.getName(nameBuf, sizeof(nameBuf))) {
-            DBG("listDir entry %s size=%u", nameBuf, entry.size());
-            callback(nameBuf, entry.size());
+            // size_t na ESP32 jest 32-bitowy – plik > 4 GiB nie może wyglądać na mały/pusty
+            uint64_t s = entry.fileSize();
+            size_t reported = s > SIZE_MAX ? SIZE_MAX : static_cast<size_t>(s);
+            DBG("listDir entry %s size=%llu", nameBuf, static_cast<unsigned long long>(s));
+            callback(nameBuf, reported);
         }
         entry.close();
     }
@@ -185,7 +156,16 @@ bool SdFatFileSystem::listDir(const char* rawPath, std::function<void(const char
 bool SdFatFileSystem::exists(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("SdFatFileSystem::exists(path=%s)", path.c_str());
-    bool res = !path.empty() && sd.exists(path.c_str());
+    MetricScope m(&stats, IoOp::Stat);
+    bool res;
+    if (IndexedDir* d = path.empty() ? nullptr : indexFor(parentPath(path))) {
+        // brak hasha = brak pliku bez dostępu do karty
+        FsFile f;
+        res = openIndexed(*d, baseName(path), O_RDONLY, f);
+        f.close();
+    } else {
+        res = !path.empty() && sd.exists(path.c_str());
+    }
     DBG("SdFatFileSystem::exists result=%d", res);
     return res;
 }
@@ -193,30 +173,79 @@ bool SdFatFileSystem::exists(const std::string& rawPath) {
 bool SdFatFileSystem::remove(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("SdFatFileSystem::remove(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Remove);
     if (path.empty()) return false;
 
-    bool res;
-    if (isDirectory(sd, path.c_str())) {
-        res = removeRecursive(sd, path);
-    } else {
-        res = sd.remove(path.c_str());
+    IndexedDir* d = indexFor(parentPath(path));
+    uint32_t pos = 0;
+    bool known = false;
+    if (d) {
+        FsFile f;
+        known = openIndexed(*d, baseName(path), O_RDONLY, f);
+        if (known) pos = f.dirIndex();
+        f.close();
+        if (!known) {
+            m.fail();
+            return false;
+        }
     }
+    dropIndexesUnder(path);
+    bool res = removeRecursive(sd, path, space);
+    if (res && known) d->names.erase(DirIndex::hashName(baseName(path).c_str()), pos);
     DBG("SdFatFileSystem::remove result=%d", res);
+    m.result(res);
     return res;
 }
 
 bool SdFatFileSystem::mkdir(const std::string& rawPath) {
     std::string path = normalizePath(rawPath);
     DBG("SdFatFileSystem::mkdir(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Mkdir);
     if (path.empty() || path == "/") return true;
-    bool res = sd.mkdir(path.c_str());
+    // rodzice przez ensureParentDirs – każdy poziom trafia do indeksu i licznika wolnego miejsca
+    bool res = ensureParentDirs(path) && sd.mkdir(path.c_str(), false);
+    if (res) {
+        space.adjust(-1);
+        indexCreated(path, nullptr);
+    }
     DBG("SdFatFileSystem::mkdir result=%d", res);
+    m.result(res);
+    return res;
+}
+
+bool SdFatFileSystem::rename(const std::string& rawFrom, const std::string& rawTo) {
+    std::string from = normalizePath(rawFrom);
+    std::string to = normalizePath(rawTo);
+    DBG("SdFatFileSystem::rename(from=%s, to=%s)", from.c_str(), to.c_str());
+    MetricScope m(&stats, IoOp::Rename);
+    bool res = !from.empty() && !to.empty() && !sd.exists(to.c_str()) && ensureParentDirs(to);
+
+    IndexedDir* d = res ? indexFor(parentPath(from)) : nullptr;
+    uint32_t pos = 0;
+    bool known = false;
+    if (d) {
+        FsFile f;
+        known = openIndexed(*d, baseName(from), O_RDONLY, f);
+        if (known) pos = f.dirIndex();
+        f.close();
+    }
+    if (res) {
+        dropIndexesUnder(from);
+        res = sd.rename(from.c_str(), to.c_str());
+    }
+    if (res) {
+        if (known) d->names.erase(DirIndex::hashName(baseName(from).c_str()), pos);
+        indexCreated(to, nullptr);
+    }
+    DBG("SdFatFileSystem::rename result=%d", res);
+    m.result(res);
     return res;
 }
 
 void SdFatFileSystem::getCreatedDateTime(const std::string& rawPath, uint16_t* date, uint16_t* time) {
     std::string path = normalizePath(rawPath);
     DBG("getCreatedDateTime(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Stat);
     FsFile f = sd.open(path.c_str(), FILE_READ);
     if (!f) { *date = 0; *time = 0; return; }
     if (!f.getCreateDateTime(date, time)) { *date = 0; *time = 0; }
@@ -226,6 +255,7 @@ void SdFatFileSystem::getCreatedDateTime(const std::string& rawPath, uint16_t* d
 void SdFatFileSystem::getModifiedDateTime(const std::string& rawPath, uint16_t* date, uint16_t* time) {
     std::string path = normalizePath(rawPath);
     DBG("getModifiedDateTime(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::Stat);
     FsFile f = sd.open(path.c_str(), FILE_READ);
     if (!f) { *date = 0; *time = 0; return; }
     if (!f.getModifyDateTime(date, time)) { *date = 0; *time = 0; }
@@ -248,29 +278,215 @@ uint32_t SdFatFileSystem::getModifiedTimestamp(const std::string& path) {
     return ts;
 }
 
-std::unique_ptr<IFile> SdFatFileSystem::open(const std::string& rawPath, OpenMode mode) {
+bool SdFatFileSystem::ensureParentDirs(const std::string& rawPath) {
+    if (rawPath.empty()) return true;
+    std::string path = normalizePath(rawPath);
+    auto pos = path.find_last_of('/');
+    if (pos == std::string::npos) return true; // brak katalogu rodzica
+    std::string dir = path.substr(0, pos);
+    if (dir.empty() || dir == "/") return true;
+    // zwykle katalog już jest – jedno sprawdzenie zamiast po jednym na poziom
+    if (sd.exists(dir.c_str())) return true;
+
+    bool absolute = dir[0] == '/';
+    size_t start = absolute ? 1 : 0;
+    std::string cur = absolute ? std::string("/") : std::string();
+
+    while (start <= dir.size()) {
+        size_t next = dir.find('/', start);
+        std::string token = dir.substr(start, (next == std::string::npos) ? std::string::npos : next - start);
+        if (!token.empty() && token != ".") {
+            if (token == "..") {
+                // cofnięcie w górę dla relatywnych — dla absolutnych ignorujemy powyżej '/'
+                if (!cur.empty() && cur != "/") {
+                    auto slash = cur.find_last_of('/');
+                    if (slash == std::string::npos) cur.clear();
+                    else cur.erase(slash ? slash : 1);
+                }
+            } else {
+                if (cur.empty() || cur == "/") cur += token;
+                else cur += "/" + token;
+                if (!sd.exists(cur.c_str())) {
+                    if (!sd.mkdir(cur.c_str())) {
+                        DBG("ensureParentDirs: mkdir failed for %s", cur.c_str());
+                        return false;
+                    }
+                    space.adjust(-1);
+                    indexCreated(cur, nullptr);
+                }
+            }
+        }
+        if (next == std::string::npos) break;
+        start = next + 1;
+    }
+    return true;
+}
+
+bool SdFatFileSystem::openRaw(const std::string& rawPath, OpenMode mode, FsFile& out) {
     std::string path = normalizePath(rawPath);
     DBG("SdFatFileSystem::open(path=%s, mode=%d)", path.c_str(), static_cast<int>(mode));
+    MetricScope m(&stats, IoOp::Open);
 
     oflag_t flags = O_RDONLY;
     switch (mode) {
         case OpenMode::Read:         flags = O_RDONLY; break;
-        case OpenMode::WriteTruncate:flags = O_WRONLY | O_CREAT | O_TRUNC; break;
+        case OpenMode::WriteTruncate:flags = O_WRONLY | O_CREAT; break; // skrócenie niżej
         case OpenMode::WriteAppend:  flags = O_WRONLY | O_CREAT | O_AT_END; break;
         case OpenMode::ReadWrite:    flags = O_RDWR   | O_CREAT; break;
     }
 
     if (mode != OpenMode::Read) {
-        if (!ensureParentDirs(sd, path)) {
+        if (!ensureParentDirs(path)) {
             DBG("ensureParentDirs failed for %s", path.c_str());
-            return nullptr;
+            m.fail();
+            return false;
+        }
+    }
+
+    IndexedDir* d = indexFor(parentPath(path));
+    if (d && openIndexed(*d, baseName(path), flags & ~O_CREAT, out)) {
+        // trafienie w indeksie – wpis otwarty po pozycji, bez przeszukiwania katalogu
+    } else if (d && mode == OpenMode::Read) {
+        DBG("open(%s): not in directory index", path.c_str());
+        m.fail();
+        return false;
+    } else {
+        out = sd.open(path.c_str(), flags);
+        if (out && d) indexCreated(path, &out);
+    }
+    if (out && mode == OpenMode::WriteTruncate && out.fileSize()) {
+        // jawne skrócenie – zwolnione klastry trafiają do licznika wolnego miejsca
+        uint64_t old = out.fileSize();
+        if (out.truncate(0)) {
+            space.resized(old, 0);
+        } else {
+            out.close();
+        }
+    }
+    DBG("open(%s) result=%d", path.c_str(), out ? 1 : 0);
+    m.result(static_cast<bool>(out));
+    return static_cast<bool>(out);
+}
+
+// ------------------- indeks katalogów -------------------
+
+SdFatFileSystem::IndexedDir* SdFatFileSystem::indexFor(const std::string& dirPath) {
+    for (auto& d : indexed) {
+        if (d->path == dirPath) return d.get();
+    }
+    return nullptr;
+}
+
+bool SdFatFileSystem::openIndexed(IndexedDir& d, const std::string& name, oflag_t flags, FsFile& out) {
+    char nameBuf[256];
+    return d.names.find(DirIndex::hashName(name.c_str()), [&](uint32_t pos, bool) {
+        // nazwa nie jest w RAM – kolizję hashy rozstrzyga porównanie po otwarciu
+        if (out.open(&d.dir, pos, flags)) {
+            if (out.getName(nameBuf, sizeof(nameBuf)) && strcasecmp(nameBuf, name.c_str()) == 0) return true;
+            out.close();
+        }
+        return false;
+    });
+}
+
+void SdFatFileSystem::indexCreated(const std::string& path, FsFile* opened) {
+    IndexedDir* d = indexFor(parentPath(path));
+    if (!d) return;
+    FsFile f;
+    FsFile* entry = opened;
+    if (!entry) {
+        f = sd.open(path.c_str(), O_RDONLY);
+        entry = &f;
+    }
+    if (*entry) {
+        uint32_t hash = DirIndex::hashName(baseName(path).c_str());
+        uint32_t pos = entry->dirIndex();
+        bool dup = d->names.find(hash, [pos](uint32_t p, bool) { return p == pos; });
+        if (!dup) d->names.insert(hash, pos, entry->isDirectory());
+    }
+    f.close();
+}
+
+void SdFatFileSystem::dropIndexesUnder(const std::string& path) {
+    for (size_t i = 0; i < indexed.size();) {
+        const std::string& p = indexed[i]->path;
+        if (p == path || (p.size() > path.size() && p.compare(0, path.size(), path) == 0 &&
+                          (path == "/" || p[path.size()] == '/'))) {
+            DBG("SdFatFileSystem: directory index dropped for %s", p.c_str());
+            indexed[i]->dir.close();
+            indexed.erase(indexed.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool SdFatFileSystem::indexDirectory(const std::string& rawPath) {
+    std::string path = normalizePath(rawPath);
+    if (path.empty()) path = "/";
+    DBG("SdFatFileSystem::indexDirectory(path=%s)", path.c_str());
+    MetricScope m(&stats, IoOp::List);
+    dropDirectoryIndex(path);
+
+    std::unique_ptr<IndexedDir> d(new IndexedDir());
+    d->path = path;
+    d->dir = sd.open(path.c_str());
+    if (!d->dir || !d->dir.isDirectory()) {
+        m.fail();
+        return false;
+    }
+
+    // jedno przejście katalogu; nazwy tylko na czas liczenia hashy
+    FsFile entry;
+    char nameBuf[256];
+    while (entry.openNext(&d->dir, O_RDONLY)) {
+        if (entry.getName(nameBuf, sizeof(nameBuf))) {
+            d->names.insert(DirIndex::hashName(nameBuf), entry.dirIndex(), entry.isDirectory());
+        }
+        entry.close();
+    }
+    DBG("SdFatFileSystem::indexDirectory -> %u entries, %u bytes", (unsigned)d->names.size(),
+        (unsigned)d->names.memoryUsage());
+    indexed.push_back(std::move(d));
+    return true;
+}
+
+void SdFatFileSystem::dropDirectoryIndex(const std::string& rawPath) {
+    std::string path = normalizePath(rawPath);
+    if (path.empty()) path = "/";
+    for (size_t i = 0; i < indexed.size(); ++i) {
+        if (indexed[i]->path == path) {
+            indexed[i]->dir.close();
+            indexed.erase(indexed.begin() + i);
+            return;
         }
     }
+}
+
+size_t SdFatFileSystem::directoryIndexBytes() const {
+    size_t total = 0;
+    for (const auto& d : indexed) total += d->names.memoryUsage();
+    return total;
+}
+
+std::unique_ptr<IFile> SdFatFileSystem::open(const std::string& path, OpenMode mode) {
+    FsFile raw;
+    if (!openRaw(path, mode, raw)) return nullptr;
+    return std::make_unique<SdFatFileWrapper>(std::move(raw), &stats, &space);
+}
+
+FileHandle SdFatFileSystem::openPooled(const std::string& path, OpenMode mode) {
+    FsFile raw;
+    if (!openRaw(path, mode, raw)) return FileHandle();
+    FileHandle h = pool.make(std::move(raw), &stats, &space);
+    if (!h) raw.close(); // pula pełna
+    return h;
+}
 
-    FsFile raw = sd.open(path.c_str(), flags);
-    DBG("open(%s) result=%d", path.c_str(), raw ? 1 : 0);
-    if (!raw) return nullptr;
-    return std::make_unique<SdFatFileWrapper>(std::move(raw));
+FileHandle SdFatFileSystem::openIn(FileSlot& slot, const std::string& path, OpenMode mode) {
+    FsFile raw;
+    if (!openRaw(path, mode, raw)) return FileHandle();
+    return placeFile<SdFatFileWrapper>(slot, std::move(raw), &stats, &space);
 }
 
 } // namespace sd
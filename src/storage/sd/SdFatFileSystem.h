@@ -4,9 +4,11 @@
 #include <SdFat.h>
 #include <memory>
 #include <string>
+#include <vector>
 #include "storage/IFileSystem.h"
 #include "storage/ITimeProvider.h"
 #include "SdFatFileWrapper.h"
+#include "DirIndex.h"
 
 namespace storage {
 namespace sd {
@@ -18,7 +20,25 @@ private:
     uint8_t csPin;
     ITimeProvider* timeProvider = nullptr;
 
+    FilePool<SdFatFileWrapper, ESP32_STORAGE_FILE_POOL_SIZE> pool;
+    FsMetrics stats{"sd"};
+    FreeSpaceTracker space;
+
+    // Katalog z indeksem nazw: otwarty uchwyt (open po indeksie wpisu) + tablica hashy.
+    struct IndexedDir {
+        std::string path;
+        FsFile dir;
+        DirIndex names;
+    };
+    std::vector<std::unique_ptr<IndexedDir>> indexed;
+
     static ITimeProvider* staticTimeProvider;
+    bool openRaw(const std::string& path, OpenMode mode, FsFile& out);
+    bool ensureParentDirs(const std::string& path);
+    IndexedDir* indexFor(const std::string& dirPath);
+    bool openIndexed(IndexedDir& d, const std::string& name, oflag_t flags, FsFile& out);
+    void indexCreated(const std::string& path, FsFile* opened);
+    void dropIndexesUnder(const std::string& path);
     void getCreatedDateTime(const std::string& path, uint16_t* date, uint16_t* time);
     void getModifiedDateTime(const std::string& path, uint16_t* date, uint16_t* time);
 public:
@@ -31,10 +51,31 @@ public:
     bool exists(const std::string& path) override;
     bool remove(const std::string& path) override;
     bool mkdir(const std::string& path) override;
+    bool rename(const std::string& from, const std::string& to) override;
     uint32_t getCreatedTimestamp(const std::string& path) override;
     uint32_t getModifiedTimestamp(const std::string& path) override;
 
     std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override;
+    FileHandle openPooled(const std::string& path, OpenMode mode) override;
+    FsMetrics* metrics() override { return &stats; }
+
+    // Pierwsze wywołanie skanuje FAT; kolejne korzystają z licznika aktualizowanego
+    // przez zapisy, skracanie, mkdir i remove tego obiektu.
+    bool info(FsInfo& out) override;
+    // Ponowne pełne liczenie (np. w czasie bezczynności, po zmianach spoza tej klasy).
+    bool recountFreeSpace();
+
+    // Indeks nazw dla dużego katalogu (opt-in): jedno przejście katalogu, potem
+    // open/exists/remove w nim bez liniowego przeszukiwania FAT. Aktualizowany przez
+    // open z tworzeniem, mkdir, remove i rename tego obiektu; zmiany z zewnątrz
+    // wymagają ponownego indexDirectory(). Trzyma otwarty uchwyt katalogu.
+    bool indexDirectory(const std::string& path);
+    void dropDirectoryIndex(const std::string& path);
+    size_t directoryIndexBytes() const;
+
+    // Otwarcie w pamięci dostarczonej przez wywołującego (musi przeżyć uchwyt).
+    using FileSlot = FileStorage<SdFatFileWrapper>;
+    FileHandle openIn(FileSlot& slot, const std::string& path, OpenMode mode);
 };
 
 } // namespace sd
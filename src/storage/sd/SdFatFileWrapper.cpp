@@ -4,51 +4,87 @@
 namespace storage {
 namespace sd {
 
-SdFatFileWrapper::SdFatFileWrapper(FsFile f) : file(std::move(f)) {
+SdFatFileWrapper::SdFatFileWrapper(FsFile f, FsMetrics* m, FreeSpaceTracker* s)
+    : file(std::move(f)), metrics(m), space(s) {
     DBG("SdFatFileWrapper::SdFatFileWrapper(%p)", &file);
 }
 
 size_t SdFatFileWrapper::read(void* buf, size_t size) {
     DBG("SdFatFileWrapper::read(size=%u)", size);
+    MetricScope m(metrics, IoOp::Read);
     size_t n = file.read(static_cast<uint8_t*>(buf), size);
+    m.bytes(n);
     DBG("SdFatFileWrapper::read -> %u", n);
     return n;
 }
 
 size_t SdFatFileWrapper::write(const void* buf, size_t size) {
     DBG("SdFatFileWrapper::write(size=%u)", size);
+    MetricScope m(metrics, IoOp::Write);
+    uint64_t before = space ? file.fileSize() : 0;
     size_t n = file.write(static_cast<const uint8_t*>(buf), size);
+    if (space && n) space->resized(before, file.fileSize());
+    m.bytes(n);
+    m.result(n == size);
     DBG("SdFatFileWrapper::write -> %u", n);
     return n;
 }
 
 void SdFatFileWrapper::flush() {
     DBG("SdFatFileWrapper::flush()");
+    MetricScope m(metrics, IoOp::Flush);
     file.flush();
     DBG("SdFatFileWrapper::flush done");
 }
 
 bool SdFatFileWrapper::seek(uint32_t pos) {
     DBG("SdFatFileWrapper::seek(pos=%u)", pos);
+    MetricScope m(metrics, IoOp::Seek);
     bool res = file.seek(pos);
+    m.result(res);
     DBG("SdFatFileWrapper::seek -> %d", res);
     return res;
 }
 
 uint32_t SdFatFileWrapper::position() {
     DBG("SdFatFileWrapper::position()");
-    uint32_t pos = file.position();
+    uint64_t p = file.curPosition();
+    uint32_t pos = p > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(p);
     DBG("SdFatFileWrapper::position -> %u", pos);
     return pos;
 }
 
 uint32_t SdFatFileWrapper::size() {
     DBG("SdFatFileWrapper::size()");
-    uint32_t s = file.size();
+    uint64_t fs = file.fileSize();
+    uint32_t s = fs > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(fs);
     DBG("SdFatFileWrapper::size -> %u", s);
     return s;
 }
 
+bool SdFatFileWrapper::seek64(uint64_t pos) {
+    DBG("SdFatFileWrapper::seek64(pos=%llu)", static_cast<unsigned long long>(pos));
+    MetricScope m(metrics, IoOp::Seek);
+    bool res = file.seekSet(pos);
+    m.result(res);
+    DBG("SdFatFileWrapper::seek64 -> %d", res);
+    return res;
+}
+
+uint64_t SdFatFileWrapper::position64() {
+    DBG("SdFatFileWrapper::position64()");
+    uint64_t pos = file.curPosition();
+    DBG("SdFatFileWrapper::position64 -> %llu", static_cast<unsigned long long>(pos));
+    return pos;
+}
+
+uint64_t SdFatFileWrapper::size64() {
+    DBG("SdFatFileWrapper::size64()");
+    uint64_t s = file.fileSize();
+    DBG("SdFatFileWrapper::size64 -> %llu", static_cast<unsigned long long>(s));
+    return s;
+}
+
 bool SdFatFileWrapper::isOpen() const {
     DBG("SdFatFileWrapper::isOpen()");
     bool res = static_cast<bool>(file);
@@ -58,6 +94,7 @@ bool SdFatFileWrapper::isOpen() const {
 
 void SdFatFileWrapper::close() {
     DBG("SdFatFileWrapper::close()");
+    MetricScope m(metrics, IoOp::Close);
     file.close();
     DBG("SdFatFileWrapper::close done");
 }
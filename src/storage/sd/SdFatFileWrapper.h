@@ -3,6 +3,8 @@
 
 #include <SdFat.h>
 #include "storage/IFile.h"
+#include "storage/Metrics.h"
+#include "FreeSpaceTracker.h"
 
 namespace storage {
 namespace sd {
@@ -11,8 +13,10 @@ namespace sd {
 class SdFatFileWrapper : public IFile {
 private:
     FsFile file;
+    FsMetrics* metrics;
+    FreeSpaceTracker* space;
 public:
-    explicit SdFatFileWrapper(FsFile f);
+    explicit SdFatFileWrapper(FsFile f, FsMetrics* m = nullptr, FreeSpaceTracker* s = nullptr);
 
     size_t read(void* buf, size_t size) override;
     size_t write(const void* buf, size_t size) override;
@@ -20,6 +24,9 @@ public:
     bool seek(uint32_t pos) override;
     uint32_t position() override;
     uint32_t size() override;
+    bool seek64(uint64_t pos) override;
+    uint64_t position64() override;
+    uint64_t size64() override;
     bool isOpen() const override;
     void close() override;
 
@@ -0,0 +1,134 @@
+#include "ShardedStore.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <algorithm>
+
+namespace storage {
+namespace store {
+
+using util::normalizePath;
+
+ShardedStore::ShardedStore(IFileSystem& f, const std::string& r) : ShardedStore(f, r, Config()) {}
+
+ShardedStore::ShardedStore(IFileSystem& f, const std::string& r, const Config& c)
+    : fs(f), root(normalizePath(r)), cfg(c) {
+    if (root == "/") root.clear();
+    if (cfg.levels < 1) cfg.levels = 1;
+    if (cfg.levels > 4) cfg.levels = 4;
+    if (cfg.bitsPerLevel < 1) cfg.bitsPerLevel = 1;
+    if (cfg.bitsPerLevel > 8) cfg.bitsPerLevel = 8;
+    while (cfg.levels * cfg.bitsPerLevel > kMaxBits) cfg.bitsPerLevel--;
+    knownDirs.assign((shardCount() + 31) / 32, 0);
+}
+
+bool ShardedStore::validName(const std::string& name) {
+    return !name.empty() && name != "." && name != ".." && name.find('/') == std::string::npos;
+}
+
+uint32_t ShardedStore::hashName(const std::string& name) {
+    uint32_t h = 2166136261u;
+    for (char ch : name) {
+        uint8_t c = static_cast<uint8_t>(ch);
+        if (c >= 'A' && c <= 'Z') c += 32;
+        h ^= c;
+        h *= 16777619u;
+    }
+    // wymieszanie – shard bierze górne bity
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+uint32_t ShardedStore::shardOf(const std::string& name) const {
+    return hashName(name) >> (32 - cfg.levels * cfg.bitsPerLevel);
+}
+
+std::string ShardedStore::shardPath(uint32_t shard) const {
+    static const char kHex[] = "0123456789abcdef";
+    std::string out = root;
+    int digits = (cfg.bitsPerLevel + 3) / 4;
+    for (int level = cfg.levels - 1; level >= 0; --level) {
+        uint32_t v = (shard >> (level * cfg.bitsPerLevel)) & ((1u << cfg.bitsPerLevel) - 1);
+        out += '/';
+        for (int d = digits - 1; d >= 0; --d) out += kHex[(v >> (d * 4)) & 0xF];
+    }
+    return out;
+}
+
+std::string ShardedStore::pathFor(const std::string& name) const {
+    if (!validName(name)) return std::string();
+    return shardPath(shardOf(name)) + "/" + name;
+}
+
+bool ShardedStore::ensureShard(uint32_t shard) {
+    uint32_t bit = 1u << (shard & 31);
+    if (knownDirs[shard / 32] & bit) return true;
+    std::string dir = shardPath(shard);
+    if (!fs.exists(dir)) {
+        // od góry: root i poziomy pośrednie mogą już istnieć
+        size_t pos = 0;
+        do {
+            pos = dir.find('/', pos + 1);
+            std::string part = dir.substr(0, pos);
+            if (!fs.exists(part) && !fs.mkdir(part)) {
+                DBG("ShardedStore: mkdir %s failed", part.c_str());
+                return false;
+            }
+        } while (pos != std::string::npos);
+    }
+    knownDirs[shard / 32] |= bit;
+    return true;
+}
+
+std::unique_ptr<IFile> ShardedStore::open(const std::string& name, OpenMode mode) {
+    if (!validName(name)) return nullptr;
+    uint32_t shard = shardOf(name);
+    if (mode != OpenMode::Read && !ensureShard(shard)) return nullptr;
+    return fs.open(shardPath(shard) + "/" + name, mode);
+}
+
+bool ShardedStore::exists(const std::string& name) {
+    return validName(name) && fs.exists(pathFor(name));
+}
+
+bool ShardedStore::remove(const std::string& name) {
+    // pusty katalog liścia zostaje – następny zapis do niego nie tworzy go od nowa
+    return validName(name) && fs.remove(pathFor(name));
+}
+
+bool ShardedStore::walk(const std::string& dir, uint8_t level, const std::function<bool(const char*, size_t)>& cb) {
+    std::vector<std::pair<std::string, size_t>> children;
+    if (!fs.listDir(dir.empty() ? "/" : dir.c_str(), [&](const char* name, size_t size) { children.emplace_back(name, size); })) {
+        return true; // brak katalogu = brak obiektów
+    }
+    for (const auto& c : children) {
+        if (level == cfg.levels) {
+            if (!cb(c.first.c_str(), c.second)) return false;
+        } else if (!walk(dir + "/" + c.first, level + 1, cb)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShardedStore::forEach(const std::function<bool(const char*, size_t)>& cb) {
+    return walk(root, 0, cb);
+}
+
+size_t ShardedStore::count() {
+    size_t n = 0;
+    forEach([&n](const char*, size_t) {
+        n++;
+        return true;
+    });
+    return n;
+}
+
+void ShardedStore::forgetDirs() {
+    std::fill(knownDirs.begin(), knownDirs.end(), 0);
+}
+
+} // namespace store
+} // namespace storage
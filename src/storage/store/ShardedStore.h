@@ -0,0 +1,82 @@
+#ifndef STORAGE_STORE_SHARDEDSTORE_H
+#define STORAGE_STORE_SHARDEDSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace store {
+
+/**
+ * @brief Magazyn obiektów rozłożonych po stałym drzewie podkatalogów.
+ *
+ * Nazwa obiektu → hash (FNV-1a, bez rozróżniania wielkości liter jak FAT)
+ * → ścieżka `root/a7/3f/<nazwa>`. Liczba poziomów i bitów na poziom jest
+ * stała, więc liczba wpisów w jednym katalogu pozostaje ograniczona
+ * (np. 100 000 obiektów / 65 536 katalogów liści) – wyszukiwanie wpisu
+ * na FAT jest liniowe, a duże katalogi spowalniają każde `open()`.
+ *
+ * Katalogi powstają leniwie przy pierwszym zapisie do danego liścia;
+ * utworzone liście zapamiętywane są w mapie bitowej (maks. 8 KiB przy
+ * 16 bitach), więc kolejne zapisy pomijają `exists`/`mkdir` poziomów
+ * magazynu. Samo `fs.open` w trybie zapisu nadal sprawdza katalog rodzica
+ * (ensureParentDirs w backendzie) – to jedno `exists` na otwarcie.
+ *
+ * @code
+ * storage::store::ShardedStore objs(sdFs, "/objs");
+ * auto f = objs.open("frame-000123.bin", storage::OpenMode::WriteTruncate);
+ * objs.forEach([](const char* name, size_t size) { ... });
+ * @endcode
+ */
+class ShardedStore {
+public:
+    struct Config {
+        uint8_t levels = 2;        // 1..4 poziomów katalogów
+        uint8_t bitsPerLevel = 8;  // 1..8 bitów (1–2 znaki hex na poziom)
+    };
+    static const uint8_t kMaxBits = 16;  // łącznie na wszystkich poziomach
+
+    ShardedStore(IFileSystem& fs, const std::string& root);
+    ShardedStore(IFileSystem& fs, const std::string& root, const Config& cfg);
+
+    // Nazwa obiektu: niepusta, bez '/', inna niż "." i "..".
+    static bool validName(const std::string& name);
+    static uint32_t hashName(const std::string& name);
+
+    uint32_t shardOf(const std::string& name) const;
+    uint32_t shardCount() const { return 1u << (cfg.levels * cfg.bitsPerLevel); }
+    std::string shardPath(uint32_t shard) const;
+    // Pusty string dla niepoprawnej nazwy.
+    std::string pathFor(const std::string& name) const;
+
+    // Tryby zapisu tworzą brakujące katalogi liścia.
+    std::unique_ptr<IFile> open(const std::string& name, OpenMode mode);
+    bool exists(const std::string& name);
+    bool remove(const std::string& name);
+
+    // Wszystkie obiekty (kolejność zależna od backendu). cb zwraca false = przerwij.
+    bool forEach(const std::function<bool(const char*, size_t)>& cb);
+    size_t count();
+
+    // Po zmianach poza magazynem (np. formatowanie nośnika).
+    void forgetDirs();
+
+private:
+    IFileSystem& fs;
+    std::string root;
+    Config cfg;
+    std::vector<uint32_t> knownDirs;  // bit na liść: katalog już istnieje
+
+    bool ensureShard(uint32_t shard);
+    bool walk(const std::string& dir, uint8_t level, const std::function<bool(const char*, size_t)>& cb);
+};
+
+} // namespace store
+} // namespace storage
+
+#endif // STORAGE_STORE_SHARDEDSTORE_H
@@ -0,0 +1,496 @@
+/*
+ * Csv – strumieniowy odczyt i zapis plików CSV (RFC 4180) bez obiektów String.
+ *
+ *  CsvReader:
+ *   - Plik czytany jest blokami (`blockSize`, domyślnie 4 KiB) do jednego bufora.
+ *     Koniec rekordu szukany jest `memchr` (LF poza cudzysłowem); niepełny rekord
+ *     na końcu bloku przesuwany jest na początek bufora przed doczytaniem.
+ *   - Pola wskazują wprost do bufora (`CsvField` – wskaźnik + długość), ważne do
+ *     następnego `next()`. Pola w cudzysłowie (`"a,b"`, `"x""y"`) są rozpakowywane
+ *     w miejscu; CRLF i LF są równoważne; puste linie są pomijane.
+ *   - Projekcja kolumn: `selectColumns({0, 3})` / `selectNamed({"time", "temp"})` –
+ *     pozostałe pola są tylko przeskakiwane, a po ostatniej wybranej kolumnie
+ *     reszta rekordu nie jest w ogóle tokenizowana.
+ *   - Liczby: `getInt`/`getDouble`/`getFloat` parsują pole bez kopiowania
+ *     (bez `atof`/`strtod` i bez `String::toFloat`). Dla mantysy do 2^53 i wykładnika
+ *     dziesiętnego |e| ≤ 22 wynik jest poprawnie zaokrąglony (jedno dzielenie
+ *     przez dokładną potęgę 10); typowe dane z czujników zawsze się w tym mieszczą.
+ *   - Rekord dłuższy niż bufor jest pomijany (`skipped()`).
+ *
+ *  CsvWriter:
+ *   - Pola dopisywane są do bufora (`bufSize`, domyślnie 1 KiB) i zapisywane
+ *     do pliku dużymi blokami; liczby formatowane wprost do bufora (bez printf).
+ *   - Tekst zawierający separator, cudzysłów lub znak końca linii jest ujmowany
+ *     w cudzysłów. NaN/nieskończoność zapisywane są jako puste pole.
+ *   - Destruktor wywołuje `flush()`.
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     auto f = sdFs.openRead("/export/sensors.csv");
+ *     CsvReader csv(*f);
+ *     csv.readHeader();
+ *     csv.selectNamed({"time", "temp"});
+ *     int32_t t; float temp;
+ *     while (csv.next()) {
+ *       if (csv.getInt(0, t) && csv.getFloat(1, temp)) { ... }
+ *     }
+ *
+ *     auto out = sdFs.openWrite("/export/daily.csv");
+ *     CsvWriter w(*out);
+ *     w.field("time").field("temp").endRow();
+ *     w.fieldInt(now).fieldDouble(21.5, 2).endRow();
+ */
+
+// storage/util/Csv.h
+#pragma once
+#include <Arduino.h>
+#include <cmath>
+#include <initializer_list>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "storage/IFile.h"
+
+namespace storage { namespace util {
+
+struct CsvField {
+  const char* data;   // nie zakończone zerem
+  size_t len;
+  bool present;       // false = rekord nie ma tej kolumny
+};
+
+namespace csv_detail {
+  // Dokładne potęgi 10 w double (do 10^22).
+  inline const double* pow10Table() {
+    static const double t[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return t;
+  }
+  inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+} // namespace csv_detail
+
+class CsvReader {
+public:
+  static const size_t kMaxFields = 32;  // bez projekcji: kolumny 0..31
+
+  explicit CsvReader(IFile& f, size_t blockSize = 4096, char sep = ',')
+    : file_(f), buf_(blockSize < 64 ? 64 : blockSize), sep_(sep) {
+    selectAll();
+  }
+
+  // Projekcja: field(i) zwraca kolumnę cols[i]; pozostałe kolumny są pomijane.
+  void selectColumns(std::initializer_list<uint8_t> cols) {
+    slotOf_.clear();
+    fields_.assign(cols.size(), CsvField{"", 0, false});
+    size_t slot = 0;
+    for (uint8_t c : cols) {
+      if (c >= slotOf_.size()) slotOf_.resize(c + 1, -1);
+      slotOf_[c] = static_cast<int8_t>(slot++);
+    }
+    projected_ = true;
+  }
+
+  // Projekcja po nazwach z nagłówka (readHeader). false = nieznana nazwa (projekcja bez zmian).
+  bool selectNamed(std::initializer_list<const char*> names) {
+    std::vector<uint8_t> cols;
+    for (const char* n : names) {
+      int c = columnIndex(n);
+      if (c < 0 || c > 255) return false;
+      cols.push_back(static_cast<uint8_t>(c));
+    }
+    slotOf_.clear();
+    fields_.assign(cols.size(), CsvField{"", 0, false});
+    for (size_t i = 0; i < cols.size(); ++i) {
+      if (cols[i] >= slotOf_.size()) slotOf_.resize(cols[i] + 1, -1);
+      slotOf_[cols[i]] = static_cast<int8_t>(i);
+    }
+    projected_ = true;
+    return true;
+  }
+
+  void selectAll() {
+    slotOf_.clear();
+    fields_.assign(kMaxFields, CsvField{"", 0, false});
+    projected_ = false;
+  }
+
+  // Pierwszy rekord jako nagłówek (wszystkie kolumny, niezależnie od projekcji).
+  bool readHeader() {
+    header_.clear();
+    bool wasProjected = projected_;
+    std::vector<int8_t> slots;
+    std::vector<CsvField> fields;
+    slots.swap(slotOf_);
+    fields.swap(fields_);
+    selectAll();
+    bool ok = next();
+    if (ok) {
+      for (size_t i = 0; i < count_; ++i) header_.emplace_back(fields_[i].data, fields_[i].len);
+    }
+    slots.swap(slotOf_);
+    fields.swap(fields_);
+    projected_ = wasProjected;
+    return ok;
+  }
+
+  int columnIndex(const char* name) const {
+    for (size_t i = 0; i < header_.size(); ++i) {
+      if (header_[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+  }
+  const std::vector<std::string>& header() const { return header_; }
+
+  // Następny rekord. false = koniec pliku.
+  bool next() {
+    for (;;) {
+      size_t end;
+      if (findRecordEnd(end)) {
+        size_t b = start_;
+        start_ = end < end_ ? end + 1 : end;
+        if (overlong_) { overlong_ = false; skipped_++; continue; }
+        if (end > b && buf_[end - 1] == '\r') end--;
+        if (end == b) continue; // pusta linia
+        tokenize(b, end);
+        records_++;
+        return true;
+      }
+      if (eof_) return false;
+      if (start_ == 0 && end_ == buf_.size()) {
+        // rekord dłuższy niż bufor – odrzucamy go do najbliższego końca rekordu
+        overlong_ = true;
+        start_ = scan_ = end_ = 0;
+      }
+      refill();
+    }
+  }
+
+  size_t fieldCount() const { return count_; }
+  uint32_t records() const { return records_; }
+  uint32_t skipped() const { return skipped_; }
+
+  CsvField field(size_t i) const {
+    return i < count_ ? fields_[i] : CsvField{"", 0, false};
+  }
+
+  bool getInt(size_t i, int32_t& out) const {
+    CsvField f = field(i);
+    return f.present && parseInt(f.data, f.len, out);
+  }
+  bool getDouble(size_t i, double& out) const {
+    CsvField f = field(i);
+    return f.present && parseDouble(f.data, f.len, out);
+  }
+  bool getFloat(size_t i, float& out) const {
+    double d;
+    if (!getDouble(i, d)) return false;
+    out = static_cast<float>(d);
+    return true;
+  }
+
+  // Liczba całkowita ze spacjami dookoła. false = pusta, niepoprawna lub poza zakresem.
+  static bool parseInt(const char* p, size_t n, int32_t& out) {
+    const char* e = p + n;
+    while (p < e && csv_detail::isSpace(*p)) ++p;
+    while (e > p && csv_detail::isSpace(e[-1])) --e;
+    bool neg = false;
+    if (p < e && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    if (p == e || e - p > 10) return false;
+    int64_t v = 0;
+    for (; p < e; ++p) {
+      unsigned d = static_cast<unsigned>(*p - '0');
+      if (d > 9) return false;
+      v = v * 10 + d;
+    }
+    if (neg) v = -v;
+    if (v < INT32_MIN || v > INT32_MAX) return false;
+    out = static_cast<int32_t>(v);
+    return true;
+  }
+
+  // Liczba zmiennoprzecinkowa: [+-]cyfry[.cyfry][e[+-]cyfry], spacje dookoła dozwolone.
+  static bool parseDouble(const char* p, size_t n, double& out) {
+    const char* e = p + n;
+    while (p < e && csv_detail::isSpace(*p)) ++p;
+    while (e > p && csv_detail::isSpace(e[-1])) --e;
+    bool neg = false;
+    if (p < e && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    uint64_t m = 0;
+    int exp10 = 0;
+    bool digits = false;
+    for (; p < e; ++p) {
+      unsigned d = static_cast<unsigned>(*p - '0');
+      if (d > 9) break;
+      digits = true;
+      if (m < 100000000000000000ULL) m = m * 10 + d; else exp10++;
+    }
+    if (p < e && *p == '.') {
+      for (++p; p < e; ++p) {
+        unsigned d = static_cast<unsigned>(*p - '0');
+        if (d > 9) break;
+        digits = true;
+        if (m < 100000000000000000ULL) { m = m * 10 + d; exp10--; }
+      }
+    }
+    if (!digits) return false;
+    if (p < e && (*p == 'e' || *p == 'E')) {
+      ++p;
+      bool eneg = false;
+      if (p < e && (*p == '-' || *p == '+')) eneg = *p++ == '-';
+      if (p == e) return false;
+      int x = 0;
+      for (; p < e; ++p) {
+        unsigned d = static_cast<unsigned>(*p - '0');
+        if (d > 9) return false;
+        if (x < 1000) x = x * 10 + d;
+      }
+      exp10 += eneg ? -x : x;
+    }
+    if (p != e) return false;
+
+    const double* pow10 = csv_detail::pow10Table();
+    double v = static_cast<double>(m);
+    if (m == 0) {
+      v = 0.0;
+    } else if (exp10 < 0) {
+      // poza szybką ścieżką: dzielenie porcjami (błąd do kilku ulp)
+      while (exp10 < -22) { v /= pow10[22]; exp10 += 22; }
+      v /= pow10[-exp10];
+    } else {
+      while (exp10 > 22) { v *= pow10[22]; exp10 -= 22; }
+      v *= pow10[exp10];
+    }
+    out = neg ? -v : v;
+    return true;
+  }
+
+private:
+  IFile& file_;
+  std::vector<char> buf_;
+  char sep_;
+  size_t start_ = 0;    // początek nieprzetworzonych danych
+  size_t scan_ = 0;     // dokąd szukano końca rekordu
+  size_t end_ = 0;      // koniec danych w buforze
+  bool inQuote_ = false;
+  bool eof_ = false;
+  bool overlong_ = false;
+  uint32_t records_ = 0;
+  uint32_t skipped_ = 0;
+
+  bool projected_ = false;
+  std::vector<int8_t> slotOf_;     // kolumna → indeks pola (-1 = pomiń)
+  std::vector<CsvField> fields_;
+  size_t count_ = 0;
+  std::vector<std::string> header_;
+
+  void refill() {
+    if (start_) {
+      memmove(buf_.data(), buf_.data() + start_, end_ - start_);
+      scan_ -= start_;
+      end_ -= start_;
+      start_ = 0;
+    }
+    size_t n = file_.read(buf_.data() + end_, buf_.size() - end_);
+    if (!n) eof_ = true;
+    end_ += n;
+  }
+
+  // Indeks LF kończącego rekord (poza cudzysłowem) albo end_ dla ostatniego rekordu bez LF.
+  bool findRecordEnd(size_t& out) {
+    char* b = buf_.data();
+    if (scan_ < start_) scan_ = start_;
+    while (scan_ < end_) {
+      if (!inQuote_) {
+        const char* nl = static_cast<const char*>(memchr(b + scan_, '\n', end_ - scan_));
+        size_t lim = nl ? static_cast<size_t>(nl - b) : end_;
+        const char* q = static_cast<const char*>(memchr(b + scan_, '"', lim - scan_));
+        if (!q) {
+          scan_ = nl ? lim + 1 : end_;
+          if (nl) { out = lim; return true; }
+          break;
+        }
+        scan_ = static_cast<size_t>(q - b) + 1;
+        inQuote_ = true;
+      } else {
+        // "" wewnątrz pola przełącza stan dwa razy – parzystość wystarcza
+        const char* q = static_cast<const char*>(memchr(b + scan_, '"', end_ - scan_));
+        if (!q) { scan_ = end_; break; }
+        scan_ = static_cast<size_t>(q - b) + 1;
+        inQuote_ = false;
+      }
+    }
+    if (eof_ && start_ < end_) {
+      inQuote_ = false; // niezamknięty cudzysłów na końcu pliku
+      out = end_;
+      return true;
+    }
+    return false;
+  }
+
+  int slotFor(size_t col) const {
+    if (!projected_) return col < kMaxFields ? static_cast<int>(col) : -1;
+    return col < slotOf_.size() ? slotOf_[col] : -1;
+  }
+
+  void tokenize(size_t p, size_t e) {
+    char* b = buf_.data();
+    for (auto& f : fields_) f = CsvField{"", 0, false};
+    size_t lastCol = projected_ ? slotOf_.size() : kMaxFields;
+    size_t col = 0;
+    for (;;) {
+      int slot = slotFor(col);
+      size_t start = p, len, next;
+      if (p < e && b[p] == '"') {
+        size_t w = p, r = p + 1;
+        for (;;) {
+          const char* q = static_cast<const char*>(memchr(b + r, '"', e - r));
+          size_t qi = q ? static_cast<size_t>(q - b) : e;
+          if (slot >= 0) memmove(b + w, b + r, qi - r);
+          w += qi - r;
+          if (!q) { r = e; break; }
+          if (qi + 1 < e && b[qi + 1] == '"') { b[w++] = '"'; r = qi + 2; continue; }
+          r = qi + 1;
+          break;
+        }
+        len = w - start;
+        const char* s = static_cast<const char*>(memchr(b + r, sep_, e - r));
+        next = s ? static_cast<size_t>(s - b) : e;
+      } else {
+        const char* s = static_cast<const char*>(memchr(b + p, sep_, e - p));
+        next = s ? static_cast<size_t>(s - b) : e;
+        len = next - p;
+      }
+      if (slot >= 0) fields_[slot] = CsvField{b + start, len, true};
+      col++;
+      if (next >= e || col >= lastCol) break; // reszta rekordu niepotrzebna
+      p = next + 1;
+    }
+    count_ = projected_ ? fields_.size() : col;
+  }
+};
+
+class CsvWriter {
+public:
+  explicit CsvWriter(IFile& f, size_t bufSize = 1024, char sep = ',')
+    : file_(f), buf_(bufSize < 64 ? 64 : bufSize), sep_(sep) {}
+  ~CsvWriter() { flush(); }
+
+  CsvWriter& field(const char* s) { return field(s, s ? strlen(s) : 0); }
+
+  CsvWriter& field(const char* s, size_t n) {
+    bool quote = false;
+    for (size_t i = 0; i < n && !quote; ++i) {
+      char c = s[i];
+      quote = c == sep_ || c == '"' || c == '\n' || c == '\r';
+    }
+    beginField();
+    if (!quote) { put(s, n); return *this; }
+    put("\"", 1);
+    const char* e = s + n;
+    while (s < e) {
+      const char* q = static_cast<const char*>(memchr(s, '"', e - s));
+      size_t len = q ? static_cast<size_t>(q - s) + 1 : static_cast<size_t>(e - s);
+      put(s, len);
+      if (q) put("\"", 1); // "" = cudzysłów w polu
+      s += len;
+    }
+    put("\"", 1);
+    return *this;
+  }
+
+  CsvWriter& fieldInt(int64_t v) {
+    char tmp[24];
+    beginField();
+    put(tmp, formatInt(v, tmp));
+    return *this;
+  }
+
+  CsvWriter& fieldDouble(double v, uint8_t decimals = 3) {
+    char tmp[32];
+    beginField();
+    put(tmp, formatDouble(v, decimals, tmp));
+    return *this;
+  }
+
+  // Kończy wiersz (LF). false = wcześniejszy błąd zapisu.
+  bool endRow() {
+    put("\n", 1);
+    first_ = true;
+    return ok_;
+  }
+
+  bool flush() {
+    if (len_ && ok_) {
+      ok_ = file_.write(buf_.data(), len_) == len_;
+    }
+    len_ = 0;
+    return ok_;
+  }
+
+  bool ok() const { return ok_; }
+
+  // Zwracają liczbę znaków (bez NUL). out: 24 B / 32 B.
+  static size_t formatInt(int64_t v, char* out) {
+    char tmp[24];
+    size_t n = 0;
+    uint64_t u = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    do { tmp[n++] = static_cast<char>('0' + u % 10); u /= 10; } while (u);
+    size_t len = 0;
+    if (v < 0) out[len++] = '-';
+    while (n) out[len++] = tmp[--n];
+    return len;
+  }
+
+  static size_t formatDouble(double v, uint8_t decimals, char* out) {
+    if (std::isnan(v) || std::isinf(v)) return 0;
+    if (decimals > 9) decimals = 9;
+    const double* pow10 = csv_detail::pow10Table();
+    double a = std::fabs(v) * pow10[decimals] + 0.5;
+    if (a >= 1e18) {
+      int n = snprintf(out, 32, "%.17g", v); // poza zakresem stałoprzecinkowym
+      return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+    uint64_t s = static_cast<uint64_t>(a);
+    uint64_t scale = static_cast<uint64_t>(pow10[decimals]);
+    size_t len = 0;
+    if (v < 0 && s) out[len++] = '-';
+    len += formatInt(static_cast<int64_t>(s / scale), out + len);
+    if (decimals) {
+      out[len++] = '.';
+      uint64_t frac = s % scale;
+      for (int i = decimals - 1; i >= 0; --i) {
+        out[len + i] = static_cast<char>('0' + frac % 10);
+        frac /= 10;
+      }
+      len += decimals;
+    }
+    return len;
+  }
+
+private:
+  IFile& file_;
+  std::vector<char> buf_;
+  char sep_;
+  size_t len_ = 0;
+  bool first_ = true;
+  bool ok_ = true;
+
+  void beginField() {
+    if (!first_) put(&sep_, 1);
+    first_ = false;
+  }
+
+  void put(const char* s, size_t n) {
+    if (len_ + n > buf_.size()) {
+      flush();
+      if (n > buf_.size()) { // dłuższe niż bufor – prosto do pliku
+        if (ok_) ok_ = file_.write(s, n) == n;
+        return;
+      }
+    }
+    memcpy(buf_.data() + len_, s, n);
+    len_ += n;
+  }
+};
+
+}} // ns
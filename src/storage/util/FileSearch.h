@@ -0,0 +1,337 @@
+/*
+ * FileSearch – strumieniowe wyszukiwanie wielu wzorców w plikach i drzewach katalogów.
+ *
+ *  ZAŁOŻENIA:
+ *   - Plik czytany jest blokami (`blockSize`, domyślnie 4 KiB) do jednego bufora;
+ *     nie ma alokacji na linię ani obiektów String.
+ *   - Do 8 wzorców naraz (bez znaku LF), opcjonalnie bez rozróżniania wielkości liter (ASCII).
+ *   - Wzorzec 1-bajtowy: `memchr`; dłuższe: Horspool z tablicą przesunięć
+ *     (256 B na wzorzec) kotwiczony przez `memchr` na ostatnim bajcie wzorca.
+ *     `memchr` z newlib/glibc porównuje słowami, co na ESP32 (Xtensa, bez SIMD)
+ *     jest najszybszą dostępną ścieżką.
+ *   - Dopasowania na granicy bloków: niezakończona ostatnia linia bloku
+ *     (do `maxLine` bajtów) przechodzi na początek następnego; dłuższa linia –
+ *     tylko ostatnie (najdłuższy wzorzec - 1) bajtów. Każde dopasowanie
+ *     zgłaszane jest dokładnie raz.
+ *
+ *  WYNIK (`SearchHit`): ścieżka, numer wzorca, numer linii (od 1), offset
+ *  dopasowania w pliku oraz treść linii (bez CR/LF, najwyżej `maxLine` bajtów;
+ *  dla linii dłuższych niż bufor – fragment).
+ *
+ *  DRZEWO KATALOGÓW:
+ *   - `beginTree()` + wielokrotne `stepTree(budgetMs)`: praca dzielona na kawałki
+ *     ograniczone czasem (sprawdzany między blokami), np. w `loop()` obok
+ *     obsługi konsoli. Wpisy o rozmiarze 0 traktowane są jako katalogi
+ *     (listDir na pustym pliku zawodzi – nie ma czego przeszukiwać).
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     FileSearch grep;
+ *     grep.addPattern("ERROR");
+ *     grep.addPattern("timeout");
+ *     grep.beginTree(sdFs, "/logs", [](const SearchHit& h) {
+ *       Serial.printf("%s:%u: %.*s\n", h.path, h.line, (int)h.textLen, h.text);
+ *       return true; // false = stop
+ *     });
+ *     while (grep.stepTree(20)) { yield(); }
+ */
+
+// storage/util/FileSearch.h
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <string.h>
+#include "storage/IFileSystem.h"
+
+namespace storage { namespace util {
+
+struct SearchHit {
+  const char* path;
+  uint8_t pattern;    // indeks z addPattern
+  uint32_t line;      // od 1
+  uint32_t offset;    // offset dopasowania w pliku
+  const char* text;   // treść linii (nie zakończona zerem)
+  size_t textLen;
+};
+
+class FileSearch {
+public:
+  using HitCallback = std::function<bool(const SearchHit&)>;
+  static const size_t kMaxPatterns = 8;
+
+  explicit FileSearch(size_t blockSize = 4096, size_t maxLine = 200)
+    : block_(blockSize < 64 ? 64 : blockSize), maxLine_(maxLine) {}
+
+  // Zwraca indeks wzorca lub -1 (pusty, z LF, za dużo wzorców).
+  int addPattern(const char* p) {
+    size_t n = p ? strlen(p) : 0;
+    if (!n || memchr(p, '\n', n) || pats_.size() >= kMaxPatterns) return -1;
+    Pattern pat;
+    pat.text.assign(p, n);
+    pats_.push_back(pat);
+    maxPat_ = std::max(maxPat_, n);
+    prepared_ = false;
+    return static_cast<int>(pats_.size() - 1);
+  }
+
+  void setIgnoreCase(bool on) { icase_ = on; prepared_ = false; }
+  void clearPatterns() { pats_.clear(); maxPat_ = 0; prepared_ = false; }
+
+  uint32_t filesScanned() const { return files_; }
+  uint64_t bytesScanned() const { return bytes_; }
+  uint32_t hits() const { return hits_; }
+
+  // Przeszukuje cały otwarty plik. Zwraca liczbę dopasowań (false z cb przerywa).
+  uint32_t searchFile(IFile& f, const char* path, const HitCallback& cb) {
+    uint32_t before = hits_;
+    Scan s;
+    if (!startScan(s, &f, path)) return 0;
+    while (!s.done && scanBlock(s, cb)) {}
+    return hits_ - before;
+  }
+
+  // Przeszukiwanie drzewa w kawałkach. clock domyślnie millis().
+  void beginTree(IFileSystem& fs, const char* root, HitCallback cb, std::function<uint32_t()> clock = nullptr) {
+    fs_ = &fs;
+    cb_ = std::move(cb);
+    clock_ = clock ? std::move(clock) : std::function<uint32_t()>([] { return (uint32_t)millis(); });
+    dirs_.assign(1, root && *root ? std::string(root) : std::string("/"));
+    entries_.clear();
+    cur_ = Scan();
+    stopped_ = false;
+    files_ = 0; bytes_ = 0; hits_ = 0;
+  }
+
+  // Zwraca true, jeśli została praca do wykonania.
+  bool stepTree(uint32_t budgetMs) {
+    if (!fs_) return false;
+    uint32_t start = clock_();
+    do {
+      if (stopped_) break;
+      if (cur_.file) {
+        if (!scanBlock(cur_, cb_)) stopped_ = true;
+        if (cur_.done) { cur_.owned.reset(); cur_.file = nullptr; }
+        continue;
+      }
+      if (!entries_.empty()) {
+        Entry e = entries_.back();
+        entries_.pop_back();
+        if (e.size == 0) { dirs_.push_back(e.path); continue; }
+        cur_ = Scan();
+        cur_.owned = fs_->openRead(e.path);
+        if (cur_.owned) { cur_.pathStore = e.path; startScan(cur_, cur_.owned.get(), nullptr); }
+        continue;
+      }
+      if (!dirs_.empty()) {
+        std::string dir = dirs_.back();
+        dirs_.pop_back();
+        std::string prefix = dir == "/" ? dir : dir + "/";
+        size_t first = entries_.size();
+        fs_->listDir(dir.c_str(), [&](const char* name, size_t size) {
+          entries_.push_back(Entry{prefix + name, size});
+        });
+        std::reverse(entries_.begin() + first, entries_.end()); // kolejność z listDir
+        continue;
+      }
+      fs_ = nullptr;
+      return false;
+    } while (clock_() - start < budgetMs);
+    if (stopped_) { fs_ = nullptr; cur_ = Scan(); return false; }
+    return true;
+  }
+
+  void cancel() { fs_ = nullptr; cur_ = Scan(); entries_.clear(); dirs_.clear(); }
+
+private:
+  struct Pattern {
+    std::string text;     // po ewentualnym złożeniu wielkości liter
+    uint8_t shift[256];
+  };
+  struct Entry { std::string path; size_t size; };
+  struct Scan {
+    IFile* file = nullptr;
+    std::unique_ptr<IFile> owned;
+    const char* path = nullptr;
+    std::string pathStore;
+    std::unique_ptr<char[]> buf;
+    size_t len = 0;           // bajty w buforze (przeniesione + nowe)
+    uint32_t bufOffset = 0;   // offset pliku dla buf[0]
+    uint32_t line = 1;        // numer linii dla buf[0]
+    bool atLineStart = true;  // czy buf[0] zaczyna linię
+    bool done = false;
+  };
+
+  size_t block_, maxLine_;
+  size_t maxPat_ = 0;
+  bool icase_ = false;
+  bool prepared_ = false;
+  std::vector<Pattern> pats_;
+  std::vector<std::pair<uint32_t, uint8_t>> found_; // (pozycja w buforze, wzorzec)
+
+  IFileSystem* fs_ = nullptr;
+  HitCallback cb_;
+  std::function<uint32_t()> clock_;
+  std::vector<std::string> dirs_;
+  std::vector<Entry> entries_;
+  Scan cur_;
+  bool stopped_ = false;
+  uint32_t files_ = 0, hits_ = 0;
+  uint64_t bytes_ = 0;
+
+  static inline uint8_t fold(uint8_t c) { return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+  void prepare() {
+    if (prepared_) return;
+    for (auto& p : pats_) {
+      if (icase_) for (auto& c : p.text) c = static_cast<char>(fold(static_cast<uint8_t>(c)));
+      size_t m = p.text.size();
+      size_t def = m < 255 ? m : 255;
+      memset(p.shift, static_cast<int>(def), sizeof(p.shift));
+      for (size_t i = 0; i + 1 < m; ++i) {
+        size_t sh = m - 1 - i;
+        uint8_t c = static_cast<uint8_t>(p.text[i]);
+        p.shift[c] = static_cast<uint8_t>(sh < 255 ? sh : 255);
+        if (icase_ && c >= 'a' && c <= 'z') p.shift[c - 32] = p.shift[c];
+      }
+    }
+    prepared_ = true;
+  }
+
+  bool startScan(Scan& s, IFile* f, const char* path) {
+    if (pats_.empty()) { s.done = true; return false; }
+    prepare();
+    s.file = f;
+    s.path = path ? path : s.pathStore.c_str();
+    s.buf.reset(new char[maxLine_ + maxPat_ + block_]);
+    s.len = 0;
+    s.bufOffset = 0;
+    s.line = 1;
+    s.atLineStart = true;
+    s.done = false;
+    files_++;
+    return f->seek(0);
+  }
+
+  bool equalAt(const char* h, const Pattern& p) const {
+    size_t m = p.text.size();
+    if (!icase_) return memcmp(h, p.text.data(), m) == 0;
+    for (size_t i = 0; i < m; ++i)
+      if (fold(static_cast<uint8_t>(h[i])) != static_cast<uint8_t>(p.text[i])) return false;
+    return true;
+  }
+
+  // Wszystkie wystąpienia p w buf[0, end) zaczynające się przed `limit`.
+  void findAll(const char* buf, size_t end, size_t limit, const Pattern& p, uint8_t idx) {
+    size_t m = p.text.size();
+    if (m > end) return;
+    uint8_t lastc = static_cast<uint8_t>(p.text[m - 1]);
+    if (m == 1 && !icase_) {
+      const char* q = buf;
+      const char* stop = buf + std::min(end, limit);
+      while (q < stop && (q = static_cast<const char*>(memchr(q, lastc, stop - q)))) {
+        found_.emplace_back(static_cast<uint32_t>(q - buf), idx);
+        ++q;
+      }
+      return;
+    }
+    size_t i = 0;
+    while (i + m <= end && i < limit) {
+      // kotwica: memchr na ostatnim bajcie (bez ignorowania wielkości liter)
+      if (!icase_) {
+        const char* a = static_cast<const char*>(memchr(buf + i + m - 1, lastc, end - (i + m - 1)));
+        if (!a) return;
+        i = static_cast<size_t>(a - buf) - (m - 1);
+        if (i >= limit) return;
+      }
+      uint8_t c = static_cast<uint8_t>(buf[i + m - 1]);
+      if ((icase_ ? fold(c) : c) == lastc && equalAt(buf + i, p)) {
+        found_.emplace_back(static_cast<uint32_t>(i), idx);
+        i++;
+      } else {
+        i += p.shift[c];
+      }
+    }
+  }
+
+  // Przetwarza jeden blok. false = callback przerwał.
+  bool scanBlock(Scan& s, const HitCallback& cb) {
+    char* buf = s.buf.get();
+    size_t got = s.file->read(buf + s.len, block_);
+    bytes_ += got;
+    bool eof = got == 0 || got < block_;
+    size_t len = s.len + got;
+    if (!len) { s.done = true; return true; }
+
+    // granica przetwarzania i początek przeniesienia do następnego bloku
+    size_t processEnd = len, carry = len;
+    if (!eof) {
+      size_t lastNl = len;
+      while (lastNl > 0 && buf[lastNl - 1] != '\n') --lastNl;
+      if (lastNl > 0 && len - lastNl <= maxLine_) {
+        processEnd = carry = lastNl;
+      } else {
+        size_t keep = maxPat_ ? maxPat_ - 1 : 0;
+        processEnd = carry = len > keep ? len - keep : 0;
+      }
+    }
+
+    found_.clear();
+    for (size_t k = 0; k < pats_.size(); ++k) {
+      size_t m = pats_[k].text.size();
+      findAll(buf, std::min(len, processEnd + m - 1), processEnd, pats_[k], static_cast<uint8_t>(k));
+    }
+    if (found_.size() > 1) std::sort(found_.begin(), found_.end());
+
+    // numery linii: przejście po LF tylko do kolejnych dopasowań
+    size_t pos = 0, lineStart = 0;
+    bool lineStartKnown = s.atLineStart;
+    uint32_t line = s.line;
+    bool keepGoing = true;
+    for (const auto& hit : found_) {
+      while (pos < hit.first) {
+        const char* nl = static_cast<const char*>(memchr(buf + pos, '\n', hit.first - pos));
+        if (!nl) { pos = hit.first; break; }
+        line++;
+        pos = static_cast<size_t>(nl - buf) + 1;
+        lineStart = pos;
+        lineStartKnown = true;
+      }
+      size_t tStart = lineStartKnown ? lineStart : 0;
+      const char* e = static_cast<const char*>(memchr(buf + tStart, '\n', len - tStart));
+      size_t tEnd = e ? static_cast<size_t>(e - buf) : len;
+      if (tEnd > tStart && buf[tEnd - 1] == '\r') tEnd--;
+      if (tEnd - tStart > maxLine_) {
+        // długa linia: fragment wokół dopasowania
+        tStart = hit.first > maxLine_ / 2 ? std::max(tStart, hit.first - maxLine_ / 2) : tStart;
+        tEnd = std::min(tEnd, tStart + maxLine_);
+      }
+      SearchHit h{s.path, hit.second, line, s.bufOffset + hit.first, buf + tStart, tEnd - tStart};
+      hits_++;
+      if (!cb(h)) { keepGoing = false; break; }
+    }
+    if (!keepGoing) { s.done = true; return false; }
+
+    // przesunięcie stanu do początku przeniesionego fragmentu
+    while (pos < carry) {
+      const char* nl = static_cast<const char*>(memchr(buf + pos, '\n', carry - pos));
+      if (!nl) { pos = carry; break; }
+      line++;
+      pos = static_cast<size_t>(nl - buf) + 1;
+      lineStartKnown = true;
+      lineStart = pos;
+    }
+    s.line = line;
+    s.atLineStart = carry == 0 ? s.atLineStart : (lineStartKnown && lineStart == carry);
+    memmove(buf, buf + carry, len - carry);
+    s.len = len - carry;
+    s.bufOffset += static_cast<uint32_t>(carry);
+    if (eof) s.done = true;
+    return true;
+  }
+};
+
+}} // ns
@@ -39,6 +39,15 @@
  *         Serial.println(port);
  *     }
  *
+ *  SCHEMAT (bez String):
+ *     Konfigurację można też wczytać bezpośrednio do struktury opisanej
+ *     statycznym schematem (`IniSchema.h`). Linie czytane są blokami do
+ *     jednego bufora, klucze wyszukiwane doskonałym hashem, a nieznane lub
+ *     niepoprawne wpisy raportowane przez callback:
+ *
+ *     AppConfig cfg;
+ *     if (!ini.parseInto(kAppSchema, cfg, onIssue)) { ... }
+ *
  *  PRZYKŁADOWY PLIK INI:
  *     ; Konfiguracja aplikacji audio
  *     # Wersja pliku 1.0
@@ -66,7 +75,12 @@
 // storage/util/IniReader.h
 #pragma once
 #include <Arduino.h>
+#include <errno.h>
+#include <memory>
+#include <string.h>
+#include <strings.h>
 #include "storage/IFile.h"
+#include "IniSchema.h"
 
 namespace storage { namespace util {
 
@@ -108,8 +122,179 @@ public:
     return true;
   }
 
+  // Wariant bez String: linie czytane blokami do jednego bufora (cap_ znaków).
+  // Sekcja i klucz są już lowercase, komentarz końcowy obcięty.
+  // Wskaźniki są ważne tylko w trakcie wywołania onKV.
+  bool parseRaw(std::function<bool(const char* section, const char* key, const char* val, uint16_t line)> onKV) {
+    std::unique_ptr<char[]> mem(new char[2 * (cap_ + 1)]);
+    char* line = mem.get();
+    char* section = line + cap_ + 1;
+    section[0] = '\0';
+    uint16_t lineNo = 0;
+
+    f_.seek(0);
+    blkLen_ = blkPos_ = 0;
+    size_t len;
+    while (readLineRaw(line, len)) {
+      lineNo++;
+      char* s = trimRaw(line, len);
+      if (!*s || *s == ';' || *s == '#') continue;
+
+      if (*s == '[') {
+        char* r = strchr(s, ']');
+        if (r && r > s + 1) {
+          *r = '\0';
+          char* name = trimRaw(s + 1, (size_t)(r - s - 1));
+          lowerRaw(name);
+          strcpy(section, name);
+        }
+        continue;
+      }
+
+      char* key; char* val;
+      if (!splitKvRaw(s, key, val)) continue;
+      lowerRaw(key);
+      if (!onKV(section, key, val, lineNo)) return false;
+    }
+    return true;
+  }
+
+  // Wczytuje plik do struktury opisanej schematem. Najpierw (opcjonalnie)
+  // ustawia wartości domyślne. Zwraca true, gdy nie zgłoszono żadnego problemu.
+  template <class T, size_t N>
+  bool parseInto(const IniSchema<T, N>& schema, T& out,
+                 std::function<void(const IniIssue&)> onIssue = nullptr,
+                 bool withDefaults = true) {
+    if (withDefaults) applyDefaults(schema, out);
+    bool clean = true;
+    auto report = [&](IniIssueKind kind, const char* sec, const char* key, const char* val, uint16_t ln) {
+      clean = false;
+      if (onIssue) onIssue(IniIssue{kind, sec, key, val, ln});
+    };
+    parseRaw([&](const char* sec, const char* key, const char* val, uint16_t ln) {
+      int idx = schema.find(sec, key);
+      if (idx < 0) { report(IniIssueKind::UnknownKey, sec, key, val, ln); return true; }
+      IniIssueKind kind;
+      if (!storeField(schema.fields[idx], reinterpret_cast<uint8_t*>(&out), val, kind))
+        report(kind, sec, key, val, ln);
+      return true;
+    });
+    return clean;
+  }
+
+  template <class T, size_t N>
+  static void applyDefaults(const IniSchema<T, N>& schema, T& out) {
+    uint8_t* base = reinterpret_cast<uint8_t*>(&out);
+    for (size_t i = 0; i < N; ++i) {
+      const IniField& f = schema.fields[i];
+      switch (f.type) {
+        case IniType::Bool:  { bool v = f.def != 0.0;      memcpy(base + f.offset, &v, sizeof(v)); break; }
+        case IniType::Int:   { int32_t v = (int32_t)f.def; memcpy(base + f.offset, &v, sizeof(v)); break; }
+        case IniType::Float: { float v = (float)f.def;     memcpy(base + f.offset, &v, sizeof(v)); break; }
+        case IniType::Str:   copyStr((char*)(base + f.offset), f.size, f.defStr ? f.defStr : ""); break;
+      }
+    }
+  }
+
 private:
   IFile& f_; size_t cap_;
+  char blk_[64]; size_t blkLen_ = 0, blkPos_ = 0;
+
+  // Linia bez \r\n, obcięta do cap_ znaków. false = EOF bez danych.
+  bool readLineRaw(char* out, size_t& len) {
+    len = 0;
+    bool any = false;
+    while (true) {
+      if (blkPos_ >= blkLen_) {
+        blkLen_ = f_.read(blk_, sizeof(blk_));
+        blkPos_ = 0;
+        if (!blkLen_) break;
+      }
+      char c = blk_[blkPos_++];
+      any = true;
+      if (c == '\r') continue;
+      if (c == '\n') { out[len] = '\0'; return true; }
+      if (len < cap_) out[len++] = c;
+    }
+    out[len] = '\0';
+    return any; // ostatnia linia bez \n
+  }
+
+  static char* trimRaw(char* s, size_t len) {
+    while (len && isspace((unsigned char)s[len - 1])) len--;
+    s[len] = '\0';
+    while (*s && isspace((unsigned char)*s)) s++;
+    return s;
+  }
+
+  static void lowerRaw(char* s) { for (; *s; ++s) *s = (char)tolower((unsigned char)*s); }
+
+  // Ta sama semantyka co parseKv + stripInlineComment, ale w miejscu.
+  static bool splitKvRaw(char* line, char*& key, char*& val) {
+    char* eq = strchr(line, '=');
+    char* split = eq;
+    if (!split) { split = line; while (*split && !isspace((unsigned char)*split)) split++; }
+    key = line;
+    if (!*split) { val = split; }
+    else {
+      *split = '\0';
+      val = split + 1;
+      char* c = val;
+      while (*c && *c != ';' && *c != '#') c++;
+      *c = '\0';
+      val = trimRaw(val, strlen(val));
+    }
+    key = trimRaw(key, strlen(key));
+    return *key != '\0';
+  }
+
+  static void copyStr(char* dst, size_t cap, const char* src) {
+    if (!cap) return;
+    size_t n = strlen(src);
+    if (n >= cap) n = cap - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+
+  static bool storeField(const IniField& f, uint8_t* base, const char* val, IniIssueKind& kind) {
+    kind = IniIssueKind::InvalidValue;
+    char* end = nullptr;
+    switch (f.type) {
+      case IniType::Bool: {
+        bool v;
+        if (!strcasecmp(val, "true") || !strcasecmp(val, "yes") || !strcasecmp(val, "on") || !strcmp(val, "1")) v = true;
+        else if (!strcasecmp(val, "false") || !strcasecmp(val, "no") || !strcasecmp(val, "off") || !strcmp(val, "0")) v = false;
+        else return false;
+        memcpy(base + f.offset, &v, sizeof(v));
+        return true;
+      }
+      case IniType::Int: {
+        bool hex = val[0] == '0' && (val[1] == 'x' || val[1] == 'X');
+        errno = 0;
+        long v = strtol(val, &end, hex ? 16 : 10);
+        if (end == val || *end) return false;
+        if (errno == ERANGE || v < INT32_MIN || v > INT32_MAX || !((double)v >= f.min && (double)v <= f.max)) {
+          kind = IniIssueKind::OutOfRange; return false;
+        }
+        int32_t iv = (int32_t)v;
+        memcpy(base + f.offset, &iv, sizeof(iv));
+        return true;
+      }
+      case IniType::Float: {
+        float v = strtof(val, &end);
+        if (end == val || *end) return false;
+        // odwrócony warunek – NaN nie spełnia żadnego porównania
+        if (!((double)v >= f.min && (double)v <= f.max)) { kind = IniIssueKind::OutOfRange; return false; }
+        memcpy(base + f.offset, &v, sizeof(v));
+        return true;
+      }
+      case IniType::Str:
+        copyStr((char*)(base + f.offset), f.size, val);
+        if (strlen(val) >= f.size) { kind = IniIssueKind::Truncated; return false; }
+        return true;
+    }
+    return false;
+  }
 
   bool readLine(String& out) {
     out.remove(0);
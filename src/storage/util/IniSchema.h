@@ -0,0 +1,243 @@
+/*
+ * IniSchema – statyczny (compile-time) opis struktury konfiguracji dla IniReader.
+ *
+ *  ZAŁOŻENIA:
+ *   - Struktura konfiguracji jest zwykłą strukturą POD (standard-layout),
+ *     a każde pole opisuje deskryptor `IniField` (sekcja, klucz, typ, offset,
+ *     wartość domyślna, zakres).
+ *   - Tablica deskryptorów jest `constexpr`; z niej w czasie kompilacji
+ *     budowana jest doskonała funkcja skrótu (hash-and-displace), więc
+ *     wyszukanie klucza to jeden hash + jedno porównanie, bez `String`.
+ *   - Sekcje i klucze porównywane są bez względu na wielkość liter.
+ *
+ *  OBSŁUGIWANE TYPY PÓL:
+ *   - `bool`    – true/false, 1/0, yes/no, on/off,
+ *   - `int32_t` – dziesiętnie lub szesnastkowo (`0x..`), z kontrolą zakresu,
+ *   - `float`   – z kontrolą zakresu,
+ *   - `char[N]` – tekst kopiowany do bufora w strukturze (bez sterty).
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     struct AppConfig {
+ *       char    host[32];
+ *       int32_t port;
+ *       bool    timeshift;
+ *       float   volume;
+ *     };
+ *
+ *     constexpr storage::util::IniField kAppFields[] = {
+ *       storage::util::iniString("network", "host", offsetof(AppConfig, host),
+ *                                sizeof(AppConfig::host), "example.com"),
+ *       storage::util::iniInt("network", "port", offsetof(AppConfig, port), 8080, 1, 65535),
+ *       storage::util::iniBool("audio", "timeshift", offsetof(AppConfig, timeshift), false),
+ *       storage::util::iniFloat("audio", "volume", offsetof(AppConfig, volume), 0.5f, 0.0f, 1.0f),
+ *     };
+ *     constexpr auto kAppSchema = storage::util::makeIniSchema<AppConfig>(kAppFields);
+ *     static_assert(kAppSchema.ok, "niepoprawny schemat konfiguracji");
+ *
+ *     AppConfig cfg;
+ *     IniReader ini(fileHandle);
+ *     ini.parseInto(kAppSchema, cfg, [](const storage::util::IniIssue& e) {
+ *       Serial.printf("config: %s [%s] %s\n", iniIssueName(e.kind), e.section, e.key);
+ *     });
+ */
+
+// storage/util/IniSchema.h
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <float.h>
+#include <type_traits>
+
+namespace storage { namespace util {
+
+enum class IniType : uint8_t { Bool, Int, Float, Str };
+
+struct IniField {
+  const char* section;
+  const char* key;
+  IniType     type;
+  uint16_t    offset;  // offsetof(T, pole)
+  uint16_t    size;    // pojemność bufora dla Str (razem z '\0')
+  double      def;     // domyślna wartość dla Bool/Int/Float
+  const char* defStr;  // domyślna wartość dla Str
+  double      min;
+  double      max;
+};
+
+// ------------------- fabryki deskryptorów -------------------
+
+constexpr IniField iniBool(const char* section, const char* key, size_t offset, bool def) {
+  return IniField{section, key, IniType::Bool, (uint16_t)offset, (uint16_t)sizeof(bool),
+                  def ? 1.0 : 0.0, nullptr, 0.0, 1.0};
+}
+
+constexpr IniField iniInt(const char* section, const char* key, size_t offset, int32_t def,
+                          int32_t min = INT32_MIN, int32_t max = INT32_MAX) {
+  return IniField{section, key, IniType::Int, (uint16_t)offset, (uint16_t)sizeof(int32_t),
+                  (double)def, nullptr, (double)min, (double)max};
+}
+
+constexpr IniField iniFloat(const char* section, const char* key, size_t offset, float def,
+                            float min = -FLT_MAX, float max = FLT_MAX) {
+  return IniField{section, key, IniType::Float, (uint16_t)offset, (uint16_t)sizeof(float),
+                  (double)def, nullptr, (double)min, (double)max};
+}
+
+constexpr IniField iniString(const char* section, const char* key, size_t offset, size_t size,
+                             const char* def = "") {
+  return IniField{section, key, IniType::Str, (uint16_t)offset, (uint16_t)size,
+                  0.0, def, 0.0, 0.0};
+}
+
+// ------------------- raportowanie problemów -------------------
+
+enum class IniIssueKind : uint8_t {
+  UnknownKey,    // klucz (lub sekcja) spoza schematu
+  InvalidValue,  // wartość nie daje się sparsować do typu pola
+  OutOfRange,    // wartość poza [min, max] – pole zachowuje poprzednią wartość
+  Truncated,     // tekst dłuższy niż bufor – zapisano obciętą wartość
+};
+
+struct IniIssue {
+  IniIssueKind kind;
+  const char*  section;
+  const char*  key;
+  const char*  value;
+  uint16_t     line;
+};
+
+inline const char* iniIssueName(IniIssueKind k) {
+  switch (k) {
+    case IniIssueKind::UnknownKey:   return "unknown key";
+    case IniIssueKind::InvalidValue: return "invalid value";
+    case IniIssueKind::OutOfRange:   return "out of range";
+    case IniIssueKind::Truncated:    return "truncated";
+  }
+  return "?";
+}
+
+// ------------------- hash (constexpr, bez alokacji) -------------------
+
+constexpr char iniFold(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; }
+
+// FNV-1a po „sekcja \x1f klucz” (case-insensitive)
+constexpr uint32_t iniHash(const char* section, const char* key) {
+  uint32_t h = 2166136261u;
+  for (const char* p = section; *p; ++p) { h ^= (uint8_t)iniFold(*p); h *= 16777619u; }
+  h ^= 0x1fu; h *= 16777619u;
+  for (const char* p = key; *p; ++p) { h ^= (uint8_t)iniFold(*p); h *= 16777619u; }
+  return h;
+}
+
+constexpr uint32_t iniMix(uint32_t h, uint32_t d) {
+  h ^= d * 0x9E3779B9u;
+  h ^= h >> 16; h *= 0x85EBCA6Bu;
+  h ^= h >> 13; h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+constexpr bool iniEqualsFold(const char* a, const char* b) {
+  while (*a && *b) { if (iniFold(*a) != iniFold(*b)) return false; ++a; ++b; }
+  return *a == *b;
+}
+
+// najmniejsza potęga 2 >= 2n (współczynnik wypełnienia <= 0.5)
+constexpr size_t iniTableSize(size_t n) {
+  size_t s = 1;
+  while (s < 2 * n) s <<= 1;
+  return s;
+}
+
+// ------------------- schemat -------------------
+
+template <class T, size_t N>
+struct IniSchema {
+  static_assert(N > 0, "IniSchema: pusta lista pol");
+  static_assert(std::is_standard_layout<T>::value, "IniSchema: struktura musi byc standard-layout");
+
+  static constexpr size_t kSlots = iniTableSize(N);
+  static constexpr size_t kBuckets = kSlots / 2;
+  static constexpr uint16_t kMaxDisplacement = 4096;
+
+  const IniField* fields;
+  uint16_t disp[kBuckets];
+  int16_t  slot[kSlots];   // indeks pola lub -1
+  bool     ok;             // false = duplikat klucza, zły offset albo brak rozwiązania
+
+  constexpr explicit IniSchema(const IniField* f) : fields(f), disp{}, slot{}, ok(false) {
+    ok = build();
+  }
+
+  constexpr size_t size() const { return N; }
+
+  // Zwraca indeks pola lub -1.
+  constexpr int find(const char* section, const char* key) const {
+    uint32_t h = iniHash(section, key);
+    int idx = slot[iniMix(h, disp[h & (kBuckets - 1)]) & (kSlots - 1)];
+    if (idx < 0) return -1;
+    const IniField& f = fields[idx];
+    return (iniEqualsFold(f.section, section) && iniEqualsFold(f.key, key)) ? idx : -1;
+  }
+
+private:
+  constexpr bool build() {
+    uint32_t h[N] = {};
+    uint16_t bucketOf[N] = {};
+    uint16_t bucketSize[kBuckets] = {};
+
+    for (size_t i = 0; i < kSlots; ++i) slot[i] = -1;
+
+    for (size_t i = 0; i < N; ++i) {
+      const IniField& f = fields[i];
+      size_t width = f.type == IniType::Str ? f.size : fieldWidth(f.type);
+      if (width == 0 || (size_t)f.offset + width > sizeof(T)) return false;
+      for (size_t j = 0; j < i; ++j)
+        if (iniEqualsFold(fields[j].section, f.section) && iniEqualsFold(fields[j].key, f.key))
+          return false;
+      h[i] = iniHash(f.section, f.key);
+      bucketOf[i] = (uint16_t)(h[i] & (kBuckets - 1));
+      bucketSize[bucketOf[i]]++;
+    }
+
+    // najpierw największe kubełki – najtrudniej im znaleźć wolne miejsca
+    for (size_t want = N; want > 0; --want) {
+      for (size_t b = 0; b < kBuckets; ++b) {
+        if (bucketSize[b] != want) continue;
+        bool placed = false;
+        for (uint16_t d = 0; d < kMaxDisplacement && !placed; ++d) {
+          placed = fits(h, bucketOf, (uint16_t)b, d);
+          if (placed) {
+            disp[b] = d;
+            for (size_t i = 0; i < N; ++i)
+              if (bucketOf[i] == b) slot[iniMix(h[i], d) & (kSlots - 1)] = (int16_t)i;
+          }
+        }
+        if (!placed) return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr bool fits(const uint32_t* h, const uint16_t* bucketOf, uint16_t b, uint16_t d) const {
+    for (size_t i = 0; i < N; ++i) {
+      if (bucketOf[i] != b) continue;
+      size_t s = iniMix(h[i], d) & (kSlots - 1);
+      if (slot[s] >= 0) return false;
+      for (size_t j = 0; j < i; ++j)
+        if (bucketOf[j] == b && (iniMix(h[j], d) & (kSlots - 1)) == s) return false;
+    }
+    return true;
+  }
+
+  static constexpr size_t fieldWidth(IniType t) {
+    return t == IniType::Bool ? sizeof(bool) : t == IniType::Int ? sizeof(int32_t) : sizeof(float);
+  }
+};
+
+template <class T, size_t N>
+constexpr IniSchema<T, N> makeIniSchema(const IniField (&fields)[N]) {
+  return IniSchema<T, N>(fields);
+}
+
+}} // ns
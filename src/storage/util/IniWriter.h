@@ -0,0 +1,318 @@
+/*
+ * IniWriter – punktowa modyfikacja istniejącego pliku INI z atomowym zatwierdzeniem.
+ *
+ *  ZAŁOŻENIA:
+ *   - Zmieniane są tylko wskazane klucze; komentarze, puste linie, kolejność
+ *     i końce linii (LF/CRLF) pozostałych wpisów zostają bajt w bajt.
+ *   - Przy podmianie wartości zachowywany jest prefiks `klucz = ` oraz końcowy
+ *     komentarz (`port = 8080 ; komentarz`).
+ *   - Składnia (sekcje, separator `=`/biały znak, komentarze `;`/`#`,
+ *     wielkość liter kluczy) jest taka sama jak w `IniReader`.
+ *   - Brakujący klucz dopisywany jest na końcu swojej sekcji (przed pustymi
+ *     liniami oddzielającymi kolejną sekcję); brakująca sekcja – na końcu pliku.
+ *
+ *  ZATWIERDZANIE (commit):
+ *   1. Przebieg „na sucho” po oryginale – jeśli nic się nie zmienia,
+ *      plik nie jest ruszany (wynik `Unchanged`).
+ *   2. Strumieniowy przepis przez bufor do `<plik>.tmp` (zapisy całymi blokami).
+ *   3. `<plik>` → `<plik>.bak`, `<plik>.tmp` → `<plik>`, usunięcie `.bak`.
+ *   W każdym momencie na nośniku istnieje kompletna wersja pliku; po utracie
+ *   zasilania `recover()` przywraca `.bak` i usuwa niedokończony `.tmp`.
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     IniWriter w(sdFs, "/config.ini");
+ *     w.set("Network", "port", "8081");
+ *     w.remove("WiFi", "password");
+ *     if (w.commit() == IniWriter::Result::Failed) { ... }
+ */
+
+// storage/util/IniWriter.h
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <string.h>
+#include "storage/IFileSystem.h"
+
+namespace storage { namespace util {
+
+class IniWriter {
+public:
+  enum class Result { Unchanged, Written, Failed };
+
+  explicit IniWriter(IFileSystem& fs, const std::string& path, size_t bufCap = 512)
+    : fs_(fs), path_(path), cap_(bufCap ? bufCap : 64) {}
+
+  void set(const char* section, const char* key, const char* value) {
+    addEdit(section, key, value, false);
+  }
+
+  void remove(const char* section, const char* key) {
+    addEdit(section, key, "", true);
+  }
+
+  void clear() { edits_.clear(); }
+
+  Result commit() {
+    recover(fs_, path_);
+    if (edits_.empty()) return Result::Unchanged;
+
+    // 1. przebieg na sucho
+    bool changed;
+    {
+      auto src = fs_.openRead(path_);
+      if (!process(src.get(), nullptr, changed)) return Result::Failed;
+    }
+    if (!changed) { DBG("IniWriter::commit(%s) unchanged", path_.c_str()); return Result::Unchanged; }
+
+    // 2. nowa wersja do .tmp
+    std::string tmp = path_ + ".tmp", bak = path_ + ".bak";
+    {
+      auto src = fs_.openRead(path_);
+      auto dst = fs_.openWrite(tmp);
+      if (!dst) return Result::Failed;
+      Sink out(*dst, cap_);
+      bool ok = process(src.get(), &out, changed) && out.flush();
+      dst->flush();
+      dst->close();
+      if (!ok) { fs_.remove(tmp); return Result::Failed; }
+    }
+
+    // 3. podmiana
+    bool hadOld = fs_.exists(path_);
+    if (hadOld && !fs_.rename(path_, bak)) { fs_.remove(tmp); return Result::Failed; }
+    if (!fs_.rename(tmp, path_)) {
+      if (hadOld) fs_.rename(bak, path_);
+      return Result::Failed;
+    }
+    if (hadOld) fs_.remove(bak);
+    DBG("IniWriter::commit(%s) written", path_.c_str());
+    return Result::Written;
+  }
+
+  // Sprzątanie po przerwanym commit(). Wywoływane automatycznie przez commit();
+  // warto je też wywołać przed pierwszym odczytem konfiguracji po starcie.
+  static bool recover(IFileSystem& fs, const std::string& path) {
+    std::string tmp = path + ".tmp", bak = path + ".bak";
+    bool ok = true;
+    if (fs.exists(bak)) {
+      if (!fs.exists(path)) ok = fs.rename(bak, path); // przerwane między rename
+      else fs.remove(bak);                              // przerwane po podmianie
+    }
+    if (fs.exists(tmp)) fs.remove(tmp);
+    return ok;
+  }
+
+private:
+  struct Edit {
+    std::string section, key, value;
+    bool erase;
+    bool seen; // klucz występuje w pliku
+  };
+
+  // Buforowany zapis – do pliku trafiają pełne bloki cap_ bajtów.
+  class Sink {
+  public:
+    Sink(IFile& f, size_t cap) : f_(f), buf_(new char[cap]), cap_(cap) {}
+    bool put(const char* p, size_t n) {
+      while (n) {
+        if (len_ == cap_ && !flush()) return false;
+        size_t k = cap_ - len_ < n ? cap_ - len_ : n;
+        memcpy(buf_.get() + len_, p, k);
+        len_ += k; p += k; n -= k;
+      }
+      return true;
+    }
+    bool put(const std::string& s) { return put(s.data(), s.size()); }
+    bool flush() {
+      if (!len_) return ok_;
+      ok_ = ok_ && f_.write(buf_.get(), len_) == len_;
+      len_ = 0;
+      return ok_;
+    }
+  private:
+    IFile& f_; std::unique_ptr<char[]> buf_; size_t cap_, len_ = 0; bool ok_ = true;
+  };
+
+  IFileSystem& fs_;
+  std::string path_;
+  size_t cap_;
+  std::vector<Edit> edits_;
+
+  void addEdit(const char* section, const char* key, const char* value, bool erase) {
+    std::string s = lower(section ? section : ""), k = lower(key ? key : "");
+    trimStr(s); trimStr(k);
+    for (auto& e : edits_) {
+      if (e.section == s && e.key == k) { e.value = value ? value : ""; e.erase = erase; return; }
+    }
+    edits_.push_back(Edit{s, k, value ? value : "", erase, false});
+  }
+
+  static std::string lower(const char* s) {
+    std::string out(s);
+    for (auto& c : out) c = (char)tolower((unsigned char)c);
+    return out;
+  }
+
+  static void trimStr(std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isspace((unsigned char)s[b])) b++;
+    while (e > b && isspace((unsigned char)s[e - 1])) e--;
+    s = s.substr(b, e - b);
+  }
+
+  static bool equalsFold(const char* a, size_t n, const std::string& b) {
+    if (n != b.size()) return false;
+    for (size_t i = 0; i < n; ++i) if (tolower((unsigned char)a[i]) != b[i]) return false;
+    return true;
+  }
+
+  // Czyta kolejną linię razem z końcem linii (bez interpretacji).
+  static bool nextLine(IFile* src, char* blk, size_t blkCap, size_t& blkLen, size_t& blkPos, std::string& line) {
+    line.clear();
+    if (!src) return false;
+    while (true) {
+      if (blkPos >= blkLen) {
+        blkLen = src->read(blk, blkCap);
+        blkPos = 0;
+        if (!blkLen) return !line.empty();
+      }
+      const char* start = blk + blkPos;
+      const char* nl = static_cast<const char*>(memchr(start, '\n', blkLen - blkPos));
+      size_t n = nl ? (size_t)(nl - start) + 1 : blkLen - blkPos;
+      line.append(start, n);
+      blkPos += n;
+      if (nl) return true;
+    }
+  }
+
+  // Dopisuje brakujące klucze sekcji `section` (przed zaległymi pustymi liniami).
+  bool insertMissing(const std::string& section, Sink* out, const std::string& eol, bool& changed) {
+    for (auto& e : edits_) {
+      if (e.erase || e.seen || e.section != section) continue;
+      e.seen = true;
+      changed = true;
+      if (out && !(out->put(e.key) && out->put(" = ", 3) && out->put(e.value) && out->put(eol))) return false;
+    }
+    return true;
+  }
+
+  bool process(IFile* src, Sink* out, bool& changed) {
+    changed = false;
+    for (auto& e : edits_) e.seen = false;
+
+    std::unique_ptr<char[]> blk(new char[cap_]);
+    size_t blkLen = 0, blkPos = 0;
+    std::string line, pendingBlank, section, eol;
+    bool endsWithNewline = true, any = false; // endsWithNewline: ostatnia linia zapisana do wyniku
+    if (src) src->seek(0);
+
+    while (nextLine(src, blk.get(), cap_, blkLen, blkPos, line)) {
+      any = true;
+      size_t end = line.size();
+      if (end && line[end - 1] == '\n') end--;
+      if (end && line[end - 1] == '\r') end--;
+      bool nl = end < line.size();
+      if (eol.empty() && nl) eol = line.substr(end);
+
+      const char* p = line.data();
+      size_t b = 0, e = end;
+      while (b < e && isspace((unsigned char)p[b])) b++;
+      while (e > b && isspace((unsigned char)p[e - 1])) e--;
+
+      if (b == e) { pendingBlank += line; continue; }
+
+      if (p[b] == '[') {
+        const char* r = static_cast<const char*>(memchr(p + b, ']', e - b));
+        if (r && r > p + b + 1) {
+          if (!insertMissing(section, out, eol.empty() ? "\n" : eol, changed)) return false;
+          size_t nb = b + 1, ne = (size_t)(r - p);
+          while (nb < ne && isspace((unsigned char)p[nb])) nb++;
+          while (ne > nb && isspace((unsigned char)p[ne - 1])) ne--;
+          section.assign(p + nb, ne - nb);
+          for (auto& c : section) c = (char)tolower((unsigned char)c);
+        }
+        if (out && !(out->put(pendingBlank) && out->put(line))) return false;
+        pendingBlank.clear();
+        endsWithNewline = nl;
+        continue;
+      }
+
+      if (out && !out->put(pendingBlank)) return false;
+      pendingBlank.clear();
+
+      Edit* hit = nullptr;
+      size_t valB = e, valE = e;
+      bool hasSep = false;
+      if (p[b] != ';' && p[b] != '#') {
+        // klucz: do '=' (jeśli jest), inaczej do pierwszego białego znaku
+        const char* eq = static_cast<const char*>(memchr(p + b, '=', e - b));
+        size_t split = eq ? (size_t)(eq - p) : b;
+        if (!eq) while (split < e && !isspace((unsigned char)p[split])) split++;
+        size_t kE = split;
+        while (kE > b && isspace((unsigned char)p[kE - 1])) kE--;
+        hasSep = split < e;
+        if (hasSep) {
+          valB = split + 1;
+          while (valB < e && isspace((unsigned char)p[valB])) valB++;
+          valE = valB;
+          while (valE < e && p[valE] != ';' && p[valE] != '#') valE++;
+          while (valE > valB && isspace((unsigned char)p[valE - 1])) valE--;
+        }
+        for (auto& ed : edits_) {
+          if (ed.section == section && equalsFold(p + b, kE - b, ed.key)) { hit = &ed; break; }
+        }
+      }
+
+      if (!hit) { endsWithNewline = nl; if (out && !out->put(line)) return false; continue; }
+      hit->seen = true;
+      if (hit->erase) { changed = true; continue; } // usunięta linia nie wpływa na koniec wyniku
+      endsWithNewline = nl;
+      if (hasSep && valE - valB == hit->value.size() && !memcmp(p + valB, hit->value.data(), valE - valB)) {
+        if (out && !out->put(line)) return false;
+        continue;
+      }
+      changed = true;
+      if (!out) continue;
+      bool ok = hasSep
+        ? out->put(p, valB) && out->put(hit->value) && out->put(p + valE, line.size() - valE)
+        : out->put(p, e) && out->put(" = ", 3) && out->put(hit->value) && out->put(p + e, line.size() - e);
+      if (!ok) return false;
+    }
+
+    if (eol.empty()) eol = "\n";
+    if (any && !endsWithNewline && hasPendingInserts()) {
+      if (out && !out->put(eol)) return false;
+    }
+    if (!insertMissing(section, out, eol, changed)) return false;
+    if (out && !out->put(pendingBlank)) return false;
+
+    // sekcje nieobecne w pliku
+    for (auto& e : edits_) {
+      if (e.erase || e.seen) continue;
+      changed = true;
+      bool first = true;
+      for (auto& o : edits_) {
+        if (o.erase || o.seen || o.section != e.section) continue;
+        o.seen = true;
+        if (!out) continue;
+        if (first) {
+          if (any && !out->put(eol)) return false;
+          if (!(out->put("[", 1) && out->put(o.section) && out->put("]", 1) && out->put(eol))) return false;
+          first = false;
+        }
+        if (!(out->put(o.key) && out->put(" = ", 3) && out->put(o.value) && out->put(eol))) return false;
+      }
+      any = true;
+    }
+    return true;
+  }
+
+  bool hasPendingInserts() const {
+    for (auto& e : edits_) if (!e.erase && !e.seen) return true;
+    return false;
+  }
+};
+
+}} // ns
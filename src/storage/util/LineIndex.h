@@ -0,0 +1,262 @@
+/*
+ * LineIndex – rzadki indeks linii dla dużych plików tekstowych (logów).
+ *
+ *  ZAŁOŻENIA / FORMAT:
+ *   - Co K-ta linia (K = `every`, domyślnie 64) ma zapisany offset początku;
+ *     tablica offsetów trzymana jest w RAM i w pliku obok: `<plik>.lidx`.
+ *   - Separator linii: LF (CRLF też działa – CR przed LF obcina `readLines`).
+ *     Samotne CR nie jest końcem linii – ani w indeksie, ani w `readLines`.
+ *   - Ostatnia linia bez LF też jest liczona (`lineCount`).
+ *
+ *  PLIK .lidx (little-endian):
+ *     u32 magic "LIX1" | u16 every | u16 headSum | u32 scannedBytes
+ *     | u32 newlines | u32 lastLineStart | u32 offsets[...]
+ *
+ *  MOŻLIWOŚCI:
+ *   - `update()` dopisuje do indeksu tylko bajty dodane od ostatniego razu
+ *     (plik rośnie – koszt proporcjonalny do przyrostu). Gdy plik się
+ *     skrócił albo zmienił (rotacja, nadpisanie – także z plikiem dłuższym
+ *     niż zindeksowana część), indeks budowany jest od nowa. Zmianę wykrywa
+ *     suma kontrolna pierwszych 32 bajtów (`headSum`) i LF przed
+ *     `lastLineStart` – dwa krótkie odczyty, tylko gdy plik urósł.
+ *   - `seekToLine(f, n)`: jeden seek do offsetu linii n - n%K i przejście
+ *     co najwyżej K-1 linii blokami – zamiast czytania od bajtu 0.
+ *   - `readLines(f, first, count, cb)`: stronicowanie (np. widok w WWW).
+ *
+ *  OGRANICZENIA:
+ *   - Zapis do pliku w trakcie `seekToLine`/`readLines` wymaga ponownego `update()`.
+ *   - Offsety 32-bitowe (pliki < 4 GiB).
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     LineIndex idx(sdFs, "/logs/app.log");
+ *     idx.update();                          // tanie przy każdym żądaniu
+ *     auto f = sdFs.openRead("/logs/app.log");
+ *     uint32_t total = idx.lineCount();
+ *     idx.readLines(*f, page * 50, 50, [](uint32_t n, const String& line) {
+ *       // wyślij linię
+ *       return true;
+ *     });
+ */
+
+// storage/util/LineIndex.h
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <string.h>
+#include "storage/IFileSystem.h"
+
+namespace storage { namespace util {
+
+class LineIndex {
+public:
+  explicit LineIndex(IFileSystem& fs, const std::string& path, uint16_t every = 64, size_t blockSize = 512)
+    : fs_(fs), path_(path), every_(every ? every : 1), block_(blockSize ? blockSize : 64) {}
+
+  const std::string& path() const { return path_; }
+  std::string sidecarPath() const { return path_ + ".lidx"; }
+
+  // Indeksuje nowe bajty pliku i zapisuje plik .lidx. false = błąd odczytu/zapisu.
+  bool update() {
+    if (!loaded_) { load(); loaded_ = true; }
+    auto f = fs_.openRead(path_);
+    if (!f) { reset(); return false; }
+    uint32_t size = f->size();
+    if (size < scanned_) { DBG("LineIndex(%s): file shrank, rebuilding", path_.c_str()); reset(); }
+    if (size == scanned_) return true;
+    if (scanned_ && !sameFile(*f)) { DBG("LineIndex(%s): file rewritten, rebuilding", path_.c_str()); reset(); }
+
+    uint32_t from = scanned_;
+    std::unique_ptr<char[]> buf(new char[block_]);
+    if (!f->seek(scanned_)) return false;
+    while (scanned_ < size) {
+      size_t n = f->read(buf.get(), block_);
+      if (!n) return false;
+      const char* p = buf.get();
+      const char* end = p + n;
+      while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!nl) break;
+        newlines_++;
+        lastLineStart_ = scanned_ + static_cast<uint32_t>(nl - buf.get()) + 1;
+        if (newlines_ % every_ == 0) offsets_.push_back(lastLineStart_);
+        p = nl + 1;
+      }
+      scanned_ += static_cast<uint32_t>(n);
+    }
+    if (from < kHeadBytes && !headSum(*f, head_)) return false;
+    return save();
+  }
+
+  // Liczba linii (z ostatnią niezakończoną LF) w zindeksowanej części pliku.
+  uint32_t lineCount() const { return newlines_ + (scanned_ > lastLineStart_ ? 1 : 0); }
+  uint32_t indexedBytes() const { return scanned_; }
+  size_t entries() const { return offsets_.size(); }
+
+  // Ustawia f na początku linii n (od 0). false = poza zakresem.
+  bool seekToLine(IFile& f, uint32_t n) {
+    if (n >= lineCount()) return false;
+    uint32_t k = n / every_;
+    if (k >= offsets_.size()) k = static_cast<uint32_t>(offsets_.size()) - 1;
+    uint32_t line = k * every_;
+    uint32_t pos = offsets_[k];
+    if (line == n) return f.seek(pos);
+
+    std::unique_ptr<char[]> buf(new char[block_]);
+    if (!f.seek(pos)) return false;
+    while (line < n) {
+      size_t got = f.read(buf.get(), block_);
+      if (!got) return false;
+      const char* p = buf.get();
+      const char* end = p + got;
+      while (line < n && p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!nl) break;
+        line++;
+        p = nl + 1;
+      }
+      pos += static_cast<uint32_t>(line < n ? got : p - buf.get());
+    }
+    return f.seek(pos);
+  }
+
+  // Stronicowanie: cb(numer linii, treść bez końca linii); false w cb przerywa.
+  // Linia dłuższa niż maxLine jest obcinana. Zwraca liczbę przekazanych linii.
+  uint32_t readLines(IFile& f, uint32_t first, uint32_t count,
+                     std::function<bool(uint32_t, const String&)> cb, size_t maxLine = 256) {
+    if (!count || !seekToLine(f, first)) return 0;
+    // podział tylko na LF, jak w update() – LineReader kończyłby linię też na samotnym CR
+    std::unique_ptr<char[]> buf(new char[block_]);
+    String line;
+    char prev = 0;       // ostatni bajt bieżącej linii (także poza maxLine)
+    bool started = false;
+    uint32_t done = 0, last = lineCount();
+    while (done < count && first + done < last) {
+      size_t got = f.read(buf.get(), block_);
+      if (!got) break;
+      const char* p = buf.get();
+      const char* end = p + got;
+      while (p < end && done < count && first + done < last) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* stop = nl ? nl : end;
+        size_t room = maxLine > (size_t)line.length() ? maxLine - line.length() : 0;
+        size_t take = std::min<size_t>(room, stop - p);
+        if (take) line.concat(p, take);
+        if (stop > p) prev = stop[-1];
+        started = true;
+        if (!nl) { p = end; break; }
+        p = nl + 1;
+        if (!emitLine(line, prev, first + done, cb)) return done + 1;
+        done++;
+        line.remove(0);
+        prev = 0;
+        started = false;
+      }
+    }
+    // ostatnia linia bez LF
+    if (started && done < count && first + done < last) {
+      emitLine(line, prev, first + done, cb);
+      done++;
+    }
+    return done;
+  }
+
+private:
+  static const uint32_t kMagic = 0x3158494C; // "LIX1"
+  static const size_t kHeader = 20;
+  static const uint32_t kHeadBytes = 32; // zakres headSum
+
+  IFileSystem& fs_;
+  std::string path_;
+  uint16_t every_;
+  size_t block_;
+  bool loaded_ = false;
+  uint32_t scanned_ = 0;
+  uint32_t newlines_ = 0;
+  uint32_t lastLineStart_ = 0;
+  uint16_t head_ = 0;                // headSum pierwszych min(scanned_, kHeadBytes) bajtów
+  std::vector<uint32_t> offsets_{0}; // offsets_[k] = początek linii k*every_
+  size_t saved_ = 0;                 // wpisy już zapisane w .lidx
+
+  static bool emitLine(String& line, char prev, uint32_t n, std::function<bool(uint32_t, const String&)>& cb) {
+    if (prev == '\r' && line.length() && line[line.length() - 1] == '\r') line.remove(line.length() - 1);
+    return cb(n, line);
+  }
+
+  // FNV-1a początku pliku złożone do 16 bitów.
+  bool headSum(IFile& f, uint16_t& out) const {
+    uint8_t head[kHeadBytes];
+    size_t len = scanned_ < kHeadBytes ? scanned_ : kHeadBytes;
+    if (!f.seek(0) || f.read(head, len) != len) return false;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) h = (h ^ head[i]) * 16777619u;
+    out = static_cast<uint16_t>(h ^ (h >> 16));
+    return true;
+  }
+
+  // Czy zindeksowana część nadal jest prefiksem pliku (a nie nowym plikiem pod tą samą nazwą).
+  bool sameFile(IFile& f) const {
+    uint16_t sum;
+    if (!headSum(f, sum) || sum != head_) return false;
+    if (!lastLineStart_) return true;
+    char c = 0;
+    return f.seek(lastLineStart_ - 1) && f.read(&c, 1) == 1 && c == '\n';
+  }
+
+  void reset() {
+    scanned_ = newlines_ = lastLineStart_ = 0;
+    head_ = 0;
+    offsets_.assign(1, 0);
+    saved_ = 0;
+  }
+
+  void load() {
+    reset();
+    auto f = fs_.openRead(sidecarPath());
+    if (!f || f->size() < kHeader + 4) return;
+    uint8_t h[kHeader];
+    if (f->read(h, kHeader) != kHeader) return;
+    uint32_t magic; uint16_t every, head;
+    memcpy(&magic, h, 4); memcpy(&every, h + 4, 2); memcpy(&head, h + 6, 2);
+    if (magic != kMagic || every != every_) { DBG("LineIndex(%s): sidecar ignored", path_.c_str()); return; }
+
+    uint32_t scanned, newlines, lastStart;
+    memcpy(&scanned, h + 8, 4); memcpy(&newlines, h + 12, 4); memcpy(&lastStart, h + 16, 4);
+    size_t n = (f->size() - kHeader) / 4;
+    size_t expected = newlines / every_ + 1;
+    if (n < expected) return; // przerwany zapis – przebudowa
+    std::vector<uint32_t> offs(expected);
+    if (f->read(offs.data(), expected * 4) != expected * 4) return;
+    offsets_.swap(offs);
+    scanned_ = scanned; newlines_ = newlines; lastLineStart_ = lastStart; head_ = head;
+    saved_ = offsets_.size();
+  }
+
+  bool save() {
+    uint8_t h[kHeader];
+    uint32_t magic = kMagic;
+    uint16_t every = every_;
+    memcpy(h, &magic, 4); memcpy(h + 4, &every, 2); memcpy(h + 6, &head_, 2);
+    memcpy(h + 8, &scanned_, 4); memcpy(h + 12, &newlines_, 4); memcpy(h + 16, &lastLineStart_, 4);
+
+    size_t n = offsets_.size() - saved_;
+    const uint8_t* entries = reinterpret_cast<const uint8_t*>(&offsets_[saved_]);
+    if (!saved_) {
+      auto f = fs_.openWrite(sidecarPath());
+      if (!f || f->write(h, kHeader) != kHeader || f->write(entries, n * 4) != n * 4) return false;
+    } else {
+      // nowe wpisy przed nagłówkiem – nagłówek wskazuje tylko zapisane dane
+      auto f = fs_.open(sidecarPath(), OpenMode::ReadWrite);
+      if (!f) return false;
+      if (n && (!f->seek(kHeader + saved_ * 4) || f->write(entries, n * 4) != n * 4)) return false;
+      if (!f->seek(0) || f->write(h, kHeader) != kHeader) return false;
+    }
+    saved_ = offsets_.size();
+    return true;
+  }
+};
+
+}} // ns
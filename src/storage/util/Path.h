@@ -0,0 +1,59 @@
+/*
+ * Path – wspólne operacje na ścieżkach dla implementacji IFileSystem.
+ *
+ *  - normalizePath: usuwa powtórzone '/', segmenty "." oraz rozwija "..";
+ *    ścieżka absolutna pozostaje absolutna, pusta wejściowa → pusta.
+ *  - parentPath:    katalog rodzica znormalizowanej ścieżki ("/" dla plików w root,
+ *    "" dla ścieżek względnych bez katalogu).
+ *  - baseName:      ostatni segment ścieżki.
+ */
+
+// storage/util/Path.h
+#pragma once
+#include <string>
+#include <vector>
+
+namespace storage { namespace util {
+
+inline std::string normalizePath(const std::string& in) {
+  if (in.empty()) return std::string();
+
+  bool absolute = in[0] == '/';
+  std::vector<std::string> stack;
+  size_t i = 0, n = in.size();
+
+  while (i < n) {
+    while (i < n && in[i] == '/') i++; // pomiń duplikaty '/'
+    if (i >= n) break;
+    size_t j = i; while (j < n && in[j] != '/') j++;
+    std::string seg = in.substr(i, j - i);
+    i = j;
+
+    if (seg == "." || seg.empty()) continue;
+    if (seg == "..") {
+      if (!stack.empty()) stack.pop_back();
+      // jeśli ścieżka relatywna i stack pusty, pozostaw tak (".." na początku)
+    } else {
+      stack.push_back(seg);
+    }
+  }
+
+  std::string out; if (absolute) out.push_back('/');
+  for (size_t k = 0; k < stack.size(); ++k) { if (k) out.push_back('/'); out += stack[k]; }
+  if (out.empty()) return absolute ? std::string("/") : std::string();
+  return out;
+}
+
+inline std::string parentPath(const std::string& path) {
+  auto pos = path.find_last_of('/');
+  if (pos == std::string::npos) return std::string();
+  if (pos == 0) return std::string("/");
+  return path.substr(0, pos);
+}
+
+inline std::string baseName(const std::string& path) {
+  auto pos = path.find_last_of('/');
+  return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+}} // ns
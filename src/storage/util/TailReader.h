@@ -0,0 +1,252 @@
+/*
+ * TailReader / TailFollower – ostatnie linie pliku i śledzenie dopisywanych danych.
+ *
+ *  TailReader (ostatnie N linii):
+ *   - Czyta plik od końca blokami (`blockSize`, domyślnie 1 KiB) i liczy LF,
+ *     aż znajdzie początek N-tej linii od końca; potem czyta do przodu tylko
+ *     ten fragment. Końcowy LF pliku nie tworzy pustej linii.
+ *   - CRLF obsługiwane (CR obcinany), samotne CR nie jest końcem linii.
+ *
+ *  TailFollower (tryb follow, jak `tail -f`):
+ *   - Pamięta offset przeczytanych danych; `poll()` otwiera plik tylko gdy
+ *     minął interwał, sprawdza rozmiar i przekazuje wyłącznie nowe linie.
+ *   - Interwał rośnie ×2 (do `maxIntervalMs`), gdy nic nie przybyło,
+ *     i wraca do `minIntervalMs` po nowych danych.
+ *   - Z `TailNotifier` piszący w tym samym procesie zgłaszają dopisanie
+ *     (`appended(path)`); follower sprawdza wtedy plik od razu, a bez
+ *     zgłoszeń odpytuje tylko rzadko (`maxIntervalMs`) – na wypadek innych piszących.
+ *   - Niezakończona linia czeka na LF. Skrócenie pliku albo podmiana
+ *     (rotacja, nadpisanie – także dłuższym plikiem) = czytanie od początku.
+ *     Podmianę wykrywa suma pierwszych 32 bajtów, sprawdzana gdy plik urósł.
+ *
+ *  PRZYKŁAD UŻYCIA:
+ *     auto f = sdFs.openRead("/logs/app.log");
+ *     TailReader(*f).lastLines(50, [](const String& line) { Serial.println(line); return true; });
+ *
+ *     TailFollower follow(sdFs, "/logs/app.log", &TailNotifier::global());
+ *     follow.seekToEnd();
+ *     // loop():
+ *     follow.poll(millis(), [](const String& line) { ws.textAll(line); });
+ *
+ *     // piszący:
+ *     log->write(buf, len);
+ *     TailNotifier::global().appended("/logs/app.log");
+ */
+
+// storage/util/TailReader.h
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string.h>
+#include "storage/IFileSystem.h"
+#include "storage/util/Path.h"
+
+namespace storage { namespace util {
+
+class TailReader {
+public:
+  explicit TailReader(IFile& f, size_t blockSize = 1024, size_t maxLine = 256)
+    : file_(f), block_(blockSize ? blockSize : 64), maxLine_(maxLine) {}
+
+  // Offset początku ostatnich n linii (0 = cały plik).
+  uint32_t findLastLines(uint32_t n) {
+    uint32_t size = file_.size();
+    if (!n || !size) return size;
+    std::unique_ptr<char[]> buf(new char[block_]);
+
+    uint32_t end = size;
+    // końcowy LF zamyka ostatnią linię, nie otwiera nowej
+    char last;
+    if (file_.seek(size - 1) && file_.read(&last, 1) == 1 && last == '\n') end--;
+
+    uint32_t found = 0;
+    while (end > 0) {
+      uint32_t start = end > block_ ? end - static_cast<uint32_t>(block_) : 0;
+      uint32_t len = end - start;
+      if (!file_.seek(start) || file_.read(buf.get(), len) != len) return 0;
+      for (uint32_t i = len; i > 0; --i) {
+        if (buf[i - 1] == '\n' && ++found == n) return start + i;
+      }
+      end = start;
+    }
+    return 0;
+  }
+
+  // Przekazuje ostatnie n linii od najstarszej. Zwraca ich liczbę.
+  uint32_t lastLines(uint32_t n, std::function<bool(const String&)> cb) {
+    uint32_t pos = findLastLines(n);
+    uint32_t size = file_.size();
+    if (pos >= size || !file_.seek(pos)) return 0;
+
+    std::unique_ptr<char[]> buf(new char[block_]);
+    String line;
+    uint32_t done = 0;
+    while (pos < size) {
+      size_t got = file_.read(buf.get(), block_ < size - pos ? block_ : size - pos);
+      if (!got) break;
+      pos += static_cast<uint32_t>(got);
+      for (size_t i = 0; i < got; ++i) {
+        char c = buf[i];
+        if (c == '\n') {
+          stripCr(line);
+          done++;
+          if (!cb(line)) return done;
+          line.remove(0);
+        } else if (line.length() < maxLine_) {
+          line += c;
+        }
+      }
+    }
+    if (line.length()) { stripCr(line); done++; cb(line); }
+    return done;
+  }
+
+  static void stripCr(String& s) {
+    if (s.length() && s[s.length() - 1] == '\r') s.remove(s.length() - 1);
+  }
+
+private:
+  IFile& file_;
+  size_t block_;
+  size_t maxLine_;
+};
+
+// Zgłoszenia dopisania od piszących w tym samym procesie (licznik per ścieżka).
+class TailNotifier {
+public:
+  void appended(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    gen_[normalizePath(path)]++;
+  }
+
+  uint32_t generation(const std::string& normalizedPath) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = gen_.find(normalizedPath);
+    return it == gen_.end() ? 0 : it->second;
+  }
+
+  static TailNotifier& global() {
+    static TailNotifier n;
+    return n;
+  }
+
+private:
+  mutable std::mutex mtx_;
+  std::map<std::string, uint32_t> gen_;
+};
+
+class TailFollower {
+public:
+  TailFollower(IFileSystem& fs, const std::string& path, TailNotifier* notifier = nullptr,
+               uint32_t minIntervalMs = 100, uint32_t maxIntervalMs = 5000,
+               size_t blockSize = 512, size_t maxLine = 256)
+    : fs_(fs), path_(normalizePath(path)), notifier_(notifier),
+      minMs_(minIntervalMs), maxMs_(maxIntervalMs < minIntervalMs ? minIntervalMs : maxIntervalMs),
+      block_(blockSize ? blockSize : 64), maxLine_(maxLine), interval_(minIntervalMs) {
+    if (notifier_) gen_ = notifier_->generation(path_);
+  }
+
+  // Następny poll przekaże tylko dane dopisane od teraz.
+  void seekToEnd() {
+    auto f = fs_.openRead(path_);
+    offset_ = f ? f->size() : 0;
+    pending_.remove(0);
+    headKnown_ = false;
+  }
+  void seekTo(uint32_t offset) { offset_ = offset; pending_.remove(0); headKnown_ = false; }
+  uint32_t offset() const { return offset_; }
+  uint32_t intervalMs() const { return interval_; }
+
+  // Wołać cyklicznie. Zwraca liczbę przekazanych linii (0 też gdy nie czas na sprawdzenie).
+  uint32_t poll(uint32_t nowMs, std::function<void(const String&)> onLine) {
+    bool notified = false;
+    if (notifier_) {
+      uint32_t g = notifier_->generation(path_);
+      notified = g != gen_;
+      gen_ = g;
+    }
+    if (!notified && started_ && static_cast<int32_t>(nowMs - nextAt_) < 0) return 0;
+    started_ = true;
+
+    uint32_t lines = readNew(onLine);
+    if (notifier_) interval_ = maxMs_; // zgłoszenia budzą od razu – odpytywanie tylko zapasowe
+    else if (lines) interval_ = minMs_;
+    else interval_ = interval_ * 2 > maxMs_ ? maxMs_ : interval_ * 2;
+    nextAt_ = nowMs + interval_;
+    return lines;
+  }
+
+private:
+  IFileSystem& fs_;
+  std::string path_;
+  TailNotifier* notifier_;
+  uint32_t minMs_, maxMs_;
+  size_t block_, maxLine_;
+  uint32_t interval_;
+  uint32_t nextAt_ = 0;
+  uint32_t gen_ = 0;
+  bool started_ = false;
+  uint32_t offset_ = 0;
+  String pending_;
+  uint32_t head_ = 0;       // suma pierwszych min(offset_, kHeadBytes) bajtów
+  bool headKnown_ = false;
+
+  static const uint32_t kHeadBytes = 32;
+
+  // FNV-1a pierwszych min(len, kHeadBytes) bajtów – tania tożsamość pliku.
+  static bool headSum(IFile& f, uint32_t len, uint32_t& out) {
+    uint8_t head[kHeadBytes];
+    if (len > kHeadBytes) len = kHeadBytes;
+    if (!f.seek(0) || f.read(head, len) != len) return false;
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < len; ++i) h = (h ^ head[i]) * 16777619u;
+    out = h;
+    return true;
+  }
+
+  uint32_t readNew(const std::function<void(const String&)>& onLine) {
+    auto f = fs_.openRead(path_);
+    if (!f) return 0;
+    uint32_t size = f->size();
+    if (size < offset_) { DBG("TailFollower(%s): truncated", path_.c_str()); offset_ = 0; pending_.remove(0); }
+    if (size == offset_) return 0;
+    if (offset_) {
+      uint32_t sum;
+      if (!headSum(*f, offset_, sum)) return 0;
+      if (headKnown_ && sum != head_) { DBG("TailFollower(%s): replaced", path_.c_str()); offset_ = 0; pending_.remove(0); }
+      else { head_ = sum; headKnown_ = true; }
+    }
+    uint32_t start = offset_;
+    if (!f->seek(offset_)) return 0;
+
+    std::unique_ptr<char[]> buf(new char[block_]);
+    uint32_t lines = 0;
+    while (offset_ < size) {
+      size_t got = f->read(buf.get(), block_ < size - offset_ ? block_ : size - offset_);
+      if (!got) break;
+      offset_ += static_cast<uint32_t>(got);
+      const char* p = buf.get();
+      const char* end = p + got;
+      while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* stop = nl ? nl : end;
+        for (const char* c = p; c < stop && pending_.length() < maxLine_; ++c) pending_ += *c;
+        if (!nl) break;
+        TailReader::stripCr(pending_);
+        onLine(pending_);
+        pending_.remove(0);
+        lines++;
+        p = nl + 1;
+      }
+    }
+    // suma obejmuje teraz więcej bajtów początku (albo plik czytany od nowa)
+    if (start < kHeadBytes) headKnown_ = headSum(*f, offset_, head_);
+    return lines;
+  }
+};
+
+}} // ns
@@ -0,0 +1,266 @@
+#include "AssetIndex.h"
+#include "storage/Debug.h"
+#include "storage/util/Path.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace storage {
+namespace web {
+
+using util::normalizePath;
+
+namespace {
+
+struct TypeEntry {
+    const char* ext;
+    const char* mime;
+};
+
+// indeks 0 = typ domyślny
+const TypeEntry kTypes[] = {
+    {"", "application/octet-stream"},
+    {".html", "text/html"},
+    {".htm", "text/html"},
+    {".css", "text/css"},
+    {".js", "application/javascript"},
+    {".mjs", "application/javascript"},
+    {".json", "application/json"},
+    {".map", "application/json"},
+    {".svg", "image/svg+xml"},
+    {".png", "image/png"},
+    {".jpg", "image/jpeg"},
+    {".jpeg", "image/jpeg"},
+    {".gif", "image/gif"},
+    {".ico", "image/x-icon"},
+    {".webp", "image/webp"},
+    {".woff", "font/woff"},
+    {".woff2", "font/woff2"},
+    {".ttf", "font/ttf"},
+    {".txt", "text/plain"},
+    {".csv", "text/csv"},
+    {".xml", "text/xml"},
+    {".wasm", "application/wasm"},
+    {".pdf", "application/pdf"},
+    {".gz", "application/gzip"},
+    {".bin", "application/octet-stream"},
+};
+const size_t kTypeCount = sizeof(kTypes) / sizeof(kTypes[0]);
+
+uint8_t typeIndex(const std::string& path) {
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return 0;
+    const char* ext = path.c_str() + dot;
+    for (size_t i = 1; i < kTypeCount; ++i) {
+        if (strcasecmp(ext, kTypes[i].ext) == 0) return static_cast<uint8_t>(i);
+    }
+    return 0;
+}
+
+uint32_t fnv1a(const void* data, size_t len, uint32_t h = 2166136261u) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+} // namespace
+
+AssetIndex::AssetIndex(IFileSystem& f, const std::string& r) : AssetIndex(f, r, Config()) {}
+
+AssetIndex::AssetIndex(IFileSystem& f, const std::string& r, const Config& c)
+    : fs(f), root(normalizePath(r)), cfg(c) {
+    if (root.empty() || root == "/") root.clear();
+}
+
+bool AssetIndex::build() {
+    DBG("AssetIndex::build(root=%s)", root.empty() ? "/" : root.c_str());
+    entries.clear();
+    paths.clear();
+
+    struct Found {
+        uint32_t size = 0;
+        uint32_t gzSize = 0;
+        uint32_t mtime = 0;
+        uint8_t flags = 0;
+    };
+    std::map<std::string, Found> found; // URL → warianty (tylko na czas budowy)
+
+    // (URL katalogu, rozmiar z listingu: 0 = może to pusty plik)
+    std::vector<std::pair<std::string, bool>> dirs;
+    dirs.emplace_back(std::string(), false);
+    bool rootOk = false;
+    while (!dirs.empty()) {
+        std::string url = dirs.back().first;
+        bool maybeFile = dirs.back().second;
+        dirs.pop_back();
+
+        std::vector<std::pair<std::string, size_t>> children;
+        std::string dirPath = root + (url.empty() ? std::string("/") : url);
+        bool isDir = fs.listDir(dirPath.c_str(), [&](const char* name, size_t size) {
+            children.emplace_back(name, size);
+        });
+        if (url.empty()) rootOk = isDir;
+        if (!isDir) {
+            if (maybeFile) found[url].flags |= kPlain; // pusty plik
+            continue;
+        }
+        for (const auto& c : children) {
+            std::string child = url + "/" + c.first;
+            if (c.second == 0) {
+                dirs.emplace_back(child, true);
+                continue;
+            }
+            uint32_t size = c.second > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(c.second);
+            if (endsWith(child, ".gz")) {
+                Found& f = found[child.substr(0, child.size() - 3)];
+                f.flags |= kGzip;
+                f.gzSize = size;
+            } else {
+                Found& f = found[child];
+                f.flags |= kPlain;
+                f.size = size;
+            }
+        }
+    }
+
+    entries.reserve(found.size());
+    for (const auto& kv : found) {
+        const std::string& url = kv.first;
+        const Found& f = kv.second;
+        uint32_t mtime = 0;
+        if (cfg.useTimestamps) {
+            mtime = fs.getModifiedTimestamp(root + url + ((f.flags & kPlain) ? "" : ".gz"));
+        }
+        Entry e;
+        e.hash = fnv1a(url.data(), url.size());
+        e.pathOff = static_cast<uint32_t>(paths.size());
+        e.pathLen = static_cast<uint16_t>(url.size() > UINT16_MAX ? UINT16_MAX : url.size());
+        e.type = typeIndex(url);
+        e.flags = f.flags;
+        e.size = f.size;
+        e.gzSize = f.gzSize;
+        uint32_t meta[3] = {f.size, f.gzSize, mtime};
+        e.etag = fnv1a(meta, sizeof(meta), e.hash);
+        paths.append(url, 0, e.pathLen);
+        entries.push_back(e);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+    entries.shrink_to_fit();
+    paths.shrink_to_fit();
+    DBG("AssetIndex::build -> %u assets, %u bytes", (unsigned)entries.size(), (unsigned)memoryUsage());
+    return rootOk;
+}
+
+const AssetIndex::Entry* AssetIndex::find(const std::string& url) const {
+    uint32_t h = fnv1a(url.data(), url.size());
+    auto it = std::lower_bound(entries.begin(), entries.end(), h,
+                               [](const Entry& e, uint32_t v) { return e.hash < v; });
+    for (; it != entries.end() && it->hash == h; ++it) {
+        if (it->pathLen == url.size() && paths.compare(it->pathOff, it->pathLen, url) == 0) return &*it;
+    }
+    return nullptr;
+}
+
+bool AssetIndex::lookup(const std::string& rawUrl, bool acceptGzip, Asset& out) const {
+    std::string url = rawUrl.substr(0, rawUrl.find_first_of("?#"));
+    bool dirUrl = url.empty() || url.back() == '/';
+    url = normalizePath(url);
+    if (url.empty() || url == "/") url.clear();
+    if (dirUrl) url += "/" + cfg.indexFile;
+
+    const Entry* e = find(url);
+    bool rawGz = false;
+    if (!e && endsWith(url, ".gz")) {
+        // bezpośrednie żądanie wariantu .gz – wysyłany bez Content-Encoding
+        e = find(url.substr(0, url.size() - 3));
+        if (!e || !(e->flags & kGzip)) return false;
+        rawGz = true;
+    }
+    if (!e) return false;
+
+    bool gz = rawGz || ((e->flags & kGzip) && (acceptGzip || !(e->flags & kPlain)));
+    out.file = root + paths.substr(e->pathOff, e->pathLen) + (gz ? ".gz" : "");
+    out.contentType = rawGz ? "application/gzip" : kTypes[e->type].mime;
+    out.size = gz ? e->gzSize : e->size;
+    out.etag = gz ? e->etag ^ 0x677a0000u : e->etag; // inny ETag dla innej reprezentacji
+    out.gzip = gz && !rawGz;
+    return true;
+}
+
+const char* AssetIndex::contentType(const std::string& path) {
+    return kTypes[typeIndex(path)].mime;
+}
+
+void AssetIndex::formatEtag(uint32_t etag, char out[11]) {
+    snprintf(out, 11, "\"%08lx\"", static_cast<unsigned long>(etag));
+}
+
+// ------------------- strumieniowanie -------------------
+
+bool parseRange(const char* header, uint32_t size, uint32_t& offset, uint32_t& length) {
+    if (!header || strncmp(header, "bytes=", 6) != 0 || !size) return false;
+    const char* p = header + 6;
+    if (strchr(p, ',')) return false; // wiele zakresów – wysyłamy całość
+    char* end;
+    if (*p == '-') {
+        unsigned long n = strtoul(p + 1, &end, 10);
+        if (end == p + 1 || !n) return false;
+        length = n > size ? size : static_cast<uint32_t>(n);
+        offset = size - length;
+        return true;
+    }
+    unsigned long first = strtoul(p, &end, 10);
+    if (end == p || *end != '-' || first >= size) return false;
+    p = end + 1;
+    unsigned long last = size - 1;
+    if (*p) {
+        last = strtoul(p, &end, 10);
+        if (end == p || last < first) return false;
+        if (last >= size) last = size - 1;
+    }
+    offset = static_cast<uint32_t>(first);
+    length = static_cast<uint32_t>(last - first + 1);
+    return true;
+}
+
+size_t readChunk(IFile& f, uint8_t* dst, size_t maxLen, uint32_t pos, uint32_t end, size_t align) {
+    if (pos >= end || !maxLen) return 0;
+    size_t want = end - pos < maxLen ? end - pos : maxLen;
+    if (align && want == maxLen && want > align) {
+        // koniec odczytu na granicy `align` – następny zaczyna się wyrównany
+        size_t cut = (pos + want) % align;
+        if (cut < want) want -= cut;
+    }
+    if (f.position() != pos && !f.seek(pos)) return 0;
+    return f.read(dst, want);
+}
+
+size_t copyTo(IFile& f, uint32_t offset, uint32_t length, uint8_t* buf, size_t bufSize,
+              const std::function<size_t(const uint8_t*, size_t)>& out) {
+    uint32_t pos = offset, end = offset + length;
+    size_t sent = 0;
+    while (pos < end) {
+        size_t n = readChunk(f, buf, bufSize, pos, end, bufSize >= 1024 ? 512 : 0);
+        if (!n) break;
+        size_t w = out(buf, n);
+        sent += w;
+        if (w != n) break;
+        pos += static_cast<uint32_t>(n);
+    }
+    return sent;
+}
+
+} // namespace web
+} // namespace storage
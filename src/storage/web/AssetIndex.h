@@ -0,0 +1,115 @@
+#ifndef STORAGE_WEB_ASSETINDEX_H
+#define STORAGE_WEB_ASSETINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "storage/IFileSystem.h"
+
+namespace storage {
+namespace web {
+
+// Wybrany wariant zasobu do wysłania.
+struct Asset {
+    std::string file;                   // ścieżka do otwarcia (z `.gz` dla wariantu skompresowanego)
+    const char* contentType = nullptr;  // typ MIME oryginału
+    uint32_t size = 0;                  // rozmiar wysyłanego wariantu
+    uint32_t etag = 0;                  // zob. AssetIndex::formatEtag
+    bool gzip = false;                  // → nagłówek `Content-Encoding: gzip`
+};
+
+/**
+ * @brief Indeks statycznych zasobów WWW budowany jednym przejściem drzewa.
+ *
+ * `build()` listuje katalog `root` rekursywnie (jeden `listDir` na katalog)
+ * i dla każdego zasobu zapamiętuje w RAM: hash ścieżki URL (FNV-1a),
+ * rozmiar, rozmiar wariantu `.gz`, ETag i typ treści. Ścieżki trzymane są
+ * w jednym buforze (weryfikacja kolizji hashy), wpisy posortowane po hashu –
+ * `lookup()` to wyszukiwanie binarne bez żadnej operacji na nośniku,
+ * zamiast `exists()` dla każdego wariantu przy każdym żądaniu.
+ *
+ * ETag = hash ścieżki, rozmiaru i czasu modyfikacji. Czas pobierany jest
+ * przy budowie (na SD: jedno otwarcie na plik; wyłączane `useTimestamps`).
+ * Po zmianie plików indeks trzeba zbudować ponownie.
+ *
+ * @code
+ * storage::web::AssetIndex assets(flashFs, "/www");
+ * assets.build();
+ * storage::web::Asset a;
+ * if (assets.lookup(url, acceptsGzip, a)) {
+ *     auto f = flashFs.openRead(a.file);
+ *     std::vector<uint8_t> buf(4096);
+ *     storage::web::copyTo(*f, client, 0, a.size, buf.data(), buf.size());
+ * }
+ * @endcode
+ */
+class AssetIndex {
+public:
+    struct Config {
+        std::string indexFile = "index.html";  // dla URL kończących się na '/'
+        bool useTimestamps = true;             // czas modyfikacji w ETag
+    };
+
+    AssetIndex(IFileSystem& fs, const std::string& root);
+    AssetIndex(IFileSystem& fs, const std::string& root, const Config& cfg);
+
+    bool build();
+    size_t size() const { return entries.size(); }
+    size_t memoryUsage() const { return entries.capacity() * sizeof(Entry) + paths.capacity(); }
+
+    // Ścieżka URL względem `root` (np. "/app.js"). Zapytanie `?...` jest ignorowane.
+    bool lookup(const std::string& url, bool acceptGzip, Asset& out) const;
+
+    static const char* contentType(const std::string& path);
+    // "\"xxxxxxxx\"" – 10 znaków + NUL
+    static void formatEtag(uint32_t etag, char out[11]);
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint32_t pathOff;
+        uint16_t pathLen;
+        uint8_t type;       // indeks w tabeli typów
+        uint8_t flags;
+        uint32_t size;
+        uint32_t gzSize;
+        uint32_t etag;
+    };
+    static const uint8_t kPlain = 1;
+    static const uint8_t kGzip = 2;
+
+    IFileSystem& fs;
+    std::string root;
+    Config cfg;
+    std::vector<Entry> entries;
+    std::string paths;
+
+    const Entry* find(const std::string& url) const;
+};
+
+// Zakres HTTP `bytes=a-b`, `bytes=a-`, `bytes=-n`. false = brak/niepoprawny (wysłać całość).
+bool parseRange(const char* header, uint32_t size, uint32_t& offset, uint32_t& length);
+
+// Fragment [pos, end) pliku prosto do bufora wywołującego (np. bufora odpowiedzi
+// serwera – bez kopii pośredniej). Odczyt kończy się na granicy `align`, więc kolejne
+// wywołania czytają wyrównane bloki. Zwraca liczbę bajtów (0 = koniec/błąd).
+size_t readChunk(IFile& f, uint8_t* dst, size_t maxLen, uint32_t pos, uint32_t end, size_t align = 512);
+
+// Strumieniowe przepisanie [offset, offset+length) do `out` dużymi blokami przez `buf`.
+// `out` zwraca liczbę przyjętych bajtów; mniej niż podano = przerwanie. Zwraca liczbę wysłanych.
+size_t copyTo(IFile& f, uint32_t offset, uint32_t length, uint8_t* buf, size_t bufSize,
+              const std::function<size_t(const uint8_t*, size_t)>& out);
+
+// Wariant dla `Print` (Arduino) i każdego typu z `write(const uint8_t*, size_t)`.
+template <class Out>
+size_t copyTo(IFile& f, Out& out, uint32_t offset, uint32_t length, uint8_t* buf, size_t bufSize) {
+    return copyTo(f, offset, length, buf, bufSize,
+                  [&out](const uint8_t* p, size_t n) { return static_cast<size_t>(out.write(p, n)); });
+}
+
+} // namespace web
+} // namespace storage
+
+#endif // STORAGE_WEB_ASSETINDEX_H
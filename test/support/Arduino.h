@@ -0,0 +1,138 @@
+// Minimalna atrapa Arduino.h dla środowiska [env:native].
+//
+// Zawiera tylko to, czego używają nagłówki z `storage/util` (String, Print,
+// min/max, millis/micros/delay). Nie jest to pełna implementacja Arduino API.
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+using std::min;
+using std::max;
+
+inline unsigned long millis() {
+  using namespace std::chrono;
+  static const auto t0 = steady_clock::now();
+  return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - t0).count();
+}
+
+inline unsigned long micros() {
+  using namespace std::chrono;
+  static const auto t0 = steady_clock::now();
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+class String {
+public:
+  String() = default;
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char* c_str() const { return s_.c_str(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char& operator[](unsigned int i) { return s_[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { s_ += o; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  bool concat(const char* o, unsigned int n) { s_.append(o, n); return true; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b) { return String(a.s_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s_); }
+
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == o; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const { return s_ != o; }
+  bool equals(const String& o) const { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String& o) const {
+    if (s_.size() != o.s_.size()) return false;
+    for (size_t i = 0; i < s_.size(); ++i)
+      if (tolower((unsigned char)s_[i]) != tolower((unsigned char)o.s_[i])) return false;
+    return true;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t p = s_.find(c, from); return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String& str, unsigned int from = 0) const {
+    size_t p = s_.find(str.s_, from); return p == std::string::npos ? -1 : (int)p;
+  }
+  int lastIndexOf(char c) const {
+    size_t p = s_.rfind(c); return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned int from) const {
+    return from >= s_.size() ? String() : String(s_.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s_.size()) return String();
+    return String(s_.substr(from, to - from));
+  }
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const {
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+
+  void remove(unsigned int idx) { if (idx < s_.size()) s_.erase(idx); }
+  void remove(unsigned int idx, unsigned int count) { if (idx < s_.size()) s_.erase(idx, count); }
+  void toLowerCase() { for (auto& c : s_) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (auto& c : s_) c = (char)toupper((unsigned char)c); }
+  void trim() {
+    size_t b = 0, e = s_.size();
+    while (b < e && isspace((unsigned char)s_[b])) ++b;
+    while (e > b && isspace((unsigned char)s_[e - 1])) --e;
+    s_ = s_.substr(b, e - b);
+  }
+
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+  double toDouble() const { return strtod(s_.c_str(), nullptr); }
+
+private:
+  std::string s_;
+};
+
+class Print {
+public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t w = 0;
+    while (n--) { if (!write(*buf++)) break; ++w; }
+    return w;
+  }
+  size_t write(const char* s) { return write(reinterpret_cast<const uint8_t*>(s), strlen(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t println(const char* s = "") { return print(s) + write("\n"); }
+  size_t printf(const char* fmt, ...) {
+    char buf[256];
+    va_list ap; va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n <= 0) return 0;
+    return write(reinterpret_cast<const uint8_t*>(buf), std::min<size_t>((size_t)n, sizeof(buf) - 1));
+  }
+};
@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/web/AssetIndex.cpp"
+
+using storage::mem::MemFileSystem;
+using storage::web::Asset;
+using storage::web::AssetIndex;
+
+namespace {
+
+void put(MemFileSystem& fs, const std::string& path, const std::string& data) {
+    auto f = fs.openWrite(path);
+    REQUIRE(f);
+    f->write(data.data(), data.size());
+}
+
+struct Sink {
+    std::string data;
+    size_t limit = SIZE_MAX;
+    size_t write(const uint8_t* p, size_t n) {
+        if (n > limit - data.size()) n = limit - data.size();
+        data.append(reinterpret_cast<const char*>(p), n);
+        return n;
+    }
+};
+
+} // namespace
+
+TEST_CASE("AssetIndex resolves variants without touching the filesystem") {
+    MemFileSystem fs;
+    put(fs, "/www/index.html", "<html></html>");
+    put(fs, "/www/app.js", std::string(5000, 'a'));
+    put(fs, "/www/app.js.gz", std::string(300, 'z'));
+    put(fs, "/www/css/site.css", "body{}");
+    put(fs, "/www/only.svg.gz", std::string(40, 'g'));
+    put(fs, "/www/empty.txt", "");
+    put(fs, "/other.txt", "x");
+
+    AssetIndex idx(fs, "/www");
+    REQUIRE(idx.build());
+    CHECK(idx.size() == 5);
+
+    Asset a;
+    REQUIRE(idx.lookup("/", true, a));
+    CHECK(a.file == "/www/index.html");
+    CHECK(std::string(a.contentType) == "text/html");
+    CHECK_FALSE(a.gzip);
+
+    REQUIRE(idx.lookup("/app.js?v=3", true, a));
+    CHECK(a.file == "/www/app.js.gz");
+    CHECK(a.gzip);
+    CHECK(a.size == 300);
+    uint32_t gzEtag = a.etag;
+    REQUIRE(idx.lookup("/app.js", false, a));
+    CHECK(a.file == "/www/app.js");
+    CHECK(a.size == 5000);
+    CHECK(a.etag != gzEtag);
+    CHECK(std::string(a.contentType) == "application/javascript");
+
+    // tylko wariant .gz – wysyłany nawet bez Accept-Encoding
+    REQUIRE(idx.lookup("/only.svg", false, a));
+    CHECK(a.gzip);
+    CHECK(std::string(a.contentType) == "image/svg+xml");
+    REQUIRE(idx.lookup("/app.js.gz", true, a));
+    CHECK_FALSE(a.gzip);
+    CHECK(std::string(a.contentType) == "application/gzip");
+
+    REQUIRE(idx.lookup("/css/../css/site.css", true, a));
+    CHECK(a.file == "/www/css/site.css");
+    REQUIRE(idx.lookup("/empty.txt", true, a));
+    CHECK(a.size == 0);
+    CHECK_FALSE(idx.lookup("/missing.js", true, a));
+    CHECK_FALSE(idx.lookup("/../other.txt", true, a));
+
+    char etag[11];
+    AssetIndex::formatEtag(0xabc, etag);
+    CHECK(std::string(etag) == "\"00000abc\"");
+}
+
+TEST_CASE("parseRange handles the common byte-range forms") {
+    uint32_t off = 0, len = 0;
+    CHECK(storage::web::parseRange("bytes=100-199", 1000, off, len));
+    CHECK(off == 100);
+    CHECK(len == 100);
+    CHECK(storage::web::parseRange("bytes=900-", 1000, off, len));
+    CHECK(len == 100);
+    CHECK(storage::web::parseRange("bytes=-50", 1000, off, len));
+    CHECK(off == 950);
+    CHECK(storage::web::parseRange("bytes=990-5000", 1000, off, len));
+    CHECK(len == 10);
+    CHECK_FALSE(storage::web::parseRange("bytes=1000-", 1000, off, len));
+    CHECK_FALSE(storage::web::parseRange("bytes=5-2", 1000, off, len));
+    CHECK_FALSE(storage::web::parseRange("bytes=0-1,5-6", 1000, off, len));
+    CHECK_FALSE(storage::web::parseRange("items=0-1", 1000, off, len));
+}
+
+TEST_CASE("copyTo streams a range in aligned chunks") {
+    MemFileSystem fs;
+    std::string data;
+    for (int i = 0; i < 20000; ++i) data += static_cast<char>('a' + i % 26);
+    put(fs, "/big.bin", data);
+    auto f = fs.openRead("/big.bin");
+    std::vector<uint8_t> buf(2048);
+
+    Sink out;
+    CHECK(storage::web::copyTo(*f, out, 0, 20000, buf.data(), buf.size()) == 20000);
+    CHECK(out.data == data);
+
+    Sink part;
+    CHECK(storage::web::copyTo(*f, part, 777, 5000, buf.data(), buf.size()) == 5000);
+    CHECK(part.data == data.substr(777, 5000));
+
+    // pierwszy odczyt kończy się na granicy 512, kolejne są wyrównane
+    CHECK(storage::web::readChunk(*f, buf.data(), 2048, 777, 20000) == 2048 - 265);
+    CHECK(storage::web::readChunk(*f, buf.data(), 2048, 2560, 20000) == 2048);
+
+    Sink slow;
+    slow.limit = 3000;
+    CHECK(storage::web::copyTo(*f, slow, 0, 20000, buf.data(), buf.size()) == 3000);
+}
@@ -0,0 +1,93 @@
+// Wymaga C++20 (co_await) – budowany w środowisku native_cpp20.
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/io/IoScheduler.cpp"
+#include "../../src/storage/io/AsyncFile.cpp"
+
+#ifndef STORAGE_IO_COROUTINES
+#error "test_async_coro wymaga kompilacji w C++20 z obsługą korutyn"
+#endif
+
+using storage::OpenMode;
+using storage::io::AsyncFile;
+using storage::io::IoPriority;
+using storage::io::IoResult;
+using storage::io::IoScheduler;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+// Korutyna „odpal i zapomnij” – wynik przekazywany przez zmienne testu.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct CoroResult {
+    std::atomic<bool> done{false};
+    bool writeOk = false;
+    size_t readBytes = 0;
+    std::string text;
+};
+
+Detached writeThenRead(AsyncFile& f, CoroResult& out) {
+    IoResult w = co_await f.writeAsync("hello\n", 6);
+    co_await f.flushAsync();
+    co_await f.seekAsync(0);
+    char buf[16] = {0};
+    IoResult r = co_await f.readAsync(buf, sizeof(buf));
+    out.writeOk = w.ok && w.bytes == 6;
+    out.readBytes = r.bytes;
+    out.text.assign(buf, r.bytes);
+    out.done = true;
+}
+
+Detached awaitFailedOpen(AsyncFile& f, CoroResult& out) {
+    IoResult o = co_await f.opened();
+    out.writeOk = o.ok;
+    out.done = true;
+}
+
+} // namespace
+
+TEST_CASE("co_await resumes after each operation completes") {
+    MemFileSystem fs;
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    auto f = AsyncFile::open(io, "/coro.txt", OpenMode::ReadWrite, IoPriority::Normal);
+    REQUIRE(f);
+    CoroResult res;
+    writeThenRead(*f, res);
+    io.drain();
+    REQUIRE(f->closeAsync().wait().ok);
+    CHECK(res.done);
+    CHECK(res.writeOk);
+    CHECK(res.readBytes == 6);
+    CHECK(res.text == "hello\n");
+}
+
+TEST_CASE("co_await on an already completed operation does not suspend") {
+    MemFileSystem fs;
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    auto f = AsyncFile::open(io, "/missing.txt", OpenMode::Read);
+    REQUIRE(f);
+    f->opened().wait();
+    CoroResult res;
+    awaitFailedOpen(*f, res);
+    CHECK(res.done); // wynik gotowy – korutyna dokończyła się synchronicznie
+    CHECK_FALSE(res.writeOk);
+}
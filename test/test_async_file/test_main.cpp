@@ -0,0 +1,125 @@
+#include <atomic>
+#include <string>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/io/IoScheduler.cpp"
+#include "../../src/storage/io/AsyncFile.cpp"
+
+using storage::IFile;
+using storage::OpenMode;
+using storage::io::AsyncFile;
+using storage::io::IoCompletion;
+using storage::io::IoPriority;
+using storage::io::IoResult;
+using storage::io::IoScheduler;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+// Zapamiętuje wątek, w którym otwarto plik.
+class OpenThreadFs : public MemFileSystem {
+public:
+    std::thread::id openedOn;
+    std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override {
+        openedOn = std::this_thread::get_id();
+        return MemFileSystem::open(path, mode);
+    }
+};
+
+std::string readAllAsync(MemFileSystem& fs, const char* path) {
+    auto f = fs.openRead(path);
+    if (!f) return std::string();
+    std::string s(f->size(), '\0');
+    if (!s.empty()) f->read(&s[0], s.size());
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("open runs on the worker thread and operations queue behind it") {
+    OpenThreadFs fs;
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    auto f = AsyncFile::open(io, "/log.txt", OpenMode::WriteAppend, IoPriority::High);
+    REQUIRE(f);
+    IoCompletion w1 = f->writeAsync("abc", 3);
+    IoCompletion w2 = f->writeAsync("def\n", 4);
+    CHECK(f->opened().wait().ok);
+    CHECK(w1.wait().ok);
+    CHECK(w2.wait().bytes == 4);
+    CHECK(f->flushAsync().wait().ok);
+    CHECK(fs.openedOn != std::this_thread::get_id());
+    CHECK(readAllAsync(fs, "/log.txt") == "abcdef\n");
+    CHECK(f->closeAsync().wait().ok);
+    CHECK_FALSE(f->isOpen());
+    CHECK_FALSE(f->writeAsync("x", 1).wait().ok);
+}
+
+TEST_CASE("read, seek, then() and waitFor()") {
+    MemFileSystem fs;
+    {
+        auto w = fs.openWrite("/data.bin");
+        w->write("0123456789", 10);
+    }
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    auto f = AsyncFile::open(io, "/data.bin", OpenMode::Read);
+    REQUIRE(f);
+    char buf[4] = {0};
+    CHECK(f->seekAsync(6).wait().ok);
+    std::atomic<bool> called(false);
+    std::atomic<size_t> got(0);
+    IoCompletion r = f->readAsync(buf, sizeof(buf));
+    r.then([&](const IoResult& res) {
+        got = res.bytes;
+        called = true;
+    });
+    REQUIRE(r.waitFor(1000));
+    CHECK(r.ready());
+    CHECK(r.result().bytes == 4);
+    CHECK(std::string(buf, 4) == "6789");
+    io.drain();
+    CHECK(called);
+    CHECK(got == 4);
+    // callback podpięty po zakończeniu wykonuje się od razu, w wątku wołającym
+    bool late = false;
+    r.then([&](const IoResult&) { late = !io.isWorkerThread(); });
+    CHECK(late);
+}
+
+TEST_CASE("a failed open fails every queued operation") {
+    MemFileSystem fs;
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    auto f = AsyncFile::open(io, "/missing.txt", OpenMode::Read);
+    REQUIRE(f);
+    char buf[8];
+    IoCompletion r = f->readAsync(buf, sizeof(buf));
+    CHECK_FALSE(f->opened().wait().ok);
+    CHECK_FALSE(r.wait().ok);
+    CHECK(r.result().bytes == 0);
+}
+
+TEST_CASE("the destructor waits for queued writes and closes the file") {
+    MemFileSystem fs;
+    IoScheduler io(fs);
+    REQUIRE(io.start());
+    {
+        auto f = AsyncFile::open(io, "/out.txt", OpenMode::WriteTruncate);
+        REQUIRE(f);
+        for (int i = 0; i < 50; ++i) f->writeAsync("x", 1);
+    }
+    CHECK(readAllAsync(fs, "/out.txt") == std::string(50, 'x'));
+}
+
+TEST_CASE("open is rejected when the scheduler is not running") {
+    MemFileSystem fs;
+    IoScheduler io(fs);
+    CHECK_FALSE(AsyncFile::open(io, "/log.txt", OpenMode::WriteAppend));
+    CHECK_FALSE(fs.exists("/log.txt"));
+}
@@ -0,0 +1,374 @@
+// Benchmarki biblioteki w [env:native].
+//
+// Każdy przypadek wypisuje jedną linię:
+//   BENCH {"name":"...","ns_per_op":...,"mb_per_s":...,"ops":...}
+// Linie można zebrać i porównać między commitami, np.:
+//   pio test -e native -f test_benchmark -v | grep '^BENCH' > bench_output.txt
+// Jeśli ustawiona jest zmienna STORAGE_BENCH_OUTPUT, linie są też dopisywane
+// (bez prefiksu, JSON Lines) do wskazanego pliku.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <Arduino.h>
+#include "../../src/storage/logs/ColumnCodec.cpp"
+#include "../../src/storage/logs/ColumnStore.cpp"
+#include "../../src/storage/logs/TimeSeriesLog.cpp"
+#include "../../src/storage/mem/MemFileSystem.h"
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/time/TimeUtils.h"
+#include "../../src/storage/time/TimeUtils.cpp"
+#include "../../src/storage/util/Csv.h"
+#include "../../src/storage/util/FileSearch.h"
+#include "../../src/storage/util/IniReader.h"
+#include "../../src/storage/util/LineReader.h"
+#include "../../src/storage/util/Path.h"
+
+using storage::OpenMode;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+volatile uint64_t g_sink = 0;
+
+struct BenchResult {
+    double nsPerOp;
+    double mbPerS;
+    uint64_t ops;
+};
+
+// Uruchamia fn() aż minie co najmniej minMs (po jednym przebiegu rozgrzewkowym).
+template <class F>
+BenchResult bench(const char* name, size_t bytesPerOp, F&& fn, unsigned minMs = 200) {
+    using clock = std::chrono::steady_clock;
+    fn();
+
+    uint64_t ops = 0;
+    auto start = clock::now();
+    auto deadline = start + std::chrono::milliseconds(minMs);
+    auto now = start;
+    uint64_t batch = 1;
+    while (now < deadline) {
+        for (uint64_t i = 0; i < batch; ++i) fn();
+        ops += batch;
+        if (batch < (1u << 16)) batch *= 2;
+        now = clock::now();
+    }
+    double ns = std::chrono::duration<double, std::nano>(now - start).count();
+
+    BenchResult r;
+    r.ops = ops;
+    r.nsPerOp = ns / ops;
+    r.mbPerS = bytesPerOp ? (double)bytesPerOp * ops / (ns / 1e9) / (1024.0 * 1024.0) : 0.0;
+
+    char line[256];
+    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ns_per_op\":%.1f,\"mb_per_s\":%.2f,\"ops\":%llu}",
+             name, r.nsPerOp, r.mbPerS, (unsigned long long)r.ops);
+    printf("BENCH %s\n", line);
+    if (const char* out = getenv("STORAGE_BENCH_OUTPUT")) {
+        if (FILE* f = fopen(out, "a")) {
+            fprintf(f, "%s\n", line);
+            fclose(f);
+        }
+    }
+    return r;
+}
+
+void writeFile(MemFileSystem& fs, const char* path, const std::string& content) {
+    auto f = fs.openWrite(path);
+    f->write(content.data(), content.size());
+    f->close();
+}
+
+std::string makeLog(size_t lines) {
+    std::string s;
+    char buf[96];
+    for (size_t i = 0; i < lines; ++i) {
+        snprintf(buf, sizeof(buf), "2026-10-16 13:%02u:%02u sensor=%u temp=%.2f hum=%.1f\n",
+                 (unsigned)(i / 60 % 60), (unsigned)(i % 60), (unsigned)(i % 16), 20.0 + (i % 100) / 10.0, 40.0 + (i % 50));
+        s += buf;
+    }
+    return s;
+}
+
+const char* kIni =
+    "; Konfiguracja aplikacji audio\n"
+    "[Network]\nhost = example.com\nport = 8080\npath = /api/stream\n\n"
+    "[Schedule]\nturnOnWeekday = 7\nturnOnWeekend = 9\n\n"
+    "[Audio]\ntimeshift = true\nvolume = 75 ; procent\nfrequency = 99.7\nfm_volume = 0.85\n\n"
+    "[WiFi]\nssid = MyWiFiNetwork\npassword = supertajnehaslo\n";
+
+struct AppConfig {
+    char host[32];
+    int32_t port;
+    char path[32];
+    int32_t turnOnWeekday;
+    int32_t turnOnWeekend;
+    bool timeshift;
+    int32_t volume;
+    float frequency;
+    float fmVolume;
+    char ssid[33];
+    char password[65];
+};
+
+constexpr storage::util::IniField kAppFields[] = {
+    storage::util::iniString("network", "host", offsetof(AppConfig, host), sizeof(AppConfig::host)),
+    storage::util::iniInt("network", "port", offsetof(AppConfig, port), 80, 1, 65535),
+    storage::util::iniString("network", "path", offsetof(AppConfig, path), sizeof(AppConfig::path)),
+    storage::util::iniInt("schedule", "turnOnWeekday", offsetof(AppConfig, turnOnWeekday), 7, 0, 23),
+    storage::util::iniInt("schedule", "turnOnWeekend", offsetof(AppConfig, turnOnWeekend), 9, 0, 23),
+    storage::util::iniBool("audio", "timeshift", offsetof(AppConfig, timeshift), false),
+    storage::util::iniInt("audio", "volume", offsetof(AppConfig, volume), 50, 0, 100),
+    storage::util::iniFloat("audio", "frequency", offsetof(AppConfig, frequency), 87.5f, 87.5f, 108.0f),
+    storage::util::iniFloat("audio", "fm_volume", offsetof(AppConfig, fmVolume), 1.0f, 0.0f, 1.0f),
+    storage::util::iniString("wifi", "ssid", offsetof(AppConfig, ssid), sizeof(AppConfig::ssid)),
+    storage::util::iniString("wifi", "password", offsetof(AppConfig, password), sizeof(AppConfig::password)),
+};
+constexpr auto kAppSchema = storage::util::makeIniSchema<AppConfig>(kAppFields);
+static_assert(kAppSchema.ok, "kAppSchema");
+
+} // namespace
+
+TEST_CASE("bench: LineReader") {
+    MemFileSystem fs;
+    std::string log = makeLog(16384);
+    writeFile(fs, "/log.txt", log);
+
+    size_t lines = 0;
+    bench("line_reader/read_all", log.size(), [&] {
+        auto f = fs.openRead("/log.txt");
+        storage::util::LineReader reader(*f);
+        String line;
+        lines = 0;
+        while (reader.readLine(line)) lines++;
+        g_sink += lines;
+    });
+    CHECK(lines == 16384);
+}
+
+TEST_CASE("bench: search in log") {
+    MemFileSystem fs;
+    std::string log = makeLog(16384);
+    writeFile(fs, "/log.txt", log);
+
+    size_t found = 0;
+    bench("search/line_reader_indexof", log.size(), [&] {
+        auto f = fs.openRead("/log.txt");
+        storage::util::LineReader reader(*f);
+        String line;
+        found = 0;
+        while (reader.readLine(line)) {
+            if (line.indexOf("hum=49.0") >= 0 || line.indexOf("sensor=15 temp=21.50") >= 0) found++;
+        }
+        g_sink += found;
+    });
+    size_t expected = found;
+
+    storage::util::FileSearch search;
+    search.addPattern("hum=49.0");
+    search.addPattern("sensor=15 temp=21.50");
+    bench("search/file_search_2_patterns", log.size(), [&] {
+        auto f = fs.openRead("/log.txt");
+        found = search.searchFile(*f, "/log.txt", [](const storage::util::SearchHit&) { return true; });
+        g_sink += found;
+    });
+    CHECK(found == expected);
+    CHECK(found > 0);
+}
+
+TEST_CASE("bench: CSV sensor export") {
+    MemFileSystem fs;
+    std::string csv = "time,sensor,temp,hum,pressure,note\n";
+    char buf[128];
+    for (unsigned i = 0; i < 16384; ++i) {
+        snprintf(buf, sizeof(buf), "%u,%u,%.2f,%.1f,%.1f,ok\n", 1760000000u + i, i % 16, 20.0 + (i % 100) / 10.0,
+                 40.0 + (i % 50), 1013.0 + (i % 20) / 10.0);
+        csv += buf;
+    }
+    writeFile(fs, "/sensors.csv", csv);
+
+    double sum = 0;
+    bench("csv/line_reader_to_float", csv.size(), [&] {
+        auto f = fs.openRead("/sensors.csv");
+        storage::util::LineReader reader(*f);
+        String line;
+        reader.readLine(line); // nagłówek
+        sum = 0;
+        while (reader.readLine(line)) {
+            int a = line.indexOf(',');
+            int b = line.indexOf(',', a + 1);
+            int c = line.indexOf(',', b + 1);
+            sum += line.substring(b + 1, c).toFloat();
+        }
+        g_sink += (uint64_t)sum;
+    });
+    double expected = sum;
+
+    bench("csv/csv_reader_projection", csv.size(), [&] {
+        auto f = fs.openRead("/sensors.csv");
+        storage::util::CsvReader reader(*f);
+        reader.readHeader();
+        reader.selectNamed({"temp"});
+        sum = 0;
+        float t;
+        while (reader.next()) {
+            if (reader.getFloat(0, t)) sum += t;
+        }
+        g_sink += (uint64_t)sum;
+    });
+    CHECK(std::fabs(sum - expected) < 1e-6 * expected);
+
+    bench("csv/csv_writer", csv.size(), [&] {
+        auto f = fs.openWrite("/out.csv");
+        storage::util::CsvWriter w(*f, 4096);
+        for (unsigned i = 0; i < 16384; ++i) {
+            w.fieldInt(1760000000u + i).fieldInt(i % 16).fieldDouble(20.0 + (i % 100) / 10.0, 2);
+            w.fieldDouble(40.0 + (i % 50), 1).fieldDouble(1013.0 + (i % 20) / 10.0, 1).field("ok").endRow();
+        }
+        w.flush();
+    });
+    CHECK(fs.openRead("/out.csv")->size() == csv.size() - strlen("time,sensor,temp,hum,pressure,note\n"));
+}
+
+TEST_CASE("bench: one channel of 16 over a day") {
+    MemFileSystem fs;
+    const size_t rows = 86400 / 4;
+    const uint64_t t0 = 1760054400000ULL; // początek doby
+    struct Row { float ch[16]; };
+    storage::logs::TimeSeriesLog tsl(fs, "/tsl", sizeof(Row));
+    storage::logs::ColumnStore cs(fs, "/cs", std::vector<storage::logs::ColumnType>(16, storage::logs::ColumnType::Float32));
+    for (size_t i = 0; i < rows; ++i) {
+        Row r;
+        double d[16];
+        for (int c = 0; c < 16; ++c) {
+            d[c] = std::round((20.0 + c + 5.0 * std::sin((i + c * 100) / 2000.0)) * 10.0) / 10.0;
+            r.ch[c] = static_cast<float>(d[c]);
+        }
+        tsl.append(t0 + i * 4000, &r);
+        cs.append(t0 + i * 4000, d);
+    }
+    tsl.close();
+    cs.close();
+
+    double sum = 0;
+    bench("columns/time_series_log_row_scan", rows * sizeof(float), [&] {
+        sum = 0;
+        tsl.query(t0, t0 + 86400000ULL, [&](uint64_t, const uint8_t* p) {
+            float v;
+            memcpy(&v, p + 5 * sizeof(float), sizeof(v));
+            sum += v;
+            return true;
+        });
+        g_sink += (uint64_t)sum;
+    });
+    double expected = sum;
+
+    bench("columns/column_store_scan", rows * sizeof(float), [&] {
+        sum = 0;
+        cs.scan(5, t0, t0 + 86400000ULL, [&](const uint64_t*, const float* v, size_t n) {
+            float s = 0;
+            for (size_t i = 0; i < n; ++i) s += v[i];
+            sum += s;
+            return true;
+        });
+        g_sink += (uint64_t)sum;
+    });
+    CHECK(std::fabs(sum - expected) < 1e-3 * expected);
+}
+
+TEST_CASE("bench: IniReader") {
+    MemFileSystem fs;
+    writeFile(fs, "/config.ini", kIni);
+    auto f = fs.openRead("/config.ini");
+    storage::util::IniReader ini(*f);
+
+    int keys = 0;
+    bench("ini_reader/parse_string", strlen(kIni), [&] {
+        keys = 0;
+        ini.parse([&](const String&, const String&, const String& v) {
+            keys++;
+            g_sink += v.length();
+            return true;
+        });
+    });
+    CHECK(keys == 11);
+
+    AppConfig cfg;
+    bool clean = false;
+    bench("ini_reader/parse_into_schema", strlen(kIni), [&] {
+        clean = ini.parseInto(kAppSchema, cfg);
+        g_sink += cfg.port;
+    });
+    CHECK(clean);
+    CHECK(cfg.port == 8080);
+    CHECK(cfg.volume == 75);
+}
+
+TEST_CASE("bench: normalizePath") {
+    const std::string paths[] = {
+        "/log.txt", "/logs/2026-10-16/13.log", "//a//b/./c/../d/file.bin",
+        "relative/dir/../file", "/a/b/c/d/e/f/g/h/i/j/k.txt",
+    };
+    size_t i = 0;
+    bench("path/normalize", 0, [&] {
+        g_sink += storage::util::normalizePath(paths[i++ % 5]).size();
+    });
+    CHECK(storage::util::normalizePath("//a//b/./c/../d/file.bin") == "/a/b/d/file.bin");
+}
+
+TEST_CASE("bench: FAT time conversion") {
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    const uint16_t fatDate = (static_cast<uint16_t>(2026 - 1980) << 9) | (10 << 5) | 16;
+    uint16_t fatTime = (13 << 11) | (37 << 5);
+    bench("fat_time/to_unix", 0, [&] {
+        g_sink += storage::time::fatDateTimeToUnix(fatDate, fatTime++ & 0x7fff);
+    });
+
+    uint32_t ts = 1760620000;
+    bench("fat_time/from_unix", 0, [&] {
+        uint16_t d, t;
+        storage::time::unixToFatDateTime(ts++, &d, &t);
+        g_sink += d + t;
+    });
+}
+
+TEST_CASE("bench: IFile sequential and random I/O") {
+    MemFileSystem fs;
+    const size_t fileSize = 1u << 20;
+    std::vector<uint8_t> block(4096, 0xA5);
+
+    bench("ifile/seq_write_512", fileSize, [&] {
+        auto f = fs.openWrite("/data.bin");
+        for (size_t off = 0; off < fileSize; off += 512) f->write(block.data(), 512);
+        f->close();
+    });
+
+    bench("ifile/seq_read_4096", fileSize, [&] {
+        auto f = fs.openRead("/data.bin");
+        size_t total = 0, n;
+        while ((n = f->read(block.data(), 4096)) > 0) total += n;
+        g_sink += total;
+    });
+
+    auto f = fs.openRead("/data.bin");
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> pick(0, fileSize / 512 - 1);
+    bench("ifile/random_read_512", 512, [&] {
+        f->seek(pick(rng) * 512);
+        g_sink += f->read(block.data(), 512);
+    });
+    CHECK(f->size() == fileSize);
+}
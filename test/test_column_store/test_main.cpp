@@ -0,0 +1,187 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/logs/ColumnCodec.cpp"
+#include "../../src/storage/logs/ColumnStore.cpp"
+
+using storage::OpenMode;
+using storage::logs::ColumnCodec;
+using storage::logs::ColumnStore;
+using storage::logs::ColumnType;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+const uint64_t kDay = 86400000ULL;
+const uint64_t kT0 = 1760000000000ULL - 1760000000000ULL % kDay; // początek doby
+
+// Temperatura z czujnika o rozdzielczości 0.1 (wartości powtarzają się przez wiele próbek).
+double temp(size_t i) { return std::round((20.0 + 5.0 * std::sin(i / 3000.0)) * 10.0) / 10.0; }
+
+// Wartość zmieniająca się w każdej próbce.
+double noisy(size_t i) { return std::round((20.0 + 5.0 * std::sin(i / 30.0)) * 100.0) / 100.0; }
+
+} // namespace
+
+TEST_CASE("ColumnCodec round-trips integers and floats") {
+    std::mt19937_64 rng(7);
+    std::vector<int64_t> ints;
+    int64_t t = 1760000000000LL;
+    for (int i = 0; i < 1000; ++i) {
+        t += 1000 + (i % 97 == 0 ? static_cast<int64_t>(rng() % 50) - 25 : 0); // jitter co jakiś czas
+        ints.push_back(t);
+    }
+    ints.push_back(INT64_MIN); // skrajne różnice: szerokość 64 bitów
+    ints.push_back(INT64_MAX);
+
+    std::vector<uint8_t> enc;
+    ColumnCodec::encodeInts(ints.data(), ints.size(), enc);
+    enc.resize(enc.size() + ColumnCodec::kPad);
+    std::vector<int64_t> dec(ints.size());
+    uint64_t scratch[ColumnCodec::kChunk];
+    REQUIRE(ColumnCodec::decodeInts(enc.data(), enc.size() - ColumnCodec::kPad, ints.size(), dec.data(), scratch));
+    CHECK(dec == ints);
+    CHECK_FALSE(ColumnCodec::decodeInts(enc.data(), 20, ints.size(), dec.data(), scratch));
+
+    std::vector<float> floats;
+    for (size_t i = 0; i < 1000; ++i) floats.push_back(static_cast<float>(i < 500 ? temp(i * 10) : noisy(i)));
+    floats.push_back(NAN);
+    floats.push_back(-0.0f);
+    enc.clear();
+    ColumnCodec::encodeFloats(floats.data(), floats.size(), enc);
+    CHECK(enc.size() < floats.size() * 4);
+    enc.resize(enc.size() + ColumnCodec::kPad);
+    std::vector<float> fdec(floats.size());
+    REQUIRE(ColumnCodec::decodeFloats(enc.data(), enc.size() - ColumnCodec::kPad, floats.size(), fdec.data(), scratch));
+    CHECK(memcmp(fdec.data(), floats.data(), floats.size() * 4) == 0);
+
+    // stały okres próbkowania: porcja 128 znaczników czasu = 1 bajt
+    std::vector<int64_t> regular(1 + 1 + 128 * 4);
+    for (size_t i = 0; i < regular.size(); ++i) regular[i] = 1000 * static_cast<int64_t>(i);
+    enc.clear();
+    ColumnCodec::encodeInts(regular.data(), regular.size(), enc);
+    CHECK(enc.size() == 16 + 4);
+}
+
+TEST_CASE("ColumnStore scans one channel over a time range") {
+    MemFileSystem fs;
+    std::vector<ColumnType> types(16, ColumnType::Float32);
+    types[15] = ColumnType::Int32;
+    ColumnStore::Config cfg;
+    cfg.rowsPerGroup = 256;
+    const size_t rows = 3000; // 1 Hz, w ostatniej grupie część wierszy zostaje w RAM
+    {
+        ColumnStore cs(fs, "/cs", types, cfg);
+        double row[16];
+        for (size_t i = 0; i < rows; ++i) {
+            for (int c = 0; c < 15; ++c) row[c] = temp(i) + c;
+            row[15] = static_cast<double>(i);
+            REQUIRE(cs.append(kT0 + i * 1000, row));
+        }
+        CHECK_FALSE(cs.append(kT0, row)); // cofnięcie czasu
+
+        size_t n = 0;
+        bool ok = true;
+        cs.scan(3, kT0 + 2900 * 1000, kT0 + 3100 * 1000, [&](const uint64_t* ts, const float* v, size_t k) {
+            for (size_t i = 0; i < k; ++i, ++n) ok = ok && v[i] == static_cast<float>(temp(2900 + n) + 3);
+            (void)ts;
+            return true;
+        });
+        CHECK(ok);
+        CHECK(n == 100); // z pliku i z RAM
+    }
+    auto f = fs.openRead("/cs/" + std::to_string(kT0 / 1000) + ".tsc");
+    REQUIRE(f);
+    CHECK(f->size() < rows * (8 + 16 * 4) / 10);
+    f->close();
+
+    ColumnStore cs(fs, "/cs", types, cfg);
+    size_t n = 0;
+    bool ok = true;
+    size_t got = cs.scan(3, kT0 + 1000 * 1000, kT0 + 1999 * 1000, [&](const uint64_t* ts, const float* v, size_t k) {
+        for (size_t i = 0; i < k; ++i, ++n) {
+            ok = ok && ts[i] == kT0 + (1000 + n) * 1000 && v[i] == static_cast<float>(temp(1000 + n) + 3);
+        }
+        return true;
+    });
+    CHECK(ok);
+    CHECK(got == 1000);
+    CHECK(n == 1000);
+    // odczytane tylko grupy z zakresem i tylko kolumny czasu i kanału 3
+    const ColumnStore::ScanStats& st = cs.lastScan();
+    CHECK(st.groupsDecoded == 5);
+    CHECK(st.bytesRead < 5 * 256 * (8 + 4) + 12 * 400);
+
+    int32_t last = -1;
+    CHECK(cs.scanInt(15, kT0 + 2990 * 1000, kT0 + kDay, [&](const uint64_t*, const int32_t* v, size_t k) {
+        last = v[k - 1];
+        return true;
+    }) == 10);
+    CHECK(last == 2999);
+    CHECK(cs.scan(15, kT0, kT0 + kDay, [](const uint64_t*, const float*, size_t) { return true; }) == 0);
+}
+
+TEST_CASE("ColumnStore minMax uses group statistics") {
+    MemFileSystem fs;
+    std::vector<ColumnType> types(2, ColumnType::Float32);
+    ColumnStore::Config cfg;
+    cfg.rowsPerGroup = 100;
+    ColumnStore cs(fs, "/mm", types, cfg);
+    for (size_t i = 0; i < 1000; ++i) {
+        double row[2] = {static_cast<double>(i % 100), i == 555 ? NAN : -static_cast<double>(i)};
+        REQUIRE(cs.append(kT0 + i * 1000, row));
+    }
+    REQUIRE(cs.flush());
+
+    double mn, mx;
+    REQUIRE(cs.minMax(1, kT0 + 150 * 1000, kT0 + 849 * 1000, mn, mx));
+    CHECK(mn == -849);
+    CHECK(mx == -150);
+    CHECK(cs.lastScan().groupsDecoded == 2);  // tylko grupy brzegowe
+    CHECK(cs.lastScan().groupsSkipped == 8);  // 6 ze statystyk + 1 przed + 1 po zakresie
+
+    CHECK_FALSE(cs.minMax(0, kT0 + 2 * kDay, kT0 + 3 * kDay, mn, mx));
+}
+
+TEST_CASE("ColumnStore ignores a group not committed to the header") {
+    MemFileSystem fs;
+    std::vector<ColumnType> types(1, ColumnType::Int32);
+    ColumnStore::Config cfg;
+    cfg.rowsPerGroup = 16;
+    std::string path = "/cr/" + std::to_string(kT0 / 1000) + ".tsc";
+    {
+        ColumnStore cs(fs, "/cr", types, cfg);
+        for (size_t i = 0; i < 32; ++i) {
+            double v = static_cast<double>(i);
+            REQUIRE(cs.append(kT0 + i * 1000, &v));
+        }
+    }
+    // symulacja awarii: dopisane śmieci za końcem danych z nagłówka
+    {
+        auto f = fs.open(path, OpenMode::WriteAppend);
+        std::string junk(50, '\x55');
+        f->write(junk.data(), junk.size());
+    }
+    ColumnStore cs(fs, "/cr", types, cfg);
+    for (size_t i = 32; i < 48; ++i) {
+        double v = static_cast<double>(i);
+        REQUIRE(cs.append(kT0 + i * 1000, &v));
+    }
+    REQUIRE(cs.flush());
+    std::vector<int32_t> all;
+    cs.scanInt(0, 0, kT0 + kDay, [&](const uint64_t*, const int32_t* v, size_t n) {
+        all.insert(all.end(), v, v + n);
+        return true;
+    });
+    REQUIRE(all.size() == 48);
+    CHECK(all.front() == 0);
+    CHECK(all.back() == 47);
+}
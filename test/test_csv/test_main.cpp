@@ -0,0 +1,157 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/util/Csv.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::CsvField;
+using storage::util::CsvReader;
+using storage::util::CsvWriter;
+
+namespace {
+
+void put(MemFileSystem& fs, const std::string& path, const std::string& data) {
+    auto f = fs.openWrite(path);
+    REQUIRE(f);
+    f->write(data.data(), data.size());
+    f->close();
+}
+
+std::string slurp(MemFileSystem& fs, const std::string& path) {
+    auto f = fs.openRead(path);
+    std::string s(f->size(), '\0');
+    f->read(&s[0], s.size());
+    return s;
+}
+
+std::string str(const CsvField& f) { return std::string(f.data, f.len); }
+
+} // namespace
+
+TEST_CASE("CsvReader handles RFC 4180 quoting and line endings") {
+    MemFileSystem fs;
+    put(fs, "/a.csv", "a,\"b,c\",\"say \"\"hi\"\"\"\r\n\n\"multi\nline\",,x\nlast,row");
+    auto f = fs.openRead("/a.csv");
+    CsvReader csv(*f, 64);
+
+    REQUIRE(csv.next());
+    CHECK(csv.fieldCount() == 3);
+    CHECK(str(csv.field(0)) == "a");
+    CHECK(str(csv.field(1)) == "b,c");
+    CHECK(str(csv.field(2)) == "say \"hi\"");
+
+    REQUIRE(csv.next()); // pusta linia pominięta
+    CHECK(str(csv.field(0)) == "multi\nline");
+    CHECK(csv.field(1).present);
+    CHECK(csv.field(1).len == 0);
+    CHECK(str(csv.field(2)) == "x");
+
+    REQUIRE(csv.next()); // ostatni rekord bez LF
+    CHECK(str(csv.field(1)) == "row");
+    CHECK_FALSE(csv.field(2).present);
+    CHECK_FALSE(csv.next());
+    CHECK(csv.records() == 3);
+}
+
+TEST_CASE("CsvReader projects columns across block boundaries") {
+    MemFileSystem fs;
+    std::string data = "time,sensor,temp,hum,note\n";
+    for (int i = 0; i < 500; ++i) {
+        char line[96];
+        snprintf(line, sizeof(line), "%d,%d,%.2f,%.1f,\"n,%d\"\n", 1000 + i, i % 8, 20.0 + i / 100.0, 40.0 + i % 10, i);
+        data += line;
+    }
+    put(fs, "/s.csv", data);
+    auto f = fs.openRead("/s.csv");
+    CsvReader csv(*f, 100); // rekordy często przechodzą przez granicę bloku
+    REQUIRE(csv.readHeader());
+    CHECK(csv.header().size() == 5);
+    CHECK(csv.columnIndex("hum") == 3);
+    CHECK_FALSE(csv.selectNamed({"time", "missing"}));
+    REQUIRE(csv.selectNamed({"hum", "time"}));
+
+    int rows = 0;
+    bool ok = true;
+    while (csv.next()) {
+        int32_t t;
+        float hum;
+        ok = ok && csv.fieldCount() == 2 && csv.getInt(1, t) && csv.getFloat(0, hum);
+        ok = ok && t == 1000 + rows && std::fabs(hum - (40.0f + rows % 10)) < 1e-4f;
+        rows++;
+    }
+    CHECK(ok);
+    CHECK(rows == 500);
+}
+
+TEST_CASE("CsvReader skips records longer than the buffer") {
+    MemFileSystem fs;
+    put(fs, "/l.csv", "1,2\n" + std::string(300, 'x') + ",\"" + std::string(100, '\n') + "\"\n3,4\n");
+    auto f = fs.openRead("/l.csv");
+    CsvReader csv(*f, 64);
+    int32_t v;
+    REQUIRE(csv.next());
+    CHECK((csv.getInt(0, v) && v == 1));
+    REQUIRE(csv.next());
+    CHECK((csv.getInt(0, v) && v == 3));
+    CHECK_FALSE(csv.next());
+    CHECK(csv.skipped() == 1);
+}
+
+TEST_CASE("CsvReader parses numbers without allocation") {
+    int32_t i;
+    CHECK((CsvReader::parseInt(" -42 ", 5, i) && i == -42));
+    CHECK((CsvReader::parseInt("2147483647", 10, i) && i == 2147483647));
+    CHECK_FALSE(CsvReader::parseInt("2147483648", 10, i));
+    CHECK_FALSE(CsvReader::parseInt("12a", 3, i));
+    CHECK_FALSE(CsvReader::parseInt("", 0, i));
+
+    const char* samples[] = {"0", "21.5", "-0.001", "1e3", "6.02214076e23", "1.7976931348623157e308",
+                             "123456789012345678901234", "0.1", "99.7", "-273.15", ".5", "5."};
+    for (const char* s : samples) {
+        double d;
+        REQUIRE(CsvReader::parseDouble(s, strlen(s), d));
+        double ref = strtod(s, nullptr);
+        CHECK(std::fabs(d - ref) <= std::fabs(ref) * 1e-15);
+    }
+    double d;
+    CHECK((CsvReader::parseDouble("21.5", 4, d) && d == 21.5));
+    CHECK((CsvReader::parseDouble("0.1", 3, d) && d == 0.1));
+    CHECK_FALSE(CsvReader::parseDouble("-", 1, d));
+    CHECK_FALSE(CsvReader::parseDouble("1e", 2, d));
+    CHECK_FALSE(CsvReader::parseDouble("1.2.3", 5, d));
+}
+
+TEST_CASE("CsvWriter formats numbers and quotes text") {
+    MemFileSystem fs;
+    {
+        auto f = fs.openWrite("/out.csv");
+        CsvWriter w(*f, 64);
+        w.field("time").field("temp").field("note").endRow();
+        w.fieldInt(-1700000000).fieldDouble(21.456, 2).field("a,\"b\"").endRow();
+        w.fieldInt(0).fieldDouble(-0.0004, 3).fieldDouble(NAN).endRow();
+        w.field(std::string(100, 'z').c_str()).endRow(); // dłuższe niż bufor
+        CHECK(w.flush());
+    }
+    std::string expected = "time,temp,note\n-1700000000,21.46,\"a,\"\"b\"\"\"\n0,0.000,\n" + std::string(100, 'z') + "\n";
+    CHECK(slurp(fs, "/out.csv") == expected);
+
+    char buf[32];
+    CHECK(std::string(buf, CsvWriter::formatDouble(99.7, 1, buf)) == "99.7");
+    CHECK(std::string(buf, CsvWriter::formatDouble(-1.005, 0, buf)) == "-1");
+    CHECK(std::string(buf, CsvWriter::formatDouble(0.5, 4, buf)) == "0.5000");
+    CHECK(std::string(buf, CsvWriter::formatInt(INT64_MIN, buf)) == "-9223372036854775808");
+
+    // odczyt tego, co zapisano
+    auto f = fs.openRead("/out.csv");
+    CsvReader csv(*f);
+    REQUIRE(csv.readHeader());
+    REQUIRE(csv.next());
+    CHECK(str(csv.field(2)) == "a,\"b\"");
+}
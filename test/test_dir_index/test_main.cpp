@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <map>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/sd/DirIndex.cpp"
+
+using storage::sd::DirIndex;
+
+namespace {
+
+// Pozycje o danym hashu (w kolejności sondowania).
+std::vector<uint32_t> positions(const DirIndex& idx, uint32_t hash) {
+    std::vector<uint32_t> out;
+    idx.find(hash, [&](uint32_t pos, bool) {
+        out.push_back(pos);
+        return false;
+    });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("DirIndex hashes names case-insensitively like FAT") {
+    CHECK(DirIndex::hashName("CAPTURE.WAV") == DirIndex::hashName("capture.wav"));
+    CHECK(DirIndex::hashName("a") != DirIndex::hashName("b"));
+}
+
+TEST_CASE("DirIndex keeps 10k entries consistent through inserts and erases") {
+    DirIndex idx;
+    idx.reserve(10000);
+    std::map<std::string, uint32_t> model;
+    char name[32];
+    for (uint32_t i = 0; i < 10000; ++i) {
+        snprintf(name, sizeof(name), "rec_%05u.wav", (unsigned)i);
+        model[name] = i * 3;
+        REQUIRE(idx.insert(DirIndex::hashName(name), i * 3, false));
+    }
+    CHECK(idx.size() == 10000);
+    CHECK(idx.memoryUsage() <= 10000 * 8 * 3 / 2);
+
+    // usunięcie co drugiego i ponowne dodanie pod inną pozycją (jak przy nadpisaniu)
+    for (uint32_t i = 0; i < 10000; i += 2) {
+        snprintf(name, sizeof(name), "rec_%05u.wav", (unsigned)i);
+        REQUIRE(idx.erase(DirIndex::hashName(name), i * 3));
+        if (i % 4 == 0) {
+            REQUIRE(idx.insert(DirIndex::hashName(name), 100000 + i, false));
+            model[name] = 100000 + i;
+        } else {
+            model.erase(name);
+        }
+    }
+    CHECK(idx.size() == model.size());
+    for (uint32_t i = 0; i < 10000; ++i) {
+        snprintf(name, sizeof(name), "rec_%05u.wav", (unsigned)i);
+        auto found = positions(idx, DirIndex::hashName(name));
+        auto it = model.find(name);
+        if (it == model.end()) {
+            CHECK(found.empty());
+        } else {
+            REQUIRE(found.size() == 1);
+            CHECK(found[0] == it->second);
+        }
+    }
+    CHECK(positions(idx, DirIndex::hashName("missing.wav")).empty());
+}
+
+TEST_CASE("DirIndex keeps colliding hashes apart and remembers directories") {
+    DirIndex idx;
+    REQUIRE(idx.insert(42, 1, false));
+    REQUIRE(idx.insert(42, 7, true));
+    CHECK(positions(idx, 42).size() == 2);
+
+    bool dir = false;
+    CHECK(idx.find(42, [&](uint32_t pos, bool isDir) {
+        dir = isDir;
+        return pos == 7;
+    }));
+    CHECK(dir);
+    CHECK_FALSE(idx.erase(42, 3));
+    CHECK(idx.erase(42, 1));
+    CHECK(positions(idx, 42) == std::vector<uint32_t>{7});
+    CHECK_FALSE(idx.insert(1, DirIndex::kMaxPos + 1, false));
+}
@@ -0,0 +1,77 @@
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/io/FileHandleCache.cpp"
+
+using storage::IFile;
+using storage::OpenMode;
+using storage::io::FileHandleCache;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+std::string readAllCached(MemFileSystem& fs, const char* path) {
+    auto f = fs.openRead(path);
+    if (!f) return std::string();
+    std::string s(f->size(), '\0');
+    if (!s.empty()) f->read(&s[0], s.size());
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("spellings of the same path share one handle") {
+    MemFileSystem fs;
+    FileHandleCache cache(fs);
+    IFile* a = cache.get("/log.txt", OpenMode::WriteAppend);
+    REQUIRE(a);
+    CHECK(cache.get("log.txt", OpenMode::WriteAppend) == a);
+    CHECK(cache.get("//log.txt", OpenMode::WriteAppend) == a);
+    CHECK(cache.get("/./logs/../log.txt", OpenMode::WriteAppend) == a);
+    CHECK(cache.size() == 1);
+    CHECK(cache.misses() == 1);
+    CHECK(cache.hits() == 3);
+
+    cache.append("log.txt", "a", 1);
+    cache.append("//log.txt", "b", 1);
+    cache.flushAll();
+    CHECK(readAllCached(fs, "/log.txt") == "ab");
+    cache.close("log.txt");
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("WriteTruncate reopens and truncates on every get") {
+    MemFileSystem fs;
+    FileHandleCache cache(fs);
+    IFile* f = cache.get("/state.bin", OpenMode::WriteTruncate);
+    REQUIRE(f);
+    f->write("first", 5);
+    f = cache.get("/state.bin", OpenMode::WriteTruncate);
+    REQUIRE(f);
+    CHECK(f->position() == 0);
+    f->write("2nd", 3);
+    cache.flushAll();
+    CHECK(readAllCached(fs, "/state.bin") == "2nd");
+    CHECK(cache.size() == 1);
+    CHECK(cache.hits() == 0);
+}
+
+TEST_CASE("another mode closes the write handle, LRU eviction flushes") {
+    MemFileSystem fs;
+    FileHandleCache cache(fs, 2);
+    cache.append("/a.log", "1", 1);
+    CHECK(cache.get("/a.log", OpenMode::Read) != nullptr);
+    CHECK(cache.size() == 1); // uchwyt zapisu zamknięty przed otwarciem do odczytu
+    CHECK(readAllCached(fs, "/a.log") == "1");
+
+    cache.append("/b.log", "2", 1);
+    cache.append("/c.log", "3", 1); // wyrzuca /a.log (najdawniej używany)
+    CHECK(cache.size() == 2);
+    cache.setLimit(1);               // wyrzuca /b.log z flush
+    CHECK(cache.size() == 1);
+    CHECK(readAllCached(fs, "/b.log") == "2");
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+
+using storage::FileHandle;
+using storage::FilePool;
+using storage::FileStorage;
+using storage::IFile;
+using storage::OpenMode;
+using storage::mem::MemFile;
+using storage::mem::MemFileSystem;
+using storage::mem::MemNode;
+
+namespace {
+
+std::atomic<int> liveFiles(0);
+
+// MemFile liczący żywe obiekty – sprawdza, że destruktor naprawdę się wykonał.
+class TrackedFile : public MemFile {
+public:
+    explicit TrackedFile(std::shared_ptr<MemNode> n) : MemFile(std::move(n), true, true, nullptr) { liveFiles++; }
+    ~TrackedFile() override { liveFiles--; }
+};
+
+// open() zwraca TrackedFile ze sterty; openPooled – domyślny z IFileSystem.
+class TrackedFs : public MemFileSystem {
+public:
+    std::shared_ptr<MemNode> node = std::make_shared<MemNode>();
+    std::unique_ptr<IFile> open(const std::string&, OpenMode) override {
+        return std::unique_ptr<IFile>(new TrackedFile(node));
+    }
+};
+
+} // namespace
+
+TEST_CASE("the pool hands out N handles, then empty ones, and reuses released slots") {
+    auto node = std::make_shared<MemNode>();
+    FilePool<TrackedFile, 3> pool;
+    CHECK(pool.capacity() == 3);
+    CHECK(pool.available() == 3);
+
+    FileHandle a = pool.make(node);
+    FileHandle b = pool.make(node);
+    FileHandle c = pool.make(node);
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(c);
+    CHECK(pool.available() == 0);
+    CHECK(liveFiles == 3);
+    CHECK_FALSE(pool.make(node)); // pula pełna – pusty uchwyt, bez sterty
+
+    IFile* slotB = b.get();
+    CHECK(b->write("xy", 2) == 2);
+    b.reset();
+    CHECK(liveFiles == 2);
+    CHECK(pool.available() == 1);
+    CHECK(node->data.size() == 2);
+
+    FileHandle d = pool.make(node);
+    REQUIRE(d);
+    CHECK(d.get() == slotB); // zwolniony slot użyty ponownie
+    CHECK(pool.available() == 0);
+
+    a.reset();
+    c.reset();
+    d.reset();
+    CHECK(pool.available() == 3);
+    CHECK(liveFiles == 0);
+    CHECK(node.use_count() == 1);
+}
+
+TEST_CASE("available() stays correct when handles are released from other threads") {
+    auto node = std::make_shared<MemNode>();
+    FilePool<TrackedFile, 8> pool;
+    for (int round = 0; round < 50; ++round) {
+        FileHandle hs[8];
+        for (auto& h : hs) {
+            h = pool.make(node);
+            REQUIRE(h);
+        }
+        CHECK(pool.available() == 0);
+        std::thread t1([&] { for (int i = 0; i < 8; i += 2) hs[i].reset(); });
+        std::thread t2([&] { for (int i = 1; i < 8; i += 2) hs[i].reset(); });
+        t1.join();
+        t2.join();
+        CHECK(pool.available() == 8);
+    }
+    CHECK(liveFiles == 0);
+}
+
+TEST_CASE("placeFile constructs in caller storage and its handle runs the destructor") {
+    auto node = std::make_shared<MemNode>();
+    FileStorage<TrackedFile> slot;
+    {
+        FileHandle f = storage::placeFile<TrackedFile>(slot, node);
+        REQUIRE(f);
+        CHECK(static_cast<void*>(f.get()) == static_cast<void*>(&slot));
+        CHECK(liveFiles == 1);
+        CHECK(node.use_count() == 2);
+        f->write("abc", 3);
+    }
+    CHECK(liveFiles == 0);
+    CHECK(node.use_count() == 1);
+    CHECK(node->data.size() == 3);
+}
+
+TEST_CASE("default openPooled falls back to the heap and deletes the file") {
+    TrackedFs fs;
+    {
+        FileHandle f = fs.openPooled("/any.bin", OpenMode::WriteTruncate);
+        REQUIRE(f);
+        CHECK(liveFiles == 1);
+        CHECK(f->write("12345", 5) == 5);
+    } // delete przez FileDeleter bez release – pod ASan także zgodność new/delete
+    CHECK(liveFiles == 0);
+    CHECK(fs.node->data.size() == 5);
+
+    MemFileSystem mem;
+    CHECK_FALSE(mem.openPooled("/missing.bin", OpenMode::Read)); // błąd open → pusty uchwyt
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "storage/util/FileSearch.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::FileSearch;
+using storage::util::SearchHit;
+
+namespace {
+
+struct Found {
+    uint8_t pattern;
+    uint32_t line;
+    uint32_t offset;
+    std::string text;
+};
+
+bool sameHit(const Found& a, const Found& b) {
+    return a.pattern == b.pattern && a.line == b.line && a.offset == b.offset;
+}
+
+std::string lowerAscii(std::string s) {
+    for (auto& c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// Wzorzec: wszystkie wystąpienia, wzorce w kolejności indeksu dla tego samego offsetu.
+std::vector<Found> naive(const std::string& text, const std::vector<std::string>& pats, bool icase) {
+    std::string hay = icase ? lowerAscii(text) : text;
+    std::vector<Found> out;
+    uint32_t line = 1;
+    for (size_t i = 0; i < hay.size(); ++i) {
+        for (size_t k = 0; k < pats.size(); ++k) {
+            std::string p = icase ? lowerAscii(pats[k]) : pats[k];
+            if (hay.compare(i, p.size(), p) == 0) out.push_back(Found{static_cast<uint8_t>(k), line, (uint32_t)i, ""});
+        }
+        if (hay[i] == '\n') line++;
+    }
+    return out;
+}
+
+std::vector<Found> run(FileSearch& grep, MemFileSystem& fs, const char* path) {
+    std::vector<Found> out;
+    auto f = fs.openRead(path);
+    CHECK(f);
+    if (!f) return out;
+    grep.searchFile(*f, path, [&](const SearchHit& h) {
+        out.push_back(Found{h.pattern, h.line, h.offset, std::string(h.text, h.textLen)});
+        return true;
+    });
+    return out;
+}
+
+void checkSameHits(std::vector<Found> got, std::vector<Found> want) {
+    auto byPos = [](const Found& a, const Found& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.pattern < b.pattern;
+    };
+    std::sort(got.begin(), got.end(), byPos);
+    std::sort(want.begin(), want.end(), byPos);
+    REQUIRE(got.size() == want.size());
+    for (size_t i = 0; i < got.size(); ++i) CHECK(sameHit(got[i], want[i]));
+}
+
+} // namespace
+
+TEST_CASE("patterns split across block boundaries are found exactly once") {
+    MemFileSystem fs;
+    std::string text;
+    srand(7);
+    const char* words[] = {"ok ", "ERROR ", "timeout ", "x", "\n", "abc", "TimeOut", "\r\n"};
+    while (text.size() < 5000) text += words[rand() % 8];
+    // wzorzec dokładnie na granicy bloku 64 B
+    text.replace(126, 5, "ERROR");
+    fs.openWrite("/a.log")->write(text.data(), text.size());
+
+    std::vector<std::string> pats = {"ERROR", "timeout", "x"};
+    FileSearch grep(64, 40);
+    for (const auto& p : pats) grep.addPattern(p.c_str());
+    auto got = run(grep, fs, "/a.log");
+    checkSameHits(got, naive(text, pats, false));
+    CHECK(grep.hits() == got.size());
+}
+
+TEST_CASE("a long line keeps matches at block edges and reports a fragment") {
+    MemFileSystem fs;
+    std::string line(300, '-');
+    line.replace(62, 6, "needle");  // przecina granicę 64
+    line.replace(250, 6, "needle");
+    std::string text = "first\n" + line + "\nlast needle\n";
+    fs.openWrite("/long.log")->write(text.data(), text.size());
+
+    FileSearch grep(64, 32);
+    grep.addPattern("needle");
+    auto got = run(grep, fs, "/long.log");
+    REQUIRE(got.size() == 3);
+    CHECK(got[0].line == 2);
+    CHECK(got[0].offset == 6 + 62);
+    CHECK(got[1].line == 2);
+    CHECK(got[1].offset == 6 + 250);
+    CHECK(got[1].text.size() <= 64);
+    CHECK(got[2].line == 3);
+    CHECK(got[2].text == "last needle");
+}
+
+TEST_CASE("ignore-case matching and line numbers without CR") {
+    MemFileSystem fs;
+    std::string text = "Alpha\r\nbeta WARN\r\n\r\nwarn again, WaRn\nnothing\nlast Warn";
+    fs.openWrite("/b.log")->write(text.data(), text.size());
+
+    FileSearch grep(64);
+    grep.addPattern("warn");
+    grep.setIgnoreCase(true);
+    auto got = run(grep, fs, "/b.log");
+    checkSameHits(got, naive(text, {"warn"}, true));
+    REQUIRE(got.size() == 4);
+    CHECK(got[0].line == 2);
+    CHECK(got[0].text == "beta WARN");
+    CHECK(got[1].line == 4);
+    CHECK(got[3].line == 6);
+    CHECK(got[3].text == "last Warn");
+
+    grep.setIgnoreCase(false);
+    got = run(grep, fs, "/b.log");
+    REQUIRE(got.size() == 1);
+    CHECK(got[0].line == 4);
+}
+
+TEST_CASE("tree search visits nested files and stops on request") {
+    MemFileSystem fs;
+    fs.openWrite("/logs/a.log")->write("hit\n", 4);
+    fs.openWrite("/logs/day/b.log")->write("no\nhit\n", 7);
+    fs.openWrite("/other.txt")->write("hit\n", 4);
+
+    FileSearch grep(64);
+    grep.addPattern("hit");
+    std::vector<std::string> paths;
+    uint32_t now = 0;
+    grep.beginTree(fs, "/logs", [&](const SearchHit& h) {
+        paths.push_back(std::string(h.path) + ":" + std::to_string(h.line));
+        return true;
+    }, [&] { return now++; });
+    while (grep.stepTree(5)) {
+    }
+    std::sort(paths.begin(), paths.end());
+    REQUIRE(paths.size() == 2);
+    CHECK(paths[0] == "/logs/a.log:1");
+    CHECK(paths[1] == "/logs/day/b.log:2");
+    CHECK(grep.filesScanned() == 2);
+
+    uint32_t seen = 0;
+    grep.beginTree(fs, "/", [&](const SearchHit&) { return ++seen < 1; }, [&] { return now++; });
+    while (grep.stepTree(1000)) {
+    }
+    CHECK(seen == 1);
+    CHECK(grep.hits() == 1);
+}
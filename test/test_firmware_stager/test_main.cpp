@@ -0,0 +1,213 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/ota/Sha256.cpp"
+#include "../../src/storage/ota/FirmwareSink.cpp"
+#include "../../src/storage/ota/FirmwareStager.cpp"
+
+using storage::mem::MemFileSystem;
+using storage::ota::FileSink;
+using storage::ota::FirmwareStager;
+using storage::ota::MemorySink;
+using storage::ota::Sha256;
+
+namespace {
+
+std::string hexOf(const void* data, size_t len) {
+    Sha256 h;
+    h.update(data, len);
+    uint8_t d[Sha256::kDigestSize];
+    h.finish(d);
+    char hex[Sha256::kDigestSize * 2 + 1];
+    Sha256::toHex(d, hex);
+    return hex;
+}
+
+std::vector<uint8_t> makeImage(size_t size) {
+    std::vector<uint8_t> img(size);
+    uint32_t x = 12345;
+    for (auto& b : img) {
+        x = x * 1103515245 + 12345;
+        b = static_cast<uint8_t>(x >> 16);
+    }
+    return img;
+}
+
+void writeFile(MemFileSystem& fs, const char* path, const std::vector<uint8_t>& data) {
+    auto f = fs.openWrite(path);
+    REQUIRE(f);
+    REQUIRE(f->write(data.data(), data.size()) == data.size());
+}
+
+// Ujście zapisujące do pamięci, które odmawia po `failAfter` blokach.
+struct FailingSink : MemorySink {
+    int failAfter;
+    int writes = 0;
+    bool aborted = false;
+    explicit FailingSink(int n) : failAfter(n) {}
+    bool write(const uint8_t* data, size_t len) override {
+        return ++writes <= failAfter && MemorySink::write(data, len);
+    }
+    void abort() override { aborted = true; MemorySink::abort(); }
+};
+
+} // namespace
+
+TEST_CASE("Sha256 matches FIPS 180-4 test vectors") {
+    CHECK(hexOf("", 0) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(hexOf("abc", 3) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    const char* two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    CHECK(hexOf(two, strlen(two)) == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    // podział na dowolne kawałki daje ten sam wynik
+    std::vector<uint8_t> img = makeImage(1000);
+    Sha256 h;
+    for (size_t i = 0; i < img.size(); i += 7) h.update(img.data() + i, img.size() - i < 7 ? img.size() - i : 7);
+    uint8_t d[Sha256::kDigestSize];
+    h.finish(d);
+    char hex[65];
+    Sha256::toHex(d, hex);
+    CHECK(std::string(hex) == hexOf(img.data(), img.size()));
+
+    uint8_t parsed[Sha256::kDigestSize];
+    CHECK(Sha256::fromHex((std::string(hex) + "\n").c_str(), parsed));
+    CHECK(memcmp(parsed, d, sizeof(d)) == 0);
+    CHECK_FALSE(Sha256::fromHex("abc", parsed));
+}
+
+TEST_CASE("FirmwareStager copies an image through the ring and verifies the digest") {
+    MemFileSystem fs;
+    std::vector<uint8_t> img = makeImage(100 * 1024 + 123);
+    writeFile(fs, "/fw/app.bin", img);
+    std::string hex = hexOf(img.data(), img.size());
+    {
+        auto f = fs.openWrite("/fw/app.bin.sha256");
+        std::string line = hex + "  app.bin\n";
+        f->write(line.data(), line.size());
+    }
+
+    uint8_t expected[Sha256::kDigestSize];
+    REQUIRE(FirmwareStager::loadDigest(fs, "/fw/app.bin.sha256", expected));
+
+    FirmwareStager::Config cfg;
+    cfg.blockSize = 1024;
+    cfg.blocks = 3;
+    FirmwareStager stager(cfg);
+    MemorySink sink;
+    uint32_t lastProgress = 0;
+    auto src = fs.openRead("/fw/app.bin");
+    auto r = stager.stage(*src, sink, expected, [&](uint32_t done, uint32_t total) {
+        CHECK(done > lastProgress);
+        CHECK(total == img.size());
+        lastProgress = done;
+    });
+    CHECK(r.status == FirmwareStager::Status::Ok);
+    CHECK(r.bytes == img.size());
+    CHECK(lastProgress == img.size());
+    CHECK(sink.committed());
+    CHECK(sink.data() == img);
+}
+
+TEST_CASE("FirmwareStager aborts on digest mismatch") {
+    MemFileSystem fs;
+    std::vector<uint8_t> img = makeImage(20000);
+    writeFile(fs, "/app.bin", img);
+    FirmwareStager::Config cfg;
+    cfg.blockSize = 512;
+    FirmwareStager stager(cfg);
+
+    uint8_t wrong[Sha256::kDigestSize] = {};
+    FailingSink sink(1000);
+    auto src = fs.openRead("/app.bin");
+    auto r = stager.stage(*src, sink, wrong);
+    CHECK(r.status == FirmwareStager::Status::DigestMismatch);
+    CHECK(r.bytes == img.size());
+    CHECK(sink.aborted);
+    CHECK_FALSE(sink.committed());
+}
+
+TEST_CASE("FirmwareStager stops reading when the sink fails") {
+    MemFileSystem fs;
+    std::vector<uint8_t> img = makeImage(20000);
+    writeFile(fs, "/app.bin", img);
+    FirmwareStager::Config cfg;
+    cfg.blockSize = 512;
+    FirmwareStager stager(cfg);
+
+    FailingSink sink(5);
+    auto src = fs.openRead("/app.bin");
+    auto r = stager.stage(*src, sink, nullptr);
+    CHECK(r.status == FirmwareStager::Status::SinkError);
+    CHECK(sink.aborted);
+    CHECK(r.bytes < img.size());
+}
+
+TEST_CASE("FirmwareStager reports a source that cannot rewind as a read error") {
+    MemFileSystem fs;
+    writeFile(fs, "/app.bin", makeImage(4096));
+    FirmwareStager stager;
+
+    FailingSink sink(1000);
+    auto src = fs.openRead("/app.bin");
+    src->close(); // seek(0) zawodzi
+    auto r = stager.stage(*src, sink, nullptr);
+    CHECK(r.status == FirmwareStager::Status::ReadError);
+    CHECK(sink.writes == 0);
+    CHECK_FALSE(sink.committed());
+}
+
+TEST_CASE("FileSink replaces the target only on commit") {
+    MemFileSystem fs;
+    std::vector<uint8_t> oldImg = makeImage(300), img = makeImage(5000);
+    writeFile(fs, "/stage/next.bin", oldImg);
+    writeFile(fs, "/new.bin", img);
+    FirmwareStager stager;
+
+    uint8_t wrong[Sha256::kDigestSize] = {};
+    {
+        FileSink sink(fs, "/stage/next.bin");
+        auto src = fs.openRead("/new.bin");
+        CHECK(stager.stage(*src, sink, wrong).status == FirmwareStager::Status::DigestMismatch);
+    }
+    CHECK_FALSE(fs.exists("/stage/next.bin.part"));
+    CHECK(fs.openRead("/stage/next.bin")->size() == oldImg.size());
+
+    FileSink sink(fs, "/stage/next.bin");
+    auto src = fs.openRead("/new.bin");
+    auto r = stager.stage(*src, sink, nullptr);
+    CHECK(r.status == FirmwareStager::Status::Ok);
+    CHECK_FALSE(fs.exists("/stage/next.bin.part"));
+    auto f = fs.openRead("/stage/next.bin");
+    std::vector<uint8_t> got(f->size());
+    f->read(got.data(), got.size());
+    CHECK(got == img);
+}
+
+TEST_CASE("FileSink recovers the previous image after an interrupted commit") {
+    MemFileSystem fs;
+    std::vector<uint8_t> oldImg = makeImage(300);
+    // przerwane między rename: obraz tylko w .bak
+    writeFile(fs, "/stage/next.bin.bak", oldImg);
+    CHECK(FileSink::recover(fs, "/stage/next.bin"));
+    CHECK_FALSE(fs.exists("/stage/next.bin.bak"));
+    REQUIRE(fs.exists("/stage/next.bin"));
+    CHECK(fs.openRead("/stage/next.bin")->size() == oldImg.size());
+
+    // przerwane po podmianie: zbędny .bak usuwa begin()
+    writeFile(fs, "/stage/next.bin.bak", oldImg);
+    FileSink sink(fs, "/stage/next.bin");
+    REQUIRE(sink.begin(10));
+    CHECK_FALSE(fs.exists("/stage/next.bin.bak"));
+    const uint8_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    REQUIRE(sink.write(data, sizeof(data)));
+    REQUIRE(sink.commit());
+    CHECK_FALSE(fs.exists("/stage/next.bin.bak"));
+    CHECK_FALSE(fs.exists("/stage/next.bin.part"));
+    CHECK(fs.openRead("/stage/next.bin")->size() == sizeof(data));
+}
@@ -0,0 +1,73 @@
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/sd/FreeSpaceTracker.cpp"
+
+using storage::FsInfo;
+using storage::mem::MemFileSystem;
+using storage::sd::FreeSpaceTracker;
+
+TEST_CASE("MemFileSystem::info reports nothing until setCapacity") {
+    MemFileSystem fs;
+    FsInfo info;
+    info.totalBytes = 123;
+    CHECK_FALSE(fs.info(info));
+    CHECK(info.totalBytes == 0);
+
+    fs.setCapacity(1000);
+    fs.openWrite("/a.bin")->write(std::string(300, 'a').data(), 300);
+    fs.openWrite("/b/c.bin")->write("xyz", 3);
+    REQUIRE(fs.info(info));
+    CHECK(info.totalBytes == 1000);
+    CHECK(info.freeBytes == 697);
+    CHECK(info.clusterSize == 1);
+    CHECK(info.ioAlignment == 1);
+
+    fs.openWrite("/big.bin")->write(std::string(900, 'b').data(), 900);
+    REQUIRE(fs.info(info));
+    CHECK(info.freeBytes == 0); // zapis nie jest ograniczany, wolne nie schodzi poniżej 0
+
+    fs.remove("/big.bin");
+    REQUIRE(fs.info(info));
+    CHECK(info.freeBytes == 697);
+}
+
+TEST_CASE("FreeSpaceTracker ignores corrections before the first count") {
+    FreeSpaceTracker t;
+    CHECK_FALSE(t.valid());
+    t.resized(0, 100000);
+    t.adjust(-5);
+    CHECK_FALSE(t.valid());
+    CHECK(t.freeClusters() == 0);
+
+    t.reset(100, 4096);
+    CHECK(t.valid());
+    CHECK(t.freeClusters() == 100);
+    CHECK(t.clusterBytes() == 4096);
+    t.invalidate();
+    t.adjust(-1);
+    CHECK_FALSE(t.valid());
+}
+
+TEST_CASE("FreeSpaceTracker::resized rounds sizes up to whole clusters") {
+    FreeSpaceTracker t;
+    t.reset(100, 4096);
+    t.resized(0, 1);          // pierwszy bajt zajmuje cały klaster
+    CHECK(t.freeClusters() == 99);
+    t.resized(1, 4096);       // ten sam klaster
+    CHECK(t.freeClusters() == 99);
+    t.resized(4096, 4097);    // drugi klaster
+    CHECK(t.freeClusters() == 98);
+    t.resized(4097, 3 * 4096 + 10);
+    CHECK(t.freeClusters() == 96);
+    t.resized(3 * 4096 + 10, 0); // usunięcie zwalnia wszystkie cztery
+    CHECK(t.freeClusters() == 100);
+
+    t.adjust(-150);           // więcej niż wolne – licznik nie schodzi poniżej 0
+    CHECK(t.valid());
+    CHECK(t.freeClusters() == 0);
+}
@@ -0,0 +1,111 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <Arduino.h>
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/util/IniReader.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::IniIssue;
+using storage::util::IniIssueKind;
+using storage::util::IniReader;
+
+namespace {
+
+struct AppConfig {
+    char host[8];
+    int32_t port;
+    bool timeshift;
+    float volume;
+};
+
+constexpr storage::util::IniField kAppFields[] = {
+    storage::util::iniString("network", "host", offsetof(AppConfig, host), sizeof(AppConfig::host), "example"),
+    storage::util::iniInt("network", "port", offsetof(AppConfig, port), 8080, 1, 65535),
+    storage::util::iniBool("audio", "timeshift", offsetof(AppConfig, timeshift), false),
+    storage::util::iniFloat("audio", "volume", offsetof(AppConfig, volume), 0.5f, 0.0f, 1.0f),
+};
+constexpr auto kAppSchema = storage::util::makeIniSchema<AppConfig>(kAppFields);
+static_assert(kAppSchema.ok, "schema");
+static_assert(kAppSchema.find("audio", "volume") == 3, "lookup at compile time");
+
+constexpr storage::util::IniField kDupFields[] = {
+    storage::util::iniInt("a", "x", offsetof(AppConfig, port), 0),
+    storage::util::iniInt("A", "X", offsetof(AppConfig, port), 0),
+};
+static_assert(!storage::util::makeIniSchema<AppConfig>(kDupFields).ok, "duplicate keys rejected");
+
+struct Parsed {
+    AppConfig cfg;
+    bool clean;
+    std::vector<IniIssueKind> issues;
+    std::vector<std::string> keys;
+};
+
+Parsed parse(const std::string& text) {
+    MemFileSystem fs;
+    {
+        auto w = fs.openWrite("/app.ini");
+        w->write(text.data(), text.size());
+    }
+    auto f = fs.openRead("/app.ini");
+    Parsed p;
+    IniReader ini(*f);
+    p.clean = ini.parseInto(kAppSchema, p.cfg, [&](const IniIssue& e) {
+        p.issues.push_back(e.kind);
+        p.keys.push_back(e.key);
+    });
+    return p;
+}
+
+} // namespace
+
+TEST_CASE("perfect hash finds every field case-insensitively and rejects others") {
+    CHECK(kAppSchema.find("network", "host") == 0);
+    CHECK(kAppSchema.find("network", "port") == 1);
+    CHECK(kAppSchema.find("audio", "timeshift") == 2);
+    CHECK(kAppSchema.find("AUDIO", "Volume") == 3);
+    CHECK(kAppSchema.find("audio", "port") == -1);
+    CHECK(kAppSchema.find("network", "") == -1);
+    CHECK(kAppSchema.find("", "volume") == -1);
+}
+
+TEST_CASE("values are parsed into the struct over defaults") {
+    Parsed p = parse("[Network]\nhost = box ; komentarz\nport=0x1F91\n[audio]\ntimeshift=on\n");
+    CHECK(p.clean);
+    CHECK(std::string(p.cfg.host) == "box");
+    CHECK(p.cfg.port == 8081); // inna niż domyślna 8080 – hex naprawdę sparsowany
+    CHECK(p.cfg.timeshift);
+    CHECK(p.cfg.volume == 0.5f);
+}
+
+TEST_CASE("invalid, out-of-range and unknown values are reported and keep defaults") {
+    Parsed p = parse("[network]\nport=70000\nhost=much-too-long\nspeed=3\n"
+                     "[audio]\nvolume=nan\ntimeshift=maybe\n");
+    CHECK_FALSE(p.clean);
+    REQUIRE(p.issues.size() == 5);
+    CHECK(p.issues[0] == IniIssueKind::OutOfRange);
+    CHECK(p.issues[1] == IniIssueKind::Truncated);
+    CHECK(p.issues[2] == IniIssueKind::UnknownKey);
+    CHECK(p.issues[3] == IniIssueKind::OutOfRange);
+    CHECK(p.issues[4] == IniIssueKind::InvalidValue);
+    CHECK(p.cfg.port == 8080);
+    CHECK(p.cfg.volume == 0.5f);
+    CHECK(std::string(p.cfg.host) == "much-to"); // obcięte do bufora
+}
+
+TEST_CASE("integer overflow is out of range, not wrapped") {
+    Parsed p = parse("[network]\nport=99999999999999999999\n");
+    REQUIRE(p.issues.size() == 1);
+    CHECK(p.issues[0] == IniIssueKind::OutOfRange);
+    CHECK(p.cfg.port == 8080);
+
+    p = parse("[network]\nport=0x100000050\n");
+    REQUIRE(p.issues.size() == 1);
+    CHECK(p.issues[0] == IniIssueKind::OutOfRange);
+}
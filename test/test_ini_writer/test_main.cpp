@@ -0,0 +1,97 @@
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/util/IniWriter.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::IniWriter;
+
+namespace {
+
+void put(MemFileSystem& fs, const std::string& path, const std::string& data) {
+    auto f = fs.openWrite(path);
+    if (!data.empty()) f->write(data.data(), data.size());
+}
+
+std::string read(MemFileSystem& fs, const std::string& path) {
+    auto f = fs.openRead(path);
+    if (!f) return "<missing>";
+    std::string s(f->size(), '\0');
+    if (!s.empty()) f->read(&s[0], s.size());
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("commit edits in place and keeps comments and line endings") {
+    MemFileSystem fs;
+    put(fs, "/c.ini", "; cfg\r\n[Network]\r\nport = 8080 ; http\r\nhost=a\r\n\r\n[wifi]\r\npassword=x\r\n");
+    IniWriter w(fs, "/c.ini");
+    w.set("network", "PORT", "8081");
+    w.set("network", "mtu", "1400");
+    w.remove("WiFi", "password");
+    w.set("audio", "volume", "0.5");
+    CHECK(w.commit() == IniWriter::Result::Written);
+    CHECK(read(fs, "/c.ini") ==
+          "; cfg\r\n[Network]\r\nport = 8081 ; http\r\nhost=a\r\nmtu = 1400\r\n\r\n[wifi]\r\n"
+          "\r\n[audio]\r\nvolume = 0.5\r\n");
+    CHECK_FALSE(fs.exists("/c.ini.tmp"));
+    CHECK_FALSE(fs.exists("/c.ini.bak"));
+    CHECK(w.commit() == IniWriter::Result::Unchanged);
+}
+
+TEST_CASE("erasing the last key without a trailing newline adds no blank line") {
+    MemFileSystem fs;
+    put(fs, "/c.ini", "[a]\nx=1\ny=2");
+    IniWriter w(fs, "/c.ini");
+    w.remove("a", "y");
+    w.set("a", "z", "3");
+    CHECK(w.commit() == IniWriter::Result::Written);
+    CHECK(read(fs, "/c.ini") == "[a]\nx=1\nz = 3\n");
+
+    put(fs, "/d.ini", "[a]\nx=1\ny=2");
+    IniWriter d(fs, "/d.ini");
+    d.set("a", "z", "3");
+    CHECK(d.commit() == IniWriter::Result::Written);
+    CHECK(read(fs, "/d.ini") == "[a]\nx=1\ny=2\nz = 3\n");
+}
+
+TEST_CASE("a null value is stored as empty") {
+    MemFileSystem fs;
+    put(fs, "/c.ini", "[a]\nx=1\n");
+    IniWriter w(fs, "/c.ini");
+    w.set("a", "x", nullptr);
+    w.set("a", "x", nullptr); // ponownie – aktualizacja istniejącej edycji
+    CHECK(w.commit() == IniWriter::Result::Written);
+    CHECK(read(fs, "/c.ini") == "[a]\nx=\n");
+}
+
+TEST_CASE("recover restores the backup after an interrupted swap") {
+    MemFileSystem fs;
+    // przerwane między rename: jest tylko .bak i niedokończony .tmp
+    put(fs, "/c.ini.bak", "[a]\nx=1\n");
+    put(fs, "/c.ini.tmp", "[a]\nx=");
+    CHECK(IniWriter::recover(fs, "/c.ini"));
+    CHECK(read(fs, "/c.ini") == "[a]\nx=1\n");
+    CHECK_FALSE(fs.exists("/c.ini.bak"));
+    CHECK_FALSE(fs.exists("/c.ini.tmp"));
+
+    // przerwane po podmianie: nowa wersja jest już na miejscu
+    put(fs, "/c.ini", "[a]\nx=2\n");
+    put(fs, "/c.ini.bak", "[a]\nx=1\n");
+    CHECK(IniWriter::recover(fs, "/c.ini"));
+    CHECK(read(fs, "/c.ini") == "[a]\nx=2\n");
+    CHECK_FALSE(fs.exists("/c.ini.bak"));
+}
+
+TEST_CASE("commit on a missing file creates it") {
+    MemFileSystem fs;
+    IniWriter w(fs, "/new.ini");
+    w.set("a", "x", "1");
+    CHECK(w.commit() == IniWriter::Result::Written);
+    CHECK(read(fs, "/new.ini") == "[a]\nx = 1\n");
+}
@@ -0,0 +1,230 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/mem/SimulatedFileSystem.cpp"
+#include "../../src/storage/io/IoScheduler.cpp"
+
+using storage::IFileSystem;
+using storage::io::IoPriority;
+using storage::io::IoResult;
+using storage::io::IoScheduler;
+using storage::mem::MediaModel;
+using storage::mem::MemFileSystem;
+using storage::mem::SimulatedFileSystem;
+using storage::mem::VirtualClock;
+
+TEST_CASE("a large append is written in maxChunk pieces") {
+    MediaModel m = MediaModel::sdCard();
+    m.stallChance = 0.0f;
+    MemFileSystem ram;
+    VirtualClock clock;
+    SimulatedFileSystem sd(ram, clock, m);
+    IoScheduler::Config cfg;
+    cfg.maxChunk = 1024;
+    IoScheduler io(sd, cfg);
+    REQUIRE(io.start());
+
+    std::vector<uint8_t> big(16 * 1024, 0x42);
+    IoResult res;
+    REQUIRE(io.append("/big.bin", big.data(), big.size(), IoPriority::Low, [&](const IoResult& r) { res = r; }));
+    io.drain();
+    CHECK(res.ok);
+    CHECK(res.bytes == big.size());
+    CHECK(ram.totalBytes() == big.size());
+    // jeden zapis 16 KiB to 32 sektory + kilka bloków kasowania; porcja 1 KiB – najwyżej 2 sektory i jedno kasowanie
+    CHECK(sd.stats().maxOpUs <= m.openUs + 2 * m.writeSectorUs + m.eraseUs);
+}
+
+TEST_CASE("small appends are still coalesced in order") {
+    MemFileSystem ram;
+    IoScheduler io(ram);
+    REQUIRE(io.start());
+    std::atomic<int> ok(0);
+    for (int i = 0; i < 100; ++i) {
+        std::string line = std::to_string(i) + "\n";
+        while (!io.append("/log.txt", line.data(), line.size(), IoPriority::Normal,
+                          [&](const IoResult& r) { if (r.ok) ok++; })) {
+            io.drain();
+        }
+    }
+    io.drain();
+    CHECK(ok == 100);
+    auto f = ram.openRead("/log.txt");
+    std::string s(f->size(), '\0');
+    f->read(&s[0], s.size());
+    std::string want;
+    for (int i = 0; i < 100; ++i) want += std::to_string(i) + "\n";
+    CHECK(s == want);
+}
+
+TEST_CASE("stop() from a callback does not terminate on destruction") {
+    MemFileSystem ram;
+    {
+        IoScheduler io(ram);
+        REQUIRE(io.start());
+        REQUIRE(io.run([&](IFileSystem&) {
+            io.stop();
+            return true;
+        }, IoPriority::Normal, nullptr));
+        io.drain();
+        CHECK_FALSE(io.append("/x", "a", 1, IoPriority::Normal, nullptr));   // po sygnale zakończenia zlecenia są odrzucane
+    } // destruktor dołącza wątek
+    CHECK(true);
+}
+
+namespace {
+
+// Blokuje wątek roboczy, dopóki test nie zakolejkuje reszty zleceń.
+struct Gate {
+    std::mutex m;
+    std::condition_variable cv;
+    bool entered = false;
+    bool open = false;
+
+    void block(IoScheduler& io) {
+        REQUIRE(io.run([this](IFileSystem&) {
+            std::unique_lock<std::mutex> lock(m);
+            entered = true;
+            cv.notify_all();
+            cv.wait(lock, [this] { return open; });
+            return true;
+        }, IoPriority::High, nullptr));
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [this] { return entered; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(m);
+        open = true;
+        cv.notify_all();
+    }
+};
+
+} // namespace
+
+TEST_CASE("a queued High request overtakes queued Low and Normal work") {
+    MemFileSystem ram;
+    IoScheduler io(ram);
+    REQUIRE(io.start());
+    Gate gate;
+    gate.block(io);
+
+    std::vector<std::string> order; // tylko wątek roboczy
+    auto job = [&order](const char* name) {
+        return [&order, name](IFileSystem&) {
+            order.push_back(name);
+            return true;
+        };
+    };
+    REQUIRE(io.run(job("low"), IoPriority::Low, nullptr));
+    REQUIRE(io.run(job("normal"), IoPriority::Normal, nullptr));
+    REQUIRE(io.run(job("high"), IoPriority::High, nullptr));
+    REQUIRE(io.run(job("normal2"), IoPriority::Normal, nullptr));
+    gate.release();
+    io.drain();
+
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == "high");
+    CHECK(order[1] == "normal");
+    CHECK(order[2] == "normal2");
+    CHECK(order[3] == "low");
+}
+
+TEST_CASE("adjacent reads of one file are served by one backend read") {
+    MemFileSystem ram;
+    {
+        auto f = ram.openWrite("/data.bin");
+        std::string d;
+        for (int i = 0; i < 300; ++i) d += static_cast<char>('a' + i % 26);
+        f->write(d.data(), d.size());
+    }
+    VirtualClock clock;
+    SimulatedFileSystem sd(ram, clock, MediaModel::instant());
+    IoScheduler io(sd);
+    REQUIRE(io.start());
+    Gate gate;
+    gate.block(io);
+    sd.resetStats();
+
+    char a[100], b[150];
+    IoResult ra, rb;
+    REQUIRE(io.read("/data.bin", 0, a, sizeof(a), IoPriority::Normal, [&](const IoResult& r) { ra = r; }));
+    REQUIRE(io.read("/data.bin", 100, b, sizeof(b), IoPriority::Normal, [&](const IoResult& r) { rb = r; }));
+    gate.release();
+    io.drain();
+
+    CHECK(ra.ok);
+    CHECK(ra.bytes == 100);
+    CHECK(rb.ok);
+    CHECK(rb.bytes == 150);
+    CHECK(a[99] == 'a' + 99 % 26);
+    CHECK(b[0] == 'a' + 100 % 26);
+    CHECK(b[149] == 'a' + 249 % 26);
+    CHECK(sd.stats().ops == 3); // open + jeden odczyt + close po opróżnieniu kolejki
+}
+
+namespace {
+
+// Zapis kończy się po `budget` bajtach (pełny nośnik).
+class BudgetFile : public storage::IFile {
+public:
+    BudgetFile(std::unique_ptr<storage::IFile> f, size_t* budget) : inner(std::move(f)), left(budget) {}
+    size_t read(void* buf, size_t size) override { return inner->read(buf, size); }
+    size_t write(const void* buf, size_t size) override {
+        size_t n = size < *left ? size : *left;
+        *left -= n;
+        return n ? inner->write(buf, n) : 0;
+    }
+    void flush() override { inner->flush(); }
+    bool seek(uint32_t pos) override { return inner->seek(pos); }
+    uint32_t position() override { return inner->position(); }
+    uint32_t size() override { return inner->size(); }
+    bool isOpen() const override { return inner->isOpen(); }
+    void close() override { inner->close(); }
+
+private:
+    std::unique_ptr<storage::IFile> inner;
+    size_t* left;
+};
+
+class BudgetFs : public MemFileSystem {
+public:
+    size_t budget = 6;
+    std::unique_ptr<storage::IFile> open(const std::string& path, storage::OpenMode mode) override {
+        auto f = MemFileSystem::open(path, mode);
+        if (!f || mode == storage::OpenMode::Read) return f;
+        return std::unique_ptr<storage::IFile>(new BudgetFile(std::move(f), &budget));
+    }
+};
+
+} // namespace
+
+TEST_CASE("a short coalesced append reports bytes per request") {
+    BudgetFs ram;
+    IoScheduler io(ram);
+    REQUIRE(io.start());
+    Gate gate;
+    gate.block(io);
+
+    std::vector<IoResult> res(3);
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(io.append("/log.txt", "abcd", 4, IoPriority::Normal, [&res, i](const IoResult& r) { res[i] = r; }));
+    }
+    gate.release();
+    io.drain();
+    CHECK(res[0].ok);
+    CHECK(res[0].bytes == 4);
+    CHECK_FALSE(res[1].ok);
+    CHECK(res[1].bytes == 2);
+    CHECK_FALSE(res[2].ok);
+    CHECK(res[2].bytes == 0);
+    CHECK(ram.totalBytes() == 6);
+}
@@ -0,0 +1,166 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "storage/util/LineIndex.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::LineIndex;
+
+namespace {
+
+void writeText(MemFileSystem& fs, const char* path, const std::string& text, bool append = false) {
+    auto f = fs.openWrite(path, !append);
+    REQUIRE(f);
+    if (!text.empty()) f->write(text.data(), text.size());
+}
+
+std::string numbered(uint32_t from, uint32_t to) {
+    std::string s;
+    for (uint32_t i = from; i < to; ++i) s += "line " + std::to_string(i) + "\n";
+    return s;
+}
+
+std::vector<std::string> page(MemFileSystem& fs, LineIndex& idx, uint32_t first, uint32_t count,
+                              size_t maxLine = 256) {
+    std::vector<std::string> out;
+    auto f = fs.openRead(idx.path());
+    idx.readLines(*f, first, count, [&](uint32_t n, const String& line) {
+        CHECK(n == first + out.size());
+        out.push_back(line.c_str());
+        return true;
+    }, maxLine);
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("build indexes every K-th line and pages through the file") {
+    MemFileSystem fs;
+    writeText(fs, "/app.log", numbered(0, 1000) + "tail");
+    LineIndex idx(fs, "/app.log", 16, 64); // blok mniejszy niż linia*K – przejścia przez granice bloków
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 1001);
+    CHECK(idx.entries() == 1000 / 16 + 1);
+
+    auto p = page(fs, idx, 517, 3);
+    REQUIRE(p.size() == 3);
+    CHECK(p[0] == "line 517");
+    CHECK(p[2] == "line 519");
+
+    p = page(fs, idx, 999, 5);
+    REQUIRE(p.size() == 2);
+    CHECK(p[0] == "line 999");
+    CHECK(p[1] == "tail");
+    CHECK(page(fs, idx, 1001, 1).empty());
+}
+
+TEST_CASE("reopen loads the sidecar and indexes only appended bytes") {
+    MemFileSystem fs;
+    writeText(fs, "/app.log", numbered(0, 100));
+    {
+        LineIndex idx(fs, "/app.log", 8);
+        REQUIRE(idx.update());
+    }
+    CHECK(fs.exists("/app.log.lidx"));
+    writeText(fs, "/app.log", numbered(100, 150), true);
+
+    LineIndex idx(fs, "/app.log", 8);
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 150);
+    CHECK(idx.entries() == 150 / 8 + 1);
+    auto p = page(fs, idx, 120, 1);
+    REQUIRE(p.size() == 1);
+    CHECK(p[0] == "line 120");
+
+    // inne K – plik .lidx ignorowany, indeks budowany od nowa
+    LineIndex other(fs, "/app.log", 32);
+    REQUIRE(other.update());
+    CHECK(other.lineCount() == 150);
+    CHECK(other.entries() == 150 / 32 + 1);
+}
+
+TEST_CASE("a shrunk file is detected and re-indexed") {
+    MemFileSystem fs;
+    writeText(fs, "/app.log", numbered(0, 200));
+    {
+        LineIndex idx(fs, "/app.log", 8);
+        REQUIRE(idx.update());
+    }
+    writeText(fs, "/app.log", "rotated\nfile\n"); // rotacja: nowa, krótsza treść
+
+    LineIndex idx(fs, "/app.log", 8);
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 2);
+    CHECK(idx.entries() == 1);
+    auto p = page(fs, idx, 0, 10);
+    REQUIRE(p.size() == 2);
+    CHECK(p[0] == "rotated");
+    CHECK(p[1] == "file");
+}
+
+TEST_CASE("a rewritten file that grew past the indexed part is re-indexed") {
+    MemFileSystem fs;
+    writeText(fs, "/app.log", numbered(0, 100));
+    {
+        LineIndex idx(fs, "/app.log", 8);
+        REQUIRE(idx.update());
+    }
+    // rotacja na plik dłuższy niż zindeksowana część – inny początek
+    std::string rotated;
+    for (uint32_t i = 0; i < 300; ++i) rotated += "rotated " + std::to_string(i) + "\n";
+    writeText(fs, "/app.log", rotated);
+
+    LineIndex idx(fs, "/app.log", 8);
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 300);
+    CHECK(idx.entries() == 300 / 8 + 1);
+    auto p = page(fs, idx, 150, 1);
+    REQUIRE(p.size() == 1);
+    CHECK(p[0] == "rotated 150");
+}
+
+TEST_CASE("same head but shifted lines is re-indexed") {
+    MemFileSystem fs;
+    writeText(fs, "/app.log", numbered(0, 100));
+    LineIndex idx(fs, "/app.log", 8);
+    REQUIRE(idx.update());
+
+    // pierwsze 32 bajty bez zmian, ale linie przesunięte – LF przed lastLineStart znika
+    writeText(fs, "/app.log", numbered(0, 10) + "inserted " + numbered(10, 200));
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 200);
+    auto p = page(fs, idx, 10, 2);
+    REQUIRE(p.size() == 2);
+    CHECK(p[0] == "inserted line 10");
+    CHECK(p[1] == "line 11");
+    p = page(fs, idx, 199, 1);
+    REQUIRE(p.size() == 1);
+    CHECK(p[0] == "line 199");
+
+    // zwykłe dopisanie nadal jest przyrostowe i nie gubi indeksu
+    writeText(fs, "/app.log", numbered(200, 210), true);
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 210);
+    p = page(fs, idx, 205, 1);
+    REQUIRE(p.size() == 1);
+    CHECK(p[0] == "line 205");
+}
+
+TEST_CASE("lone CR stays in the line, CRLF is stripped, long lines are cut") {
+    MemFileSystem fs;
+    writeText(fs, "/mix.log", "a\rb\r\nc\n" + std::string(40, 'x') + "\r\nd");
+    LineIndex idx(fs, "/mix.log", 1, 16);
+    REQUIRE(idx.update());
+    CHECK(idx.lineCount() == 4);
+    auto p = page(fs, idx, 0, 10, 8);
+    REQUIRE(p.size() == 4);
+    CHECK(p[0] == "a\rb");
+    CHECK(p[1] == "c");
+    CHECK(p[2] == std::string(8, 'x'));
+    CHECK(p[3] == "d");
+}
@@ -0,0 +1,279 @@
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/mem/SimulatedFileSystem.cpp"
+#include "../../src/storage/logs/RetentionManager.cpp"
+#include "../../src/storage/logs/RotatingLog.cpp"
+
+using storage::logs::NaturalLess;
+using storage::logs::RetentionManager;
+using storage::logs::RotatingLog;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+const uint32_t kDay = 1760572800; // 2025-10-16 00:00:00 UTC
+
+// remove zawodzi dla wybranych ścieżek (np. plik otwarty przez inny proces)
+class StubbornFs : public MemFileSystem {
+public:
+    std::vector<std::string> locked;
+    uint32_t removeCalls = 0;
+    bool remove(const std::string& path) override {
+        removeCalls++;
+        for (const auto& l : locked) {
+            if (l == path) return false;
+        }
+        return MemFileSystem::remove(path);
+    }
+};
+
+struct Env {
+    Env() {
+        setenv("TZ", "UTC", 1);
+        tzset();
+        ram.setTimeSource([this] { return now; });
+    }
+    uint32_t now = kDay + 13 * 3600;
+    MemFileSystem ram;
+    std::function<uint32_t()> clock() { return [this] { return now; }; }
+};
+
+std::string read(MemFileSystem& fs, const std::string& path) {
+    auto f = fs.openRead(path);
+    if (!f) return "<missing>";
+    std::string s(f->size(), '\0');
+    f->read(&s[0], s.size());
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("NaturalLess orders numbered parts by value") {
+    NaturalLess less;
+    CHECK(less("/logs/13.2.log", "/logs/13.10.log"));
+    CHECK(less("/logs/9.log", "/logs/10.log"));
+    CHECK(less("/logs/2025-10-16/23.log", "/logs/2025-10-17/00.log"));
+    CHECK_FALSE(less("/logs/13.10.log", "/logs/13.2.log"));
+    CHECK_FALSE(less("/a", "/a"));
+}
+
+TEST_CASE("files switch on time bucket boundaries") {
+    Env env;
+    RotatingLog log(env.ram, env.clock());
+    log.println("a");
+    env.now += 3599;
+    log.println("b");
+    env.now += 1; // 14:00
+    log.println("c");
+    env.now = kDay + 86400; // następny dzień
+    log.println("d");
+    log.close();
+
+    CHECK(read(env.ram, "/logs/2025-10-16/13.log") == "a\nb\n");
+    CHECK(read(env.ram, "/logs/2025-10-16/14.log") == "c\n");
+    CHECK(read(env.ram, "/logs/2025-10-17/00.log") == "d\n");
+}
+
+TEST_CASE("size limit splits a bucket into numbered parts and resumes after restart") {
+    Env env;
+    RotatingLog::Config cfg;
+    cfg.maxFileBytes = 10;
+    {
+        RotatingLog log(env.ram, env.clock(), cfg);
+        log.println("1234");
+        log.println("5678"); // 10 B – mieści się
+        log.println("abcd"); // nowa część
+        CHECK(log.currentPath() == "/logs/2025-10-16/13.1.log");
+    }
+    RotatingLog log(env.ram, env.clock(), cfg);
+    log.println("ef");
+    log.println("gh"); // 5 + 3 + 3 > 10 → 13.2
+    log.close();
+    CHECK(read(env.ram, "/logs/2025-10-16/13.0.log") == "1234\n5678\n");
+    CHECK(read(env.ram, "/logs/2025-10-16/13.1.log") == "abcd\nef\n");
+    CHECK(read(env.ram, "/logs/2025-10-16/13.2.log") == "gh\n");
+}
+
+TEST_CASE("println longer than the buffer writes the line and its terminator together") {
+    Env env;
+    RotatingLog::Config cfg;
+    cfg.bufferSize = 8;
+    cfg.maxFileBytes = 24;
+    RotatingLog log(env.ram, env.clock(), cfg);
+    log.println("short");
+    CHECK(log.println("exactly-eight.") == 15); // > bufor – bezpośrednio do pliku
+    log.println("0123456789"); // 6 + 15 + 11 > 24 – cała linia w nowej części
+    log.close();
+    CHECK(read(env.ram, "/logs/2025-10-16/13.0.log") == "short\nexactly-eight.\n");
+    CHECK(read(env.ram, "/logs/2025-10-16/13.1.log") == "0123456789\n");
+}
+
+TEST_CASE("retention scans once and then prunes oldest-first without listing") {
+    Env env;
+    // 10 dni po 24 pliki po 100 B
+    std::string payload(99, 'x');
+    payload += '\n';
+    for (uint32_t d = 0; d < 10; ++d) {
+        for (uint32_t h = 0; h < 24; ++h) {
+            char p[48];
+            snprintf(p, sizeof(p), "/logs/2025-10-%02u/%02u.log", 6 + d, h);
+            auto f = env.ram.openWrite(p);
+            f->write(payload.data(), payload.size());
+        }
+    }
+
+    storage::mem::VirtualClock vclock;
+    storage::mem::SimulatedFileSystem sd(env.ram, vclock, storage::mem::MediaModel::instant());
+    RetentionManager::Policy keep;
+    keep.maxTotalBytes = 48 * 100; // dwa dni
+    RetentionManager retention(sd, "/logs", keep, env.clock());
+
+    uint32_t steps = 0;
+    while (retention.step(8)) steps++;
+    CHECK(retention.scanned());
+    CHECK(retention.fileCount() == 48);
+    CHECK(retention.totalBytes() == 4800);
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-13"));
+    CHECK(env.ram.exists("/logs/2025-10-14/00.log"));
+    CHECK(env.ram.exists("/logs/2025-10-15/23.log"));
+    CHECK(steps > 10); // praca rozłożona na wiele kroków
+
+    // nowe logi: tylko remove (i rmdir), bez ponownego listDir
+    env.now = kDay + 5;
+    RotatingLog log(sd, env.clock(), &retention);
+    log.print(payload.c_str());
+    log.flush();
+    sd.resetStats();
+    while (retention.step()) {
+    }
+    CHECK(sd.stats().ops == 1);
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-14/00.log"));
+    CHECK(retention.fileCount() == 48);
+    CHECK(env.ram.exists("/logs/2025-10-16/00.log"));
+}
+
+TEST_CASE("age limit removes old files and empty day directories, never the active file") {
+    Env env;
+    RetentionManager::Policy keep;
+    keep.maxAgeSec = 3600;
+    RetentionManager retention(env.ram, "/logs", keep, env.clock());
+    RotatingLog log(env.ram, env.clock(), &retention);
+
+    log.println("old");
+    env.now += 3600;
+    log.println("newer");
+    env.now += 3 * 3600;
+    while (retention.step()) {
+    }
+    // 13.log za stary, 14.log też – ale 14.log jest bieżący
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-16/13.log"));
+    CHECK(env.ram.exists("/logs/2025-10-16/14.log"));
+
+    env.now = kDay + 86400 + 10;
+    log.println("tomorrow");
+    log.flush();
+    env.now += 2 * 3600;
+    while (retention.step()) {
+    }
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-16"));
+    CHECK(env.ram.exists("/logs/2025-10-17/00.log"));
+    CHECK(retention.removedFiles() == 2);
+}
+
+TEST_CASE("a file without a timestamp does not stop age pruning of newer files") {
+    Env env;
+    env.now = 0; // backend bez daty
+    env.ram.openWrite("/logs/2025-10-16/00.log")->write("x", 1);
+    env.now = kDay + 3600;
+    env.ram.openWrite("/logs/2025-10-16/01.log")->write("y", 1);
+    env.ram.openWrite("/logs/2025-10-16/02.log")->write("z", 1);
+    env.now += 2 * 3600;
+    env.ram.openWrite("/logs/2025-10-16/03.log")->write("w", 1);
+
+    RetentionManager::Policy keep;
+    keep.maxAgeSec = 3600;
+    RetentionManager retention(env.ram, "/logs", keep, env.clock());
+    while (retention.step()) {
+    }
+    CHECK(env.ram.exists("/logs/2025-10-16/00.log"));
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-16/01.log"));
+    CHECK_FALSE(env.ram.exists("/logs/2025-10-16/02.log"));
+    CHECK(env.ram.exists("/logs/2025-10-16/03.log"));
+    CHECK(retention.removedFiles() == 2);
+}
+
+TEST_CASE("a file that cannot be removed stays counted and is retried in the next step") {
+    Env env;
+    StubbornFs fs;
+    for (uint32_t h = 0; h < 4; ++h) {
+        char p[48];
+        snprintf(p, sizeof(p), "/logs/2025-10-16/%02u.log", h);
+        fs.openWrite(p)->write("0123456789", 10);
+    }
+    fs.locked.push_back("/logs/2025-10-16/00.log");
+
+    RetentionManager::Policy keep;
+    keep.maxFiles = 2;
+    RetentionManager retention(fs, "/logs", keep, env.clock());
+    while (retention.step()) {
+    }
+    // 00.log został (i się liczy), więc polityka usunęła nowszy 01.log i 02.log
+    CHECK(fs.exists("/logs/2025-10-16/00.log"));
+    CHECK_FALSE(fs.exists("/logs/2025-10-16/01.log"));
+    CHECK_FALSE(fs.exists("/logs/2025-10-16/02.log"));
+    CHECK(fs.exists("/logs/2025-10-16/03.log"));
+    CHECK(retention.fileCount() == 2);
+    CHECK(retention.totalBytes() == 20);
+    CHECK(retention.removedFiles() == 2);
+
+    // kolejny step ponawia 00.log (jedna próba), potem kończy
+    fs.removeCalls = 0;
+    CHECK_FALSE(retention.step());
+    CHECK(fs.removeCalls == 0); // limit spełniony – nic do usunięcia
+
+    fs.openWrite("/logs/2025-10-16/04.log")->write("x", 1);
+    retention.track("/logs/2025-10-16/04.log", 1, env.now);
+    CHECK_FALSE(retention.step());
+    CHECK(fs.removeCalls == 2); // 00.log (nadal zablokowany), potem 03.log
+    CHECK(fs.exists("/logs/2025-10-16/00.log"));
+    CHECK_FALSE(fs.exists("/logs/2025-10-16/03.log"));
+
+    fs.locked.clear();
+    fs.openWrite("/logs/2025-10-16/05.log")->write("y", 1);
+    retention.track("/logs/2025-10-16/05.log", 1, env.now);
+    while (retention.step()) {
+    }
+    CHECK_FALSE(fs.exists("/logs/2025-10-16/00.log"));
+    CHECK(retention.fileCount() == 2);
+    CHECK(retention.totalBytes() == 2);
+    CHECK(retention.removedFiles() == 4);
+}
+
+TEST_CASE("a failed remove of a file deleted elsewhere drops it from the catalog") {
+    Env env;
+    StubbornFs fs;
+    fs.openWrite("/logs/a/1.log")->write("1", 1);
+    fs.openWrite("/logs/a/2.log")->write("2", 1);
+    RetentionManager::Policy keep;
+    keep.maxFiles = 1;
+    RetentionManager retention(fs, "/logs", keep, env.clock());
+    while (!retention.scanned()) retention.step(1);
+
+    // ktoś inny usunął 1.log; remove zawodzi, ale pliku już nie ma
+    fs.MemFileSystem::remove("/logs/a/1.log");
+    fs.locked.push_back("/logs/a/1.log");
+    while (retention.step()) {
+    }
+    CHECK(retention.fileCount() == 1);
+    CHECK(retention.totalBytes() == 1);
+    CHECK(retention.removedFiles() == 0);
+    CHECK(fs.exists("/logs/a/2.log"));
+}
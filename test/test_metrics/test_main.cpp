@@ -0,0 +1,243 @@
+// Metryki są domyślnie wyłączone – ten test kompiluje je jawnie.
+#define ESP32_STORAGE_METRICS
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+
+using storage::FsMetrics;
+using storage::IoOp;
+using storage::OpStats;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+struct StringOut {
+    std::string text;
+    void print(const char* s) { text += s; }
+};
+
+// Minimalny walidator JSON (RFC 8259 bez \u w kluczach) – wystarczy do dumpJson.
+class JsonCheck {
+public:
+    explicit JsonCheck(const std::string& s) : src(s) {}
+
+    bool valid() {
+        pos = 0;
+        return value() && (skipWs(), pos == src.size());
+    }
+
+private:
+    const std::string& src;
+    size_t pos = 0;
+
+    void skipWs() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) pos++;
+    }
+    bool eat(char c) {
+        skipWs();
+        if (pos < src.size() && src[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+    bool value() {
+        skipWs();
+        if (pos >= src.size()) return false;
+        char c = src[pos];
+        if (c == '{') return object();
+        if (c == '[') return array();
+        if (c == '"') return string();
+        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return number();
+        for (const char* lit : {"true", "false", "null"}) {
+            if (src.compare(pos, std::strlen(lit), lit) == 0) {
+                pos += std::strlen(lit);
+                return true;
+            }
+        }
+        return false;
+    }
+    bool object() {
+        pos++;
+        if (eat('}')) return true;
+        do {
+            skipWs();
+            if (!string() || !eat(':') || !value()) return false;
+        } while (eat(','));
+        return eat('}');
+    }
+    bool array() {
+        pos++;
+        if (eat(']')) return true;
+        do {
+            if (!value()) return false;
+        } while (eat(','));
+        return eat(']');
+    }
+    bool string() {
+        if (pos >= src.size() || src[pos] != '"') return false;
+        for (pos++; pos < src.size(); pos++) {
+            char c = src[pos];
+            if (c == '"') {
+                pos++;
+                return true;
+            }
+            if (c == '\\') pos++;
+            else if (static_cast<unsigned char>(c) < 0x20) return false;
+        }
+        return false;
+    }
+    bool number() {
+        size_t start = pos;
+        if (src[pos] == '-') pos++;
+        while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+        if (pos < src.size() && src[pos] == '.') {
+            pos++;
+            while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+        }
+        return pos > start && std::isdigit(static_cast<unsigned char>(src[pos - 1]));
+    }
+};
+
+bool parses(const std::string& json) {
+    return JsonCheck(json).valid();
+}
+
+} // namespace
+
+TEST_CASE("json checker rejects malformed output") {
+    CHECK(parses("{\"a\":[1,2,{\"b\":\"x\"}],\"c\":-3}"));
+    CHECK_FALSE(parses("{\"a\":1,}"));
+    CHECK_FALSE(parses("{\"a\":1}}"));
+    CHECK_FALSE(parses("[1 2]"));
+}
+
+TEST_CASE("mem backend counts operations, bytes and errors") {
+    MemFileSystem fs;
+    FsMetrics* m = fs.metrics();
+    REQUIRE(m);
+    CHECK(std::string(m->name()) == "mem");
+
+    {
+        auto f = fs.openWrite("/log/a.txt");
+        REQUIRE(f);
+        CHECK(f->write("hello", 5) == 5);
+        CHECK(f->write(" world", 6) == 6);
+    }
+    {
+        auto f = fs.openRead("/log/a.txt");
+        REQUIRE(f);
+        char buf[32];
+        CHECK(f->read(buf, sizeof(buf)) == 11);
+        CHECK(f->read(buf, sizeof(buf)) == 0); // EOF to nie błąd
+        CHECK(f->write("x", 1) == 0);          // plik tylko do odczytu
+    }
+    CHECK_FALSE(fs.openRead("/missing.txt"));
+    CHECK(fs.exists("/log/a.txt"));
+    CHECK_FALSE(fs.remove("/missing.txt"));
+    CHECK(fs.rename("/log/a.txt", "/log/b.txt"));
+
+    const OpStats& open = m->stats(IoOp::Open);
+    CHECK(open.count == 3);
+    CHECK(open.errors == 1);
+
+    const OpStats& write = m->stats(IoOp::Write);
+    CHECK(write.count == 3);
+    CHECK(write.errors == 1);
+    CHECK(write.bytes == 11);
+
+    const OpStats& read = m->stats(IoOp::Read);
+    CHECK(read.count == 2);
+    CHECK(read.errors == 0);
+    CHECK(read.bytes == 11);
+
+    CHECK(m->stats(IoOp::Close).count == 2);
+    CHECK(m->stats(IoOp::Stat).count == 1);
+    CHECK(m->stats(IoOp::Remove).errors == 1);
+    CHECK(m->stats(IoOp::Rename).count == 1);
+    CHECK(m->stats(IoOp::Rename).errors == 0);
+
+    m->reset();
+    CHECK(m->stats(IoOp::Open).count == 0);
+    CHECK(m->stats(IoOp::Write).bytes == 0);
+}
+
+TEST_CASE("percentiles come from power-of-two buckets capped by max") {
+    OpStats s;
+    CHECK(s.percentileCycles(500) == 0);
+
+    for (int i = 0; i < 90; ++i) s.record(100, 0, true);  // kubełek 6: 64..127
+    for (int i = 0; i < 10; ++i) s.record(5000, 0, true); // kubełek 12: 4096..8191
+    CHECK(s.count == 100);
+    CHECK(s.hist[6] == 90);
+    CHECK(s.hist[12] == 10);
+    CHECK(s.maxCycles == 5000);
+    CHECK(s.totalCycles == 90u * 100 + 10u * 5000);
+
+    CHECK(s.percentileCycles(500) == 127);
+    CHECK(s.percentileCycles(900) == 127);
+    CHECK(s.percentileCycles(910) == 5000); // górna granica 8191 obcięta do max
+    CHECK(s.percentileCycles(990) == 5000);
+
+    OpStats edge;
+    edge.record(0, 0, true);
+    edge.record(1, 0, true);
+    edge.record(UINT32_MAX, 0, false);
+    CHECK(edge.hist[0] == 2);
+    CHECK(edge.hist[OpStats::kBuckets - 1] == 1);
+    CHECK(edge.errors == 1);
+    CHECK(edge.percentileCycles(1000) == UINT32_MAX);
+}
+
+TEST_CASE("host clock does not wrap after 2^32 ns") {
+    using namespace storage::metrics_clock;
+    ticks t = now();
+    CHECK(since(t) < 1000u * 1000 * 1000);
+    // 4.3 s wstecz: 32-bitowy licznik ns dałby tu kilka ms
+    CHECK(since(t - 4300000000ull) == UINT32_MAX);
+    CHECK(since(t - 3000000000ull) >= 3000000000u);
+}
+
+TEST_CASE("dumpJson and dumpAll produce valid json") {
+    MemFileSystem fs;
+    FsMetrics* m = fs.metrics();
+
+    StringOut empty;
+    m->dumpJson(empty);
+    CHECK(empty.text == "{\"fs\":\"mem\",\"ops\":{}}");
+    CHECK(parses(empty.text));
+
+    {
+        auto f = fs.openWrite("/a.bin");
+        REQUIRE(f);
+        uint8_t buf[64] = {};
+        f->write(buf, sizeof(buf));
+    }
+    CHECK_FALSE(fs.openRead("/nope"));
+
+    StringOut one;
+    m->dumpJson(one);
+    CHECK(parses(one.text));
+    CHECK(one.text.find("\"open\":{\"n\":2,\"err\":1,") != std::string::npos);
+    CHECK(one.text.find("\"write\":{\"n\":1,\"err\":0,\"bytes\":64,") != std::string::npos);
+
+    MemFileSystem other;
+    StringOut all;
+    FsMetrics::dumpAll(all, true);
+    CHECK(!all.text.empty() && all.text.back() == '\n');
+    all.text.pop_back();
+    CHECK(parses(all.text));
+    CHECK(all.text.front() == '[');
+
+    StringOut text;
+    FsMetrics::dumpAll(text);
+    CHECK(text.text.find("[mem] open") != std::string::npos);
+}
@@ -0,0 +1,287 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/pack/Crc32.cpp"
+#include "../../src/storage/pack/PackFile.cpp"
+
+using storage::OpenMode;
+using storage::mem::MemFileSystem;
+using storage::pack::Crc32;
+using storage::pack::PackIndexEntry;
+using storage::pack::PackReader;
+using storage::pack::PackWriter;
+
+namespace {
+
+void put(MemFileSystem& fs, const std::string& path, const std::string& data) {
+    auto f = fs.openWrite(path);
+    REQUIRE(f);
+    if (!data.empty()) f->write(data.data(), data.size());
+    f->close();
+}
+
+std::string readAll(storage::IFile& f) {
+    std::string s(f.size(), '\0');
+    if (!s.empty()) f.read(&s[0], s.size());
+    return s;
+}
+
+std::string entry(PackReader& r, const std::string& name) {
+    auto f = r.openEntry(name);
+    return f ? readAll(*f) : std::string("<missing>");
+}
+
+// Plik, którego zapis po `budget` bajtach się nie udaje (pełny nośnik).
+class ShortWriteFile : public storage::IFile {
+public:
+    ShortWriteFile(std::unique_ptr<storage::IFile> f, size_t* budget) : inner(std::move(f)), left(budget) {}
+    size_t read(void* buf, size_t size) override { return inner->read(buf, size); }
+    size_t write(const void* buf, size_t size) override {
+        size_t n = size < *left ? size : *left;
+        *left -= n;
+        return n ? inner->write(buf, n) : 0;
+    }
+    void flush() override { inner->flush(); }
+    bool seek(uint32_t pos) override { return inner->seek(pos); }
+    uint32_t position() override { return inner->position(); }
+    uint32_t size() override { return inner->size(); }
+    bool isOpen() const override { return inner->isOpen(); }
+    void close() override { inner->close(); }
+
+private:
+    std::unique_ptr<storage::IFile> inner;
+    size_t* left;
+};
+
+class ShortWriteFs : public MemFileSystem {
+public:
+    size_t budget = SIZE_MAX;
+    std::unique_ptr<storage::IFile> open(const std::string& path, OpenMode mode) override {
+        auto f = MemFileSystem::open(path, mode);
+        if (!f || mode == OpenMode::Read) return f;
+        return std::unique_ptr<storage::IFile>(new ShortWriteFile(std::move(f), &budget));
+    }
+};
+
+// Źródło, którego nie da się przewinąć.
+class NoSeekFile : public storage::IFile {
+public:
+    size_t read(void*, size_t) override { return 0; }
+    size_t write(const void*, size_t) override { return 0; }
+    void flush() override {}
+    bool seek(uint32_t) override { return false; }
+    uint32_t position() override { return 0; }
+    uint32_t size() override { return 10; }
+    bool isOpen() const override { return true; }
+    void close() override {}
+};
+
+} // namespace
+
+TEST_CASE("Crc32 matches the IEEE check value") {
+    CHECK(Crc32::update(0, "123456789", 9) == 0xCBF43926u);
+    CHECK(Crc32::update(Crc32::update(0, "1234", 4), "56789", 5) == 0xCBF43926u);
+}
+
+TEST_CASE("Pack entries are found by name and read as IFile views") {
+    MemFileSystem fs;
+    {
+        PackWriter w(fs, "/ui.pak");
+        REQUIRE(w.create());
+        for (int i = 0; i < 300; ++i) {
+            std::string body = "{\"id\":" + std::to_string(i) + "}";
+            REQUIRE(w.add("lang/" + std::to_string(i) + ".json", body.data(), body.size()));
+        }
+        REQUIRE(w.add("empty.txt", "", 0));
+        REQUIRE(w.finish());
+    }
+    PackReader r(fs, "/ui.pak");
+    REQUIRE(r.open());
+    CHECK(r.size() == 301);
+    CHECK(r.exists("/lang/17.json"));
+    CHECK_FALSE(r.exists("lang/300.json"));
+    CHECK(entry(r, "lang/250.json") == "{\"id\":250}");
+    CHECK(entry(r, "empty.txt").empty());
+    CHECK_FALSE(r.openEntry("nope"));
+
+    // dwa widoki na jednym uchwycie kontenera, z niezależnymi pozycjami
+    auto a = r.openEntry("lang/1.json");
+    auto b = r.openEntry("lang/2.json");
+    char x[4] = {}, y[4] = {};
+    REQUIRE(a->read(x, 3) == 3);
+    REQUIRE(b->read(y, 3) == 3);
+    REQUIRE(a->read(x, 3) == 3);
+    CHECK(std::string(x, 3) == "d\":");
+    CHECK(a->write("z", 1) == 0);
+    CHECK(a->seek(a->size()));
+    CHECK_FALSE(a->seek(a->size() + 1));
+    CHECK(a->read(x, 1) == 0);
+    r.close();
+    CHECK(std::string(y, 3) == "{\"i");
+    CHECK(b->read(y, 3) == 3); // widok przeżywa czytnik
+    CHECK(std::string(y, 3) == "d\":");
+
+    REQUIRE(r.open());
+    CHECK(r.verifyAll());
+    PackIndexEntry st;
+    REQUIRE(r.stat("lang/0.json", st));
+    CHECK(st.length == 8);
+}
+
+TEST_CASE("Pack append replaces, removes and survives an interrupted append") {
+    MemFileSystem fs;
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.create());
+        REQUIRE(w.add("a", "one", 3));
+        REQUIRE(w.add("b", "two", 3));
+    } // finish() w destruktorze
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.append());
+        CHECK(w.size() == 2);
+        REQUIRE(w.add("a", "ONE!", 4));
+        REQUIRE(w.remove("b"));
+        REQUIRE(w.add("c", "three", 5));
+        REQUIRE(w.finish());
+    }
+    PackReader r(fs, "/p.pak");
+    REQUIRE(r.open());
+    CHECK(r.size() == 2);
+    CHECK(entry(r, "a") == "ONE!");
+    CHECK_FALSE(r.exists("b"));
+    CHECK(r.deadBytes() > 6);
+    r.close();
+
+    // przerwane dopisywanie: dane bez nowej stopki
+    {
+        auto f = fs.open("/p.pak", OpenMode::WriteAppend);
+        std::string junk(5000, 'j');
+        f->write(junk.data(), junk.size());
+    }
+    REQUIRE(r.open());
+    CHECK(entry(r, "c") == "three");
+    r.close();
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.append());
+        REQUIRE(w.add("d", "four", 4));
+    }
+    REQUIRE(r.open());
+    CHECK(r.size() == 3);
+    CHECK(entry(r, "d") == "four");
+    CHECK(r.deadBytes() >= 5000);
+}
+
+TEST_CASE("buildPack packs a directory tree and compactPack drops dead bytes") {
+    MemFileSystem fs;
+    put(fs, "/www/index.html", "<html></html>");
+    put(fs, "/www/css/app.css", "body{}");
+    put(fs, "/www/lang/pl/strings.json", "{\"ok\":\"tak\"}");
+    put(fs, "/www/lang/en/strings.json", "{\"ok\":\"yes\"}");
+    put(fs, "/www/empty", "");
+    fs.mkdir("/www/emptydir");
+
+    CHECK(storage::pack::buildPack(fs, "/www", "/www.pak") == 5);
+    PackReader r(fs, "/www.pak");
+    REQUIRE(r.open());
+    CHECK(entry(r, "lang/pl/strings.json") == "{\"ok\":\"tak\"}");
+    CHECK(entry(r, "css/app.css") == "body{}");
+    CHECK(r.exists("empty"));
+    std::vector<std::string> names;
+    r.forEach([&](const char* n, uint32_t) { names.emplace_back(n); });
+    CHECK(names.size() == 5);
+    r.close();
+
+    {
+        PackWriter w(fs, "/www.pak");
+        REQUIRE(w.append());
+        REQUIRE(w.remove("index.html"));
+        REQUIRE(w.add("css/app.css", "body{margin:0}", 14));
+    }
+    REQUIRE(r.open());
+    uint32_t before = r.containerBytes();
+    CHECK(r.deadBytes() > 0);
+    r.close();
+
+    REQUIRE(storage::pack::compactPack(fs, "/www.pak"));
+    CHECK_FALSE(fs.exists("/www.pak.tmp"));
+    REQUIRE(r.open());
+    CHECK(r.deadBytes() == 0);
+    CHECK(r.containerBytes() < before);
+    CHECK(r.size() == 4);
+    CHECK(entry(r, "css/app.css") == "body{margin:0}");
+    CHECK(r.verifyAll());
+}
+
+TEST_CASE("a failed replacement keeps the previous entry") {
+    ShortWriteFs fs;
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.create());
+        REQUIRE(w.add("a", "one", 3));
+        REQUIRE(w.add("b", "two", 3));
+    }
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.append());
+        NoSeekFile src;
+        CHECK_FALSE(w.addFile("a", src));
+        CHECK(w.size() == 2);
+        fs.budget = 4; // zapis 10 B się urwie
+        CHECK_FALSE(w.add("b", "0123456789", 10));
+        CHECK(w.size() == 2);
+        fs.budget = SIZE_MAX;
+        REQUIRE(w.finish());
+    }
+    PackReader r(fs, "/p.pak");
+    REQUIRE(r.open());
+    CHECK(r.size() == 2);
+    CHECK(entry(r, "a") == "one");
+    CHECK(entry(r, "b") == "two");
+    CHECK(r.verifyAll());
+}
+
+TEST_CASE("an interrupted compactPack is recovered from .bak") {
+    MemFileSystem fs;
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.create());
+        REQUIRE(w.add("a", "one", 3));
+    }
+    // przerwane między rename: paczka tylko w .bak, niedokończony .tmp
+    REQUIRE(fs.rename("/p.pak", "/p.pak.bak"));
+    put(fs, "/p.pak.tmp", "partial");
+    PackReader r(fs, "/p.pak");
+    REQUIRE(r.open());
+    CHECK(entry(r, "a") == "one");
+    CHECK_FALSE(fs.exists("/p.pak.bak"));
+    CHECK_FALSE(fs.exists("/p.pak.tmp"));
+    r.close();
+
+    // przerwane po podmianie: zbędny .bak nie blokuje następnej kompaktacji
+    put(fs, "/p.pak.bak", "old");
+    REQUIRE(storage::pack::compactPack(fs, "/p.pak"));
+    CHECK_FALSE(fs.exists("/p.pak.bak"));
+    REQUIRE(r.open());
+    CHECK(entry(r, "a") == "one");
+    r.close();
+
+    // dopisywanie też odzyskuje paczkę zamiast tworzyć pustą
+    REQUIRE(fs.rename("/p.pak", "/p.pak.bak"));
+    {
+        PackWriter w(fs, "/p.pak");
+        REQUIRE(w.append());
+        CHECK(w.size() == 1);
+        REQUIRE(w.add("b", "two", 3));
+    }
+    REQUIRE(r.open());
+    CHECK(r.size() == 2);
+}
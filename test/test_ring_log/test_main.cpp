@@ -0,0 +1,207 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/pack/Crc32.cpp"
+#include "../../src/storage/logs/RingLog.cpp"
+
+using storage::OpenMode;
+using storage::logs::RingLog;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+RingLog::Config small() {
+    RingLog::Config c;
+    c.capacity = 1024;
+    c.maxRecord = 100;
+    return c;
+}
+
+std::string event(uint32_t i) {
+    return "event " + std::to_string(i) + std::string(i % 7 * 5, '.');
+}
+
+std::vector<std::string> all(RingLog& log, std::vector<uint32_t>* seqs = nullptr) {
+    std::vector<std::string> out;
+    log.forEach([&](uint32_t seq, const uint8_t* data, size_t len) {
+        out.emplace_back(reinterpret_cast<const char*>(data), len);
+        if (seqs) seqs->push_back(seq);
+        return true;
+    });
+    return out;
+}
+
+bool add(RingLog& log, const std::string& s) {
+    return log.append(s.data(), s.size());
+}
+
+// stan pliku bez close() – jak po utracie zasilania
+void crashCopy(MemFileSystem& fs, const char* from, const char* to) {
+    auto src = fs.openRead(from);
+    std::string raw(src->size(), '\0');
+    src->read(&raw[0], raw.size());
+    fs.openWrite(to)->write(raw.data(), raw.size());
+}
+
+uint32_t fileSize(MemFileSystem& fs, const char* path) {
+    auto f = fs.openRead(path);
+    return f ? f->size() : 0;
+}
+
+} // namespace
+
+TEST_CASE("records are returned oldest first and the file never grows") {
+    MemFileSystem ram;
+    RingLog log(ram, "/events.ring", small());
+    REQUIRE(log.open());
+    uint32_t created = fileSize(ram, "/events.ring");
+    CHECK(created == 64 + 1024);
+
+    for (uint32_t i = 0; i < 500; ++i) REQUIRE(add(log, event(i)));
+    CHECK(fileSize(ram, "/events.ring") == created);
+    CHECK(log.nextSeq() == 500);
+
+    std::vector<uint32_t> seqs;
+    std::vector<std::string> got = all(log, &seqs);
+    REQUIRE(got.size() == log.count());
+    CHECK(got.size() > 10);
+    CHECK(seqs.front() == log.firstSeq());
+    for (size_t i = 0; i < got.size(); ++i) {
+        CHECK(seqs[i] == log.firstSeq() + i);
+        CHECK(got[i] == event(seqs[i]));
+    }
+    CHECK(seqs.back() == 499);
+    CHECK_FALSE(log.append(std::string(101, 'x').c_str()));
+}
+
+TEST_CASE("flushed state survives reopen and clear keeps numbering") {
+    MemFileSystem ram;
+    {
+        RingLog log(ram, "/events.ring", small());
+        REQUIRE(log.open());
+        for (uint32_t i = 0; i < 50; ++i) add(log, event(i));
+    } // close() = flush
+    RingLog log(ram, "/events.ring", small());
+    REQUIRE(log.open());
+    CHECK(log.nextSeq() == 50);
+    std::vector<uint32_t> seqs;
+    all(log, &seqs);
+    REQUIRE(!seqs.empty());
+    CHECK(seqs.back() == 49);
+
+    REQUIRE(log.clear());
+    CHECK(log.count() == 0);
+    CHECK(all(log).empty());
+    log.append("after clear");
+    seqs.clear();
+    CHECK(all(log, &seqs) == std::vector<std::string>{"after clear"});
+    CHECK(seqs[0] == 50);
+}
+
+TEST_CASE("records appended after the last flush are recovered after a crash") {
+    MemFileSystem ram;
+    uint32_t first = 0;
+    {
+        RingLog log(ram, "/events.ring", small());
+        REQUIRE(log.open());
+        for (uint32_t i = 0; i < 30; ++i) add(log, event(i));
+        log.flush();
+        for (uint32_t i = 30; i < 120; ++i) add(log, event(i)); // kilka okrążeń bez flush()
+        first = log.firstSeq();
+        crashCopy(ram, "/events.ring", "/crash.ring");
+    }
+    RingLog log(ram, "/crash.ring", small());
+    REQUIRE(log.open());
+    CHECK(log.nextSeq() == 120);
+    CHECK(log.firstSeq() == first);
+    std::vector<uint32_t> seqs;
+    std::vector<std::string> got = all(log, &seqs);
+    REQUIRE(seqs.size() == 120 - first);
+    CHECK(got.back() == event(119));
+}
+
+TEST_CASE("a header flushed with head at the end of the data area is accepted") {
+    MemFileSystem ram;
+    RingLog::Config cfg;
+    cfg.capacity = 256;
+    cfg.maxRecord = 48;
+    uint32_t count = 0, first = 0;
+    {
+        RingLog log(ram, "/events.ring", cfg);
+        REQUIRE(log.open());
+        for (int i = 0; i < 4; ++i) REQUIRE(add(log, std::string(48, static_cast<char>('a' + i))));
+        REQUIRE(log.flush()); // head == capacity w obu slotach nagłówka
+        REQUIRE(add(log, "x"));
+        count = log.count();
+        first = log.firstSeq();
+        crashCopy(ram, "/events.ring", "/crash.ring");
+    }
+    RingLog log(ram, "/crash.ring", cfg);
+    REQUIRE(log.open());
+    CHECK(log.count() == count);
+    CHECK(log.firstSeq() == first);
+    CHECK(log.nextSeq() == 5);
+    std::vector<std::string> got = all(log);
+    REQUIRE(got.size() == count);
+    CHECK(got.back() == "x");
+    CHECK(got.front() == std::string(48, static_cast<char>('a' + first)));
+}
+
+TEST_CASE("a torn record is dropped and the oldest records resynchronize") {
+    MemFileSystem ram;
+    {
+        RingLog log(ram, "/events.ring", small());
+        REQUIRE(log.open());
+        for (uint32_t i = 0; i < 80; ++i) add(log, event(i));
+        log.flush();
+        add(log, event(80));
+        crashCopy(ram, "/events.ring", "/crash.ring");
+    }
+    {
+        // przerwany zapis: śmieci od środka nagłówka rekordu 80 (także na najstarszych rekordach)
+        auto f = ram.open("/crash.ring", OpenMode::ReadWrite);
+        std::vector<uint8_t> raw(f->size());
+        f->read(raw.data(), raw.size());
+        uint32_t pos = 0;
+        for (uint32_t p = 64; p + 4 <= raw.size(); p += 4) {
+            uint32_t seq;
+            memcpy(&seq, &raw[p], 4);
+            if (seq == 80) pos = p;
+        }
+        REQUIRE(pos);
+        std::vector<uint8_t> junk(120, 0xA5);
+        f->seek(pos + 8);
+        f->write(junk.data(), junk.size());
+    }
+    RingLog log(ram, "/crash.ring", small());
+    REQUIRE(log.open());
+    CHECK(log.nextSeq() == 80);
+    std::vector<uint32_t> seqs;
+    std::vector<std::string> got = all(log, &seqs);
+    REQUIRE(!got.empty());
+    CHECK(seqs.back() == 79);
+    for (size_t i = 0; i < got.size(); ++i) CHECK(got[i] == event(seqs[i]));
+    REQUIRE(log.append("next", 4));
+    CHECK(all(log).back() == "next");
+}
+
+TEST_CASE("a different capacity recreates the file") {
+    MemFileSystem ram;
+    {
+        RingLog log(ram, "/events.ring", small());
+        REQUIRE(log.open());
+        log.append("old");
+    }
+    RingLog::Config big = small();
+    big.capacity = 4096;
+    RingLog log(ram, "/events.ring", big);
+    REQUIRE(log.open());
+    CHECK(fileSize(ram, "/events.ring") == 64 + 4096);
+    CHECK(log.count() == 0);
+}
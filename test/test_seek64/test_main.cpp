@@ -0,0 +1,99 @@
+#include <memory>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/mem/SimulatedFileSystem.cpp"
+#include "../../src/storage/io/WatchedFileSystem.cpp"
+
+using storage::IFile;
+using storage::OpenMode;
+using storage::io::WatchedFileSystem;
+using storage::mem::MediaModel;
+using storage::mem::MemFileSystem;
+using storage::mem::SimulatedFileSystem;
+using storage::mem::VirtualClock;
+
+namespace {
+
+const uint64_t kGiB = 1024ULL * 1024 * 1024;
+
+// Plik 6 GiB bez danych – tylko pozycja i rozmiar 64-bitowe (jak FsFile na exFAT).
+class HugeFile : public IFile {
+public:
+    uint64_t pos = 0;
+    uint64_t len = 6 * kGiB;
+
+    size_t read(void*, size_t) override { return 0; }
+    size_t write(const void*, size_t) override { return 0; }
+    void flush() override {}
+    bool seek(uint32_t p) override { return seek64(p); }
+    uint32_t position() override { return pos > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(pos); }
+    uint32_t size() override { return len > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(len); }
+    bool seek64(uint64_t p) override {
+        if (p > len) return false;
+        pos = p;
+        return true;
+    }
+    uint64_t position64() override { return pos; }
+    uint64_t size64() override { return len; }
+    bool isOpen() const override { return true; }
+    void close() override {}
+};
+
+// "/huge.bin" otwierany jako HugeFile, reszta jak w MemFileSystem.
+class HugeFs : public MemFileSystem {
+public:
+    std::unique_ptr<IFile> open(const std::string& path, OpenMode mode) override {
+        if (path == "/huge.bin") return std::unique_ptr<IFile>(new HugeFile());
+        return MemFileSystem::open(path, mode);
+    }
+};
+
+void checkForwards64(IFile& f) {
+    CHECK(f.size64() == 6 * kGiB);
+    CHECK(f.size() == UINT32_MAX);
+    REQUIRE(f.seek64(5 * kGiB + 7));
+    CHECK(f.position64() == 5 * kGiB + 7);
+    CHECK(f.position() == UINT32_MAX);
+    CHECK_FALSE(f.seek64(7 * kGiB));
+    CHECK(f.position64() == 5 * kGiB + 7);
+}
+
+} // namespace
+
+TEST_CASE("default seek64 rejects positions beyond 4 GiB") {
+    MemFileSystem fs;
+    auto f = fs.openWrite("/small.bin");
+    REQUIRE(f);
+    f->write("abcd", 4);
+    CHECK(f->seek64(2));
+    CHECK(f->position64() == 2);
+    CHECK(f->size64() == 4);
+    CHECK_FALSE(f->seek64(4 * kGiB));        // obcięte do 0 trafiłoby w początek pliku
+    CHECK_FALSE(f->seek64(UINT64_MAX));
+    CHECK(f->position64() == 2);
+    CHECK(f->seek64(UINT32_MAX) == f->seek(UINT32_MAX)); // granica zakresu – jak 32-bit
+}
+
+TEST_CASE("SimulatedFile forwards 64-bit calls") {
+    HugeFs ram;
+    VirtualClock clock;
+    SimulatedFileSystem sd(ram, clock, MediaModel::instant());
+    auto f = sd.openRead("/huge.bin");
+    REQUIRE(f);
+    checkForwards64(*f);
+    f->close();
+    CHECK_FALSE(f->seek64(kGiB)); // zamknięty plik
+}
+
+TEST_CASE("WatchedFile forwards 64-bit calls") {
+    HugeFs ram;
+    WatchedFileSystem watched(ram);
+    auto f = watched.openRead("/huge.bin");
+    REQUIRE(f);
+    checkForwards64(*f);
+}
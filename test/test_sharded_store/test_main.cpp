@@ -0,0 +1,130 @@
+#include <map>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/store/ShardedStore.cpp"
+
+using storage::OpenMode;
+using storage::mem::MemFileSystem;
+using storage::store::ShardedStore;
+
+namespace {
+
+// Liczy operacje na katalogach wykonywane przez magazyn.
+class CountingFs : public MemFileSystem {
+public:
+    int mkdirs = 0;
+    int existsCalls = 0;
+    bool mkdir(const std::string& path) override {
+        mkdirs++;
+        return MemFileSystem::mkdir(path);
+    }
+    bool exists(const std::string& path) override {
+        existsCalls++;
+        return MemFileSystem::exists(path);
+    }
+};
+
+void put(ShardedStore& store, const std::string& name, const std::string& data) {
+    auto f = store.open(name, OpenMode::WriteTruncate);
+    REQUIRE(f);
+    f->write(data.data(), data.size());
+    f->close();
+}
+
+} // namespace
+
+TEST_CASE("ShardedStore maps names to a fixed fan-out path") {
+    MemFileSystem fs;
+    ShardedStore store(fs, "/objs");
+    std::string p = store.pathFor("frame-1.bin");
+    REQUIRE(p.size() == std::string("/objs/xx/yy/frame-1.bin").size());
+    CHECK(p.compare(0, 6, "/objs/") == 0);
+    CHECK(p[8] == '/');
+    CHECK(p[11] == '/');
+    CHECK(store.shardPath(0xa73f) == "/objs/a7/3f");
+    CHECK(store.shardCount() == 65536);
+    // FAT nie rozróżnia wielkości liter – ta sama nazwa musi trafić do tego samego katalogu
+    CHECK(store.shardOf("Frame-1.BIN") == store.shardOf("frame-1.bin"));
+
+    CHECK(store.pathFor("").empty());
+    CHECK(store.pathFor("..").empty());
+    CHECK(store.pathFor("a/b").empty());
+    CHECK_FALSE(store.open("a/b", OpenMode::WriteTruncate));
+}
+
+TEST_CASE("ShardedStore clamps the layout to 16 bits") {
+    MemFileSystem fs;
+    ShardedStore::Config cfg;
+    cfg.levels = 3;
+    cfg.bitsPerLevel = 8;
+    ShardedStore store(fs, "/", cfg);
+    CHECK(store.shardCount() <= 65536);
+    CHECK(store.shardPath(0) == "/00/00/00");
+
+    cfg.levels = 1;
+    cfg.bitsPerLevel = 4;
+    ShardedStore flat(fs, "/o", cfg);
+    CHECK(flat.shardCount() == 16);
+    CHECK(flat.shardPath(0xb) == "/o/b");
+}
+
+TEST_CASE("ShardedStore writes, reads, removes and enumerates objects") {
+    MemFileSystem fs;
+    ShardedStore store(fs, "/objs");
+    std::map<std::string, size_t> written;
+    for (int i = 0; i < 200; ++i) {
+        std::string name = "obj" + std::to_string(i);
+        std::string data(i % 7 + 1, 'x');
+        put(store, name, data);
+        written[name] = data.size();
+    }
+    CHECK(fs.exists(store.pathFor("obj42")));
+    CHECK(store.exists("obj42"));
+    CHECK_FALSE(store.exists("obj999"));
+
+    auto f = store.open("obj13", OpenMode::Read);
+    REQUIRE(f);
+    CHECK(f->size() == 13 % 7 + 1);
+    f->close();
+
+    std::map<std::string, size_t> seen;
+    CHECK(store.forEach([&](const char* name, size_t size) {
+        seen[name] = size;
+        return true;
+    }));
+    CHECK(seen == written);
+    CHECK(store.count() == 200);
+
+    CHECK(store.remove("obj42"));
+    CHECK_FALSE(store.exists("obj42"));
+    CHECK(store.count() == 199);
+
+    int visited = 0;
+    CHECK_FALSE(store.forEach([&](const char*, size_t) { return ++visited < 5; }));
+    CHECK(visited == 5);
+}
+
+TEST_CASE("ShardedStore creates shard directories once") {
+    CountingFs fs;
+    ShardedStore store(fs, "/objs");
+    put(store, "a", "1");
+    int first = fs.mkdirs;
+    CHECK(first == 3); // root + dwa poziomy
+
+    int existsBefore = fs.existsCalls;
+    put(store, "a", "2");
+    CHECK(fs.mkdirs == first);
+    CHECK(fs.existsCalls == existsBefore); // liść zapamiętany – bez sprawdzania nośnika
+
+    // inny magazyn na tym samym drzewie: katalogi już są, więc bez mkdir
+    ShardedStore again(fs, "/objs");
+    put(again, "a", "3");
+    CHECK(fs.mkdirs == first);
+
+    CHECK(ShardedStore(fs, "/empty").count() == 0);
+}
@@ -0,0 +1,149 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/mem/SimulatedFileSystem.cpp"
+#include "../../src/storage/io/IoScheduler.cpp"
+
+using storage::mem::MediaModel;
+using storage::mem::MemFileSystem;
+using storage::mem::SimulatedFileSystem;
+using storage::mem::VirtualClock;
+
+namespace {
+
+MediaModel noStalls() {
+    MediaModel m = MediaModel::sdCard();
+    m.stallChance = 0.0f;
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("sequential sector-aligned writes pay per sector and per erase block") {
+    MemFileSystem ram;
+    VirtualClock clock;
+    MediaModel m = noStalls();
+    SimulatedFileSystem sd(ram, clock, m);
+
+    auto f = sd.openWrite("/a.bin");
+    CHECK(clock.nowUs() == m.openUs);
+
+    std::vector<uint8_t> buf(1024, 0x55);
+    uint64_t t0 = clock.nowUs();
+    f->write(buf.data(), 1024);
+    CHECK(clock.nowUs() - t0 == 2 * m.writeSectorUs + m.eraseUs);
+
+    t0 = clock.nowUs();
+    f->write(buf.data(), 1024);
+    CHECK(clock.nowUs() - t0 == 2 * m.writeSectorUs); // ten sam blok kasowania
+    f->close();
+    CHECK(ram.totalBytes() == 2048);
+}
+
+TEST_CASE("partial sectors and random access cost extra") {
+    MemFileSystem ram;
+    VirtualClock clock;
+    MediaModel m = noStalls();
+    SimulatedFileSystem sd(ram, clock, m);
+
+    std::vector<uint8_t> buf(4096, 1);
+    auto f = sd.openWrite("/b.bin");
+    f->write(buf.data(), 4096);
+
+    uint64_t t0 = clock.nowUs();
+    f->write(buf.data(), 100); // ogon niepełny → odczyt sektora
+    CHECK(clock.nowUs() - t0 == m.writeSectorUs + m.readSectorUs);
+    f->close();
+
+    auto r = sd.openRead("/b.bin");
+    t0 = clock.nowUs();
+    r->read(buf.data(), 512);
+    CHECK(clock.nowUs() - t0 == m.readSectorUs);
+    r->seek(3072);
+    t0 = clock.nowUs();
+    r->read(buf.data(), 100); // nieciągły, mieści się w jednym sektorze
+    CHECK(clock.nowUs() - t0 == m.seekUs + m.readSectorUs);
+}
+
+TEST_CASE("open file limit is enforced") {
+    MemFileSystem ram;
+    VirtualClock clock;
+    SimulatedFileSystem flash(ram, clock, MediaModel::spiFlash());
+
+    std::vector<std::unique_ptr<storage::IFile>> files;
+    for (int i = 0; i < 5; ++i) {
+        files.push_back(flash.openWrite("/f" + std::to_string(i)));
+        REQUIRE(files.back());
+    }
+    CHECK_FALSE(flash.openWrite("/f5"));
+    CHECK(flash.stats().rejectedOpens == 1);
+
+    files[0]->close();
+    CHECK(flash.openWrite("/f5"));
+    CHECK(flash.stats().peakOpenFiles == 5);
+}
+
+TEST_CASE("write stalls are reproducible for a given seed") {
+    MediaModel m = MediaModel::sdCard();
+    m.stallChance = 0.25f;
+    std::vector<uint8_t> buf(4096, 7);
+
+    uint32_t stalls[2];
+    uint64_t elapsed[2];
+    for (int run = 0; run < 2; ++run) {
+        MemFileSystem ram;
+        VirtualClock clock;
+        SimulatedFileSystem sd(ram, clock, m);
+        auto f = sd.openWrite("/big.bin");
+        for (int i = 0; i < 1024; ++i) f->write(buf.data(), buf.size()); // 4 MiB = 64 bloki
+        f->close();
+        stalls[run] = sd.stats().stalls;
+        elapsed[run] = clock.nowUs();
+        CHECK(sd.stats().erases == 64);
+        CHECK(sd.stats().maxOpUs >= m.stallUs);
+    }
+    CHECK(stalls[0] > 0);
+    CHECK(stalls[0] == stalls[1]);
+    CHECK(elapsed[0] == elapsed[1]);
+}
+
+TEST_CASE("IoScheduler keeps card stalls off the caller thread") {
+    MediaModel m = MediaModel::sdCard();
+    m.eraseBlockSize = 4096;
+    m.stallChance = 1.0f; // każdy nowy blok kasowania = przestój
+    const char line[] = "2026-10-18 12:00:00 temp=21.5 hum=40.0\n";
+    const size_t n = sizeof(line) - 1;
+
+    // bezpośrednio: wątek aplikacji płaci za każdy przestój
+    {
+        MemFileSystem ram;
+        VirtualClock clock;
+        SimulatedFileSystem sd(ram, clock, m);
+        VirtualClock::resetThreadUs();
+        auto f = sd.openAppend("/log.txt");
+        for (int i = 0; i < 500; ++i) f->write(line, n);
+        f->close();
+        CHECK(VirtualClock::threadUs() >= m.stallUs * 4);
+    }
+
+    // przez scheduler: wątek aplikacji tylko kolejkuje
+    MemFileSystem ram;
+    VirtualClock clock;
+    SimulatedFileSystem sd(ram, clock, m);
+    storage::io::IoScheduler io(sd);
+    REQUIRE(io.start());
+    VirtualClock::resetThreadUs();
+    for (int i = 0; i < 500; ++i) {
+        while (!io.append("/log.txt", line, n, storage::io::IoPriority::Normal)) io.drain();
+    }
+    io.drain();
+    io.stop();
+    CHECK(VirtualClock::threadUs() == 0);
+    CHECK(sd.stats().stalls >= 4);
+    CHECK(ram.totalBytes() == 500 * n);
+}
@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "storage/util/TailReader.h"
+
+using storage::mem::MemFileSystem;
+using storage::util::TailFollower;
+using storage::util::TailNotifier;
+using storage::util::TailReader;
+
+namespace {
+
+void appendText(MemFileSystem& fs, const char* path, const std::string& text) {
+    auto f = fs.openAppend(path);
+    REQUIRE(f);
+    if (!text.empty()) f->write(text.data(), text.size());
+}
+
+struct Collected {
+    std::vector<std::string> lines;
+    std::function<void(const String&)> sink() {
+        return [this](const String& l) { lines.push_back(l.c_str()); };
+    }
+};
+
+} // namespace
+
+TEST_CASE("lastLines returns the last N lines across block boundaries") {
+    MemFileSystem fs;
+    std::string text;
+    for (int i = 0; i < 100; ++i) text += "entry " + std::to_string(i) + "\r\n";
+    appendText(fs, "/app.log", text);
+    auto f = fs.openRead("/app.log");
+    TailReader tail(*f, 16);
+    std::vector<std::string> got;
+    CHECK(tail.lastLines(3, [&](const String& l) { got.push_back(l.c_str()); return true; }) == 3);
+    REQUIRE(got.size() == 3);
+    CHECK(got[0] == "entry 97");
+    CHECK(got[2] == "entry 99");
+
+    got.clear();
+    CHECK(tail.lastLines(500, [&](const String& l) { got.push_back(l.c_str()); return true; }) == 100);
+    CHECK(got.front() == "entry 0");
+}
+
+TEST_CASE("follow passes only complete new lines and backs off when idle") {
+    MemFileSystem fs;
+    appendText(fs, "/app.log", "old 1\nold 2\n");
+    TailFollower follow(fs, "/app.log", nullptr, 100, 800, 8);
+    follow.seekToEnd();
+    Collected c;
+
+    CHECK(follow.poll(0, c.sink()) == 0);
+    CHECK(follow.intervalMs() == 200);
+    appendText(fs, "/app.log", "new 1\nnew 2 part");
+    CHECK(follow.poll(100, c.sink()) == 0); // przed terminem – pliku nie sprawdza
+    CHECK(follow.poll(200, c.sink()) == 1);
+    CHECK(follow.intervalMs() == 100);
+    appendText(fs, "/app.log", "ial\r\n");
+    CHECK(follow.poll(300, c.sink()) == 1);
+    REQUIRE(c.lines.size() == 2);
+    CHECK(c.lines[0] == "new 1");
+    CHECK(c.lines[1] == "new 2 partial");
+
+    for (uint32_t t = 400; t < 10000; t += 100) follow.poll(t, c.sink());
+    CHECK(follow.intervalMs() == 800);
+}
+
+TEST_CASE("a notifier wakes the follower before its interval") {
+    MemFileSystem fs;
+    TailNotifier notifier;
+    appendText(fs, "/app.log", "");
+    TailFollower follow(fs, "/app.log", &notifier, 100, 5000);
+    Collected c;
+    follow.poll(0, c.sink());
+    CHECK(follow.intervalMs() == 5000);
+    appendText(fs, "/app.log", "ping\n");
+    CHECK(follow.poll(10, c.sink()) == 0);
+    notifier.appended("//app.log"); // ścieżka normalizowana
+    CHECK(follow.poll(20, c.sink()) == 1);
+    REQUIRE(c.lines.size() == 1);
+    CHECK(c.lines[0] == "ping");
+}
+
+TEST_CASE("truncation and rotation restart from the beginning of the new file") {
+    MemFileSystem fs;
+    appendText(fs, "/app.log", "a very long first line\nsecond\n");
+    TailFollower follow(fs, "/app.log", nullptr, 10, 10);
+    follow.seekToEnd();
+    Collected c;
+
+    // nadpisanie krótszą treścią
+    fs.openWrite("/app.log")->write("x\n", 2);
+    CHECK(follow.poll(0, c.sink()) == 1);
+    REQUIRE(c.lines.size() == 1);
+    CHECK(c.lines[0] == "x");
+
+    // rotacja: stary plik przeniesiony, nowy (krótszy) zaczyna od zera
+    appendText(fs, "/app.log", "half of a line");
+    CHECK(follow.poll(10, c.sink()) == 0);
+    REQUIRE(fs.rename("/app.log", "/app.log.1"));
+    CHECK(follow.poll(20, c.sink()) == 0); // brak pliku – bez zmian
+    appendText(fs, "/app.log", "fresh\n");
+    CHECK(follow.poll(30, c.sink()) == 1);
+    REQUIRE(c.lines.size() == 2);
+    CHECK(c.lines[1] == "fresh"); // niedokończona linia starego pliku odrzucona
+    CHECK(follow.offset() == 6);
+}
+
+TEST_CASE("a larger replacement file is read from its beginning") {
+    MemFileSystem fs;
+    appendText(fs, "/app.log", "old 1\nold 2\n");
+    TailFollower follow(fs, "/app.log", nullptr, 10, 10);
+    Collected c;
+    CHECK(follow.poll(0, c.sink()) == 2);
+    CHECK(follow.offset() == 12);
+
+    // rotacja na plik dłuższy niż przeczytana część – sam rozmiar tego nie zdradza
+    REQUIRE(fs.rename("/app.log", "/app.log.1"));
+    appendText(fs, "/app.log", "new 1\nnew 2\nnew 3\nnew 4\n");
+    CHECK(follow.poll(10, c.sink()) == 4);
+    REQUIRE(c.lines.size() == 6);
+    CHECK(c.lines[2] == "new 1");
+    CHECK(c.lines[5] == "new 4");
+
+    // dalsze dopisywanie – bez fałszywych restartów (suma obejmuje już pełne 32 bajty)
+    appendText(fs, "/app.log", "new 5\nnew 6\nnew 7\n");
+    CHECK(follow.poll(20, c.sink()) == 3);
+    appendText(fs, "/app.log", "new 8\n");
+    CHECK(follow.poll(30, c.sink()) == 1);
+    REQUIRE(c.lines.size() == 10);
+    CHECK(c.lines[9] == "new 8");
+
+    // seekToEnd na nowym pliku, potem nadpisanie dłuższą treścią o innym początku
+    follow.seekToEnd();
+    appendText(fs, "/app.log", "tail\n");
+    CHECK(follow.poll(40, c.sink()) == 1);
+    std::string big;
+    for (int i = 0; i < 20; ++i) big += "rewrite " + std::to_string(i) + "\n";
+    fs.openWrite("/app.log")->write(big.data(), big.size());
+    CHECK(follow.poll(50, c.sink()) == 20);
+    CHECK(c.lines.back() == "rewrite 19");
+}
@@ -0,0 +1,149 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/mem/SimulatedFileSystem.cpp"
+#include "../../src/storage/logs/TimeSeriesLog.cpp"
+
+using storage::logs::TimeSeriesLog;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+struct Sample {
+    float temp;
+    uint32_t seq;
+};
+
+const uint64_t kDay = 1760572800000ULL; // 2025-10-16 00:00:00 UTC, ms
+
+void fill(TimeSeriesLog& ts, uint32_t count, uint64_t start, uint32_t stepMs) {
+    for (uint32_t i = 0; i < count; ++i) {
+        Sample s{20.0f + i % 10, i};
+        REQUIRE(ts.append(start + static_cast<uint64_t>(i) * stepMs, &s));
+    }
+}
+
+} // namespace
+
+TEST_CASE("range query returns exactly the samples in [from, to]") {
+    MemFileSystem fs;
+    TimeSeriesLog ts(fs, "/ts/env", sizeof(Sample));
+    fill(ts, 3 * 36000 + 5, kDay, 100); // ~3 h przy 10 Hz → 4 pliki
+
+    std::vector<uint32_t> seqs;
+    uint64_t from = kDay + 5400000;  // 1:30
+    uint64_t to = kDay + 9000000;    // 2:30
+    size_t n = ts.query(from, to, [&](uint64_t t, const uint8_t* p) {
+        Sample s;
+        memcpy(&s, p, sizeof(s));
+        CHECK(t == kDay + static_cast<uint64_t>(s.seq) * 100);
+        seqs.push_back(s.seq);
+        return true;
+    });
+    REQUIRE(n == 36001);
+    CHECK(seqs.front() == 54000);
+    CHECK(seqs.back() == 90000);
+
+    uint64_t first = 0, last = 0;
+    REQUIRE(ts.span(first, last));
+    CHECK(first == kDay);
+    CHECK(last == kDay + static_cast<uint64_t>(3 * 36000 + 4) * 100);
+
+    // rekordy w buforze (niepełny blok) też są widoczne
+    CHECK(ts.query(last, last, [](uint64_t, const uint8_t*) { return true; }) == 1);
+    CHECK(fs.exists("/ts/env/1760572800.tsl"));
+    CHECK(fs.exists("/ts/env/1760576400.idx"));
+}
+
+TEST_CASE("query skips files and blocks it does not need") {
+    MemFileSystem ram;
+    storage::mem::VirtualClock clock;
+    storage::mem::SimulatedFileSystem sd(ram, clock, storage::mem::MediaModel::instant());
+    {
+        TimeSeriesLog ts(sd, "/ts", sizeof(Sample));
+        fill(ts, 24 * 3600, kDay, 1000); // doba, 1 Hz
+    }
+
+    TimeSeriesLog ts(sd, "/ts", sizeof(Sample));
+    sd.resetStats();
+    size_t n = ts.query(kDay + 23 * 3600000ULL, kDay + 23 * 3600000ULL + 59999,
+                        [](uint64_t, const uint8_t*) { return true; });
+    CHECK(n == 60);
+    // listDir + open/read nagłówka + indeks + 1-2 bloki, a nie 24 pliki
+    CHECK(sd.stats().ops < 40);
+}
+
+TEST_CASE("reopened log continues and rejects time going backwards") {
+    MemFileSystem fs;
+    {
+        TimeSeriesLog ts(fs, "/ts", sizeof(Sample));
+        fill(ts, 100, kDay, 100);
+    }
+    TimeSeriesLog ts(fs, "/ts", sizeof(Sample));
+    Sample s{1.0f, 100};
+    CHECK_FALSE(ts.append(kDay, &s));
+    CHECK(ts.append(kDay + 10000, &s));
+    CHECK(ts.query(0, UINT64_MAX, [](uint64_t, const uint8_t*) { return true; }) == 101);
+
+    TimeSeriesLog other(fs, "/ts", sizeof(Sample) + 4);
+    CHECK(other.query(0, UINT64_MAX, [](uint64_t, const uint8_t*) { return true; }) == 0);
+}
+
+TEST_CASE("stale header and missing index entries are recovered") {
+    MemFileSystem fs;
+    TimeSeriesLog::Config cfg;
+    cfg.recordsPerBlock = 8;
+    {
+        TimeSeriesLog ts(fs, "/ts", sizeof(Sample), cfg);
+        fill(ts, 40, kDay, 100);
+    }
+    // symulacja przerwanego zapisu: pusty indeks, nieaktualny licznik w nagłówku
+    fs.open("/ts/1760572800.idx", storage::OpenMode::WriteTruncate)->close();
+    {
+        auto f = fs.open("/ts/1760572800.tsl", storage::OpenMode::ReadWrite);
+        uint32_t staleCount = 16;
+        f->seek(16);
+        f->write(&staleCount, sizeof(staleCount));
+    }
+
+    TimeSeriesLog ts(fs, "/ts", sizeof(Sample), cfg);
+    Sample s{0.0f, 40};
+    CHECK_FALSE(ts.append(kDay + 3800, &s)); // ostatni rekord odczytany z danych, nie z nagłówka
+    REQUIRE(ts.append(kDay + 5000, &s));
+    CHECK(ts.query(kDay + 3000, kDay + 5000, [](uint64_t, const uint8_t*) { return true; }) == 11);
+    ts.close();
+
+    auto idx = fs.openRead("/ts/1760572800.idx");
+    CHECK(idx->size() == 6 * 8);
+}
+
+TEST_CASE("files written with another block size or period are rejected") {
+    MemFileSystem fs;
+    TimeSeriesLog::Config cfg;
+    cfg.recordsPerBlock = 8;
+    {
+        TimeSeriesLog ts(fs, "/ts", sizeof(Sample), cfg);
+        fill(ts, 40, kDay, 100);
+    }
+    auto all = [](uint64_t, const uint8_t*) { return true; };
+    Sample s{0.0f, 40};
+
+    TimeSeriesLog::Config otherBlock = cfg;
+    otherBlock.recordsPerBlock = 16;
+    TimeSeriesLog a(fs, "/ts", sizeof(Sample), otherBlock);
+    CHECK(a.query(0, UINT64_MAX, all) == 0);
+    CHECK_FALSE(a.append(kDay + 5000, &s));
+
+    TimeSeriesLog::Config otherPeriod = cfg;
+    otherPeriod.filePeriodSec = 86400;
+    TimeSeriesLog b(fs, "/ts", sizeof(Sample), otherPeriod);
+    CHECK(b.query(0, UINT64_MAX, all) == 0);
+
+    TimeSeriesLog same(fs, "/ts", sizeof(Sample), cfg);
+    CHECK(same.query(0, UINT64_MAX, all) == 40);
+}
@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/storage/mem/MemFileSystem.cpp"
+#include "../../src/storage/mem/MemFile.cpp"
+#include "../../src/storage/io/WatchedFileSystem.cpp"
+
+using storage::OpenMode;
+using storage::io::WatchedFileSystem;
+using storage::mem::MemFileSystem;
+
+namespace {
+
+struct Seen {
+    std::string path;
+    uint8_t events;
+};
+
+void put(storage::IFileSystem& fs, const std::string& path, const std::string& data) {
+    auto f = fs.openWrite(path);
+    REQUIRE(f);
+    f->write(data.data(), data.size());
+}
+
+} // namespace
+
+TEST_CASE("writes are coalesced per path and delivered only by dispatch") {
+    MemFileSystem ram;
+    WatchedFileSystem fs(ram);
+    fs.mkdir("/config");
+    std::vector<Seen> seen;
+    fs.subscribe("/config", [&](const std::string& p, uint8_t e) { seen.push_back(Seen{p, e}); });
+
+    put(fs, "/config/app.ini", "a=1");
+    put(fs, "/config/app.ini", "a=2");
+    auto f = fs.openAppend("/config/app.ini");
+    f->write("\nb=3", 4);
+    CHECK(seen.empty());          // nic w trakcie I/O
+    CHECK(fs.pending() == 1);
+    f.reset();
+
+    CHECK(fs.dispatch() == 1);
+    REQUIRE(seen.size() == 1);
+    CHECK(seen[0].path == "/config/app.ini");
+    CHECK(seen[0].events == (WatchedFileSystem::Created | WatchedFileSystem::Modified));
+    CHECK(fs.dispatch() == 0);
+}
+
+TEST_CASE("only matching subscriptions are notified") {
+    MemFileSystem ram;
+    WatchedFileSystem fs(ram);
+    int configCalls = 0, allCalls = 0;
+    fs.subscribe("/config/app.ini", [&](const std::string&, uint8_t) { configCalls++; });
+    uint32_t all = fs.subscribe("/", [&](const std::string&, uint8_t) { allCalls++; });
+
+    put(fs, "/config.bak", "x");      // ten sam prefiks tekstowy, inna ścieżka
+    put(fs, "/data/log.txt", "x");
+    fs.dispatch();
+    CHECK(configCalls == 0);
+    CHECK(allCalls == 2);
+
+    fs.unsubscribe(all);
+    put(fs, "/data/log.txt", "y");
+    CHECK(fs.pending() == 0);         // nikt nie obserwuje – brak kolejki
+}
+
+TEST_CASE("read-only opens and untouched append handles report nothing") {
+    MemFileSystem ram;
+    WatchedFileSystem fs(ram);
+    put(ram, "/a.txt", "abc");
+    fs.subscribe("/a.txt", [](const std::string&, uint8_t) {});
+
+    char buf[4];
+    fs.openRead("/a.txt")->read(buf, 3);
+    fs.openAppend("/a.txt");
+    CHECK(fs.pending() == 0);
+}
+
+TEST_CASE("remove, rename and parent directory changes") {
+    MemFileSystem ram;
+    WatchedFileSystem fs(ram);
+    put(ram, "/cfg/app.ini", "a=1");
+    std::vector<Seen> seen;
+    fs.subscribe("/cfg/app.ini", [&](const std::string& p, uint8_t e) { seen.push_back(Seen{p, e}); });
+    fs.subscribe("/new.ini", [&](const std::string& p, uint8_t e) { seen.push_back(Seen{p, e}); });
+
+    REQUIRE(fs.rename("/cfg/app.ini", "/new.ini"));
+    fs.dispatch();
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0].path == "/cfg/app.ini");
+    CHECK(seen[0].events == (WatchedFileSystem::Removed | WatchedFileSystem::Renamed));
+    CHECK(seen[1].path == "/new.ini");
+    CHECK(seen[1].events == (WatchedFileSystem::Created | WatchedFileSystem::Renamed));
+
+    seen.clear();
+    CHECK(fs.remove("/cfg"));         // katalog nadrzędny obserwowanej ścieżki
+    CHECK_FALSE(fs.remove("/missing.ini"));
+    fs.dispatch();
+    REQUIRE(seen.size() == 1);
+    CHECK(seen[0].path == "/cfg");
+    CHECK(seen[0].events == WatchedFileSystem::Removed);
+}
+
+TEST_CASE("wakeup fires once per batch and callbacks may do I/O") {
+    MemFileSystem ram;
+    WatchedFileSystem fs(ram);
+    int wakes = 0;
+    fs.setWakeup([&] { wakes++; });
+    int calls = 0;
+    fs.subscribe("/in", [&](const std::string& p, uint8_t) {
+        calls++;
+        fs.remove(p);                 // reakcja na zdarzenie – bez zakleszczenia
+    });
+
+    put(fs, "/in/1.job", "x");
+    put(fs, "/in/2.job", "y");
+    CHECK(wakes == 1);
+    CHECK(fs.dispatch() == 2);
+    CHECK(calls == 2);
+    CHECK_FALSE(ram.exists("/in/1.job"));
+    CHECK(fs.pending() == 2);         // usunięcia zgłoszone w następnej partii
+    CHECK(wakes == 2);
+}